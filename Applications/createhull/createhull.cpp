@@ -1,8 +1,10 @@
 #include "GEK/Math/Common.hpp"
 #include "GEK/Math/Matrix4x4.hpp"
 #include "GEK/Math/Vector3.hpp"
+#include "GEK/Physics/Format.hpp"
 #include "GEK/Shapes/AlignedBox.hpp"
 #include "GEK/Utility/Context.hpp"
+#include "GEK/Utility/FileSystem.hpp"
 #include "GEK/Utility/String.hpp"
 #include <algorithm>
 #include <sstream>
@@ -24,14 +26,22 @@ struct Header
 {
     uint32_t identifier = *(uint32_t *)"GEKX";
     uint16_t type = 1;
-    uint16_t version = 3;
+    uint16_t version = 4;
 };
 
+template <typename DATA>
+void Append(std::vector<uint8_t> &buffer, DATA const *data, size_t count)
+{
+    auto rawData = reinterpret_cast<uint8_t const *>(data);
+    buffer.insert(std::end(buffer), rawData, (rawData + (sizeof(DATA) * count)));
+}
+
 struct Parameters
 {
     std::string sourceName;
     std::string targetName;
     float feetPerUnit;
+    bool compress;
 };
 
 bool GetModels(Context *context, Parameters const &parameters, aiScene const *inputScene, aiNode const *inputNode, aiMatrix4x4 const &parentTransform, std::vector<Math::Float3> &pointList, Shapes::AlignedBox &boundingBox)
@@ -135,6 +145,11 @@ int main(int argumentCount, char const *const argumentList[])
         .help("units per foot")
         .default_value(1.0f);
 
+    program.add_argument("-r", "--raw")
+        .help("store the data without compression")
+        .default_value(false)
+        .implicit_value(true);
+
     program.add_description("Convert input model in to GEK Engine format.");
     program.add_epilog("Input model formats include anything supported by the Assimp library.");
 
@@ -164,6 +179,7 @@ int main(int argumentCount, char const *const argumentList[])
     parameters.sourceName = program.get<std::string>("--input");
     parameters.targetName = program.get<std::string>("--output");
     parameters.feetPerUnit = (1.0f / program.get<float>("--unitsperfoot"));
+    parameters.compress = !program.get<bool>("--raw");
 
     auto pluginPath(FileSystem::GetModuleFilePath().getParentPath());
     auto cachePath(FileSystem::GetCacheFromModule());
@@ -271,12 +287,15 @@ int main(int argumentCount, char const *const argumentList[])
         file.open(outputPath.getString().data(), std::ios::out | std::ios::binary);
         if (file.is_open())
         {
+            std::vector<uint8_t> buffer;
             Header header;
-            FileSystem::Write(file, &header, 1);
+            Append(buffer, &header, 1);
 
             uint32_t pointCount = pointList.size();
-            FileSystem::Write(file, &pointCount, 1);
-            FileSystem::Write(file, pointList.data(), pointCount);
+            Append(buffer, &pointCount, 1);
+            Append(buffer, pointList.data(), pointCount);
+            auto fileData = PhysicsFormat::EncodePayload(buffer, parameters.compress);
+            FileSystem::Write(file, fileData.data(), static_cast<uint32_t>(fileData.size()));
             file.close();
         }
         else
@@ -1,17 +1,23 @@
 #include "GEK/Math/Common.hpp"
 #include "GEK/Math/Matrix4x4.hpp"
 #include "GEK/Math/Vector3.hpp"
+#include "GEK/Model/Format.hpp"
 #include "GEK/Shapes/AlignedBox.hpp"
+#include "GEK/Shapes/MeshOptimizer.hpp"
+#include "GEK/Utility/Compression.hpp"
 #include "GEK/Utility/Context.hpp"
 #include "GEK/Utility/FileSystem.hpp"
 #include "GEK/Utility/JSON.hpp"
 #include "GEK/Utility/String.hpp"
 #include <algorithm>
 #include <argparse/argparse.hpp>
+#include <array>
 #include <assimp/cimport.h>
 #include <assimp/config.h>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <cmath>
+#include <cstring>
 #include <format>
 #include <map>
 #include <mikktspace.h>
@@ -26,11 +32,10 @@
 
 using namespace Gek;
 
-enum class NormalEncoding : uint8_t
-{
-    RG = 0,
-    RGB = 1,
-};
+using ModelFormat::NormalEncoding;
+using ModelFormat::StreamCodec;
+using ModelFormat::VertexEncoding;
+using ModelFormat::MaxLevelCount;
 
 constexpr const char *ToString(NormalEncoding encoding)
 {
@@ -56,26 +61,6 @@ NormalEncoding ParseNormalEncoding(std::string value)
     return NormalEncoding::RGB;
 }
 
-struct Header
-{
-    struct Mesh
-    {
-        char material[64] = "";
-        uint32_t vertexCount = 0;
-        uint32_t faceCount = 0;
-        uint8_t normalEncoding = static_cast<uint8_t>(NormalEncoding::RGB);
-        uint8_t reserved[3] = { 0, 0, 0 };
-    };
-
-    uint32_t identifier = *(uint32_t *)"GEKX";
-    uint16_t type = 0;
-    uint16_t version = 9;
-
-    Shapes::AlignedBox boundingBox;
-
-    uint32_t meshCount = 0;
-};
-
 struct Mesh
 {
     std::string material;
@@ -88,23 +73,19 @@ struct Mesh
 struct IndexedMesh
     : public Mesh
 {
-    struct Face
+    struct Level
     {
-        uint16_t data[3];
-        uint16_t &operator[](size_t index)
-        {
-            return data[index];
-        }
-
-        const uint16_t &operator[](size_t index) const
-        {
-            return data[index];
-        }
+        std::vector<uint32_t> indexList;
+        float error = 0.0f;
     };
 
-    std::vector<Face> faceList;
+    std::vector<uint32_t> indexList;
+    std::vector<Level> levelList;
+    std::vector<Shapes::MeshOptimizer::Meshlet> meshletList;
 };
 
+static_assert(sizeof(Shapes::MeshOptimizer::Meshlet) == (sizeof(uint32_t) * 10), "Meshlets are written as they are and can not contain padding");
+
 struct Model
 {
     std::string name;
@@ -122,9 +103,239 @@ struct Parameters
     bool generateSmoothNormals;
     float smoothingAngle;
     bool saveAsCode;
+    bool compressStreams;
+    bool quantizeVertices;
+    uint32_t levelCount;
+    uint32_t meshletFaceCount;
     NormalEncoding normalEncoding;
 };
 
+std::string ToString(ModelFormat::MeshHeader::Stream const &stream)
+{
+    switch (static_cast<StreamCodec>(stream.codec))
+    {
+    case StreamCodec::LZ4:
+        return std::format("lz4 ({} bytes)", stream.storedSize);
+
+    case StreamCodec::ShuffledLZ4:
+        return std::format("shuffled lz4 ({} bytes)", stream.storedSize);
+
+    case StreamCodec::None:
+    default:
+        return std::format("raw ({} bytes)", stream.storedSize);
+    }
+}
+
+uint16_t GetUnorm16(float value)
+{
+    return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+// Rounds to the nearest half float, ties to even, so texture coordinates land on the closest representable value
+uint16_t GetHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(float));
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    const uint32_t magnitude = (bits & 0x7FFFFFFF);
+    if (magnitude >= 0x47800000)
+    {
+        return (sign | ((magnitude > 0x7F800000) ? 0x7E00 : 0x7C00));
+    }
+
+    if (magnitude < 0x38800000)
+    {
+        return (sign | static_cast<uint16_t>(std::lrint(std::abs(value) * 16777216.0f)));
+    }
+
+    uint32_t half = ((magnitude - 0x38000000) >> 13);
+    const uint32_t remainder = (magnitude & 0x1FFF);
+    if ((remainder > 0x1000) || ((remainder == 0x1000) && (half & 1)))
+    {
+        ++half;
+    }
+
+    return (sign | static_cast<uint16_t>(half));
+}
+
+// Matches GetEncodedNormal in GEKUtility.slang, both components end up in the unsigned zero to one range
+std::array<uint16_t, 2> GetOctahedralNormal(Math::Float3 const &normal)
+{
+    const float length = (std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z));
+    if (length <= 0.0f)
+    {
+        return { GetUnorm16(0.5f), GetUnorm16(0.5f) };
+    }
+
+    float x = (normal.x / length);
+    float y = (normal.y / length);
+    if (normal.z < 0.0f)
+    {
+        const float wrappedX = ((1.0f - std::abs(y)) * ((x >= 0.0f) ? 1.0f : -1.0f));
+        const float wrappedY = ((1.0f - std::abs(x)) * ((y >= 0.0f) ? 1.0f : -1.0f));
+        x = wrappedX;
+        y = wrappedY;
+    }
+
+    return { GetUnorm16((x * 0.5f) + 0.5f), GetUnorm16((y * 0.5f) + 0.5f) };
+}
+
+// Fills the vertex streams of the mesh header in the requested encoding, quantized positions are stored as
+// fractions of a cube around the mesh bounds so that a uniform scale expands them again
+void EncodeVertexStreams(IndexedMesh const &mesh, Parameters const &parameters, ModelFormat::MeshHeader &meshHeader, std::vector<std::vector<uint8_t>> &streamDataList)
+{
+    if (!parameters.quantizeVertices)
+    {
+        meshHeader.vertexEncoding = static_cast<uint8_t>(VertexEncoding::Float);
+        streamDataList.push_back(ModelFormat::EncodeStream(mesh.pointList.data(), (sizeof(Math::Float3) * mesh.pointList.size()), sizeof(float), parameters.compressStreams, meshHeader.streamList[0]));
+        streamDataList.push_back(ModelFormat::EncodeStream(mesh.texCoordList.data(), (sizeof(Math::Float2) * mesh.texCoordList.size()), sizeof(float), parameters.compressStreams, meshHeader.streamList[1]));
+        streamDataList.push_back(ModelFormat::EncodeStream(mesh.tangentList.data(), (sizeof(Math::Float4) * mesh.tangentList.size()), sizeof(float), parameters.compressStreams, meshHeader.streamList[2]));
+        streamDataList.push_back(ModelFormat::EncodeStream(mesh.normalList.data(), (sizeof(Math::Float3) * mesh.normalList.size()), sizeof(float), parameters.compressStreams, meshHeader.streamList[3]));
+        return;
+    }
+
+    Shapes::AlignedBox boundingBox;
+    for (auto const &point : mesh.pointList)
+    {
+        boundingBox.extend(point);
+    }
+
+    auto size = (boundingBox.maximum - boundingBox.minimum);
+    meshHeader.vertexEncoding = static_cast<uint8_t>(VertexEncoding::Quantized);
+    meshHeader.positionMinimum = boundingBox.minimum;
+    meshHeader.positionScale = std::max({ size.x, size.y, size.z });
+    if (meshHeader.positionScale <= 0.0f)
+    {
+        meshHeader.positionScale = 1.0f;
+    }
+
+    const size_t vertexCount = mesh.pointList.size();
+    std::vector<uint16_t> positionList, texCoordList, tangentList, normalList;
+    positionList.reserve(vertexCount * 4);
+    texCoordList.reserve(vertexCount * 2);
+    tangentList.reserve(vertexCount * 4);
+    normalList.reserve(vertexCount * 2);
+    for (size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+    {
+        auto position = ((mesh.pointList[vertexIndex] - meshHeader.positionMinimum) / meshHeader.positionScale);
+        positionList.insert(std::end(positionList), { GetUnorm16(position.x), GetUnorm16(position.y), GetUnorm16(position.z), 0 });
+
+        auto const &texCoord = mesh.texCoordList[vertexIndex];
+        texCoordList.insert(std::end(texCoordList), { GetHalf(texCoord.x), GetHalf(texCoord.y) });
+
+        auto const &tangent = mesh.tangentList[vertexIndex];
+        auto encodedTangent = GetOctahedralNormal(tangent.xyz());
+        tangentList.insert(std::end(tangentList), { encodedTangent[0], encodedTangent[1], 0, GetUnorm16((tangent.w < 0.0f) ? 0.0f : 1.0f) });
+
+        auto encodedNormal = GetOctahedralNormal(mesh.normalList[vertexIndex]);
+        normalList.insert(std::end(normalList), { encodedNormal[0], encodedNormal[1] });
+    }
+
+    streamDataList.push_back(ModelFormat::EncodeStream(positionList.data(), (sizeof(uint16_t) * positionList.size()), sizeof(uint16_t), parameters.compressStreams, meshHeader.streamList[0]));
+    streamDataList.push_back(ModelFormat::EncodeStream(texCoordList.data(), (sizeof(uint16_t) * texCoordList.size()), sizeof(uint16_t), parameters.compressStreams, meshHeader.streamList[1]));
+    streamDataList.push_back(ModelFormat::EncodeStream(tangentList.data(), (sizeof(uint16_t) * tangentList.size()), sizeof(uint16_t), parameters.compressStreams, meshHeader.streamList[2]));
+    streamDataList.push_back(ModelFormat::EncodeStream(normalList.data(), (sizeof(uint16_t) * normalList.size()), sizeof(uint16_t), parameters.compressStreams, meshHeader.streamList[3]));
+}
+
+// Each level aims for half the triangles of the one before, always simplified from the full detail mesh so the errors
+// stay relative to the original surface.  Levels that barely save anything end the chain.
+void GetLevels(Context *context, Parameters const &parameters, IndexedMesh &indexedMesh)
+{
+    Shapes::AlignedBox boundingBox;
+    for (auto const &point : indexedMesh.pointList)
+    {
+        boundingBox.extend(point);
+    }
+
+    auto size(boundingBox.maximum - boundingBox.minimum);
+    const float maximumError = (std::max({ size.x, size.y, size.z }) * 0.05f);
+    const uint32_t vertexCount = static_cast<uint32_t>(indexedMesh.pointList.size());
+    size_t previousIndexCount = indexedMesh.indexList.size();
+    for (uint32_t level = 0; level < std::min(parameters.levelCount, MaxLevelCount); ++level)
+    {
+        size_t targetIndexCount = ((indexedMesh.indexList.size() >> (level + 1)) / 3 * 3);
+        IndexedMesh::Level meshLevel;
+        meshLevel.indexList = Shapes::MeshOptimizer::Simplify(indexedMesh.indexList, indexedMesh.pointList.data(), vertexCount, targetIndexCount, maximumError, &meshLevel.error);
+        if (meshLevel.indexList.empty() || (meshLevel.indexList.size() > (previousIndexCount * 9 / 10)))
+        {
+            break;
+        }
+
+        auto clusterList = Shapes::MeshOptimizer::OptimizeVertexCache(meshLevel.indexList, vertexCount);
+        Shapes::MeshOptimizer::OptimizeOverdraw(meshLevel.indexList, clusterList, indexedMesh.pointList.data(), vertexCount);
+        context->log(Context::Info, "- Level {}: {} faces, {:.5f} error", (level + 1), (meshLevel.indexList.size() / 3), meshLevel.error);
+        previousIndexCount = meshLevel.indexList.size();
+        indexedMesh.levelList.push_back(std::move(meshLevel));
+    }
+}
+
+// Welds the vertices that came out of MikkTSpace identical, then orders the triangles and vertices for the GPU caches
+IndexedMesh GetIndexedMesh(Context *context, Parameters const &parameters, Mesh const &mesh)
+{
+    struct Vertex
+    {
+        Math::Float3 position;
+        Math::Float2 texCoord;
+        Math::Float4 tangent;
+        Math::Float3 normal;
+    };
+
+    static_assert(sizeof(Vertex) == (sizeof(float) * 12), "Vertices are compared byte for byte and can not contain padding");
+
+    const uint32_t vertexCount = static_cast<uint32_t>(mesh.pointList.size());
+    std::vector<Vertex> vertexList(vertexCount);
+    for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+    {
+        auto &vertex = vertexList[vertexIndex];
+        vertex.position = mesh.pointList[vertexIndex];
+        vertex.texCoord = mesh.texCoordList[vertexIndex];
+        vertex.tangent = mesh.tangentList[vertexIndex];
+        vertex.normal = mesh.normalList[vertexIndex];
+    }
+
+    // The source mesh has one vertex per corner, so the remap doubles as the welded index list
+    IndexedMesh indexedMesh;
+    indexedMesh.material = mesh.material;
+    auto weldedCount = Shapes::MeshOptimizer::GenerateVertexRemap(vertexList.data(), vertexCount, sizeof(Vertex), indexedMesh.indexList);
+    vertexList = Shapes::MeshOptimizer::RemapVertices(vertexList, indexedMesh.indexList, weldedCount);
+
+    std::vector<Math::Float3> positionList(weldedCount);
+    std::transform(std::begin(vertexList), std::end(vertexList), std::begin(positionList), [](Vertex const &vertex) -> Math::Float3
+    {
+        return vertex.position;
+    });
+
+    auto originalRatio = Shapes::MeshOptimizer::GetCacheMissRatio(indexedMesh.indexList, weldedCount);
+    auto clusterList = Shapes::MeshOptimizer::OptimizeVertexCache(indexedMesh.indexList, weldedCount);
+    Shapes::MeshOptimizer::OptimizeOverdraw(indexedMesh.indexList, clusterList, positionList.data(), weldedCount);
+    auto optimizedRatio = Shapes::MeshOptimizer::GetCacheMissRatio(indexedMesh.indexList, weldedCount);
+
+    std::vector<uint32_t> remapList;
+    auto fetchCount = Shapes::MeshOptimizer::OptimizeVertexFetch(indexedMesh.indexList, weldedCount, remapList);
+    vertexList = Shapes::MeshOptimizer::RemapVertices(vertexList, remapList, fetchCount);
+    for (auto const &vertex : vertexList)
+    {
+        indexedMesh.pointList.push_back(vertex.position);
+        indexedMesh.texCoordList.push_back(vertex.texCoord);
+        indexedMesh.tangentList.push_back(vertex.tangent);
+        indexedMesh.normalList.push_back(vertex.normal);
+    }
+
+    context->log(Context::Info, "- Welded: {} vertices in to {}, {} clusters", vertexCount, fetchCount, clusterList.size());
+    context->log(Context::Info, "- Cache Misses: {:.3f} per triangle, {:.3f} before optimizing", optimizedRatio, originalRatio);
+    GetLevels(context, parameters, indexedMesh);
+
+    // Only the full detail indices are split, the simplified levels are drawn whole
+    const size_t faceCount = (indexedMesh.indexList.size() / 3);
+    if ((parameters.meshletFaceCount > 0) && (faceCount >= parameters.meshletFaceCount))
+    {
+        indexedMesh.meshletList = Shapes::MeshOptimizer::BuildMeshlets(indexedMesh.indexList, indexedMesh.pointList.data(), fetchCount);
+        context->log(Context::Info, "- Meshlets: {}, {:.1f} faces each", indexedMesh.meshletList.size(), (float(faceCount) / indexedMesh.meshletList.size()));
+    }
+
+    return indexedMesh;
+}
+
 bool GetModels(Context *context, Parameters const &parameters, aiScene const *inputScene, aiNode const *inputNode, aiMatrix4x4 const &accumulatedTransform, ModelList &modelList, std::function<std::string(const std::string &, const std::string &)> findMaterialForMesh)
 {
     if (inputNode == nullptr)
@@ -204,63 +415,6 @@ bool GetModels(Context *context, Parameters const &parameters, aiScene const *in
                 context->log(Context::Info, "- Num. Faces: {}", inputMesh->mNumFaces);
                 context->log(Context::Info, "- Num. Vertex: {}", inputMesh->mNumVertices);
 
-                IndexedMesh indexedMesh;
-                indexedMesh.material = material;
-                indexedMesh.faceList.reserve(inputMesh->mNumFaces);
-                for (uint32_t faceIndex = 0; faceIndex < inputMesh->mNumFaces; ++faceIndex)
-                {
-                    const aiFace &face = inputMesh->mFaces[faceIndex];
-                    if (face.mNumIndices != 3)
-                    {
-                        context->log(Context::Error, "Skipping non-triangular face, face: {}, {} indices", faceIndex, face.mNumIndices);
-                        continue;
-                    }
-
-                    IndexedMesh::Face meshFace;
-                    for (uint32_t edgeIndex = 0; edgeIndex < 3; ++edgeIndex)
-                    {
-                        meshFace[edgeIndex] = face.mIndices[edgeIndex];
-                    }
-
-                    indexedMesh.faceList.push_back(meshFace);
-                }
-
-                indexedMesh.pointList.resize(inputMesh->mNumVertices);
-                indexedMesh.texCoordList.resize(inputMesh->mNumVertices);
-                indexedMesh.tangentList.resize(inputMesh->mNumVertices);
-                indexedMesh.normalList.resize(inputMesh->mNumVertices);
-                for (uint32_t vertexIndex = 0; vertexIndex < inputMesh->mNumVertices; ++vertexIndex)
-                {
-                    Math::Float3 position(inputMesh->mVertices[vertexIndex].x, inputMesh->mVertices[vertexIndex].y, inputMesh->mVertices[vertexIndex].z);
-                    Math::Float2 texCoord(inputMesh->mTextureCoords[0][vertexIndex].x, inputMesh->mTextureCoords[0][vertexIndex].y);
-                    Math::Float3 normal(inputMesh->mNormals[vertexIndex].x, inputMesh->mNormals[vertexIndex].y, inputMesh->mNormals[vertexIndex].z);
-
-                    Math::Float3 tangent(1.0f, 0.0f, 0.0f);
-                    float tangentSign = 1.0f;
-                    if (inputMesh->mTangents)
-                    {
-                        tangent = Math::Float3(inputMesh->mTangents[vertexIndex].x, inputMesh->mTangents[vertexIndex].y, inputMesh->mTangents[vertexIndex].z);
-
-                        if (inputMesh->mBitangents)
-                        {
-                            Math::Float3 bitangent(inputMesh->mBitangents[vertexIndex].x, inputMesh->mBitangents[vertexIndex].y, inputMesh->mBitangents[vertexIndex].z);
-                            tangentSign = ((normal.cross(tangent)).dot(bitangent) < 0.0f) ? -1.0f : 1.0f;
-                        }
-                    }
-
-                    tangentSign = -tangentSign;
-
-                    indexedMesh.pointList[vertexIndex] = localTransform.transform(position) * parameters.feetPerUnit;
-                    indexedMesh.texCoordList[vertexIndex] = texCoord;
-                    indexedMesh.tangentList[vertexIndex].set(localTransform.rotate(tangent), tangentSign);
-                    indexedMesh.normalList[vertexIndex] = localTransform.rotate(normal);
-                }
-
-                for (const auto &point : indexedMesh.pointList)
-                {
-                    model.boundingBox.extend(point);
-                }
-
                 Mesh mesh;
                 mesh.material = material;
                 mesh.pointList.reserve(inputMesh->mNumFaces * 3);
@@ -420,7 +574,7 @@ bool GetModels(Context *context, Parameters const &parameters, aiScene const *in
                     regularUVFaceCount);
 
                 model.meshList.push_back(mesh);
-                model.indexedMeshList.push_back(indexedMesh);
+                model.indexedMeshList.push_back(GetIndexedMesh(context, parameters, mesh));
             }
 
             modelList.push_back(model);
@@ -472,6 +626,26 @@ int main(int argumentCount, char const *const argumentList[])
         .help("units per foot")
         .default_value(1.0f);
 
+    program.add_argument("-r", "--raw")
+        .help("store vertex streams without compression")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("-q", "--quantize")
+        .help("store 16 bit positions, half float texture coordinates and octahedral tangent frames")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("-l", "--levels")
+        .scan<'u', uint32_t>()
+        .help("number of simplified levels of detail to generate, at most 4")
+        .default_value(3u);
+
+    program.add_argument("-m", "--meshletfaces")
+        .scan<'u', uint32_t>()
+        .help("split meshes with at least this many faces in to meshlets that are culled separately, 0 to disable")
+        .default_value(4096u);
+
     program.add_argument("-n", "--normalencoding")
         .help("normal texture encoding to coordinate materials and model metadata (rgb|rg)")
         .default_value(std::string("rgb"));
@@ -507,6 +681,10 @@ int main(int argumentCount, char const *const argumentList[])
     parameters.smoothingAngle = program.get<float>("--smoothangle");
     parameters.generateSmoothNormals = program.is_used("--smoothangle");
     parameters.saveAsCode = program.get<bool>("codify");
+    parameters.compressStreams = !program.get<bool>("--raw");
+    parameters.quantizeVertices = program.get<bool>("--quantize");
+    parameters.levelCount = program.get<uint32_t>("--levels");
+    parameters.meshletFaceCount = program.get<uint32_t>("--meshletfaces");
     parameters.normalEncoding = ParseNormalEncoding(program.get<std::string>("--normalencoding"));
 
     auto pluginPath(FileSystem::GetModuleFilePath().getParentPath());
@@ -904,33 +1082,66 @@ struct StaticModel
                     return -__LINE__;
                 }
 
-                Header header;
-                header.meshCount = model.meshList.size();
+                ModelFormat::FileHeader header;
+                header.meshCount = model.indexedMeshList.size();
                 header.boundingBox = model.boundingBox;
-                fwrite(&header, sizeof(Header), 1, file);
+                fwrite(&header, sizeof(ModelFormat::FileHeader), 1, file);
 
-                for (auto &mesh : model.meshList)
+                // Streams are encoded up front, the mesh headers need their stored sizes
+                std::vector<std::vector<uint8_t>> streamDataList;
+                for (auto &mesh : model.indexedMeshList)
                 {
                     context->log(Context::Info, "- Mesh: {}", mesh.material);
                     context->log(Context::Info, "- Num. Vertices: {}", mesh.pointList.size());
-                    // context->log(Context::Info, "- Num. Faces: {}", mesh.faceList.size());
+                    context->log(Context::Info, "- Num. Faces: {}", (mesh.indexList.size() / 3));
 
-                    Header::Mesh meshHeader;
+                    ModelFormat::MeshHeader meshHeader;
                     std::strncpy(meshHeader.material, mesh.material.data(), 63);
                     meshHeader.vertexCount = mesh.pointList.size();
-                    // meshHeader.faceCount = mesh.faceList.size();
+                    meshHeader.faceCount = (mesh.indexList.size() / 3);
                     //  Always write the normalEncoding field from parameters, regardless of material properties
                     meshHeader.normalEncoding = static_cast<uint8_t>(parameters.normalEncoding);
-                    fwrite(&meshHeader, sizeof(Header::Mesh), 1, file);
+                    EncodeVertexStreams(mesh, parameters, meshHeader, streamDataList);
+
+                    // Levels share the vertices, their indices follow the full detail indices in the same stream
+                    std::vector<uint32_t> indexList(mesh.indexList);
+                    meshHeader.levelCount = static_cast<uint32_t>(mesh.levelList.size());
+                    for (uint32_t level = 0; level < meshHeader.levelCount; ++level)
+                    {
+                        auto const &levelIndexList = mesh.levelList[level].indexList;
+                        meshHeader.levelIndexCountList[level] = static_cast<uint32_t>(levelIndexList.size());
+                        meshHeader.levelErrorList[level] = mesh.levelList[level].error;
+                        indexList.insert(std::end(indexList), std::begin(levelIndexList), std::end(levelIndexList));
+                    }
+
+                    // Sixteen bit indices whenever every vertex can be reached with them
+                    if (meshHeader.vertexCount <= 0x10000)
+                    {
+                        std::vector<uint16_t> shortIndexList(std::begin(indexList), std::end(indexList));
+                        meshHeader.indexSize = sizeof(uint16_t);
+                        streamDataList.push_back(ModelFormat::EncodeStream(shortIndexList.data(), (sizeof(uint16_t) * shortIndexList.size()), sizeof(uint16_t), parameters.compressStreams, meshHeader.indexStream));
+                    }
+                    else
+                    {
+                        meshHeader.indexSize = sizeof(uint32_t);
+                        streamDataList.push_back(ModelFormat::EncodeStream(indexList.data(), (sizeof(uint32_t) * indexList.size()), sizeof(uint32_t), parameters.compressStreams, meshHeader.indexStream));
+                    }
+
+                    if (!mesh.meshletList.empty())
+                    {
+                        meshHeader.meshletCount = static_cast<uint32_t>(mesh.meshletList.size());
+                        streamDataList.push_back(ModelFormat::EncodeStream(mesh.meshletList.data(), (sizeof(Shapes::MeshOptimizer::Meshlet) * mesh.meshletList.size()), sizeof(float), parameters.compressStreams, meshHeader.meshletStream));
+                    }
+
+                    context->log(Context::Info, "- Vertex Encoding: {}", parameters.quantizeVertices ? "quantized" : "float");
+                    context->log(Context::Info, "- Stream Codecs: {}, {}, {}, {}", ToString(meshHeader.streamList[0]), ToString(meshHeader.streamList[1]), ToString(meshHeader.streamList[2]), ToString(meshHeader.streamList[3]));
+                    context->log(Context::Info, "- Index Codec: {}-bit, {}", (meshHeader.indexSize * 8), ToString(meshHeader.indexStream));
+                    fwrite(&meshHeader, sizeof(ModelFormat::MeshHeader), 1, file);
                 }
 
-                for (auto &mesh : model.meshList)
+                for (auto &streamData : streamDataList)
                 {
-                    // fwrite(mesh.faceList.data(), sizeof(Mesh::Face), mesh.faceList.size(), file);
-                    fwrite(mesh.pointList.data(), sizeof(Math::Float3), mesh.pointList.size(), file);
-                    fwrite(mesh.texCoordList.data(), sizeof(Math::Float2), mesh.texCoordList.size(), file);
-                    fwrite(mesh.tangentList.data(), sizeof(Math::Float4), mesh.tangentList.size(), file);
-                    fwrite(mesh.normalList.data(), sizeof(Math::Float3), mesh.normalList.size(), file);
+                    fwrite(streamData.data(), 1, streamData.size(), file);
                 }
 
                 fclose(file);
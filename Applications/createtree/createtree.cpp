@@ -1,6 +1,7 @@
 #include "GEK/Math/Common.hpp"
 #include "GEK/Math/Matrix4x4.hpp"
 #include "GEK/Math/Vector3.hpp"
+#include "GEK/Physics/Format.hpp"
 #include "GEK/Shapes/AlignedBox.hpp"
 #include "GEK/Utility/Context.hpp"
 #include "GEK/Utility/FileSystem.hpp"
@@ -41,12 +42,19 @@ struct Header
 
     uint32_t identifier = *(uint32_t *)"GEKX";
     uint16_t type = 2;
-    uint16_t version = 3;
+    uint16_t version = 4;
 
     uint32_t materialCount = 0;
     uint32_t meshCount = 0;
 };
 
+template <typename DATA>
+void Append(std::vector<uint8_t> &buffer, DATA const *data, size_t count)
+{
+    auto rawData = reinterpret_cast<uint8_t const *>(data);
+    buffer.insert(std::end(buffer), rawData, (rawData + (sizeof(DATA) * count)));
+}
+
 struct Mesh
 {
     struct Face
@@ -79,6 +87,7 @@ struct Parameters
     std::string sourceName;
     std::string targetName;
     float feetPerUnit;
+    bool compress;
 };
 
 bool GetModels(Context *context, Parameters const &parameters, aiScene const *inputScene, aiNode const *inputNode, aiMatrix4x4 const &parentTransform, Model &model, std::function<std::string(const std::string &, const std::string &)> findMaterialForMesh)
@@ -209,6 +218,11 @@ int main(int argumentCount, char const *const argumentList[], char const *const
         .help("units per foot")
         .default_value(1.0f);
 
+    program.add_argument("-r", "--raw")
+        .help("store the data without compression")
+        .default_value(false)
+        .implicit_value(true);
+
     program.add_description("Convert input model in to GEK Engine format.");
     program.add_epilog("Input model formats include anything supported by the Assimp library.");
 
@@ -238,6 +252,7 @@ int main(int argumentCount, char const *const argumentList[], char const *const
     parameters.sourceName = program.get<std::string>("--input");
     parameters.targetName = program.get<std::string>("--output");
     parameters.feetPerUnit = (1.0f / program.get<float>("--unitsperfoot"));
+    parameters.compress = !program.get<bool>("--raw");
 
     auto pluginPath(FileSystem::GetModuleFilePath().getParentPath());
     auto cachePath(FileSystem::GetCacheFromModule());
@@ -450,15 +465,16 @@ int main(int argumentCount, char const *const argumentList[], char const *const
                 materialList.insert(mesh.material);
             }
 
+            std::vector<uint8_t> buffer;
             Header header;
             header.materialCount = materialList.size();
             header.meshCount = model.meshList.size();
-            FileSystem::Write(file, &header, 1);
+            Append(buffer, &header, 1);
             for (auto const &material : materialList)
             {
                 Header::Material materialHeader;
                 std::strncpy(materialHeader.name, material.data(), 63);
-                FileSystem::Write(file, &materialHeader, 1);
+                Append(buffer, &materialHeader, 1);
             }
 
             for (auto const &mesh : model.meshList)
@@ -473,11 +489,13 @@ int main(int argumentCount, char const *const argumentList[], char const *const
                 meshHeader.materialIndex = std::distance(std::begin(materialList), materialSearch);
                 meshHeader.faceCount = mesh.faceList.size();
                 meshHeader.pointCount = mesh.pointList.size();
-                FileSystem::Write(file, &meshHeader, 1);
-                FileSystem::Write(file, mesh.faceList.data(), meshHeader.faceCount);
-                FileSystem::Write(file, mesh.pointList.data(), meshHeader.pointCount);
+                Append(buffer, &meshHeader, 1);
+                Append(buffer, mesh.faceList.data(), meshHeader.faceCount);
+                Append(buffer, mesh.pointList.data(), meshHeader.pointCount);
             }
 
+            auto fileData = PhysicsFormat::EncodePayload(buffer, parameters.compress);
+            FileSystem::Write(file, fileData.data(), static_cast<uint32_t>(fileData.size()));
             file.close();
         }
         else
@@ -4,9 +4,12 @@
 #include "GEK/Utility/ContextUser.hpp"
 #include "GEK/Utility/FileSystem.hpp"
 #include "GEK/Utility/String.hpp"
+#include <string>
+#include <vector>
 
 #ifdef _WIN32
 #include <Windows.h>
+#include <shellapi.h>
 #include <cstdio>
 
 static void initializeConsoleOutput(void)
@@ -20,10 +23,91 @@ static void initializeConsoleOutput(void)
     freopen_s(&stream, "CONOUT$", "w", stdout);
     freopen_s(&stream, "CONOUT$", "w", stderr);
 }
+
+static std::vector<std::string> getArgumentList(void)
+{
+    std::vector<std::string> argumentList;
+    int argumentCount = 0;
+    if (auto wideArgumentList = CommandLineToArgvW(GetCommandLineW(), &argumentCount))
+    {
+        for (int argumentIndex = 1; argumentIndex < argumentCount; ++argumentIndex)
+        {
+            int size = WideCharToMultiByte(CP_UTF8, 0, wideArgumentList[argumentIndex], -1, nullptr, 0, nullptr, nullptr);
+            std::string argument((size > 0 ? (size - 1) : 0), '\0');
+            WideCharToMultiByte(CP_UTF8, 0, wideArgumentList[argumentIndex], -1, argument.data(), size, nullptr, nullptr);
+            argumentList.push_back(argument);
+        }
+
+        LocalFree(wideArgumentList);
+    }
+
+    return argumentList;
+}
 #endif
 
 using namespace Gek;
 
+// demo_engine --benchmark <scene> [--frames 1000] [--warmup 120] [--timestep 0.016667] [--output benchmark.json] [--device rendernull] [--trace trace.json]
+static Engine::Core::Benchmark parseBenchmark(std::vector<std::string> const &argumentList)
+{
+    Engine::Core::Benchmark benchmark;
+    for (size_t argumentIndex = 0; (argumentIndex + 1) < argumentList.size(); ++argumentIndex)
+    {
+        auto const &argument = argumentList[argumentIndex];
+        auto const &value = argumentList[argumentIndex + 1];
+        if (argument == "--benchmark")
+        {
+            benchmark.scene = value;
+        }
+        else if (argument == "--frames")
+        {
+            benchmark.frameCount = String::Convert(value, benchmark.frameCount);
+        }
+        else if (argument == "--warmup")
+        {
+            benchmark.warmupFrameCount = String::Convert(value, benchmark.warmupFrameCount);
+        }
+        else if (argument == "--timestep")
+        {
+            benchmark.timeStep = String::Convert(value, benchmark.timeStep);
+        }
+        else if (argument == "--output")
+        {
+            benchmark.outputPath = value;
+        }
+        else if (argument == "--device")
+        {
+            benchmark.device = value;
+        }
+        else if (argument == "--trace")
+        {
+            benchmark.tracePath = value;
+        }
+        else
+        {
+            continue;
+        }
+
+        ++argumentIndex;
+    }
+
+    if (benchmark.scene.empty())
+    {
+        benchmark.frameCount = 0;
+    }
+    else if (benchmark.frameCount == 0)
+    {
+        benchmark.frameCount = 1000;
+    }
+
+    if (benchmark.isEnabled() && benchmark.device.empty())
+    {
+        benchmark.device = "rendernull";
+    }
+
+    return benchmark;
+}
+
 #ifdef _WIN32
 int CALLBACK wWinMain(_In_ HINSTANCE instance, _In_opt_ HINSTANCE previousInstance, _In_ wchar_t *commandLine, _In_ int commandShow)
 #else
@@ -32,6 +116,9 @@ int main(int argumentCount, char const *const argumentList[])
 {
 #ifdef _WIN32
     initializeConsoleOutput();
+    auto benchmark = parseBenchmark(getArgumentList());
+#else
+    auto benchmark = parseBenchmark(std::vector<std::string>(argumentList + 1, argumentList + argumentCount));
 #endif
 
     auto binaryPath(FileSystem::GetModuleFilePath().getParentPath());
@@ -61,13 +148,23 @@ int main(int argumentCount, char const *const argumentList[])
     config["render"] = renderOptions;
     Gek::JSON::Save(config, configPath);
 
+    // Benchmarks run headless and leave the configured device alone
     std::vector<FileSystem::Path> pluginList;
-    pluginList.push_back(renderPluginPath / renderDevice);
-    pluginList.push_back(systemPluginPath / systemPluginName);
+    if (benchmark.isEnabled())
+    {
+        pluginList.push_back(renderPluginPath / benchmark.device);
+        pluginList.push_back(systemPluginPath / "systemnull");
+    }
+    else
+    {
+        pluginList.push_back(renderPluginPath / renderDevice);
+        pluginList.push_back(systemPluginPath / systemPluginName);
+    }
 
     ContextPtr context(Context::Create(&searchPathList, &pluginList));
     if (context)
     {
+        context->installCrashLogHandlers();
         context->setCachePath(cachePath);
 
         auto gekDataPath = std::getenv("gek_data_path");
@@ -79,7 +176,7 @@ int main(int argumentCount, char const *const argumentList[])
         context->addDataPath(rootPath / "data");
         context->addDataPath(rootPath.getString());
 
-        Plugin::CorePtr core = context->createClass<Plugin::Core>("Engine::Core");
+        Plugin::CorePtr core = context->createClass<Plugin::Core>("Engine::Core", benchmark);
     }
 
     return 0;
@@ -0,0 +1,104 @@
+#include "GEK/Utility/Archive.hpp"
+#include "GEK/Utility/Context.hpp"
+#include "GEK/Utility/FileSystem.hpp"
+#include "GEK/Utility/String.hpp"
+#include <sstream>
+#include <vector>
+
+#include <argparse/argparse.hpp>
+
+using namespace Gek;
+
+int main(int argumentCount, char const *const argumentList[])
+{
+    ContextPtr context(Context::Create(nullptr));
+
+    argparse::ArgumentParser program("GEK Data Packer", "1.0");
+
+    program.add_argument("-i", "--input")
+        .required()
+        .help("input data directory");
+
+    program.add_argument("-o", "--output")
+        .help("output archive, defaults to the input directory with the archive extension");
+
+    program.add_argument("-c", "--compress")
+        .help("compress files that get smaller")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("-a", "--alignment")
+        .scan<'u', uint32_t>()
+        .help("file data alignment, a power of two")
+        .default_value(Archive::DefaultAlignment);
+
+    program.add_description("Pack a data directory in to a GEK Engine archive.");
+    program.add_epilog("An archive next to a data directory with the same name is mounted in its place.");
+
+    try
+    {
+        std::vector<std::string> arguments;
+        for (int argumentIndex = 0; argumentIndex < argumentCount; argumentIndex++)
+        {
+            arguments.push_back(argumentList[argumentIndex]);
+        }
+
+        program.parse_args(arguments);
+    }
+    catch (const std::runtime_error &err)
+    {
+        if (context)
+        {
+            std::ostringstream usageStream;
+            usageStream << program;
+            context->log(Context::Error, "{}", err.what());
+            context->log(Context::Error, "{}", usageStream.str());
+        }
+        return 1;
+    }
+
+    FileSystem::Path inputPath(program.get<std::string>("--input"));
+    FileSystem::Path outputPath(inputPath.getString() + std::string(Archive::Extension));
+    if (auto output = program.present("--output"))
+    {
+        outputPath = output.value();
+    }
+
+    bool compress = program.get<bool>("--compress");
+    uint32_t alignment = program.get<uint32_t>("--alignment");
+
+    if (context)
+    {
+        context->log(Context::Info, "GEK Data Packer");
+        if (!inputPath.isDirectory())
+        {
+            context->log(Context::Error, "Input directory not found: {}", inputPath.getString());
+            return -__LINE__;
+        }
+
+        context->log(Context::Info, "Packing: {}", inputPath.getString());
+
+        size_t totalSize = 0;
+        Archive::Writer writer;
+        inputPath.findFiles([&](FileSystem::Path const &filePath) -> bool
+        {
+            auto relativePath = filePath.lexicallyRelative(inputPath);
+            auto data = FileSystem::Load(filePath);
+            totalSize += data.size();
+            writer.addFile(relativePath.data.generic_string(), std::move(data), compress);
+            return true;
+        }, true);
+
+        context->log(Context::Info, "Writing: {}", outputPath.getString());
+        if (!writer.save(outputPath, alignment))
+        {
+            context->log(Context::Error, "Unable to save archive: {}", outputPath.getString());
+            return -__LINE__;
+        }
+
+        context->log(Context::Info, "Num. Files: {}", writer.getFileCount());
+        context->log(Context::Info, "Size: {} bytes packed in to {} bytes", totalSize, outputPath.getFileSize());
+    }
+
+    return 0;
+}
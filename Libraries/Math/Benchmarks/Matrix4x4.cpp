@@ -0,0 +1,67 @@
+#include "GEK/Math/Matrix4x4.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+using namespace Gek::Math;
+
+namespace
+{
+    std::vector<Float4x4> MakeMatrixList(size_t count)
+    {
+        std::mt19937 generator(1234);
+        std::uniform_real_distribution<float> angleDistribution(-Pi, Pi);
+        std::uniform_real_distribution<float> positionDistribution(-100.0f, 100.0f);
+
+        std::vector<Float4x4> matrixList(count);
+        for (auto &matrix : matrixList)
+        {
+            Float3 position(positionDistribution(generator), positionDistribution(generator), positionDistribution(generator));
+            matrix = Float4x4::MakeEulerRotation(angleDistribution(generator), angleDistribution(generator), angleDistribution(generator), position);
+        }
+
+        return matrixList;
+    }
+}; // namespace
+
+static void Matrix4x4_Multiply(benchmark::State &state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    auto matrixList = MakeMatrixList(count);
+    auto viewMatrix(Float4x4::MakeEulerRotation(0.3f, 0.6f, 0.0f, Float3(5.0f, 2.0f, -10.0f)).getInverse());
+    std::vector<Float4x4> resultList(count);
+    for (auto _ : state)
+    {
+        for (size_t index = 0; index < count; ++index)
+        {
+            resultList[index] = (matrixList[index] * viewMatrix);
+        }
+
+        benchmark::DoNotOptimize(resultList.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void Matrix4x4_Inverse(benchmark::State &state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    auto matrixList = MakeMatrixList(count);
+    std::vector<Float4x4> resultList(count);
+    for (auto _ : state)
+    {
+        for (size_t index = 0; index < count; ++index)
+        {
+            resultList[index] = matrixList[index].getInverse();
+        }
+
+        benchmark::DoNotOptimize(resultList.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(Matrix4x4_Multiply)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+BENCHMARK(Matrix4x4_Inverse)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
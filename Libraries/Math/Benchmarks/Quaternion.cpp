@@ -0,0 +1,66 @@
+#include "GEK/Math/Matrix4x4.hpp"
+#include "GEK/Math/Quaternion.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+using namespace Gek::Math;
+
+namespace
+{
+    std::vector<Quaternion> MakeRotationList(size_t count)
+    {
+        std::mt19937 generator(4321);
+        std::uniform_real_distribution<float> angleDistribution(-Pi, Pi);
+
+        std::vector<Quaternion> rotationList(count);
+        for (auto &rotation : rotationList)
+        {
+            rotation = Quaternion::MakeEulerRotation(angleDistribution(generator), angleDistribution(generator), angleDistribution(generator));
+        }
+
+        return rotationList;
+    }
+}; // namespace
+
+static void Quaternion_MakeMatrix(benchmark::State &state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    auto rotationList = MakeRotationList(count);
+    std::vector<Float4x4> resultList(count);
+    for (auto _ : state)
+    {
+        for (size_t index = 0; index < count; ++index)
+        {
+            resultList[index] = Float4x4::MakeQuaternionRotation(rotationList[index], Float3(float(index), 0.0f, 0.0f));
+        }
+
+        benchmark::DoNotOptimize(resultList.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void Quaternion_Multiply(benchmark::State &state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    auto rotationList = MakeRotationList(count);
+    auto parentRotation(Quaternion::MakeEulerRotation(0.1f, 0.2f, 0.3f));
+    std::vector<Quaternion> resultList(count);
+    for (auto _ : state)
+    {
+        for (size_t index = 0; index < count; ++index)
+        {
+            resultList[index] = (rotationList[index] * parentRotation);
+        }
+
+        benchmark::DoNotOptimize(resultList.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(Quaternion_MakeMatrix)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+BENCHMARK(Quaternion_Multiply)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
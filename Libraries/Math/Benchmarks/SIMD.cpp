@@ -0,0 +1,154 @@
+#include "GEK/Math/SIMD.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Gek::Math;
+
+namespace
+{
+    using FloatList = std::vector<float>;
+    using VisibilityList = std::vector<uint8_t>;
+
+    Float4x4 GetViewMatrix(void)
+    {
+        return Float4x4::MakeEulerRotation(0.2f, 0.9f, 0.0f, Float3(10.0f, 5.0f, -20.0f)).getInverse();
+    }
+
+    Float4x4 GetProjectionMatrix(void)
+    {
+        return Float4x4::MakePerspective(DegreesToRadians(70.0f), 1.5f, 0.5f, 200.0f);
+    }
+
+    // Returns false after flagging the run when the processor can't run the requested kernels
+    bool SetInstructionSet(benchmark::State &state)
+    {
+        auto instructionSet = static_cast<SIMD::InstructionSet>(state.range(1));
+        if (static_cast<uint8_t>(instructionSet) > static_cast<uint8_t>(SIMD::GetSupportedInstructionSet()))
+        {
+            state.SkipWithError("Instruction set not supported");
+            return false;
+        }
+
+        SIMD::SetInstructionSet(instructionSet);
+        state.SetLabel(std::string(SIMD::GetInstructionSetName(instructionSet)));
+        return true;
+    }
+
+    // Objects are scattered around the camera so that a good part of them are culled
+    struct Scene
+    {
+        std::mt19937 generator;
+        std::uniform_real_distribution<float> positionDistribution;
+        std::uniform_real_distribution<float> sizeDistribution;
+
+        Scene(void)
+            : generator(1234)
+            , positionDistribution(-200.0f, 200.0f)
+            , sizeDistribution(0.1f, 5.0f)
+        {
+        }
+
+        Float3 getPosition(void)
+        {
+            return Float3(positionDistribution(generator), positionDistribution(generator), positionDistribution(generator));
+        }
+
+        float getSize(void)
+        {
+            return sizeDistribution(generator);
+        }
+    };
+}; // namespace
+
+static void SIMD_CullSpheres(benchmark::State &state)
+{
+    if (!SetInstructionSet(state))
+    {
+        return;
+    }
+
+    const auto count = SIMD::GetPaddedCount(static_cast<size_t>(state.range(0)));
+    FloatList xPositionList(count), yPositionList(count), zPositionList(count), radiusList(count);
+    VisibilityList visibilityList(count);
+
+    Scene scene;
+    for (size_t index = 0; index < count; ++index)
+    {
+        auto position(scene.getPosition());
+        xPositionList[index] = position.x;
+        yPositionList[index] = position.y;
+        zPositionList[index] = position.z;
+        radiusList[index] = scene.getSize();
+    }
+
+    // Axis aligned box around the middle of the scene, planes face inward
+    Float4 planeList[6] =
+    {
+        Float4(1.0f, 0.0f, 0.0f, 100.0f),
+        Float4(-1.0f, 0.0f, 0.0f, 100.0f),
+        Float4(0.0f, 1.0f, 0.0f, 100.0f),
+        Float4(0.0f, -1.0f, 0.0f, 100.0f),
+        Float4(0.0f, 0.0f, 1.0f, 100.0f),
+        Float4(0.0f, 0.0f, -1.0f, 100.0f),
+    };
+
+    auto frustum(SIMD::loadFrustum(planeList));
+    for (auto _ : state)
+    {
+        SIMD::cullSpheres(frustum, count, xPositionList, yPositionList, zPositionList, radiusList, visibilityList);
+        benchmark::DoNotOptimize(visibilityList.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+    SIMD::SetInstructionSet(SIMD::GetSupportedInstructionSet());
+}
+
+static void SIMD_CullOrientedBoundingBoxes(benchmark::State &state)
+{
+    if (!SetInstructionSet(state))
+    {
+        return;
+    }
+
+    const auto count = SIMD::GetPaddedCount(static_cast<size_t>(state.range(0)));
+    FloatList halfSizeXList(count), halfSizeYList(count), halfSizeZList(count);
+    FloatList transformList[16];
+    for (auto &elementList : transformList)
+    {
+        elementList.resize(count);
+    }
+
+    Scene scene;
+    for (size_t index = 0; index < count; ++index)
+    {
+        halfSizeXList[index] = scene.getSize();
+        halfSizeYList[index] = scene.getSize();
+        halfSizeZList[index] = scene.getSize();
+
+        auto matrix(Float4x4::MakeEulerRotation(scene.getSize(), scene.getSize(), 0.0f, scene.getPosition()));
+        for (size_t element = 0; element < 16; ++element)
+        {
+            transformList[element][index] = matrix.data[element];
+        }
+    }
+
+    VisibilityList visibilityList(count);
+    auto viewMatrix(GetViewMatrix());
+    auto projectionMatrix(GetProjectionMatrix());
+    for (auto _ : state)
+    {
+        SIMD::cullOrientedBoundingBoxes(viewMatrix, projectionMatrix, count, halfSizeXList, halfSizeYList, halfSizeZList, transformList, visibilityList);
+        benchmark::DoNotOptimize(visibilityList.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+    SIMD::SetInstructionSet(SIMD::GetSupportedInstructionSet());
+}
+
+// Second argument is the SIMD::InstructionSet, unsupported ones are reported as skipped
+BENCHMARK(SIMD_CullSpheres)->ArgsProduct({ benchmark::CreateRange(1 << 10, 1 << 20, 8), { 0, 1, 2 } })->ArgNames({ "count", "instructionSet" });
+BENCHMARK(SIMD_CullOrientedBoundingBoxes)->ArgsProduct({ benchmark::CreateRange(1 << 10, 1 << 20, 8), { 0, 1, 2 } })->ArgNames({ "count", "instructionSet" });
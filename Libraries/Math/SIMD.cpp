@@ -0,0 +1,222 @@
+#include "GEK/Math/SIMD.hpp"
+#include "SIMDKernels.hpp"
+#include <atomic>
+#include <emmintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace Gek
+{
+    namespace Math
+    {
+        namespace SIMD
+        {
+            namespace
+            {
+                struct Lanes
+                {
+                    using Register = __m128;
+                    using Mask = __m128;
+                    static constexpr size_t Width = SSE::Width;
+
+                    static Register Zero(void) { return _mm_setzero_ps(); }
+                    static Register Set(float value) { return _mm_set_ps1(value); }
+                    static Register Load(float const *data) { return _mm_loadu_ps(data); }
+                    static Register Add(Register left, Register right) { return _mm_add_ps(left, right); }
+                    static Register Subtract(Register left, Register right) { return _mm_sub_ps(left, right); }
+                    static Register Multiply(Register left, Register right) { return _mm_mul_ps(left, right); }
+                    static Register SquareRoot(Register value) { return _mm_sqrt_ps(value); }
+                    static Mask Less(Register left, Register right) { return _mm_cmplt_ps(left, right); }
+                    static Mask LessEqual(Register left, Register right) { return _mm_cmple_ps(left, right); }
+                    static Mask GreaterEqual(Register left, Register right) { return _mm_cmpge_ps(left, right); }
+                    static Mask And(Mask left, Mask right) { return _mm_and_ps(left, right); }
+                    static Mask Or(Mask left, Mask right) { return _mm_or_ps(left, right); }
+                    static Mask None(void) { return _mm_setzero_ps(); }
+                    static Mask All(void) { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+
+                    static void StoreVisibility(Mask isOutside, uint8_t *visibilityList)
+                    {
+                        auto outsideBits = _mm_movemask_ps(isOutside);
+                        for (size_t lane = 0; lane < Width; ++lane)
+                        {
+                            visibilityList[lane] = !((outsideBits >> lane) & 1);
+                        }
+                    }
+                };
+
+                InstructionSet DetectInstructionSet(void)
+                {
+#ifdef _MSC_VER
+                    int information[4];
+                    __cpuid(information, 0);
+                    const int highestFunction = information[0];
+
+                    // AVX state has to be enabled by the operating system as well as supported by the processor
+                    __cpuid(information, 1);
+                    const bool hasOSXSave = ((information[2] & (1 << 27)) != 0);
+                    const bool hasAVX = ((information[2] & (1 << 28)) != 0);
+                    if (!hasOSXSave || !hasAVX || highestFunction < 7)
+                    {
+                        return InstructionSet::SSE;
+                    }
+
+                    const auto enabledState = _xgetbv(0);
+                    if ((enabledState & 0x06) != 0x06)
+                    {
+                        return InstructionSet::SSE;
+                    }
+
+                    __cpuidex(information, 7, 0);
+                    const bool hasAVX2 = ((information[1] & (1 << 5)) != 0);
+                    const bool hasAVX512 = ((information[1] & (1 << 16)) != 0);
+                    if (hasAVX512 && ((enabledState & 0xE6) == 0xE6))
+                    {
+                        return InstructionSet::AVX512;
+                    }
+
+                    return (hasAVX2 ? InstructionSet::AVX2 : InstructionSet::SSE);
+#else
+                    __builtin_cpu_init();
+                    if (__builtin_cpu_supports("avx512f"))
+                    {
+                        return InstructionSet::AVX512;
+                    }
+                    else if (__builtin_cpu_supports("avx2"))
+                    {
+                        return InstructionSet::AVX2;
+                    }
+
+                    return InstructionSet::SSE;
+#endif
+                }
+
+                struct Dispatch
+                {
+                    InstructionSet instructionSet = InstructionSet::SSE;
+                    size_t width = SSE::Width;
+                    CullSpheresFunction cullSpheres = SSE::cullSpheres;
+                    CullOrientedBoundingBoxesFunction cullOrientedBoundingBoxes = SSE::cullOrientedBoundingBoxes;
+                    CullClustersFunction cullClusters = SSE::cullClusters;
+                };
+
+                Dispatch const &GetDispatch(InstructionSet instructionSet)
+                {
+                    static const Dispatch dispatchList[] =
+                    {
+                        { InstructionSet::SSE, SSE::Width, SSE::cullSpheres, SSE::cullOrientedBoundingBoxes, SSE::cullClusters },
+                        { InstructionSet::AVX2, AVX2::Width, AVX2::cullSpheres, AVX2::cullOrientedBoundingBoxes, AVX2::cullClusters },
+                        { InstructionSet::AVX512, AVX512::Width, AVX512::cullSpheres, AVX512::cullOrientedBoundingBoxes, AVX512::cullClusters },
+                    };
+
+                    return dispatchList[static_cast<size_t>(instructionSet)];
+                }
+
+                std::atomic<Dispatch const *> &GetCurrentDispatch(void)
+                {
+                    static std::atomic<Dispatch const *> currentDispatch = &GetDispatch(GetSupportedInstructionSet());
+                    return currentDispatch;
+                }
+            }; // namespace
+
+            namespace SSE
+            {
+                void cullSpheres(float const *planeList, size_t objectStart, size_t objectEnd, float const *shapeXPositionList, float const *shapeYPositionList, float const *shapeZPositionList, float const *shapeRadiusList, uint8_t *visibilityList)
+                {
+                    Kernels<Lanes>::cullSpheres(planeList, objectStart, objectEnd, shapeXPositionList, shapeYPositionList, shapeZPositionList, shapeRadiusList, visibilityList);
+                }
+
+                void cullOrientedBoundingBoxes(float const *viewProjectionMatrix, size_t objectStart, size_t objectEnd, float const *halfSizeXList, float const *halfSizeYList, float const *halfSizeZList, float const *const *transformList, uint8_t *visibilityList)
+                {
+                    Kernels<Lanes>::cullOrientedBoundingBoxes(viewProjectionMatrix, objectStart, objectEnd, halfSizeXList, halfSizeYList, halfSizeZList, transformList, visibilityList);
+                }
+
+                void cullClusters(float const *planeList, float const *viewPosition, size_t objectStart, size_t objectEnd, float const *const *clusterList, uint8_t *visibilityList)
+                {
+                    Kernels<Lanes>::cullClusters(planeList, viewPosition, objectStart, objectEnd, clusterList, visibilityList);
+                }
+            }; // namespace SSE
+
+            InstructionSet GetSupportedInstructionSet(void) noexcept
+            {
+                static const InstructionSet supportedInstructionSet = DetectInstructionSet();
+                return supportedInstructionSet;
+            }
+
+            InstructionSet GetInstructionSet(void) noexcept
+            {
+                return GetCurrentDispatch().load(std::memory_order_acquire)->instructionSet;
+            }
+
+            void SetInstructionSet(InstructionSet instructionSet) noexcept
+            {
+                auto supportedInstructionSet = GetSupportedInstructionSet();
+                if (static_cast<uint8_t>(instructionSet) > static_cast<uint8_t>(supportedInstructionSet))
+                {
+                    instructionSet = supportedInstructionSet;
+                }
+
+                GetCurrentDispatch().store(&GetDispatch(instructionSet), std::memory_order_release);
+            }
+
+            std::string_view GetInstructionSetName(InstructionSet instructionSet) noexcept
+            {
+                switch (instructionSet)
+                {
+                case InstructionSet::SSE:
+                    return "sse";
+
+                case InstructionSet::AVX2:
+                    return "avx2";
+
+                case InstructionSet::AVX512:
+                    return "avx512";
+
+                default:
+                    return "unknown";
+                };
+            }
+
+            static_assert(sizeof(Frustum) == (sizeof(float) * 24), "Frustum planes are passed to the kernels as one array");
+
+            // The widest kernel covers as much as it can, anything left over is a multiple of 4 and finishes on SSE
+            void cullSpheres(Frustum const &frustum, size_t objectCount, float const *shapeXPositionList, float const *shapeYPositionList, float const *shapeZPositionList, float const *shapeRadiusList, uint8_t *visibilityList) noexcept
+            {
+                auto const &dispatch = *GetCurrentDispatch().load(std::memory_order_acquire);
+                auto planeList = frustum.planeList[0].data;
+                const size_t wideCount = (objectCount - (objectCount % dispatch.width));
+                dispatch.cullSpheres(planeList, 0, wideCount, shapeXPositionList, shapeYPositionList, shapeZPositionList, shapeRadiusList, visibilityList);
+                if (wideCount < objectCount)
+                {
+                    SSE::cullSpheres(planeList, wideCount, objectCount, shapeXPositionList, shapeYPositionList, shapeZPositionList, shapeRadiusList, visibilityList);
+                }
+            }
+
+            void cullOrientedBoundingBoxes(Float4x4 const &viewMatrix, Float4x4 const &projectionMatrix, size_t objectCount, float const *halfSizeXList, float const *halfSizeYList, float const *halfSizeZList, float const *const transformList[16], uint8_t *visibilityList) noexcept
+            {
+                auto const &dispatch = *GetCurrentDispatch().load(std::memory_order_acquire);
+                const auto viewProjectionMatrix(viewMatrix * projectionMatrix);
+                const size_t wideCount = (objectCount - (objectCount % dispatch.width));
+                dispatch.cullOrientedBoundingBoxes(viewProjectionMatrix.data, 0, wideCount, halfSizeXList, halfSizeYList, halfSizeZList, transformList, visibilityList);
+                if (wideCount < objectCount)
+                {
+                    SSE::cullOrientedBoundingBoxes(viewProjectionMatrix.data, wideCount, objectCount, halfSizeXList, halfSizeYList, halfSizeZList, transformList, visibilityList);
+                }
+            }
+
+            void cullClusters(Frustum const &frustum, Float3 const &viewPosition, size_t objectCount, float const *const clusterList[8], uint8_t *visibilityList) noexcept
+            {
+                auto const &dispatch = *GetCurrentDispatch().load(std::memory_order_acquire);
+                auto planeList = frustum.planeList[0].data;
+                const size_t wideCount = (objectCount - (objectCount % dispatch.width));
+                dispatch.cullClusters(planeList, viewPosition.data, 0, wideCount, clusterList, visibilityList);
+                if (wideCount < objectCount)
+                {
+                    SSE::cullClusters(planeList, viewPosition.data, wideCount, objectCount, clusterList, visibilityList);
+                }
+            }
+        }; // namespace SIMD
+    }; // namespace Math
+}; // namespace Gek
@@ -0,0 +1,220 @@
+/// @file
+/// @author Todd Zupan <toddzupan@gmail.com>
+/// @version $Revision$
+/// @section LICENSE
+/// https://en.wikipedia.org/wiki/MIT_License
+/// @section DESCRIPTION
+/// Last Changed: $Date$
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Shared by the per instruction set translation units, which are compiled with different target flags.  Only
+// intrinsics and code from this header may be used in those units, any inline function that the linker could merge
+// with a baseline copy would leak the wider instructions into code that runs on every processor.
+namespace Gek
+{
+    namespace Math
+    {
+        namespace SIMD
+        {
+            // planeList holds the six frustum planes as 24 floats
+            using CullSpheresFunction = void (*)(float const *planeList, size_t objectStart, size_t objectEnd, float const *shapeXPositionList, float const *shapeYPositionList, float const *shapeZPositionList, float const *shapeRadiusList, uint8_t *visibilityList);
+
+            // viewProjectionMatrix holds the 16 floats of the combined view and projection matrix
+            using CullOrientedBoundingBoxesFunction = void (*)(float const *viewProjectionMatrix, size_t objectStart, size_t objectEnd, float const *halfSizeXList, float const *halfSizeYList, float const *halfSizeZList, float const *const *transformList, uint8_t *visibilityList);
+
+            // viewPosition holds 3 floats, clusterList the center, radius, cone axis and cone cutoff lists in that order
+            using CullClustersFunction = void (*)(float const *planeList, float const *viewPosition, size_t objectStart, size_t objectEnd, float const *const *clusterList, uint8_t *visibilityList);
+
+            namespace SSE
+            {
+                static constexpr size_t Width = 4;
+                void cullSpheres(float const *planeList, size_t objectStart, size_t objectEnd, float const *shapeXPositionList, float const *shapeYPositionList, float const *shapeZPositionList, float const *shapeRadiusList, uint8_t *visibilityList);
+                void cullOrientedBoundingBoxes(float const *viewProjectionMatrix, size_t objectStart, size_t objectEnd, float const *halfSizeXList, float const *halfSizeYList, float const *halfSizeZList, float const *const *transformList, uint8_t *visibilityList);
+                void cullClusters(float const *planeList, float const *viewPosition, size_t objectStart, size_t objectEnd, float const *const *clusterList, uint8_t *visibilityList);
+            }; // namespace SSE
+
+            namespace AVX2
+            {
+                static constexpr size_t Width = 8;
+                void cullSpheres(float const *planeList, size_t objectStart, size_t objectEnd, float const *shapeXPositionList, float const *shapeYPositionList, float const *shapeZPositionList, float const *shapeRadiusList, uint8_t *visibilityList);
+                void cullOrientedBoundingBoxes(float const *viewProjectionMatrix, size_t objectStart, size_t objectEnd, float const *halfSizeXList, float const *halfSizeYList, float const *halfSizeZList, float const *const *transformList, uint8_t *visibilityList);
+                void cullClusters(float const *planeList, float const *viewPosition, size_t objectStart, size_t objectEnd, float const *const *clusterList, uint8_t *visibilityList);
+            }; // namespace AVX2
+
+            namespace AVX512
+            {
+                static constexpr size_t Width = 16;
+                void cullSpheres(float const *planeList, size_t objectStart, size_t objectEnd, float const *shapeXPositionList, float const *shapeYPositionList, float const *shapeZPositionList, float const *shapeRadiusList, uint8_t *visibilityList);
+                void cullOrientedBoundingBoxes(float const *viewProjectionMatrix, size_t objectStart, size_t objectEnd, float const *halfSizeXList, float const *halfSizeYList, float const *halfSizeZList, float const *const *transformList, uint8_t *visibilityList);
+                void cullClusters(float const *planeList, float const *viewPosition, size_t objectStart, size_t objectEnd, float const *const *clusterList, uint8_t *visibilityList);
+            }; // namespace AVX512
+
+            // LANES provides the register type, a mask type and the handful of operations the kernels need
+            template <typename LANES>
+            struct Kernels
+            {
+                using Register = typename LANES::Register;
+                using Mask = typename LANES::Mask;
+
+                static void cullSpheres(float const *planeList, size_t objectStart, size_t objectEnd, float const *shapeXPositionList, float const *shapeYPositionList, float const *shapeZPositionList, float const *shapeRadiusList, uint8_t *visibilityList)
+                {
+                    Register planeRegisterList[24];
+                    for (size_t element = 0; element < 24; ++element)
+                    {
+                        planeRegisterList[element] = LANES::Set(planeList[element]);
+                    }
+
+                    const auto zero = LANES::Zero();
+                    for (size_t objectBase = objectStart; objectBase < objectEnd; objectBase += LANES::Width)
+                    {
+                        const auto shapeXPosition = LANES::Load(&shapeXPositionList[objectBase]);
+                        const auto shapeYPosition = LANES::Load(&shapeYPositionList[objectBase]);
+                        const auto shapeZPosition = LANES::Load(&shapeZPositionList[objectBase]);
+                        const auto negativeShapeRadius = LANES::Subtract(zero, LANES::Load(&shapeRadiusList[objectBase]));
+
+                        // Outside as soon as the sphere is entirely behind any one plane
+                        auto isOutside = LANES::None();
+                        for (size_t plane = 0; plane < 6; ++plane)
+                        {
+                            const auto *planeRegister = &planeRegisterList[plane * 4];
+                            auto planeDistance = LANES::Multiply(shapeXPosition, planeRegister[0]);
+                            planeDistance = LANES::Add(planeDistance, LANES::Multiply(shapeYPosition, planeRegister[1]));
+                            planeDistance = LANES::Add(planeDistance, LANES::Multiply(shapeZPosition, planeRegister[2]));
+                            planeDistance = LANES::Add(planeDistance, planeRegister[3]);
+                            isOutside = LANES::Or(isOutside, LANES::Less(planeDistance, negativeShapeRadius));
+                        }
+
+                        LANES::StoreVisibility(isOutside, &visibilityList[objectBase]);
+                    }
+                }
+
+                static void cullOrientedBoundingBoxes(float const *viewProjectionMatrix, size_t objectStart, size_t objectEnd, float const *halfSizeXList, float const *halfSizeYList, float const *halfSizeZList, float const *const *transformList, uint8_t *visibilityList)
+                {
+                    Register viewProjectionRegisterList[16];
+                    for (size_t element = 0; element < 16; ++element)
+                    {
+                        viewProjectionRegisterList[element] = LANES::Set(viewProjectionMatrix[element]);
+                    }
+
+                    const auto zero = LANES::Zero();
+                    for (size_t objectBase = objectStart; objectBase < objectEnd; objectBase += LANES::Width)
+                    {
+                        // Rows of world * viewProjection for each object, objects use row vectors
+                        Register worldViewProjection[16];
+                        for (size_t row = 0; row < 4; ++row)
+                        {
+                            const auto rowX = LANES::Load(&transformList[(row * 4) + 0][objectBase]);
+                            const auto rowY = LANES::Load(&transformList[(row * 4) + 1][objectBase]);
+                            const auto rowZ = LANES::Load(&transformList[(row * 4) + 2][objectBase]);
+                            const auto rowW = LANES::Load(&transformList[(row * 4) + 3][objectBase]);
+                            for (size_t column = 0; column < 4; ++column)
+                            {
+                                auto value = LANES::Multiply(rowX, viewProjectionRegisterList[column]);
+                                value = LANES::Add(value, LANES::Multiply(rowY, viewProjectionRegisterList[4 + column]));
+                                value = LANES::Add(value, LANES::Multiply(rowZ, viewProjectionRegisterList[8 + column]));
+                                value = LANES::Add(value, LANES::Multiply(rowW, viewProjectionRegisterList[12 + column]));
+                                worldViewProjection[(row * 4) + column] = value;
+                            }
+                        }
+
+                        // Corners are the projected center plus or minus each projected half axis
+                        const auto halfSizeX = LANES::Load(&halfSizeXList[objectBase]);
+                        const auto halfSizeY = LANES::Load(&halfSizeYList[objectBase]);
+                        const auto halfSizeZ = LANES::Load(&halfSizeZList[objectBase]);
+                        Register axisX[4], axisY[4], axisZ[4], center[4];
+                        for (size_t column = 0; column < 4; ++column)
+                        {
+                            axisX[column] = LANES::Multiply(halfSizeX, worldViewProjection[column]);
+                            axisY[column] = LANES::Multiply(halfSizeY, worldViewProjection[4 + column]);
+                            axisZ[column] = LANES::Multiply(halfSizeZ, worldViewProjection[8 + column]);
+                            center[column] = worldViewProjection[12 + column];
+                        }
+
+                        auto areAllXLess = LANES::All();
+                        auto areAllXGreater = LANES::All();
+                        auto areAllYLess = LANES::All();
+                        auto areAllYGreater = LANES::All();
+                        auto areAllZLess = LANES::All();
+                        auto areAllZGreater = LANES::All();
+                        for (uint32_t corner = 0; corner < 8; ++corner)
+                        {
+                            Register clip[4];
+                            for (size_t column = 0; column < 4; ++column)
+                            {
+                                auto value = ((corner & 1) ? LANES::Add(center[column], axisX[column]) : LANES::Subtract(center[column], axisX[column]));
+                                value = ((corner & 2) ? LANES::Add(value, axisY[column]) : LANES::Subtract(value, axisY[column]));
+                                clip[column] = ((corner & 4) ? LANES::Add(value, axisZ[column]) : LANES::Subtract(value, axisZ[column]));
+                            }
+
+                            const auto negativeW = LANES::Subtract(zero, clip[3]);
+                            areAllXLess = LANES::And(areAllXLess, LANES::LessEqual(clip[0], negativeW));
+                            areAllXGreater = LANES::And(areAllXGreater, LANES::GreaterEqual(clip[0], clip[3]));
+                            areAllYLess = LANES::And(areAllYLess, LANES::LessEqual(clip[1], negativeW));
+                            areAllYGreater = LANES::And(areAllYGreater, LANES::GreaterEqual(clip[1], clip[3]));
+                            areAllZLess = LANES::And(areAllZLess, LANES::LessEqual(clip[2], zero));
+                            areAllZGreater = LANES::And(areAllZGreater, LANES::GreaterEqual(clip[2], clip[3]));
+                        }
+
+                        // Outside when every corner is beyond the same clip plane
+                        auto isOutside = LANES::Or(areAllXLess, areAllXGreater);
+                        isOutside = LANES::Or(isOutside, LANES::Or(areAllYLess, areAllYGreater));
+                        isOutside = LANES::Or(isOutside, LANES::Or(areAllZLess, areAllZGreater));
+                        LANES::StoreVisibility(isOutside, &visibilityList[objectBase]);
+                    }
+                }
+
+                static void cullClusters(float const *planeList, float const *viewPosition, size_t objectStart, size_t objectEnd, float const *const *clusterList, uint8_t *visibilityList)
+                {
+                    Register planeRegisterList[24];
+                    for (size_t element = 0; element < 24; ++element)
+                    {
+                        planeRegisterList[element] = LANES::Set(planeList[element]);
+                    }
+
+                    const auto viewX = LANES::Set(viewPosition[0]);
+                    const auto viewY = LANES::Set(viewPosition[1]);
+                    const auto viewZ = LANES::Set(viewPosition[2]);
+                    const auto zero = LANES::Zero();
+                    for (size_t objectBase = objectStart; objectBase < objectEnd; objectBase += LANES::Width)
+                    {
+                        const auto centerX = LANES::Load(&clusterList[0][objectBase]);
+                        const auto centerY = LANES::Load(&clusterList[1][objectBase]);
+                        const auto centerZ = LANES::Load(&clusterList[2][objectBase]);
+                        const auto radius = LANES::Load(&clusterList[3][objectBase]);
+                        const auto negativeRadius = LANES::Subtract(zero, radius);
+
+                        // Zeroed padding has no radius, which is never the case for a cluster with any triangles
+                        auto isOutside = LANES::LessEqual(radius, zero);
+                        for (size_t plane = 0; plane < 6; ++plane)
+                        {
+                            const auto *planeRegister = &planeRegisterList[plane * 4];
+                            auto planeDistance = LANES::Multiply(centerX, planeRegister[0]);
+                            planeDistance = LANES::Add(planeDistance, LANES::Multiply(centerY, planeRegister[1]));
+                            planeDistance = LANES::Add(planeDistance, LANES::Multiply(centerZ, planeRegister[2]));
+                            planeDistance = LANES::Add(planeDistance, planeRegister[3]);
+                            isOutside = LANES::Or(isOutside, LANES::Less(planeDistance, negativeRadius));
+                        }
+
+                        // Every triangle faces away once the view lies inside the cone opposite the normals, pushed
+                        // back by the radius so that the test holds for the whole sphere
+                        const auto directionX = LANES::Subtract(centerX, viewX);
+                        const auto directionY = LANES::Subtract(centerY, viewY);
+                        const auto directionZ = LANES::Subtract(centerZ, viewZ);
+                        auto distance = LANES::Multiply(directionX, directionX);
+                        distance = LANES::Add(distance, LANES::Multiply(directionY, directionY));
+                        distance = LANES::SquareRoot(LANES::Add(distance, LANES::Multiply(directionZ, directionZ)));
+                        auto coneDistance = LANES::Multiply(directionX, LANES::Load(&clusterList[4][objectBase]));
+                        coneDistance = LANES::Add(coneDistance, LANES::Multiply(directionY, LANES::Load(&clusterList[5][objectBase])));
+                        coneDistance = LANES::Add(coneDistance, LANES::Multiply(directionZ, LANES::Load(&clusterList[6][objectBase])));
+                        const auto coneLimit = LANES::Add(LANES::Multiply(distance, LANES::Load(&clusterList[7][objectBase])), radius);
+                        isOutside = LANES::Or(isOutside, LANES::GreaterEqual(coneDistance, coneLimit));
+                        LANES::StoreVisibility(isOutside, &visibilityList[objectBase]);
+                    }
+                }
+            };
+        }; // namespace SIMD
+    }; // namespace Math
+}; // namespace Gek
@@ -0,0 +1,63 @@
+#include "SIMDKernels.hpp"
+#include <immintrin.h>
+
+// Compiled with AVX-512 code generation, see SIMDKernels.hpp before including anything else here
+namespace Gek
+{
+    namespace Math
+    {
+        namespace SIMD
+        {
+            namespace
+            {
+                struct Lanes
+                {
+                    using Register = __m512;
+                    using Mask = __mmask16;
+                    static constexpr size_t Width = AVX512::Width;
+
+                    static Register Zero(void) { return _mm512_setzero_ps(); }
+                    static Register Set(float value) { return _mm512_set1_ps(value); }
+                    static Register Load(float const *data) { return _mm512_loadu_ps(data); }
+                    static Register Add(Register left, Register right) { return _mm512_add_ps(left, right); }
+                    static Register Subtract(Register left, Register right) { return _mm512_sub_ps(left, right); }
+                    static Register Multiply(Register left, Register right) { return _mm512_mul_ps(left, right); }
+                    static Register SquareRoot(Register value) { return _mm512_sqrt_ps(value); }
+                    static Mask Less(Register left, Register right) { return _mm512_cmp_ps_mask(left, right, _CMP_LT_OS); }
+                    static Mask LessEqual(Register left, Register right) { return _mm512_cmp_ps_mask(left, right, _CMP_LE_OS); }
+                    static Mask GreaterEqual(Register left, Register right) { return _mm512_cmp_ps_mask(left, right, _CMP_GE_OS); }
+                    static Mask And(Mask left, Mask right) { return _mm512_kand(left, right); }
+                    static Mask Or(Mask left, Mask right) { return _mm512_kor(left, right); }
+                    static Mask None(void) { return 0; }
+                    static Mask All(void) { return 0xFFFF; }
+
+                    static void StoreVisibility(Mask isOutside, uint8_t *visibilityList)
+                    {
+                        for (size_t lane = 0; lane < Width; ++lane)
+                        {
+                            visibilityList[lane] = !((isOutside >> lane) & 1);
+                        }
+                    }
+                };
+            }; // namespace
+
+            namespace AVX512
+            {
+                void cullSpheres(float const *planeList, size_t objectStart, size_t objectEnd, float const *shapeXPositionList, float const *shapeYPositionList, float const *shapeZPositionList, float const *shapeRadiusList, uint8_t *visibilityList)
+                {
+                    Kernels<Lanes>::cullSpheres(planeList, objectStart, objectEnd, shapeXPositionList, shapeYPositionList, shapeZPositionList, shapeRadiusList, visibilityList);
+                }
+
+                void cullOrientedBoundingBoxes(float const *viewProjectionMatrix, size_t objectStart, size_t objectEnd, float const *halfSizeXList, float const *halfSizeYList, float const *halfSizeZList, float const *const *transformList, uint8_t *visibilityList)
+                {
+                    Kernels<Lanes>::cullOrientedBoundingBoxes(viewProjectionMatrix, objectStart, objectEnd, halfSizeXList, halfSizeYList, halfSizeZList, transformList, visibilityList);
+                }
+
+                void cullClusters(float const *planeList, float const *viewPosition, size_t objectStart, size_t objectEnd, float const *const *clusterList, uint8_t *visibilityList)
+                {
+                    Kernels<Lanes>::cullClusters(planeList, viewPosition, objectStart, objectEnd, clusterList, visibilityList);
+                }
+            }; // namespace AVX512
+        }; // namespace SIMD
+    }; // namespace Math
+}; // namespace Gek
@@ -0,0 +1,239 @@
+#include "GEK/Math/SIMD.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace Gek::Math;
+
+namespace
+{
+    struct BoxList
+    {
+        std::vector<float> halfSizeXList;
+        std::vector<float> halfSizeYList;
+        std::vector<float> halfSizeZList;
+        std::vector<float> transformList[16];
+
+        BoxList(size_t count)
+            : halfSizeXList(count, 0.0f)
+            , halfSizeYList(count, 0.0f)
+            , halfSizeZList(count, 0.0f)
+        {
+            for (auto &elementList : transformList)
+            {
+                elementList.resize(count, 0.0f);
+            }
+        }
+
+        void set(size_t index, Float3 const &halfSize, Float4x4 const &matrix)
+        {
+            halfSizeXList[index] = halfSize.x;
+            halfSizeYList[index] = halfSize.y;
+            halfSizeZList[index] = halfSize.z;
+            for (size_t element = 0; element < 16; ++element)
+            {
+                transformList[element][index] = matrix.data[element];
+            }
+        }
+
+        std::vector<uint8_t> cull(Float4x4 const &viewMatrix, Float4x4 const &projectionMatrix, size_t count) const
+        {
+            std::vector<uint8_t> visibilityList(halfSizeXList.size(), 2);
+            SIMD::cullOrientedBoundingBoxes(viewMatrix, projectionMatrix, count, halfSizeXList, halfSizeYList, halfSizeZList, transformList, visibilityList);
+            return visibilityList;
+        }
+    };
+
+    std::vector<SIMD::InstructionSet> GetInstructionSetList(void)
+    {
+        std::vector<SIMD::InstructionSet> instructionSetList;
+        for (auto instructionSet : { SIMD::InstructionSet::SSE, SIMD::InstructionSet::AVX2, SIMD::InstructionSet::AVX512 })
+        {
+            if (static_cast<uint8_t>(instructionSet) <= static_cast<uint8_t>(SIMD::GetSupportedInstructionSet()))
+            {
+                instructionSetList.push_back(instructionSet);
+            }
+        }
+
+        return instructionSetList;
+    }
+}; // namespace
+
+TEST(SIMD, GetPaddedCount)
+{
+    EXPECT_EQ(SIMD::GetPaddedCount(0), 0);
+    EXPECT_EQ(SIMD::GetPaddedCount(1), SIMD::LaneCount);
+    EXPECT_EQ(SIMD::GetPaddedCount(SIMD::LaneCount), SIMD::LaneCount);
+    EXPECT_EQ(SIMD::GetPaddedCount(SIMD::LaneCount + 1), SIMD::LaneCount * 2);
+}
+
+TEST(SIMD, SetInstructionSet)
+{
+    SIMD::SetInstructionSet(SIMD::InstructionSet::AVX512);
+    EXPECT_EQ(SIMD::GetInstructionSet(), SIMD::GetSupportedInstructionSet());
+    SIMD::SetInstructionSet(SIMD::InstructionSet::SSE);
+    EXPECT_EQ(SIMD::GetInstructionSet(), SIMD::InstructionSet::SSE);
+    SIMD::SetInstructionSet(SIMD::GetSupportedInstructionSet());
+}
+
+TEST(SIMD, CullOrientedBoundingBoxes)
+{
+    BoxList boxList(SIMD::LaneCount);
+    boxList.set(0, Float3::One, Float4x4::MakeTranslation(Float3(0.0f, 0.0f, 10.0f)));
+    boxList.set(1, Float3::One, Float4x4::MakeTranslation(Float3(0.0f, 0.0f, -10.0f)));
+    boxList.set(2, Float3::One, Float4x4::MakeTranslation(Float3(1000.0f, 0.0f, 10.0f)));
+    boxList.set(3, Float3::One, Float4x4::MakeTranslation(Float3(0.0f, 0.0f, 5.0f)));
+
+    auto projectionMatrix(Float4x4::MakePerspective(DegreesToRadians(90.0f), 1.0f, 0.1f, 100.0f));
+    for (auto instructionSet : GetInstructionSetList())
+    {
+        SIMD::SetInstructionSet(instructionSet);
+        auto visibilityList = boxList.cull(Float4x4::Identity, projectionMatrix, SIMD::LaneCount);
+        EXPECT_TRUE(visibilityList[0]) << SIMD::GetInstructionSetName(instructionSet);
+        EXPECT_FALSE(visibilityList[1]) << SIMD::GetInstructionSetName(instructionSet);
+        EXPECT_FALSE(visibilityList[2]) << SIMD::GetInstructionSetName(instructionSet);
+        EXPECT_TRUE(visibilityList[3]) << SIMD::GetInstructionSetName(instructionSet);
+
+        // Zeroed padding is always culled
+        for (size_t index = 4; index < SIMD::LaneCount; ++index)
+        {
+            EXPECT_FALSE(visibilityList[index]) << SIMD::GetInstructionSetName(instructionSet);
+        }
+    }
+
+    SIMD::SetInstructionSet(SIMD::GetSupportedInstructionSet());
+}
+
+TEST(SIMD, CullOrientedBoundingBoxesMatchAcrossInstructionSets)
+{
+    // 4 past the padded size so that the SSE kernel has to finish the remainder for the wider sets
+    static constexpr size_t BoxCount = (SIMD::LaneCount * 8) + 4;
+    std::mt19937 generator(1234);
+    std::uniform_real_distribution<float> positionDistribution(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> sizeDistribution(0.1f, 4.0f);
+    std::uniform_real_distribution<float> angleDistribution(-Pi, Pi);
+
+    BoxList boxList(BoxCount);
+    for (size_t index = 0; index < BoxCount; ++index)
+    {
+        auto rotation(Quaternion::MakeEulerRotation(angleDistribution(generator), angleDistribution(generator), angleDistribution(generator)));
+        auto matrix(Float4x4::MakeQuaternionRotation(rotation, Float3(positionDistribution(generator), positionDistribution(generator), positionDistribution(generator))));
+        boxList.set(index, Float3(sizeDistribution(generator), sizeDistribution(generator), sizeDistribution(generator)), matrix);
+    }
+
+    auto viewMatrix(Float4x4::MakeQuaternionRotation(Quaternion::MakeEulerRotation(0.3f, 0.7f, 0.0f), Float3(2.0f, 1.0f, -5.0f)).getInverse());
+    auto projectionMatrix(Float4x4::MakePerspective(DegreesToRadians(75.0f), 1.5f, 0.5f, 50.0f));
+
+    SIMD::SetInstructionSet(SIMD::InstructionSet::SSE);
+    auto expectedList = boxList.cull(viewMatrix, projectionMatrix, BoxCount);
+    for (auto instructionSet : GetInstructionSetList())
+    {
+        SIMD::SetInstructionSet(instructionSet);
+        EXPECT_EQ(boxList.cull(viewMatrix, projectionMatrix, BoxCount), expectedList) << SIMD::GetInstructionSetName(instructionSet);
+    }
+
+    SIMD::SetInstructionSet(SIMD::GetSupportedInstructionSet());
+}
+
+TEST(SIMD, CullSpheres)
+{
+    // Axis aligned box from -10 to 10 on every axis, planes face inward
+    Float4 planeList[6] =
+    {
+        Float4(1.0f, 0.0f, 0.0f, 10.0f),
+        Float4(-1.0f, 0.0f, 0.0f, 10.0f),
+        Float4(0.0f, 1.0f, 0.0f, 10.0f),
+        Float4(0.0f, -1.0f, 0.0f, 10.0f),
+        Float4(0.0f, 0.0f, 1.0f, 10.0f),
+        Float4(0.0f, 0.0f, -1.0f, 10.0f),
+    };
+
+    auto frustum(SIMD::loadFrustum(planeList));
+    std::vector<float> xList(SIMD::LaneCount + 4, 0.0f), yList(SIMD::LaneCount + 4, 0.0f), zList(SIMD::LaneCount + 4, 0.0f), radiusList(SIMD::LaneCount + 4, 1.0f);
+    for (size_t index = 0; index < xList.size(); ++index)
+    {
+        xList[index] = ((index % 2) ? 20.0f : 0.0f);
+        radiusList[index] = ((index % 4) == 3 ? 15.0f : 1.0f);
+    }
+
+    for (auto instructionSet : GetInstructionSetList())
+    {
+        SIMD::SetInstructionSet(instructionSet);
+        std::vector<uint8_t> visibilityList(xList.size(), 2);
+        SIMD::cullSpheres(frustum, xList.size(), xList, yList, zList, radiusList, visibilityList);
+        for (size_t index = 0; index < xList.size(); ++index)
+        {
+            bool expected = (!(index % 2) || ((index % 4) == 3));
+            EXPECT_EQ(visibilityList[index], expected ? 1 : 0) << SIMD::GetInstructionSetName(instructionSet) << " " << index;
+        }
+    }
+
+    SIMD::SetInstructionSet(SIMD::GetSupportedInstructionSet());
+}
+
+TEST(SIMD, CullClusters)
+{
+    Float4 planeList[6] =
+    {
+        Float4(1.0f, 0.0f, 0.0f, 10.0f),
+        Float4(-1.0f, 0.0f, 0.0f, 10.0f),
+        Float4(0.0f, 1.0f, 0.0f, 10.0f),
+        Float4(0.0f, -1.0f, 0.0f, 10.0f),
+        Float4(0.0f, 0.0f, 1.0f, 10.0f),
+        Float4(0.0f, 0.0f, -1.0f, 10.0f),
+    };
+
+    // Centered, outside, facing away, facing the view, spread too wide to cull and zeroed padding
+    struct Cluster
+    {
+        Float3 center;
+        float radius;
+        Float3 coneAxis;
+        float coneCutoff;
+        bool visible;
+    };
+
+    const Cluster testList[] =
+    {
+        { Float3(0.0f, 0.0f, 0.0f), 1.0f, Float3::Zero, 1.0f, true },
+        { Float3(20.0f, 0.0f, 0.0f), 1.0f, Float3::Zero, 1.0f, false },
+        { Float3(0.0f, 0.0f, 5.0f), 1.0f, Float3(0.0f, 0.0f, 1.0f), 0.0f, false },
+        { Float3(0.0f, 0.0f, 5.0f), 1.0f, Float3(0.0f, 0.0f, -1.0f), 0.0f, true },
+        { Float3(0.0f, 0.0f, 5.0f), 1.0f, Float3(0.0f, 0.0f, 1.0f), 0.99f, true },
+        { Float3::Zero, 0.0f, Float3::Zero, 0.0f, false },
+    };
+
+    const size_t clusterCount = (SIMD::LaneCount + 4);
+    std::vector<float> clusterList[8];
+    for (auto &elementList : clusterList)
+    {
+        elementList.resize(clusterCount);
+    }
+
+    for (size_t index = 0; index < clusterCount; ++index)
+    {
+        auto const &cluster = testList[index % std::size(testList)];
+        clusterList[0][index] = cluster.center.x;
+        clusterList[1][index] = cluster.center.y;
+        clusterList[2][index] = cluster.center.z;
+        clusterList[3][index] = cluster.radius;
+        clusterList[4][index] = cluster.coneAxis.x;
+        clusterList[5][index] = cluster.coneAxis.y;
+        clusterList[6][index] = cluster.coneAxis.z;
+        clusterList[7][index] = cluster.coneCutoff;
+    }
+
+    auto frustum(SIMD::loadFrustum(planeList));
+    for (auto instructionSet : GetInstructionSetList())
+    {
+        SIMD::SetInstructionSet(instructionSet);
+        std::vector<uint8_t> visibilityList(clusterCount, 2);
+        SIMD::cullClusters(frustum, Float3(0.0f, 0.0f, -5.0f), clusterCount, clusterList, visibilityList);
+        for (size_t index = 0; index < clusterCount; ++index)
+        {
+            EXPECT_EQ(visibilityList[index], testList[index % std::size(testList)].visible ? 1 : 0) << SIMD::GetInstructionSetName(instructionSet) << " " << index;
+        }
+    }
+
+    SIMD::SetInstructionSet(SIMD::GetSupportedInstructionSet());
+}
@@ -40,6 +40,18 @@ namespace Gek
             maximum = maximum.getMaximum(point);
         }
 
+        void AlignedBox::extend(AlignedBox const &box) noexcept
+        {
+            minimum = minimum.getMinimum(box.minimum);
+            maximum = maximum.getMaximum(box.maximum);
+        }
+
+        bool AlignedBox::contains(AlignedBox const &box) const noexcept
+        {
+            return (minimum.x <= box.minimum.x && minimum.y <= box.minimum.y && minimum.z <= box.minimum.z &&
+                    maximum.x >= box.maximum.x && maximum.y >= box.maximum.y && maximum.z >= box.maximum.z);
+        }
+
         Math::Float3 AlignedBox::getSize(void) const noexcept
         {
             return (maximum - minimum);
@@ -54,5 +66,11 @@ namespace Gek
         {
             return (minimum + getHalfSize());
         }
+
+        float AlignedBox::getSurfaceArea(void) const noexcept
+        {
+            auto size(getSize());
+            return (2.0f * ((size.x * size.y) + (size.y * size.z) + (size.z * size.x)));
+        }
     }; // namespace Shapes
 }; // namespace Gek
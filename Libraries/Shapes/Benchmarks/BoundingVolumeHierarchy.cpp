@@ -0,0 +1,105 @@
+#include "GEK/Shapes/BoundingVolumeHierarchy.hpp"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Gek::Math;
+
+namespace
+{
+    // Spread grows with the count so the density, and the fraction inside the frustum, stays about the same
+    std::vector<Gek::Shapes::AlignedBox> MakeBoxList(size_t count)
+    {
+        const float extent = (std::cbrt(float(count)) * 10.0f);
+        std::mt19937 generator(1234);
+        std::uniform_real_distribution<float> positionDistribution(-extent, extent);
+        std::uniform_real_distribution<float> sizeDistribution(0.1f, 5.0f);
+
+        std::vector<Gek::Shapes::AlignedBox> boxList(count);
+        for (auto &box : boxList)
+        {
+            Float3 position(positionDistribution(generator), positionDistribution(generator), positionDistribution(generator));
+            Float3 halfSize(sizeDistribution(generator), sizeDistribution(generator), sizeDistribution(generator));
+            box = Gek::Shapes::AlignedBox((position - halfSize), (position + halfSize));
+        }
+
+        return boxList;
+    }
+
+    Gek::Shapes::Frustum MakeFrustum(size_t count)
+    {
+        const float extent = (std::cbrt(float(count)) * 10.0f);
+        auto viewMatrix(Float4x4::MakeEulerRotation(0.2f, 0.9f, 0.0f).getInverse());
+        auto projectionMatrix(Float4x4::MakePerspective(DegreesToRadians(70.0f), 1.5f, 0.5f, extent));
+        return Gek::Shapes::Frustum(viewMatrix * projectionMatrix);
+    }
+}; // namespace
+
+static void BoundingVolumeHierarchy_Insert(benchmark::State &state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    auto boxList = MakeBoxList(count);
+    for (auto _ : state)
+    {
+        Gek::Shapes::BoundingVolumeHierarchy tree;
+        for (size_t index = 0; index < count; ++index)
+        {
+            tree.createProxy(boxList[index], index);
+        }
+
+        benchmark::DoNotOptimize(tree.getHeight());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BoundingVolumeHierarchy_Rebuild(benchmark::State &state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    auto boxList = MakeBoxList(count);
+    Gek::Shapes::BoundingVolumeHierarchy tree;
+    for (size_t index = 0; index < count; ++index)
+    {
+        tree.createProxy(boxList[index], index);
+    }
+
+    for (auto _ : state)
+    {
+        tree.rebuild();
+        benchmark::DoNotOptimize(tree.getHeight());
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void BoundingVolumeHierarchy_FrustumQuery(benchmark::State &state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    auto boxList = MakeBoxList(count);
+    Gek::Shapes::BoundingVolumeHierarchy tree;
+    for (size_t index = 0; index < count; ++index)
+    {
+        tree.createProxy(boxList[index], index);
+    }
+
+    auto frustum(MakeFrustum(count));
+    size_t visibleCount = 0;
+    for (auto _ : state)
+    {
+        visibleCount = 0;
+        tree.query(frustum, [&](uint64_t userData, bool isInside) -> void
+        {
+            ++visibleCount;
+        });
+
+        benchmark::DoNotOptimize(visibleCount);
+    }
+
+    state.counters["visible"] = static_cast<double>(visibleCount);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BoundingVolumeHierarchy_Insert)->RangeMultiplier(8)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BoundingVolumeHierarchy_Rebuild)->RangeMultiplier(8)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BoundingVolumeHierarchy_FrustumQuery)->RangeMultiplier(8)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMicrosecond);
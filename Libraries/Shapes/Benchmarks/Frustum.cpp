@@ -0,0 +1,83 @@
+#include "GEK/Shapes/Frustum.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+using namespace Gek::Math;
+
+namespace
+{
+    std::vector<Float4x4> MakeViewProjectionList(size_t count)
+    {
+        std::mt19937 generator(1234);
+        std::uniform_real_distribution<float> angleDistribution(-Pi, Pi);
+        auto projectionMatrix(Float4x4::MakePerspective(DegreesToRadians(70.0f), 1.5f, 0.5f, 200.0f));
+
+        std::vector<Float4x4> matrixList(count);
+        for (auto &matrix : matrixList)
+        {
+            matrix = (Float4x4::MakeEulerRotation(angleDistribution(generator), angleDistribution(generator), 0.0f).getInverse() * projectionMatrix);
+        }
+
+        return matrixList;
+    }
+
+    std::vector<Gek::Shapes::AlignedBox> MakeBoxList(size_t count)
+    {
+        std::mt19937 generator(4321);
+        std::uniform_real_distribution<float> positionDistribution(-200.0f, 200.0f);
+        std::uniform_real_distribution<float> sizeDistribution(0.1f, 5.0f);
+
+        std::vector<Gek::Shapes::AlignedBox> boxList(count);
+        for (auto &box : boxList)
+        {
+            Float3 position(positionDistribution(generator), positionDistribution(generator), positionDistribution(generator));
+            Float3 halfSize(sizeDistribution(generator), sizeDistribution(generator), sizeDistribution(generator));
+            box = Gek::Shapes::AlignedBox((position - halfSize), (position + halfSize));
+        }
+
+        return boxList;
+    }
+}; // namespace
+
+static void Frustum_Create(benchmark::State &state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    auto matrixList = MakeViewProjectionList(count);
+    std::vector<Gek::Shapes::Frustum> frustumList(count);
+    for (auto _ : state)
+    {
+        for (size_t index = 0; index < count; ++index)
+        {
+            frustumList[index].create(matrixList[index]);
+        }
+
+        benchmark::DoNotOptimize(frustumList.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void Frustum_GetContainment(benchmark::State &state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    auto boxList = MakeBoxList(count);
+    Gek::Shapes::Frustum frustum(MakeViewProjectionList(1).front());
+    std::vector<Gek::Shapes::Frustum::Containment> containmentList(count);
+    for (auto _ : state)
+    {
+        for (size_t index = 0; index < count; ++index)
+        {
+            containmentList[index] = frustum.getContainment(boxList[index]);
+        }
+
+        benchmark::DoNotOptimize(containmentList.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(Frustum_Create)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+BENCHMARK(Frustum_GetContainment)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
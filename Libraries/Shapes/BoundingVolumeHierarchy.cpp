@@ -0,0 +1,379 @@
+#include "GEK/Shapes/BoundingVolumeHierarchy.hpp"
+#include <algorithm>
+
+namespace Gek
+{
+    namespace Shapes
+    {
+        namespace
+        {
+            AlignedBox Merge(AlignedBox const &left, AlignedBox const &right) noexcept
+            {
+                AlignedBox box(left);
+                box.extend(right);
+                return box;
+            }
+
+            AlignedBox Grow(AlignedBox const &box, float amount) noexcept
+            {
+                return AlignedBox(box.minimum - amount, box.maximum + amount);
+            }
+        }; // namespace
+
+        BoundingVolumeHierarchy::BoundingVolumeHierarchy(float margin) noexcept
+            : margin(margin)
+        {
+        }
+
+        void BoundingVolumeHierarchy::clear(void) noexcept
+        {
+            nodeList.clear();
+            rootNode = InvalidProxy;
+            freeNode = InvalidProxy;
+            proxyCount = 0;
+        }
+
+        uint32_t BoundingVolumeHierarchy::createProxy(AlignedBox const &box, uint64_t userData)
+        {
+            auto proxy = allocateNode();
+            auto &node = nodeList[proxy];
+            node.box = Grow(box, margin);
+            node.userData = userData;
+            insertLeaf(proxy);
+            ++proxyCount;
+            return proxy;
+        }
+
+        void BoundingVolumeHierarchy::destroyProxy(uint32_t proxy) noexcept
+        {
+            removeLeaf(proxy);
+            releaseNode(proxy);
+            --proxyCount;
+        }
+
+        bool BoundingVolumeHierarchy::moveProxy(uint32_t proxy, AlignedBox const &box)
+        {
+            // Also reinsert once the box has shrunk well inside its old bounds, or the tree slowly loosens
+            auto &node = nodeList[proxy];
+            auto fatBox(Grow(box, margin));
+            if (node.box.contains(box) && Grow(fatBox, (margin * 4.0f)).contains(node.box))
+            {
+                return false;
+            }
+
+            removeLeaf(proxy);
+            nodeList[proxy].box = fatBox;
+            insertLeaf(proxy);
+            return true;
+        }
+
+        void BoundingVolumeHierarchy::rebuild(void)
+        {
+            std::vector<uint32_t> leafList;
+            leafList.reserve(proxyCount);
+            for (uint32_t nodeIndex = 0; nodeIndex < nodeList.size(); ++nodeIndex)
+            {
+                auto &node = nodeList[nodeIndex];
+                if (node.height < 0)
+                {
+                    continue;
+                }
+                else if (node.isLeaf())
+                {
+                    node.parent = InvalidProxy;
+                    leafList.push_back(nodeIndex);
+                }
+                else
+                {
+                    releaseNode(nodeIndex);
+                }
+            }
+
+            rootNode = (leafList.empty() ? InvalidProxy : build(leafList, 0, leafList.size()));
+            if (rootNode != InvalidProxy)
+            {
+                nodeList[rootNode].parent = InvalidProxy;
+            }
+        }
+
+        bool BoundingVolumeHierarchy::validate(void) const noexcept
+        {
+            if (rootNode == InvalidProxy)
+            {
+                return (proxyCount == 0);
+            }
+
+            if (nodeList[rootNode].parent != InvalidProxy)
+            {
+                return false;
+            }
+
+            uint32_t leafCount = 0;
+            std::vector<uint32_t> stack = { rootNode };
+            while (!stack.empty())
+            {
+                auto nodeIndex = stack.back();
+                stack.pop_back();
+
+                auto const &node = nodeList[nodeIndex];
+                if (node.isLeaf())
+                {
+                    if (node.height != 0)
+                    {
+                        return false;
+                    }
+
+                    ++leafCount;
+                    continue;
+                }
+
+                auto const &left = nodeList[node.left];
+                auto const &right = nodeList[node.right];
+                if (left.parent != nodeIndex || right.parent != nodeIndex ||
+                    node.height != (1 + std::max(left.height, right.height)) ||
+                    !node.box.contains(left.box) || !node.box.contains(right.box))
+                {
+                    return false;
+                }
+
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+
+            return (leafCount == proxyCount);
+        }
+
+        uint32_t BoundingVolumeHierarchy::allocateNode(void)
+        {
+            uint32_t nodeIndex = freeNode;
+            if (nodeIndex == InvalidProxy)
+            {
+                nodeIndex = static_cast<uint32_t>(nodeList.size());
+                nodeList.emplace_back();
+            }
+            else
+            {
+                freeNode = nodeList[nodeIndex].left;
+            }
+
+            auto &node = nodeList[nodeIndex];
+            node = Node();
+            node.height = 0;
+            return nodeIndex;
+        }
+
+        void BoundingVolumeHierarchy::releaseNode(uint32_t nodeIndex) noexcept
+        {
+            auto &node = nodeList[nodeIndex];
+            node.left = freeNode;
+            node.height = -1;
+            freeNode = nodeIndex;
+        }
+
+        // Walks down to the sibling that adds the least surface area to the tree, including what the ancestors grow by
+        void BoundingVolumeHierarchy::insertLeaf(uint32_t leaf)
+        {
+            if (rootNode == InvalidProxy)
+            {
+                rootNode = leaf;
+                nodeList[leaf].parent = InvalidProxy;
+                return;
+            }
+
+            const auto leafBox(nodeList[leaf].box);
+            uint32_t sibling = rootNode;
+            while (!nodeList[sibling].isLeaf())
+            {
+                auto const &node = nodeList[sibling];
+                const float area = node.box.getSurfaceArea();
+                const float combinedArea = Merge(node.box, leafBox).getSurfaceArea();
+
+                const float cost = (2.0f * combinedArea);
+                const float inheritanceCost = (2.0f * (combinedArea - area));
+                auto getDescentCost = [&](uint32_t childIndex) -> float
+                {
+                    auto const &child = nodeList[childIndex];
+                    const float childArea = Merge(child.box, leafBox).getSurfaceArea();
+                    return (inheritanceCost + (child.isLeaf() ? childArea : (childArea - child.box.getSurfaceArea())));
+                };
+
+                const float leftCost = getDescentCost(node.left);
+                const float rightCost = getDescentCost(node.right);
+                if (cost < leftCost && cost < rightCost)
+                {
+                    break;
+                }
+
+                sibling = (leftCost < rightCost ? node.left : node.right);
+            }
+
+            const uint32_t oldParent = nodeList[sibling].parent;
+            const uint32_t newParent = allocateNode();
+            auto &parentNode = nodeList[newParent];
+            parentNode.parent = oldParent;
+            parentNode.box = Merge(leafBox, nodeList[sibling].box);
+            parentNode.height = (nodeList[sibling].height + 1);
+            parentNode.left = sibling;
+            parentNode.right = leaf;
+            nodeList[sibling].parent = newParent;
+            nodeList[leaf].parent = newParent;
+            if (oldParent == InvalidProxy)
+            {
+                rootNode = newParent;
+            }
+            else if (nodeList[oldParent].left == sibling)
+            {
+                nodeList[oldParent].left = newParent;
+            }
+            else
+            {
+                nodeList[oldParent].right = newParent;
+            }
+
+            updateAncestors(newParent);
+        }
+
+        void BoundingVolumeHierarchy::removeLeaf(uint32_t leaf) noexcept
+        {
+            if (leaf == rootNode)
+            {
+                rootNode = InvalidProxy;
+                return;
+            }
+
+            const uint32_t parent = nodeList[leaf].parent;
+            const uint32_t grandParent = nodeList[parent].parent;
+            const uint32_t sibling = (nodeList[parent].left == leaf ? nodeList[parent].right : nodeList[parent].left);
+            releaseNode(parent);
+            nodeList[leaf].parent = InvalidProxy;
+            if (grandParent == InvalidProxy)
+            {
+                rootNode = sibling;
+                nodeList[sibling].parent = InvalidProxy;
+                return;
+            }
+
+            if (nodeList[grandParent].left == parent)
+            {
+                nodeList[grandParent].left = sibling;
+            }
+            else
+            {
+                nodeList[grandParent].right = sibling;
+            }
+
+            nodeList[sibling].parent = grandParent;
+            updateAncestors(grandParent);
+        }
+
+        void BoundingVolumeHierarchy::updateAncestors(uint32_t nodeIndex) noexcept
+        {
+            while (nodeIndex != InvalidProxy)
+            {
+                nodeIndex = balance(nodeIndex);
+
+                auto &node = nodeList[nodeIndex];
+                auto const &left = nodeList[node.left];
+                auto const &right = nodeList[node.right];
+                node.height = (1 + std::max(left.height, right.height));
+                node.box = Merge(left.box, right.box);
+                nodeIndex = node.parent;
+            }
+        }
+
+        // Rotates the taller grandchild up whenever the children heights differ by more than one
+        uint32_t BoundingVolumeHierarchy::balance(uint32_t nodeIndex) noexcept
+        {
+            auto &node = nodeList[nodeIndex];
+            if (node.isLeaf() || node.height < 2)
+            {
+                return nodeIndex;
+            }
+
+            auto rotate = [&](uint32_t pivotIndex, uint32_t keptIndex, bool pivotIsRight) -> uint32_t
+            {
+                auto &pivot = nodeList[pivotIndex];
+                const uint32_t first = pivot.left;
+                const uint32_t second = pivot.right;
+
+                pivot.left = nodeIndex;
+                pivot.parent = node.parent;
+                node.parent = pivotIndex;
+                if (pivot.parent == InvalidProxy)
+                {
+                    rootNode = pivotIndex;
+                }
+                else if (nodeList[pivot.parent].left == nodeIndex)
+                {
+                    nodeList[pivot.parent].left = pivotIndex;
+                }
+                else
+                {
+                    nodeList[pivot.parent].right = pivotIndex;
+                }
+
+                // The taller grandchild stays with the pivot, the other one replaces the pivot under the node
+                const bool keepFirst = (nodeList[first].height > nodeList[second].height);
+                const uint32_t stay = (keepFirst ? first : second);
+                const uint32_t move = (keepFirst ? second : first);
+                pivot.right = stay;
+                (pivotIsRight ? node.right : node.left) = move;
+                nodeList[move].parent = nodeIndex;
+
+                auto const &kept = nodeList[keptIndex];
+                node.box = Merge(kept.box, nodeList[move].box);
+                node.height = (1 + std::max(kept.height, nodeList[move].height));
+                pivot.box = Merge(node.box, nodeList[stay].box);
+                pivot.height = (1 + std::max(node.height, nodeList[stay].height));
+                return pivotIndex;
+            };
+
+            const uint32_t left = node.left;
+            const uint32_t right = node.right;
+            const int32_t difference = (nodeList[right].height - nodeList[left].height);
+            if (difference > 1)
+            {
+                return rotate(right, left, true);
+            }
+            else if (difference < -1)
+            {
+                return rotate(left, right, false);
+            }
+
+            return nodeIndex;
+        }
+
+        // Median split along the longest axis of the leaf centers
+        uint32_t BoundingVolumeHierarchy::build(std::vector<uint32_t> &leafList, size_t start, size_t end)
+        {
+            if ((end - start) == 1)
+            {
+                return leafList[start];
+            }
+
+            AlignedBox centerBox;
+            for (size_t index = start; index < end; ++index)
+            {
+                centerBox.extend(nodeList[leafList[index]].box.getCenter());
+            }
+
+            const auto size(centerBox.getSize());
+            const size_t axis = (size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2));
+            const size_t middle = (start + ((end - start) / 2));
+            std::nth_element(std::begin(leafList) + start, std::begin(leafList) + middle, std::begin(leafList) + end, [&](uint32_t leftIndex, uint32_t rightIndex) -> bool
+                             { return (nodeList[leftIndex].box.getCenter().data[axis] < nodeList[rightIndex].box.getCenter().data[axis]); });
+
+            const uint32_t left = build(leafList, start, middle);
+            const uint32_t right = build(leafList, middle, end);
+            const uint32_t parent = allocateNode();
+            auto &node = nodeList[parent];
+            node.left = left;
+            node.right = right;
+            node.box = Merge(nodeList[left].box, nodeList[right].box);
+            node.height = (1 + std::max(nodeList[left].height, nodeList[right].height));
+            nodeList[left].parent = parent;
+            nodeList[right].parent = parent;
+            return parent;
+        }
+    }; // namespace Shapes
+}; // namespace Gek
@@ -1,4 +1,5 @@
 #include "GEK/Shapes/Frustum.hpp"
+#include <cmath>
 
 namespace Gek
 {
@@ -64,5 +65,27 @@ namespace Gek
                 plane.normalize();
             }
         }
+
+        Frustum::Containment Frustum::getContainment(AlignedBox const &box) const noexcept
+        {
+            const auto center(box.getCenter());
+            const auto halfSize(box.getHalfSize());
+            auto containment = Containment::Inside;
+            for (auto const &plane : planeList)
+            {
+                const float distance = plane.getDistance(center);
+                const float extent = ((std::abs(plane.a) * halfSize.x) + (std::abs(plane.b) * halfSize.y) + (std::abs(plane.c) * halfSize.z));
+                if ((distance + extent) < 0.0f)
+                {
+                    return Containment::Outside;
+                }
+                else if ((distance - extent) < 0.0f)
+                {
+                    containment = Containment::Intersecting;
+                }
+            }
+
+            return containment;
+        }
     }; // namespace Shapes
 }; // namespace Gek
@@ -28,10 +28,14 @@ namespace Gek
             AlignedBox &operator=(AlignedBox const &box) noexcept;
 
             void extend(const Math::Float3 &point) noexcept;
+            void extend(AlignedBox const &box) noexcept;
+
+            bool contains(AlignedBox const &box) const noexcept;
 
             Math::Float3 getSize(void) const noexcept;
             Math::Float3 getHalfSize(void) const noexcept;
             Math::Float3 getCenter(void) const noexcept;
+            float getSurfaceArea(void) const noexcept;
         };
     }; // namespace Shapes
 }; // namespace Gek
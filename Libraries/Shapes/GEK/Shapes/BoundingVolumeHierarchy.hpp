@@ -0,0 +1,178 @@
+/// @file
+/// @author Todd Zupan <toddzupan@gmail.com>
+/// @version $Revision$
+/// @section LICENSE
+/// https://en.wikipedia.org/wiki/MIT_License
+/// @section DESCRIPTION
+/// Last Changed: $Date$
+#pragma once
+
+#include "GEK/Shapes/AlignedBox.hpp"
+#include "GEK/Shapes/Frustum.hpp"
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Gek
+{
+    namespace Shapes
+    {
+        // Dynamic tree of aligned boxes, leaves store a box grown by the margin so that small movements don't touch
+        // the tree at all.  Not synchronized, callers have to serialize modifications against queries.
+        class BoundingVolumeHierarchy
+        {
+          public:
+            static constexpr uint32_t InvalidProxy = std::numeric_limits<uint32_t>::max();
+
+            struct Node
+            {
+                AlignedBox box;
+                uint64_t userData = 0;
+                uint32_t parent = InvalidProxy;
+                uint32_t left = InvalidProxy;
+                uint32_t right = InvalidProxy;
+
+                // Zero for leaves, free nodes are marked with -1
+                int32_t height = -1;
+
+                bool isLeaf(void) const noexcept
+                {
+                    return (left == InvalidProxy);
+                }
+            };
+
+          private:
+            std::vector<Node> nodeList;
+            uint32_t rootNode = InvalidProxy;
+            uint32_t freeNode = InvalidProxy;
+            uint32_t proxyCount = 0;
+            float margin = 0.1f;
+
+          public:
+            BoundingVolumeHierarchy(float margin = 0.1f) noexcept;
+
+            void clear(void) noexcept;
+
+            uint32_t createProxy(AlignedBox const &box, uint64_t userData);
+            void destroyProxy(uint32_t proxy) noexcept;
+
+            // Returns true when the box left its fattened bounds and the proxy had to be reinserted
+            bool moveProxy(uint32_t proxy, AlignedBox const &box);
+
+            // Rebuilds the whole tree top down, cheaper than incremental inserts after loading a lot of proxies
+            void rebuild(void);
+
+            AlignedBox const &getFatBox(uint32_t proxy) const noexcept
+            {
+                return nodeList[proxy].box;
+            }
+
+            uint64_t getUserData(uint32_t proxy) const noexcept
+            {
+                return nodeList[proxy].userData;
+            }
+
+            uint32_t getProxyCount(void) const noexcept
+            {
+                return proxyCount;
+            }
+
+            int32_t getHeight(void) const noexcept
+            {
+                return (rootNode == InvalidProxy ? 0 : nodeList[rootNode].height);
+            }
+
+            // Checks the parent links, heights and boxes of every node, used by the tests
+            bool validate(void) const noexcept;
+
+            // onProxy(uint64_t userData, bool isInside) is called for every leaf that isn't fully outside the frustum,
+            // subtrees that are completely inside are walked without testing any more planes
+            template <typename FUNCTION>
+            void query(Frustum const &frustum, FUNCTION &&onProxy) const
+            {
+                if (rootNode == InvalidProxy)
+                {
+                    return;
+                }
+
+                std::vector<std::pair<uint32_t, bool>> stack;
+                stack.reserve(64);
+                stack.emplace_back(rootNode, false);
+                while (!stack.empty())
+                {
+                    auto [nodeIndex, isInside] = stack.back();
+                    stack.pop_back();
+
+                    auto const &node = nodeList[nodeIndex];
+                    if (!isInside)
+                    {
+                        auto containment = frustum.getContainment(node.box);
+                        if (containment == Frustum::Containment::Outside)
+                        {
+                            continue;
+                        }
+
+                        isInside = (containment == Frustum::Containment::Inside);
+                    }
+
+                    if (node.isLeaf())
+                    {
+                        onProxy(node.userData, isInside);
+                    }
+                    else
+                    {
+                        stack.emplace_back(node.left, isInside);
+                        stack.emplace_back(node.right, isInside);
+                    }
+                }
+            }
+
+            // onProxy(uint64_t userData) is called for every leaf whose fattened box overlaps the box
+            template <typename FUNCTION>
+            void query(AlignedBox const &box, FUNCTION &&onProxy) const
+            {
+                if (rootNode == InvalidProxy)
+                {
+                    return;
+                }
+
+                std::vector<uint32_t> stack;
+                stack.reserve(64);
+                stack.push_back(rootNode);
+                while (!stack.empty())
+                {
+                    auto const &node = nodeList[stack.back()];
+                    stack.pop_back();
+                    if (node.box.minimum.x > box.maximum.x || node.box.maximum.x < box.minimum.x ||
+                        node.box.minimum.y > box.maximum.y || node.box.maximum.y < box.minimum.y ||
+                        node.box.minimum.z > box.maximum.z || node.box.maximum.z < box.minimum.z)
+                    {
+                        continue;
+                    }
+
+                    if (node.isLeaf())
+                    {
+                        onProxy(node.userData);
+                    }
+                    else
+                    {
+                        stack.push_back(node.left);
+                        stack.push_back(node.right);
+                    }
+                }
+            }
+
+          private:
+            uint32_t allocateNode(void);
+            void releaseNode(uint32_t nodeIndex) noexcept;
+
+            void insertLeaf(uint32_t leaf);
+            void removeLeaf(uint32_t leaf) noexcept;
+            void updateAncestors(uint32_t nodeIndex) noexcept;
+            uint32_t balance(uint32_t nodeIndex) noexcept;
+
+            uint32_t build(std::vector<uint32_t> &leafList, size_t start, size_t end);
+        };
+    }; // namespace Shapes
+}; // namespace Gek
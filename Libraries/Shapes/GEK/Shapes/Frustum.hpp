@@ -34,6 +34,13 @@ namespace Gek
                 };
             }; // struct Planes
 
+            enum class Containment : uint8_t
+            {
+                Outside = 0,
+                Intersecting,
+                Inside,
+            };
+
           public:
             Plane planeList[6];
 
@@ -43,6 +50,9 @@ namespace Gek
             Frustum(Math::Float4x4 const &perspectiveTransform) noexcept;
 
             void create(Math::Float4x4 const &perspectiveTransform) noexcept;
+
+            // Conservative, boxes that straddle the corner of two planes can report Intersecting while being outside
+            Containment getContainment(AlignedBox const &box) const noexcept;
         };
     }; // namespace Shapes
 }; // namespace Gek
@@ -0,0 +1,78 @@
+/// @file
+/// @author Todd Zupan <toddzupan@gmail.com>
+/// @version $Revision$
+/// @section LICENSE
+/// https://en.wikipedia.org/wiki/MIT_License
+/// @section DESCRIPTION
+/// Last Changed: $Date$
+#pragma once
+
+#include "GEK/Math/Vector3.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace Gek
+{
+    namespace Shapes
+    {
+        // Offline preparation of indexed triangle lists for the GPU, every function works on lists of three indices
+        // per triangle and leaves the triangles themselves untouched
+        namespace MeshOptimizer
+        {
+            // Contiguous range of triangles with a bounding sphere and a cone around their normals, a meshlet can be
+            // skipped when its sphere is outside the frustum or the view lies behind every one of its triangles
+            struct Meshlet
+            {
+                uint32_t firstIndex = 0;
+                uint32_t indexCount = 0;
+                Math::Float3 center = Math::Float3::Zero;
+                float radius = 0.0f;
+                Math::Float3 coneAxis = Math::Float3::Zero;
+                float coneCutoff = 1.0f;
+            };
+
+            // Maps every vertex to the first vertex with exactly the same bytes, returns the number of unique vertices
+            uint32_t GenerateVertexRemap(void const *vertexData, uint32_t vertexCount, size_t vertexSize, std::vector<uint32_t> &remapList);
+
+            // Moves each vertex to its remapped slot, vertices that map to the same slot must be identical
+            template <typename TYPE>
+            std::vector<TYPE> RemapVertices(std::vector<TYPE> const &vertexList, std::vector<uint32_t> const &remapList, uint32_t remappedCount)
+            {
+                std::vector<TYPE> remappedList(remappedCount);
+                for (size_t vertexIndex = 0; vertexIndex < remapList.size(); ++vertexIndex)
+                {
+                    if (remapList[vertexIndex] < remappedCount)
+                    {
+                        remappedList[remapList[vertexIndex]] = vertexList[vertexIndex];
+                    }
+                }
+
+                return remappedList;
+            }
+
+            void RemapIndices(std::vector<uint32_t> &indexList, std::vector<uint32_t> const &remapList);
+
+            // Tipsify reordering for a post transform cache of the given size.  Returns the first index of every cluster
+            // that starts after a dead end, clusters can be reordered between each other without hurting the cache.
+            std::vector<uint32_t> OptimizeVertexCache(std::vector<uint32_t> &indexList, uint32_t vertexCount, uint32_t cacheSize = 16);
+
+            // Draws the clusters that face out from the middle of the mesh first, they are the most likely to hide the rest
+            void OptimizeOverdraw(std::vector<uint32_t> &indexList, std::vector<uint32_t> const &clusterList, Math::Float3 const *positionList, uint32_t vertexCount);
+
+            // Numbers the vertices in the order the triangles first use them, returns the number of vertices still used
+            uint32_t OptimizeVertexFetch(std::vector<uint32_t> &indexList, uint32_t vertexCount, std::vector<uint32_t> &remapList);
+
+            // Collapses edges in order of their quadric error until the index count drops to the target or the next collapse
+            // would move the surface further than the target error.  Vertices on open borders or attribute seams never
+            // move, so the result keeps using the original vertices and the error is returned in position units.
+            std::vector<uint32_t> Simplify(std::vector<uint32_t> const &indexList, Math::Float3 const *positionList, uint32_t vertexCount, size_t targetIndexCount, float targetError, float *resultError = nullptr);
+
+            // Splits the triangles in to meshlets without reordering them, each meshlet ends before it would use more
+            // than the given number of vertices or triangles.  Meshlets whose normals spread too far keep a cutoff of one.
+            std::vector<Meshlet> BuildMeshlets(std::vector<uint32_t> const &indexList, Math::Float3 const *positionList, uint32_t vertexCount, uint32_t maxVertexCount = 64, uint32_t maxTriangleCount = 124);
+
+            // Average vertices transformed per triangle through a FIFO cache, from 0.5 at best to 3 without any reuse
+            float GetCacheMissRatio(std::vector<uint32_t> const &indexList, uint32_t vertexCount, uint32_t cacheSize = 16);
+        }; // namespace MeshOptimizer
+    }; // namespace Shapes
+}; // namespace Gek
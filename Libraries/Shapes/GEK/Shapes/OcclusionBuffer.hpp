@@ -0,0 +1,89 @@
+/// @file
+/// @author Todd Zupan <toddzupan@gmail.com>
+/// @version $Revision$
+/// @section LICENSE
+/// https://en.wikipedia.org/wiki/MIT_License
+/// @section DESCRIPTION
+/// Last Changed: $Date$
+#pragma once
+
+#include "GEK/Math/Matrix4x4.hpp"
+#include "GEK/Shapes/AlignedBox.hpp"
+#include "GEK/Utility/Allocator.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace Gek
+{
+    namespace Shapes
+    {
+        // Low resolution software depth buffer for occlusion culling.  Occluders are rasterized as solid boxes, the
+        // buffer keeps the nearest depth per pixel and a pyramid of the farthest depth per tile for the tests.
+        class OcclusionBuffer
+        {
+          private:
+            using DepthList = std::vector<float, AlignedAllocator<float, 16>>;
+
+            uint32_t width = 0;
+            uint32_t height = 0;
+            Math::Float4x4 viewProjectionMatrix = Math::Float4x4::Identity;
+            bool isDepthReversed = false;
+            std::vector<DepthList> levelList;
+            std::vector<uint32_t> levelWidthList;
+            std::vector<uint32_t> levelHeightList;
+            uint32_t occluderCount = 0;
+
+          public:
+            // Width is rounded up to a multiple of 4 so that rows can be rasterized 4 pixels at a time
+            OcclusionBuffer(uint32_t width = 256, uint32_t height = 128);
+
+            uint32_t getWidth(void) const noexcept
+            {
+                return width;
+            }
+
+            uint32_t getHeight(void) const noexcept
+            {
+                return height;
+            }
+
+            uint32_t getOccluderCount(void) const noexcept
+            {
+                return occluderCount;
+            }
+
+            // Depth is stored from zero at the near plane to one at the far plane, whichever way the projection maps it
+            float getDepth(uint32_t x, uint32_t y) const noexcept
+            {
+                return levelList[0][(y * width) + x];
+            }
+
+            // Resets every pixel to the far plane and sets the camera used by the following calls
+            void clear(Math::Float4x4 const &viewMatrix, Math::Float4x4 const &projectionMatrix) noexcept;
+
+            // Only valid for geometry that really fills the box, occluders crossing the near plane are skipped
+            void addOccluder(AlignedBox const &box, Math::Float4x4 const &matrix) noexcept;
+
+            // Builds the depth pyramid, call once after the last occluder and before testing
+            void finalize(void) noexcept;
+
+            // False only when every pixel the box covers is behind an occluder
+            bool isVisible(AlignedBox const &box, Math::Float4x4 const &matrix) const noexcept;
+
+          private:
+            struct ScreenVertex
+            {
+                float x, y, z;
+            };
+
+            float normalizeDepth(float projectedDepth) const noexcept
+            {
+                return (isDepthReversed ? (1.0f - projectedDepth) : projectedDepth);
+            }
+
+            void rasterizeTriangle(ScreenVertex const &vertex0, ScreenVertex vertex1, ScreenVertex vertex2) noexcept;
+            bool isRegionVisible(uint32_t level, uint32_t tileStartX, uint32_t tileStartY, uint32_t tileEndX, uint32_t tileEndY,
+                                 uint32_t pixelStartX, uint32_t pixelStartY, uint32_t pixelEndX, uint32_t pixelEndY, float minimumDepth) const noexcept;
+        };
+    }; // namespace Shapes
+}; // namespace Gek
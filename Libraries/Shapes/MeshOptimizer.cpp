@@ -0,0 +1,688 @@
+#include "GEK/Shapes/MeshOptimizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <string_view>
+
+namespace Gek
+{
+    namespace Shapes
+    {
+        namespace MeshOptimizer
+        {
+            namespace
+            {
+                static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+                // Sum of squared distances to a set of planes, each weighted by the area of its triangle
+                struct Quadric
+                {
+                    double xx = 0.0, xy = 0.0, xz = 0.0, xw = 0.0;
+                    double yy = 0.0, yz = 0.0, yw = 0.0;
+                    double zz = 0.0, zw = 0.0;
+                    double ww = 0.0;
+                    double weight = 0.0;
+
+                    void addPlane(Math::Float3 const &normal, float distance, double area)
+                    {
+                        const double x = normal.x, y = normal.y, z = normal.z, w = distance;
+                        xx += (area * x * x), xy += (area * x * y), xz += (area * x * z), xw += (area * x * w);
+                        yy += (area * y * y), yz += (area * y * z), yw += (area * y * w);
+                        zz += (area * z * z), zw += (area * z * w);
+                        ww += (area * w * w);
+                        weight += area;
+                    }
+
+                    void operator+=(Quadric const &quadric)
+                    {
+                        xx += quadric.xx, xy += quadric.xy, xz += quadric.xz, xw += quadric.xw;
+                        yy += quadric.yy, yz += quadric.yz, yw += quadric.yw;
+                        zz += quadric.zz, zw += quadric.zw;
+                        ww += quadric.ww;
+                        weight += quadric.weight;
+                    }
+
+                    // Root mean square distance of the point from the planes
+                    static float getError(Quadric const &first, Quadric const &second, Math::Float3 const &point)
+                    {
+                        const double x = point.x, y = point.y, z = point.z;
+                        const double weight = (first.weight + second.weight);
+                        const double error =
+                            ((first.xx + second.xx) * x * x) + (2.0 * (first.xy + second.xy) * x * y) + (2.0 * (first.xz + second.xz) * x * z) + (2.0 * (first.xw + second.xw) * x) +
+                            ((first.yy + second.yy) * y * y) + (2.0 * (first.yz + second.yz) * y * z) + (2.0 * (first.yw + second.yw) * y) +
+                            ((first.zz + second.zz) * z * z) + (2.0 * (first.zw + second.zw) * z) +
+                            (first.ww + second.ww);
+                        return (weight > 0.0 ? static_cast<float>(std::sqrt(std::max(error, 0.0) / weight)) : 0.0f);
+                    }
+                };
+            }; // namespace
+
+            uint32_t GenerateVertexRemap(void const *vertexData, uint32_t vertexCount, size_t vertexSize, std::vector<uint32_t> &remapList)
+            {
+                auto data = static_cast<uint8_t const *>(vertexData);
+                remapList.assign(vertexCount, InvalidIndex);
+
+                // Open addressing on the vertex bytes, the table holds the first vertex seen with each value
+                size_t tableSize = 1;
+                while (tableSize < (size_t(vertexCount) * 2))
+                {
+                    tableSize <<= 1;
+                }
+
+                const size_t tableMask = (tableSize - 1);
+                std::vector<uint32_t> tableList(tableSize, InvalidIndex);
+                uint32_t uniqueCount = 0;
+                for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+                {
+                    auto vertex = (data + (vertexIndex * vertexSize));
+                    size_t slot = (std::hash<std::string_view>()(std::string_view(reinterpret_cast<char const *>(vertex), vertexSize)) & tableMask);
+                    while (tableList[slot] != InvalidIndex && std::memcmp((data + (tableList[slot] * vertexSize)), vertex, vertexSize) != 0)
+                    {
+                        slot = ((slot + 1) & tableMask);
+                    }
+
+                    if (tableList[slot] == InvalidIndex)
+                    {
+                        tableList[slot] = vertexIndex;
+                        remapList[vertexIndex] = uniqueCount++;
+                    }
+                    else
+                    {
+                        remapList[vertexIndex] = remapList[tableList[slot]];
+                    }
+                }
+
+                return uniqueCount;
+            }
+
+            void RemapIndices(std::vector<uint32_t> &indexList, std::vector<uint32_t> const &remapList)
+            {
+                for (auto &index : indexList)
+                {
+                    index = remapList[index];
+                }
+            }
+
+            std::vector<uint32_t> OptimizeVertexCache(std::vector<uint32_t> &indexList, uint32_t vertexCount, uint32_t cacheSize)
+            {
+                std::vector<uint32_t> clusterList;
+                const uint32_t triangleCount = static_cast<uint32_t>(indexList.size() / 3);
+                if (triangleCount == 0)
+                {
+                    return clusterList;
+                }
+
+                // Triangles using each vertex, packed one vertex after the other
+                std::vector<uint32_t> liveCountList(vertexCount, 0);
+                for (auto index : indexList)
+                {
+                    ++liveCountList[index];
+                }
+
+                std::vector<uint32_t> adjacencyOffsetList(vertexCount + 1, 0);
+                for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+                {
+                    adjacencyOffsetList[vertexIndex + 1] = (adjacencyOffsetList[vertexIndex] + liveCountList[vertexIndex]);
+                }
+
+                std::vector<uint32_t> adjacencyList(triangleCount * 3);
+                std::vector<uint32_t> fillOffsetList(std::begin(adjacencyOffsetList), std::prev(std::end(adjacencyOffsetList)));
+                for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex)
+                {
+                    for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex)
+                    {
+                        adjacencyList[fillOffsetList[indexList[(triangleIndex * 3) + cornerIndex]]++] = triangleIndex;
+                    }
+                }
+
+                std::vector<uint32_t> timeStampList(vertexCount, 0);
+                std::vector<uint8_t> emittedList(triangleCount, 0);
+                std::vector<uint32_t> deadEndList;
+                std::vector<uint32_t> candidateList;
+                std::vector<uint32_t> optimizedList;
+                optimizedList.reserve(indexList.size());
+
+                uint32_t timeStamp = (cacheSize + 1);
+                uint32_t vertexCursor = 0;
+                auto skipDeadEnd = [&](void) -> uint32_t
+                {
+                    while (!deadEndList.empty())
+                    {
+                        auto vertexIndex = deadEndList.back();
+                        deadEndList.pop_back();
+                        if (liveCountList[vertexIndex] > 0)
+                        {
+                            return vertexIndex;
+                        }
+                    }
+
+                    for (; vertexCursor < vertexCount; ++vertexCursor)
+                    {
+                        if (liveCountList[vertexCursor] > 0)
+                        {
+                            return vertexCursor;
+                        }
+                    }
+
+                    return InvalidIndex;
+                };
+
+                clusterList.push_back(0);
+                for (auto fanningVertex = skipDeadEnd(); fanningVertex != InvalidIndex;)
+                {
+                    candidateList.clear();
+                    for (auto adjacency = adjacencyOffsetList[fanningVertex]; adjacency < adjacencyOffsetList[fanningVertex + 1]; ++adjacency)
+                    {
+                        auto triangleIndex = adjacencyList[adjacency];
+                        if (emittedList[triangleIndex])
+                        {
+                            continue;
+                        }
+
+                        for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex)
+                        {
+                            auto vertexIndex = indexList[(triangleIndex * 3) + cornerIndex];
+                            optimizedList.push_back(vertexIndex);
+                            deadEndList.push_back(vertexIndex);
+                            candidateList.push_back(vertexIndex);
+                            --liveCountList[vertexIndex];
+                            if ((timeStamp - timeStampList[vertexIndex]) > cacheSize)
+                            {
+                                timeStampList[vertexIndex] = timeStamp++;
+                            }
+                        }
+
+                        emittedList[triangleIndex] = 1;
+                    }
+
+                    // Prefer the vertex that has been in the cache longest, as long as its remaining triangles still fit
+                    uint32_t nextVertex = InvalidIndex;
+                    int64_t bestPriority = -1;
+                    for (auto vertexIndex : candidateList)
+                    {
+                        if (liveCountList[vertexIndex] > 0)
+                        {
+                            int64_t priority = 0;
+                            const uint32_t age = (timeStamp - timeStampList[vertexIndex]);
+                            if ((age + (2 * liveCountList[vertexIndex])) <= cacheSize)
+                            {
+                                priority = age;
+                            }
+
+                            if (priority > bestPriority)
+                            {
+                                bestPriority = priority;
+                                nextVertex = vertexIndex;
+                            }
+                        }
+                    }
+
+                    if (nextVertex == InvalidIndex)
+                    {
+                        nextVertex = skipDeadEnd();
+                        if (nextVertex != InvalidIndex)
+                        {
+                            clusterList.push_back(static_cast<uint32_t>(optimizedList.size()));
+                        }
+                    }
+
+                    fanningVertex = nextVertex;
+                }
+
+                indexList = std::move(optimizedList);
+                return clusterList;
+            }
+
+            void OptimizeOverdraw(std::vector<uint32_t> &indexList, std::vector<uint32_t> const &clusterList, Math::Float3 const *positionList, uint32_t vertexCount)
+            {
+                if (clusterList.size() < 2)
+                {
+                    return;
+                }
+
+                struct Cluster
+                {
+                    uint32_t firstIndex = 0;
+                    uint32_t lastIndex = 0;
+                    Math::Float3 center = Math::Float3::Zero;
+                    Math::Float3 normal = Math::Float3::Zero;
+                    float area = 0.0f;
+                    float sortKey = 0.0f;
+                };
+
+                // Areas are left doubled throughout, only the ratios between them matter
+                std::vector<Cluster> sortList(clusterList.size());
+                Math::Float3 meshCenter = Math::Float3::Zero;
+                float meshArea = 0.0f;
+                for (size_t clusterIndex = 0; clusterIndex < clusterList.size(); ++clusterIndex)
+                {
+                    auto &cluster = sortList[clusterIndex];
+                    cluster.firstIndex = clusterList[clusterIndex];
+                    cluster.lastIndex = ((clusterIndex + 1) < clusterList.size() ? clusterList[clusterIndex + 1] : static_cast<uint32_t>(indexList.size()));
+                    for (auto index = cluster.firstIndex; (index + 2) < cluster.lastIndex; index += 3)
+                    {
+                        // Triangles that reference missing vertices are still moved with their cluster, they just do not steer it
+                        if (indexList[index + 0] >= vertexCount || indexList[index + 1] >= vertexCount || indexList[index + 2] >= vertexCount)
+                        {
+                            continue;
+                        }
+
+                        auto const &first = positionList[indexList[index + 0]];
+                        auto const &second = positionList[indexList[index + 1]];
+                        auto const &third = positionList[indexList[index + 2]];
+                        auto normal = (second - first).cross(third - first);
+                        auto area = normal.getLength();
+                        cluster.center += (((first + second + third) / 3.0f) * area);
+                        cluster.normal += normal;
+                        cluster.area += area;
+                    }
+
+                    meshCenter += cluster.center;
+                    meshArea += cluster.area;
+                    if (cluster.area > 0.0f)
+                    {
+                        cluster.center /= cluster.area;
+                    }
+                }
+
+                if (meshArea > 0.0f)
+                {
+                    meshCenter /= meshArea;
+                }
+
+                for (auto &cluster : sortList)
+                {
+                    auto normalLength = cluster.normal.getLength();
+                    cluster.sortKey = (normalLength > 0.0f ? ((cluster.center - meshCenter).dot(cluster.normal) / normalLength) : 0.0f);
+                }
+
+                std::stable_sort(std::begin(sortList), std::end(sortList), [](Cluster const &left, Cluster const &right) -> bool
+                {
+                    return (left.sortKey > right.sortKey);
+                });
+
+                std::vector<uint32_t> sortedList;
+                sortedList.reserve(indexList.size());
+                for (auto const &cluster : sortList)
+                {
+                    sortedList.insert(std::end(sortedList), (std::begin(indexList) + cluster.firstIndex), (std::begin(indexList) + cluster.lastIndex));
+                }
+
+                indexList = std::move(sortedList);
+            }
+
+            uint32_t OptimizeVertexFetch(std::vector<uint32_t> &indexList, uint32_t vertexCount, std::vector<uint32_t> &remapList)
+            {
+                remapList.assign(vertexCount, InvalidIndex);
+                uint32_t remappedCount = 0;
+                for (auto &index : indexList)
+                {
+                    auto &remappedIndex = remapList[index];
+                    if (remappedIndex == InvalidIndex)
+                    {
+                        remappedIndex = remappedCount++;
+                    }
+
+                    index = remappedIndex;
+                }
+
+                return remappedCount;
+            }
+
+            std::vector<uint32_t> Simplify(std::vector<uint32_t> const &indexList, Math::Float3 const *positionList, uint32_t vertexCount, size_t targetIndexCount, float targetError, float *resultError)
+            {
+                std::vector<uint32_t> simplifiedList(indexList);
+                float maximumError = 0.0f;
+
+                // Vertices that only differ by their attributes share a position, those seams and open borders are locked
+                std::vector<uint32_t> positionRemapList;
+                GenerateVertexRemap(positionList, vertexCount, sizeof(Math::Float3), positionRemapList);
+                std::vector<uint32_t> positionCountList(vertexCount, 0);
+                for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+                {
+                    ++positionCountList[positionRemapList[vertexIndex]];
+                }
+
+                std::vector<uint64_t> edgeList;
+                edgeList.reserve(indexList.size());
+                for (size_t index = 0; index < indexList.size(); index += 3)
+                {
+                    for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex)
+                    {
+                        uint64_t first = positionRemapList[indexList[index + cornerIndex]];
+                        uint64_t second = positionRemapList[indexList[index + ((cornerIndex + 1) % 3)]];
+                        edgeList.push_back((first << 32) | second);
+                    }
+                }
+
+                std::sort(std::begin(edgeList), std::end(edgeList));
+                std::vector<uint8_t> lockedList(vertexCount, 0);
+                for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+                {
+                    lockedList[vertexIndex] = (positionCountList[positionRemapList[vertexIndex]] > 1);
+                }
+
+                std::vector<uint8_t> borderList(vertexCount, 0);
+                for (auto edge : edgeList)
+                {
+                    auto reverseEdge = ((edge << 32) | (edge >> 32));
+                    if (!std::binary_search(std::begin(edgeList), std::end(edgeList), reverseEdge))
+                    {
+                        borderList[edge >> 32] = 1;
+                        borderList[edge & 0xFFFFFFFF] = 1;
+                    }
+                }
+
+                std::vector<Quadric> quadricList(vertexCount);
+                for (size_t index = 0; index < indexList.size(); index += 3)
+                {
+                    auto const &first = positionList[indexList[index + 0]];
+                    auto normal = (positionList[indexList[index + 1]] - first).cross(positionList[indexList[index + 2]] - first);
+                    auto length = normal.getLength();
+                    if (length > 0.0f)
+                    {
+                        normal /= length;
+                        for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex)
+                        {
+                            quadricList[indexList[index + cornerIndex]].addPlane(normal, -normal.dot(first), (length * 0.5));
+                        }
+                    }
+                }
+
+                for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+                {
+                    lockedList[vertexIndex] |= borderList[positionRemapList[vertexIndex]];
+                }
+
+                struct Collapse
+                {
+                    uint32_t source = 0;
+                    uint32_t target = 0;
+                    float error = 0.0f;
+                };
+
+                std::vector<Collapse> collapseList;
+                std::vector<uint32_t> adjacencyOffsetList;
+                std::vector<uint32_t> adjacencyList;
+                std::vector<uint32_t> remapList(vertexCount);
+                std::vector<uint8_t> movedList(vertexCount);
+                while (simplifiedList.size() > targetIndexCount)
+                {
+                    const uint32_t triangleCount = static_cast<uint32_t>(simplifiedList.size() / 3);
+                    adjacencyOffsetList.assign(vertexCount + 1, 0);
+                    for (auto index : simplifiedList)
+                    {
+                        ++adjacencyOffsetList[index + 1];
+                    }
+
+                    for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+                    {
+                        adjacencyOffsetList[vertexIndex + 1] += adjacencyOffsetList[vertexIndex];
+                    }
+
+                    adjacencyList.resize(simplifiedList.size());
+                    std::vector<uint32_t> fillOffsetList(std::begin(adjacencyOffsetList), std::prev(std::end(adjacencyOffsetList)));
+                    for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex)
+                    {
+                        for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex)
+                        {
+                            adjacencyList[fillOffsetList[simplifiedList[(triangleIndex * 3) + cornerIndex]]++] = triangleIndex;
+                        }
+                    }
+
+                    // Every edge collapses whichever way round is cheaper, interior edges show up once from each side
+                    collapseList.clear();
+                    for (size_t index = 0; index < simplifiedList.size(); index += 3)
+                    {
+                        for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex)
+                        {
+                            auto first = simplifiedList[index + cornerIndex];
+                            auto second = simplifiedList[index + ((cornerIndex + 1) % 3)];
+                            if (first > second && !lockedList[first] && !lockedList[second])
+                            {
+                                continue;
+                            }
+
+                            Collapse collapse;
+                            collapse.error = std::numeric_limits<float>::max();
+                            if (!lockedList[first])
+                            {
+                                collapse = { first, second, Quadric::getError(quadricList[first], quadricList[second], positionList[second]) };
+                            }
+
+                            if (!lockedList[second])
+                            {
+                                auto error = Quadric::getError(quadricList[first], quadricList[second], positionList[first]);
+                                if (error < collapse.error)
+                                {
+                                    collapse = { second, first, error };
+                                }
+                            }
+
+                            if (collapse.error <= targetError)
+                            {
+                                collapseList.push_back(collapse);
+                            }
+                        }
+                    }
+
+                    std::sort(std::begin(collapseList), std::end(collapseList), [](Collapse const &left, Collapse const &right) -> bool
+                    {
+                        return (left.error < right.error);
+                    });
+
+                    // Vertices around a collapse keep still for the rest of the pass so the flip test stays valid
+                    std::iota(std::begin(remapList), std::end(remapList), 0);
+                    std::fill(std::begin(movedList), std::end(movedList), 0);
+                    size_t remainingTriangleCount = triangleCount;
+                    size_t collapseCount = 0;
+                    for (auto const &collapse : collapseList)
+                    {
+                        if ((remainingTriangleCount * 3) <= targetIndexCount)
+                        {
+                            break;
+                        }
+
+                        if (movedList[collapse.source] || movedList[collapse.target])
+                        {
+                            continue;
+                        }
+
+                        bool flipped = false;
+                        size_t removedTriangleCount = 0;
+                        auto const &targetPosition = positionList[collapse.target];
+                        for (auto adjacency = adjacencyOffsetList[collapse.source]; adjacency < adjacencyOffsetList[collapse.source + 1] && !flipped; ++adjacency)
+                        {
+                            auto triangle = &simplifiedList[adjacencyList[adjacency] * 3];
+                            if (triangle[0] == collapse.target || triangle[1] == collapse.target || triangle[2] == collapse.target)
+                            {
+                                ++removedTriangleCount;
+                                continue;
+                            }
+
+                            Math::Float3 cornerList[3] = { positionList[triangle[0]], positionList[triangle[1]], positionList[triangle[2]] };
+                            auto normal = (cornerList[1] - cornerList[0]).cross(cornerList[2] - cornerList[0]);
+                            for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex)
+                            {
+                                if (triangle[cornerIndex] == collapse.source)
+                                {
+                                    cornerList[cornerIndex] = targetPosition;
+                                }
+                            }
+
+                            auto collapsedNormal = (cornerList[1] - cornerList[0]).cross(cornerList[2] - cornerList[0]);
+                            flipped = (normal.dot(collapsedNormal) <= (0.25f * normal.getLength() * collapsedNormal.getLength()));
+                        }
+
+                        if (flipped)
+                        {
+                            continue;
+                        }
+
+                        for (auto adjacency = adjacencyOffsetList[collapse.source]; adjacency < adjacencyOffsetList[collapse.source + 1]; ++adjacency)
+                        {
+                            auto triangle = &simplifiedList[adjacencyList[adjacency] * 3];
+                            movedList[triangle[0]] = movedList[triangle[1]] = movedList[triangle[2]] = 1;
+                        }
+
+                        remapList[collapse.source] = collapse.target;
+                        quadricList[collapse.target] += quadricList[collapse.source];
+                        maximumError = std::max(maximumError, collapse.error);
+                        remainingTriangleCount -= removedTriangleCount;
+                        ++collapseCount;
+                    }
+
+                    if (collapseCount == 0)
+                    {
+                        break;
+                    }
+
+                    size_t writeIndex = 0;
+                    for (size_t index = 0; index < simplifiedList.size(); index += 3)
+                    {
+                        auto first = remapList[simplifiedList[index + 0]];
+                        auto second = remapList[simplifiedList[index + 1]];
+                        auto third = remapList[simplifiedList[index + 2]];
+                        if (first != second && second != third && third != first)
+                        {
+                            simplifiedList[writeIndex++] = first;
+                            simplifiedList[writeIndex++] = second;
+                            simplifiedList[writeIndex++] = third;
+                        }
+                    }
+
+                    simplifiedList.resize(writeIndex);
+                }
+
+                if (resultError)
+                {
+                    (*resultError) = maximumError;
+                }
+
+                return simplifiedList;
+            }
+
+            std::vector<Meshlet> BuildMeshlets(std::vector<uint32_t> const &indexList, Math::Float3 const *positionList, uint32_t vertexCount, uint32_t maxVertexCount, uint32_t maxTriangleCount)
+            {
+                // Vertices are tagged with the last meshlet that used them, so nothing has to be cleared between meshlets
+                std::vector<Meshlet> meshletList;
+                std::vector<uint32_t> meshletTagList(vertexCount, InvalidIndex);
+                uint32_t meshletVertexCount = 0;
+                for (size_t index = 0; index < indexList.size(); index += 3)
+                {
+                    uint32_t newVertexCount = 0;
+                    if (!meshletList.empty())
+                    {
+                        for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex)
+                        {
+                            newVertexCount += (meshletTagList[indexList[index + cornerIndex]] != (meshletList.size() - 1));
+                        }
+                    }
+
+                    if (meshletList.empty() || ((meshletVertexCount + newVertexCount) > maxVertexCount) || (((meshletList.back().indexCount / 3) + 1) > maxTriangleCount))
+                    {
+                        meshletList.emplace_back().firstIndex = static_cast<uint32_t>(index);
+                        meshletVertexCount = 0;
+                    }
+
+                    auto &meshlet = meshletList.back();
+                    for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex)
+                    {
+                        auto &meshletTag = meshletTagList[indexList[index + cornerIndex]];
+                        if (meshletTag != (meshletList.size() - 1))
+                        {
+                            meshletTag = static_cast<uint32_t>(meshletList.size() - 1);
+                            ++meshletVertexCount;
+                        }
+                    }
+
+                    meshlet.indexCount += 3;
+                }
+
+                for (auto &meshlet : meshletList)
+                {
+                    Math::Float3 minimum(std::numeric_limits<float>::max());
+                    Math::Float3 maximum(-std::numeric_limits<float>::max());
+                    Math::Float3 normalSum(Math::Float3::Zero);
+                    for (uint32_t index = meshlet.firstIndex; index < (meshlet.firstIndex + meshlet.indexCount); index += 3)
+                    {
+                        auto const &first = positionList[indexList[index + 0]];
+                        auto const &second = positionList[indexList[index + 1]];
+                        auto const &third = positionList[indexList[index + 2]];
+                        minimum = minimum.getMinimum(first).getMinimum(second).getMinimum(third);
+                        maximum = maximum.getMaximum(first).getMaximum(second).getMaximum(third);
+
+                        auto normal = (second - first).cross(third - first);
+                        auto length = normal.getLength();
+                        if (length > 0.0f)
+                        {
+                            normalSum += (normal / length);
+                        }
+                    }
+
+                    meshlet.center = ((minimum + maximum) * 0.5f);
+                    for (uint32_t index = meshlet.firstIndex; index < (meshlet.firstIndex + meshlet.indexCount); ++index)
+                    {
+                        meshlet.radius = std::max(meshlet.radius, positionList[indexList[index]].getDistance(meshlet.center));
+                    }
+
+                    // The cutoff is the sine of the widest angle between the axis and a normal, the cone is left open
+                    // once the normals spread close to a half sphere since it could hardly ever cull anything
+                    auto normalLength = normalSum.getLength();
+                    if (normalLength <= 0.0f)
+                    {
+                        continue;
+                    }
+
+                    auto coneAxis(normalSum / normalLength);
+                    float minimumDot = 1.0f;
+                    for (uint32_t index = meshlet.firstIndex; index < (meshlet.firstIndex + meshlet.indexCount); index += 3)
+                    {
+                        auto const &first = positionList[indexList[index + 0]];
+                        auto normal = (positionList[indexList[index + 1]] - first).cross(positionList[indexList[index + 2]] - first);
+                        auto length = normal.getLength();
+                        if (length > 0.0f)
+                        {
+                            minimumDot = std::min(minimumDot, (coneAxis.dot(normal) / length));
+                        }
+                    }
+
+                    if (minimumDot > 0.1f)
+                    {
+                        meshlet.coneAxis = coneAxis;
+                        meshlet.coneCutoff = std::sqrt(1.0f - (minimumDot * minimumDot));
+                    }
+                }
+
+                return meshletList;
+            }
+
+            float GetCacheMissRatio(std::vector<uint32_t> const &indexList, uint32_t vertexCount, uint32_t cacheSize)
+            {
+                const size_t triangleCount = (indexList.size() / 3);
+                if (triangleCount == 0)
+                {
+                    return 0.0f;
+                }
+
+                // A vertex is still cached while fewer than cacheSize others have been added since it was
+                std::vector<uint32_t> timeStampList(vertexCount, 0);
+                uint32_t timeStamp = (cacheSize + 1);
+                size_t missCount = 0;
+                for (auto index : indexList)
+                {
+                    if ((timeStamp - timeStampList[index]) > cacheSize)
+                    {
+                        timeStampList[index] = timeStamp++;
+                        ++missCount;
+                    }
+                }
+
+                return (float(missCount) / float(triangleCount));
+            }
+        }; // namespace MeshOptimizer
+    }; // namespace Shapes
+}; // namespace Gek
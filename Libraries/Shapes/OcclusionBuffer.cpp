@@ -0,0 +1,308 @@
+#include "GEK/Shapes/OcclusionBuffer.hpp"
+#include "GEK/Math/Common.hpp"
+#include <algorithm>
+#include <cmath>
+#include <emmintrin.h>
+
+namespace Gek
+{
+    namespace Shapes
+    {
+        namespace
+        {
+            // Corners are indexed by bits, x in the first, y in the second and z in the third
+            static constexpr uint8_t BoxFaceList[6][4] =
+            {
+                { 0, 2, 6, 4 },
+                { 1, 3, 7, 5 },
+                { 0, 1, 5, 4 },
+                { 2, 3, 7, 6 },
+                { 0, 1, 3, 2 },
+                { 4, 5, 7, 6 },
+            };
+
+            Math::Float3 GetCorner(AlignedBox const &box, uint32_t corner) noexcept
+            {
+                return Math::Float3(
+                    ((corner & 1) ? box.maximum.x : box.minimum.x),
+                    ((corner & 2) ? box.maximum.y : box.minimum.y),
+                    ((corner & 4) ? box.maximum.z : box.minimum.z));
+            }
+        }; // namespace
+
+        OcclusionBuffer::OcclusionBuffer(uint32_t requestedWidth, uint32_t requestedHeight)
+            : width((std::max(requestedWidth, 4u) + 3) & ~3u)
+            , height(std::max(requestedHeight, 1u))
+        {
+            uint32_t levelWidth = width;
+            uint32_t levelHeight = height;
+            while (true)
+            {
+                levelList.emplace_back(levelWidth * levelHeight, 1.0f);
+                levelWidthList.push_back(levelWidth);
+                levelHeightList.push_back(levelHeight);
+                if (levelWidth == 1 && levelHeight == 1)
+                {
+                    break;
+                }
+
+                levelWidth = ((levelWidth + 1) / 2);
+                levelHeight = ((levelHeight + 1) / 2);
+            }
+        }
+
+        void OcclusionBuffer::clear(Math::Float4x4 const &viewMatrix, Math::Float4x4 const &projectionMatrix) noexcept
+        {
+            viewProjectionMatrix = (viewMatrix * projectionMatrix);
+
+            // Projections built with the near and far planes swapped map the near plane to one
+            isDepthReversed = (projectionMatrix._33 < 0.0f);
+            for (auto &depthList : levelList)
+            {
+                std::fill(std::begin(depthList), std::end(depthList), 1.0f);
+            }
+
+            occluderCount = 0;
+        }
+
+        void OcclusionBuffer::addOccluder(AlignedBox const &box, Math::Float4x4 const &matrix) noexcept
+        {
+            const auto worldViewProjectionMatrix(matrix * viewProjectionMatrix);
+            const float halfWidth = (float(width) * 0.5f);
+            const float halfHeight = (float(height) * 0.5f);
+
+            ScreenVertex screenList[8];
+            for (uint32_t corner = 0; corner < 8; ++corner)
+            {
+                auto clip = worldViewProjectionMatrix.transform(Math::Float4(GetCorner(box, corner), 1.0f));
+                if (clip.w <= Math::Epsilon)
+                {
+                    return;
+                }
+
+                const float inverseW = (1.0f / clip.w);
+                screenList[corner].x = (((clip.x * inverseW) + 1.0f) * halfWidth);
+                screenList[corner].y = ((1.0f - (clip.y * inverseW)) * halfHeight);
+                screenList[corner].z = normalizeDepth(clip.z * inverseW);
+                if (screenList[corner].z < 0.0f)
+                {
+                    return;
+                }
+            }
+
+            // Back faces are farther away than the front faces covering the same pixels, so winding doesn't matter
+            for (auto const &face : BoxFaceList)
+            {
+                rasterizeTriangle(screenList[face[0]], screenList[face[1]], screenList[face[2]]);
+                rasterizeTriangle(screenList[face[0]], screenList[face[2]], screenList[face[3]]);
+            }
+
+            ++occluderCount;
+        }
+
+        void OcclusionBuffer::rasterizeTriangle(ScreenVertex const &vertex0, ScreenVertex vertex1, ScreenVertex vertex2) noexcept
+        {
+            float area = (((vertex1.x - vertex0.x) * (vertex2.y - vertex0.y)) - ((vertex1.y - vertex0.y) * (vertex2.x - vertex0.x)));
+            if (std::abs(area) < Math::Epsilon)
+            {
+                return;
+            }
+            else if (area < 0.0f)
+            {
+                std::swap(vertex1, vertex2);
+                area = -area;
+            }
+
+            // Pixels are covered when their center is inside the triangle
+            const float minimumX = std::min({ vertex0.x, vertex1.x, vertex2.x });
+            const float maximumX = std::max({ vertex0.x, vertex1.x, vertex2.x });
+            const float minimumY = std::min({ vertex0.y, vertex1.y, vertex2.y });
+            const float maximumY = std::max({ vertex0.y, vertex1.y, vertex2.y });
+            const int32_t startX = (std::max(int32_t(std::ceil(minimumX - 0.5f)), 0) & ~3);
+            const int32_t endX = std::min(int32_t(std::floor(maximumX - 0.5f)), int32_t(width - 1));
+            const int32_t startY = std::max(int32_t(std::ceil(minimumY - 0.5f)), 0);
+            const int32_t endY = std::min(int32_t(std::floor(maximumY - 0.5f)), int32_t(height - 1));
+            if (startX > endX || startY > endY)
+            {
+                return;
+            }
+
+            // Edge functions and depth as planes over the screen, value = (a * x) + (b * y) + c
+            struct Edge
+            {
+                float a, b, c;
+            };
+
+            auto makeEdge = [](ScreenVertex const &from, ScreenVertex const &to) -> Edge
+            {
+                const float a = (from.y - to.y);
+                const float b = (to.x - from.x);
+                return { a, b, -((a * from.x) + (b * from.y)) };
+            };
+
+            const Edge edge0 = makeEdge(vertex1, vertex2);
+            const Edge edge1 = makeEdge(vertex2, vertex0);
+            const Edge edge2 = makeEdge(vertex0, vertex1);
+            const float inverseArea = (1.0f / area);
+            const Edge depth =
+            {
+                (((edge0.a * vertex0.z) + (edge1.a * vertex1.z) + (edge2.a * vertex2.z)) * inverseArea),
+                (((edge0.b * vertex0.z) + (edge1.b * vertex1.z) + (edge2.b * vertex2.z)) * inverseArea),
+                (((edge0.c * vertex0.z) + (edge1.c * vertex1.z) + (edge2.c * vertex2.z)) * inverseArea),
+            };
+
+            const auto zero = _mm_setzero_ps();
+            const auto pixelOffset = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+            const auto edge0A = _mm_set1_ps(edge0.a);
+            const auto edge1A = _mm_set1_ps(edge1.a);
+            const auto edge2A = _mm_set1_ps(edge2.a);
+            const auto depthA = _mm_set1_ps(depth.a);
+            auto &depthList = levelList[0];
+            for (int32_t y = startY; y <= endY; ++y)
+            {
+                const float centerY = (float(y) + 0.5f);
+                const auto edge0Row = _mm_set1_ps((edge0.b * centerY) + edge0.c);
+                const auto edge1Row = _mm_set1_ps((edge1.b * centerY) + edge1.c);
+                const auto edge2Row = _mm_set1_ps((edge2.b * centerY) + edge2.c);
+                const auto depthRow = _mm_set1_ps((depth.b * centerY) + depth.c);
+                float *row = &depthList[y * width];
+                for (int32_t x = startX; x <= endX; x += 4)
+                {
+                    const auto centerX = _mm_add_ps(_mm_set1_ps(float(x)), pixelOffset);
+                    auto isInside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edge0A, centerX), edge0Row), zero);
+                    isInside = _mm_and_ps(isInside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edge1A, centerX), edge1Row), zero));
+                    isInside = _mm_and_ps(isInside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edge2A, centerX), edge2Row), zero));
+                    if (_mm_movemask_ps(isInside) == 0)
+                    {
+                        continue;
+                    }
+
+                    const auto pixelDepth = _mm_add_ps(_mm_mul_ps(depthA, centerX), depthRow);
+                    const auto currentDepth = _mm_load_ps(&row[x]);
+                    const auto nearestDepth = _mm_min_ps(currentDepth, pixelDepth);
+                    _mm_store_ps(&row[x], _mm_or_ps(_mm_and_ps(isInside, nearestDepth), _mm_andnot_ps(isInside, currentDepth)));
+                }
+            }
+        }
+
+        void OcclusionBuffer::finalize(void) noexcept
+        {
+            for (size_t level = 1; level < levelList.size(); ++level)
+            {
+                auto const &sourceList = levelList[level - 1];
+                const uint32_t sourceWidth = levelWidthList[level - 1];
+                const uint32_t sourceHeight = levelHeightList[level - 1];
+                auto &targetList = levelList[level];
+                const uint32_t targetWidth = levelWidthList[level];
+                const uint32_t targetHeight = levelHeightList[level];
+                for (uint32_t y = 0; y < targetHeight; ++y)
+                {
+                    const uint32_t sourceY0 = (y * 2);
+                    const uint32_t sourceY1 = std::min((sourceY0 + 1), (sourceHeight - 1));
+                    for (uint32_t x = 0; x < targetWidth; ++x)
+                    {
+                        const uint32_t sourceX0 = (x * 2);
+                        const uint32_t sourceX1 = std::min((sourceX0 + 1), (sourceWidth - 1));
+                        targetList[(y * targetWidth) + x] = std::max(
+                            std::max(sourceList[(sourceY0 * sourceWidth) + sourceX0], sourceList[(sourceY0 * sourceWidth) + sourceX1]),
+                            std::max(sourceList[(sourceY1 * sourceWidth) + sourceX0], sourceList[(sourceY1 * sourceWidth) + sourceX1]));
+                    }
+                }
+            }
+        }
+
+        bool OcclusionBuffer::isVisible(AlignedBox const &box, Math::Float4x4 const &matrix) const noexcept
+        {
+            if (occluderCount == 0)
+            {
+                return true;
+            }
+
+            const auto worldViewProjectionMatrix(matrix * viewProjectionMatrix);
+            const float halfWidth = (float(width) * 0.5f);
+            const float halfHeight = (float(height) * 0.5f);
+            float minimumX = Math::Infinity, maximumX = Math::NegativeInfinity;
+            float minimumY = Math::Infinity, maximumY = Math::NegativeInfinity;
+            float minimumDepth = Math::Infinity;
+            for (uint32_t corner = 0; corner < 8; ++corner)
+            {
+                auto clip = worldViewProjectionMatrix.transform(Math::Float4(GetCorner(box, corner), 1.0f));
+                if (clip.w <= Math::Epsilon)
+                {
+                    return true;
+                }
+
+                const float inverseW = (1.0f / clip.w);
+                const float x = (((clip.x * inverseW) + 1.0f) * halfWidth);
+                const float y = ((1.0f - (clip.y * inverseW)) * halfHeight);
+                const float depth = normalizeDepth(clip.z * inverseW);
+                if (depth < 0.0f)
+                {
+                    return true;
+                }
+
+                minimumX = std::min(minimumX, x);
+                maximumX = std::max(maximumX, x);
+                minimumY = std::min(minimumY, y);
+                maximumY = std::max(maximumY, y);
+                minimumDepth = std::min(minimumDepth, depth);
+            }
+
+            if (maximumX < 0.0f || maximumY < 0.0f || minimumX >= float(width) || minimumY >= float(height))
+            {
+                return true;
+            }
+
+            // Every pixel the screen rectangle touches, not just the ones whose centers it covers
+            const uint32_t pixelStartX = uint32_t(std::max(minimumX, 0.0f));
+            const uint32_t pixelStartY = uint32_t(std::max(minimumY, 0.0f));
+            const uint32_t pixelEndX = std::min(uint32_t(maximumX), (width - 1));
+            const uint32_t pixelEndY = std::min(uint32_t(maximumY), (height - 1));
+
+            // Start from the coarsest level where the rectangle still spans at most 2x2 tiles
+            uint32_t level = 0;
+            while ((level + 1) < levelList.size() &&
+                   (((pixelEndX >> level) - (pixelStartX >> level)) > 1 || ((pixelEndY >> level) - (pixelStartY >> level)) > 1))
+            {
+                ++level;
+            }
+
+            return isRegionVisible(level, (pixelStartX >> level), (pixelStartY >> level), (pixelEndX >> level), (pixelEndY >> level),
+                                   pixelStartX, pixelStartY, pixelEndX, pixelEndY, minimumDepth);
+        }
+
+        bool OcclusionBuffer::isRegionVisible(uint32_t level, uint32_t tileStartX, uint32_t tileStartY, uint32_t tileEndX, uint32_t tileEndY,
+                                              uint32_t pixelStartX, uint32_t pixelStartY, uint32_t pixelEndX, uint32_t pixelEndY, float minimumDepth) const noexcept
+        {
+            auto const &depthList = levelList[level];
+            const uint32_t levelWidth = levelWidthList[level];
+            for (uint32_t y = tileStartY; y <= tileEndY; ++y)
+            {
+                for (uint32_t x = tileStartX; x <= tileEndX; ++x)
+                {
+                    // Hidden tile, the nearest point of the box is behind the farthest occluder in it
+                    if (minimumDepth > depthList[(y * levelWidth) + x])
+                    {
+                        continue;
+                    }
+                    else if (level == 0)
+                    {
+                        return true;
+                    }
+
+                    const uint32_t childLevel = (level - 1);
+                    const uint32_t childStartX = std::max((x * 2), (pixelStartX >> childLevel));
+                    const uint32_t childStartY = std::max((y * 2), (pixelStartY >> childLevel));
+                    const uint32_t childEndX = std::min(((x * 2) + 1), (pixelEndX >> childLevel));
+                    const uint32_t childEndY = std::min(((y * 2) + 1), (pixelEndY >> childLevel));
+                    if (isRegionVisible(childLevel, childStartX, childStartY, childEndX, childEndY, pixelStartX, pixelStartY, pixelEndX, pixelEndY, minimumDepth))
+                    {
+                        return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+    }; // namespace Shapes
+}; // namespace Gek
@@ -5,4 +5,16 @@ using namespace Gek::Math;
 
 TEST(AlignedBox, Initialize)
 {
-}
\ No newline at end of file
+}
+
+TEST(AlignedBox, Contains)
+{
+    Gek::Shapes::AlignedBox box(Float3(-1.0f), Float3(1.0f));
+    EXPECT_TRUE(box.contains(Gek::Shapes::AlignedBox(Float3(-0.5f), Float3(0.5f))));
+    EXPECT_TRUE(box.contains(box));
+    EXPECT_FALSE(box.contains(Gek::Shapes::AlignedBox(Float3(0.5f), Float3(1.5f))));
+
+    box.extend(Gek::Shapes::AlignedBox(Float3(0.5f), Float3(1.5f)));
+    EXPECT_EQ(box.maximum, Float3(1.5f));
+    EXPECT_FLOAT_EQ(box.getSurfaceArea(), (6.0f * 2.5f * 2.5f));
+}
@@ -0,0 +1,177 @@
+#include "GEK/Shapes/BoundingVolumeHierarchy.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace Gek::Math;
+
+namespace
+{
+    Gek::Shapes::AlignedBox MakeBox(std::mt19937 &generator)
+    {
+        std::uniform_real_distribution<float> positionDistribution(-200.0f, 200.0f);
+        std::uniform_real_distribution<float> sizeDistribution(0.1f, 5.0f);
+        Float3 position(positionDistribution(generator), positionDistribution(generator), positionDistribution(generator));
+        Float3 halfSize(sizeDistribution(generator), sizeDistribution(generator), sizeDistribution(generator));
+        return Gek::Shapes::AlignedBox((position - halfSize), (position + halfSize));
+    }
+
+    std::set<uint64_t> QueryTree(Gek::Shapes::BoundingVolumeHierarchy const &tree, Gek::Shapes::Frustum const &frustum)
+    {
+        std::set<uint64_t> visibleSet;
+        tree.query(frustum, [&](uint64_t userData, bool isInside) -> void
+        {
+            EXPECT_TRUE(visibleSet.insert(userData).second);
+        });
+
+        return visibleSet;
+    }
+
+    std::set<uint64_t> QueryBruteForce(Gek::Shapes::BoundingVolumeHierarchy const &tree, std::vector<uint32_t> const &proxyList, Gek::Shapes::Frustum const &frustum)
+    {
+        std::set<uint64_t> visibleSet;
+        for (auto proxy : proxyList)
+        {
+            if (frustum.getContainment(tree.getFatBox(proxy)) != Gek::Shapes::Frustum::Containment::Outside)
+            {
+                visibleSet.insert(tree.getUserData(proxy));
+            }
+        }
+
+        return visibleSet;
+    }
+
+    Gek::Shapes::Frustum MakeFrustum(void)
+    {
+        auto viewMatrix(Float4x4::MakeQuaternionRotation(Quaternion::MakeEulerRotation(0.2f, 0.9f, 0.0f), Float3(10.0f, 5.0f, -20.0f)).getInverse());
+        auto projectionMatrix(Float4x4::MakePerspective(DegreesToRadians(70.0f), 1.5f, 0.5f, 150.0f));
+        return Gek::Shapes::Frustum(viewMatrix * projectionMatrix);
+    }
+}; // namespace
+
+TEST(BoundingVolumeHierarchy, CreateAndDestroy)
+{
+    std::mt19937 generator(1234);
+    Gek::Shapes::BoundingVolumeHierarchy tree;
+    std::vector<uint32_t> proxyList;
+    for (uint64_t index = 0; index < 1000; ++index)
+    {
+        proxyList.push_back(tree.createProxy(MakeBox(generator), index));
+    }
+
+    EXPECT_TRUE(tree.validate());
+    EXPECT_EQ(tree.getProxyCount(), 1000);
+    EXPECT_LE(tree.getHeight(), 20);
+
+    for (size_t index = 0; index < proxyList.size(); index += 2)
+    {
+        tree.destroyProxy(proxyList[index]);
+    }
+
+    EXPECT_TRUE(tree.validate());
+    EXPECT_EQ(tree.getProxyCount(), 500);
+
+    for (size_t index = 1; index < proxyList.size(); index += 2)
+    {
+        tree.destroyProxy(proxyList[index]);
+    }
+
+    EXPECT_TRUE(tree.validate());
+    EXPECT_EQ(tree.getProxyCount(), 0);
+    EXPECT_EQ(tree.getHeight(), 0);
+}
+
+TEST(BoundingVolumeHierarchy, MoveProxy)
+{
+    Gek::Shapes::BoundingVolumeHierarchy tree(0.5f);
+    auto proxy = tree.createProxy(Gek::Shapes::AlignedBox(Float3(-1.0f), Float3(1.0f)), 7);
+    tree.createProxy(Gek::Shapes::AlignedBox(Float3(9.0f), Float3(11.0f)), 8);
+
+    EXPECT_FALSE(tree.moveProxy(proxy, Gek::Shapes::AlignedBox(Float3(-0.8f), Float3(1.2f))));
+    EXPECT_TRUE(tree.moveProxy(proxy, Gek::Shapes::AlignedBox(Float3(20.0f), Float3(30.0f))));
+    EXPECT_TRUE(tree.getFatBox(proxy).contains(Gek::Shapes::AlignedBox(Float3(20.0f), Float3(30.0f))));
+    EXPECT_EQ(tree.getUserData(proxy), 7);
+    EXPECT_TRUE(tree.validate());
+
+    // Shrinking well inside the old bounds tightens them again
+    EXPECT_TRUE(tree.moveProxy(proxy, Gek::Shapes::AlignedBox(Float3(24.9f), Float3(25.0f))));
+    EXPECT_TRUE(tree.validate());
+}
+
+TEST(BoundingVolumeHierarchy, FrustumQueryMatchesBruteForce)
+{
+    std::mt19937 generator(4321);
+    Gek::Shapes::BoundingVolumeHierarchy tree;
+    std::vector<uint32_t> proxyList;
+    for (uint64_t index = 0; index < 2000; ++index)
+    {
+        proxyList.push_back(tree.createProxy(MakeBox(generator), index));
+    }
+
+    auto frustum(MakeFrustum());
+    auto expectedSet = QueryBruteForce(tree, proxyList, frustum);
+    EXPECT_FALSE(expectedSet.empty());
+    EXPECT_EQ(QueryTree(tree, frustum), expectedSet);
+
+    // Leaves reported as inside must really be inside
+    tree.query(frustum, [&](uint64_t userData, bool isInside) -> void
+    {
+        if (isInside)
+        {
+            EXPECT_EQ(frustum.getContainment(tree.getFatBox(proxyList[userData])), Gek::Shapes::Frustum::Containment::Inside);
+        }
+    });
+
+    for (auto proxy : proxyList)
+    {
+        tree.moveProxy(proxy, MakeBox(generator));
+    }
+
+    EXPECT_TRUE(tree.validate());
+    EXPECT_EQ(QueryTree(tree, frustum), QueryBruteForce(tree, proxyList, frustum));
+}
+
+TEST(BoundingVolumeHierarchy, Rebuild)
+{
+    std::mt19937 generator(5678);
+    Gek::Shapes::BoundingVolumeHierarchy tree;
+    std::vector<uint32_t> proxyList;
+    for (uint64_t index = 0; index < 1024; ++index)
+    {
+        proxyList.push_back(tree.createProxy(MakeBox(generator), index));
+    }
+
+    auto frustum(MakeFrustum());
+    auto expectedSet = QueryTree(tree, frustum);
+
+    tree.rebuild();
+    EXPECT_TRUE(tree.validate());
+    EXPECT_EQ(tree.getHeight(), 10);
+    EXPECT_EQ(QueryTree(tree, frustum), expectedSet);
+
+    // Incremental changes keep working on top of a rebuilt tree
+    tree.destroyProxy(proxyList.back());
+    proxyList.back() = tree.createProxy(MakeBox(generator), 1023);
+    EXPECT_TRUE(tree.validate());
+    EXPECT_EQ(QueryTree(tree, frustum), QueryBruteForce(tree, proxyList, frustum));
+}
+
+TEST(BoundingVolumeHierarchy, BoxQuery)
+{
+    Gek::Shapes::BoundingVolumeHierarchy tree(0.0f);
+    for (uint64_t index = 0; index < 10; ++index)
+    {
+        auto position(Float3(float(index) * 10.0f, 0.0f, 0.0f));
+        tree.createProxy(Gek::Shapes::AlignedBox((position - 1.0f), (position + 1.0f)), index);
+    }
+
+    std::set<uint64_t> foundSet;
+    tree.query(Gek::Shapes::AlignedBox(Float3(15.0f, -1.0f, -1.0f), Float3(35.0f, 1.0f, 1.0f)), [&](uint64_t userData) -> void
+    {
+        foundSet.insert(userData);
+    });
+
+    EXPECT_EQ(foundSet, std::set<uint64_t>({ 2, 3 }));
+}
@@ -5,4 +5,14 @@ using namespace Gek::Math;
 
 TEST(Frustum, Initialize)
 {
-}
\ No newline at end of file
+}
+
+TEST(Frustum, GetContainment)
+{
+    Gek::Shapes::Frustum frustum(Float4x4::MakePerspective(DegreesToRadians(90.0f), 1.0f, 1.0f, 100.0f));
+    EXPECT_EQ(frustum.getContainment(Gek::Shapes::AlignedBox(Float3(-1.0f, -1.0f, 9.0f), Float3(1.0f, 1.0f, 11.0f))), Gek::Shapes::Frustum::Containment::Inside);
+    EXPECT_EQ(frustum.getContainment(Gek::Shapes::AlignedBox(Float3(-1.0f, -1.0f, -11.0f), Float3(1.0f, 1.0f, -9.0f))), Gek::Shapes::Frustum::Containment::Outside);
+    EXPECT_EQ(frustum.getContainment(Gek::Shapes::AlignedBox(Float3(-1.0f, -1.0f, 0.0f), Float3(1.0f, 1.0f, 2.0f))), Gek::Shapes::Frustum::Containment::Intersecting);
+    EXPECT_EQ(frustum.getContainment(Gek::Shapes::AlignedBox(Float3(-1.0f, -1.0f, 99.0f), Float3(1.0f, 1.0f, 101.0f))), Gek::Shapes::Frustum::Containment::Intersecting);
+    EXPECT_EQ(frustum.getContainment(Gek::Shapes::AlignedBox(Float3(50.0f, -1.0f, 9.0f), Float3(52.0f, 1.0f, 11.0f))), Gek::Shapes::Frustum::Containment::Outside);
+}
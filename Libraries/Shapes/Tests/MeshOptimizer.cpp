@@ -0,0 +1,262 @@
+#include "GEK/Shapes/MeshOptimizer.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+
+using namespace Gek::Math;
+using namespace Gek::Shapes;
+
+namespace
+{
+    // Two triangles per cell of a size by size grid of shared vertices
+    std::vector<uint32_t> MakeGrid(uint32_t size)
+    {
+        std::vector<uint32_t> indexList;
+        for (uint32_t y = 0; y < size; ++y)
+        {
+            for (uint32_t x = 0; x < size; ++x)
+            {
+                uint32_t corner = ((y * (size + 1)) + x);
+                indexList.insert(std::end(indexList), { corner, (corner + size + 1), (corner + 1) });
+                indexList.insert(std::end(indexList), { (corner + 1), (corner + size + 1), (corner + size + 2) });
+            }
+        }
+
+        return indexList;
+    }
+
+    std::vector<std::array<uint32_t, 3>> GetSortedTriangles(std::vector<uint32_t> const &indexList)
+    {
+        std::vector<std::array<uint32_t, 3>> triangleList;
+        for (size_t index = 0; index < indexList.size(); index += 3)
+        {
+            // Rotate so the lowest index comes first, keeping the winding
+            std::array<uint32_t, 3> triangle = { indexList[index], indexList[index + 1], indexList[index + 2] };
+            std::rotate(std::begin(triangle), std::min_element(std::begin(triangle), std::end(triangle)), std::end(triangle));
+            triangleList.push_back(triangle);
+        }
+
+        std::sort(std::begin(triangleList), std::end(triangleList));
+        return triangleList;
+    }
+}; // namespace
+
+TEST(MeshOptimizer, WeldDuplicateVertices)
+{
+    std::vector<Float3> vertexList =
+    {
+        Float3(0.0f, 0.0f, 0.0f),
+        Float3(1.0f, 0.0f, 0.0f),
+        Float3(0.0f, 1.0f, 0.0f),
+        Float3(1.0f, 0.0f, 0.0f),
+        Float3(1.0f, 1.0f, 0.0f),
+        Float3(0.0f, 1.0f, 0.0f),
+    };
+
+    std::vector<uint32_t> remapList;
+    auto uniqueCount = MeshOptimizer::GenerateVertexRemap(vertexList.data(), uint32_t(vertexList.size()), sizeof(Float3), remapList);
+    EXPECT_EQ(uniqueCount, 4);
+    EXPECT_EQ(remapList, std::vector<uint32_t>({ 0, 1, 2, 1, 3, 2 }));
+
+    auto weldedList = MeshOptimizer::RemapVertices(vertexList, remapList, uniqueCount);
+    ASSERT_EQ(weldedList.size(), 4);
+    EXPECT_EQ(weldedList[3].x, 1.0f);
+    EXPECT_EQ(weldedList[3].y, 1.0f);
+
+    std::vector<uint32_t> indexList = { 0, 1, 2, 3, 4, 5 };
+    MeshOptimizer::RemapIndices(indexList, remapList);
+    EXPECT_EQ(indexList, std::vector<uint32_t>({ 0, 1, 2, 1, 3, 2 }));
+}
+
+TEST(MeshOptimizer, VertexCacheKeepsTrianglesAndReducesMisses)
+{
+    static constexpr uint32_t GridSize = 32;
+    static constexpr uint32_t VertexCount = ((GridSize + 1) * (GridSize + 1));
+
+    // Worst case ordering, each triangle only shares vertices with ones far away in the list
+    auto sourceList = MakeGrid(GridSize);
+    std::vector<uint32_t> indexList;
+    for (uint32_t stride = 0; stride < 7; ++stride)
+    {
+        for (size_t triangle = stride; triangle < (sourceList.size() / 3); triangle += 7)
+        {
+            indexList.insert(std::end(indexList), (std::begin(sourceList) + (triangle * 3)), (std::begin(sourceList) + (triangle * 3) + 3));
+        }
+    }
+
+    auto originalRatio = MeshOptimizer::GetCacheMissRatio(indexList, VertexCount);
+    auto originalTriangles = GetSortedTriangles(indexList);
+    auto clusterList = MeshOptimizer::OptimizeVertexCache(indexList, VertexCount);
+    auto optimizedRatio = MeshOptimizer::GetCacheMissRatio(indexList, VertexCount);
+
+    EXPECT_EQ(GetSortedTriangles(indexList), originalTriangles);
+    EXPECT_FALSE(clusterList.empty());
+    EXPECT_EQ(clusterList.front(), 0);
+    EXPECT_LT(optimizedRatio, originalRatio);
+    EXPECT_LT(optimizedRatio, 1.0f);
+}
+
+TEST(MeshOptimizer, OverdrawKeepsTriangles)
+{
+    static constexpr uint32_t GridSize = 16;
+    static constexpr uint32_t VertexCount = ((GridSize + 1) * (GridSize + 1));
+
+    // Fold the grid in to a hill so the clusters face different ways
+    std::vector<Float3> positionList;
+    for (uint32_t y = 0; y <= GridSize; ++y)
+    {
+        for (uint32_t x = 0; x <= GridSize; ++x)
+        {
+            float offsetX = (float(x) - (GridSize * 0.5f));
+            float offsetY = (float(y) - (GridSize * 0.5f));
+            positionList.push_back(Float3(float(x), float(y), -((offsetX * offsetX) + (offsetY * offsetY)) * 0.1f));
+        }
+    }
+
+    auto indexList = MakeGrid(GridSize);
+    auto originalTriangles = GetSortedTriangles(indexList);
+    auto clusterList = MeshOptimizer::OptimizeVertexCache(indexList, VertexCount, 8);
+    MeshOptimizer::OptimizeOverdraw(indexList, clusterList, positionList.data(), VertexCount);
+    EXPECT_EQ(indexList.size(), (GridSize * GridSize * 6));
+    EXPECT_EQ(GetSortedTriangles(indexList), originalTriangles);
+}
+
+TEST(MeshOptimizer, OverdrawIgnoresMissingVertices)
+{
+    std::vector<Float3> positionList = { Float3(0.0f, 0.0f, 0.0f), Float3(1.0f, 0.0f, 0.0f), Float3(0.0f, 1.0f, 0.0f) };
+    std::vector<uint32_t> indexList = { 0, 1, 2, 0, 1, 9 };
+    std::vector<uint32_t> clusterList = { 0, 3 };
+    MeshOptimizer::OptimizeOverdraw(indexList, clusterList, positionList.data(), static_cast<uint32_t>(positionList.size()));
+    EXPECT_EQ(GetSortedTriangles(indexList), GetSortedTriangles({ 0, 1, 2, 0, 1, 9 }));
+}
+
+TEST(MeshOptimizer, VertexFetchIsSequential)
+{
+    std::vector<uint32_t> indexList = { 7, 3, 5, 3, 7, 1 };
+    std::vector<uint32_t> remapList;
+    auto usedCount = MeshOptimizer::OptimizeVertexFetch(indexList, 8, remapList);
+    EXPECT_EQ(usedCount, 4);
+    EXPECT_EQ(indexList, std::vector<uint32_t>({ 0, 1, 2, 1, 0, 3 }));
+    EXPECT_EQ(remapList[7], 0);
+    EXPECT_EQ(remapList[1], 3);
+    EXPECT_EQ(remapList[0], ~0u);
+
+    std::vector<uint32_t> valueList = { 0, 10, 20, 30, 40, 50, 60, 70 };
+    auto fetchList = MeshOptimizer::RemapVertices(valueList, remapList, usedCount);
+    EXPECT_EQ(fetchList, std::vector<uint32_t>({ 70, 30, 50, 10 }));
+}
+
+TEST(MeshOptimizer, SimplifyFlatGridKeepsBorder)
+{
+    static constexpr uint32_t GridSize = 8;
+    static constexpr uint32_t VertexCount = ((GridSize + 1) * (GridSize + 1));
+
+    std::vector<Float3> positionList;
+    for (uint32_t y = 0; y <= GridSize; ++y)
+    {
+        for (uint32_t x = 0; x <= GridSize; ++x)
+        {
+            positionList.push_back(Float3(float(x), float(y), 0.0f));
+        }
+    }
+
+    auto indexList = MakeGrid(GridSize);
+    float error = 1.0f;
+    auto simplifiedList = MeshOptimizer::Simplify(indexList, positionList.data(), VertexCount, 0, 0.01f, &error);
+    EXPECT_LT(simplifiedList.size(), indexList.size());
+    EXPECT_NEAR(error, 0.0f, 1.0e-4f);
+
+    // Only interior vertices collapse, the border still covers the whole grid with the grid's clockwise winding
+    float area = 0.0f;
+    for (size_t index = 0; index < simplifiedList.size(); index += 3)
+    {
+        auto const &first = positionList[simplifiedList[index]];
+        auto normal = (positionList[simplifiedList[index + 1]] - first).cross(positionList[simplifiedList[index + 2]] - first);
+        EXPECT_LT(normal.z, 0.0f);
+        area -= (normal.z * 0.5f);
+    }
+
+    EXPECT_NEAR(area, float(GridSize * GridSize), 1.0e-3f);
+}
+
+TEST(MeshOptimizer, SimplifyCurvedMeshStopsAtTarget)
+{
+    static constexpr uint32_t GridSize = 16;
+    static constexpr uint32_t VertexCount = ((GridSize + 1) * (GridSize + 1));
+
+    std::vector<Float3> positionList;
+    for (uint32_t y = 0; y <= GridSize; ++y)
+    {
+        for (uint32_t x = 0; x <= GridSize; ++x)
+        {
+            float offsetX = (float(x) - (GridSize * 0.5f));
+            float offsetY = (float(y) - (GridSize * 0.5f));
+            positionList.push_back(Float3(float(x), float(y), -((offsetX * offsetX) + (offsetY * offsetY)) * 0.1f));
+        }
+    }
+
+    auto indexList = MakeGrid(GridSize);
+    size_t targetIndexCount = (indexList.size() / 4);
+    float error = 0.0f;
+    auto simplifiedList = MeshOptimizer::Simplify(indexList, positionList.data(), VertexCount, targetIndexCount, 10.0f, &error);
+    EXPECT_LE(simplifiedList.size(), (indexList.size() / 2));
+    EXPECT_GE(simplifiedList.size(), (targetIndexCount - 6));
+    EXPECT_GT(error, 0.0f);
+    EXPECT_EQ((simplifiedList.size() % 3), 0);
+    for (size_t index = 0; index < simplifiedList.size(); index += 3)
+    {
+        EXPECT_LT(simplifiedList[index], VertexCount);
+        EXPECT_NE(simplifiedList[index + 0], simplifiedList[index + 1]);
+        EXPECT_NE(simplifiedList[index + 1], simplifiedList[index + 2]);
+        EXPECT_NE(simplifiedList[index + 2], simplifiedList[index + 0]);
+    }
+
+    // A tight error bound leaves the curved surface alone
+    auto tightList = MeshOptimizer::Simplify(indexList, positionList.data(), VertexCount, targetIndexCount, 1.0e-6f, &error);
+    EXPECT_EQ(tightList.size(), indexList.size());
+}
+
+TEST(MeshOptimizer, BuildMeshletsCoversTrianglesWithinLimits)
+{
+    static constexpr uint32_t GridSize = 32;
+    static constexpr uint32_t VertexCount = ((GridSize + 1) * (GridSize + 1));
+
+    std::vector<Float3> positionList;
+    for (uint32_t y = 0; y <= GridSize; ++y)
+    {
+        for (uint32_t x = 0; x <= GridSize; ++x)
+        {
+            positionList.push_back(Float3(float(x), float(y), 0.0f));
+        }
+    }
+
+    auto indexList = MakeGrid(GridSize);
+    MeshOptimizer::OptimizeVertexCache(indexList, VertexCount);
+    auto meshletList = MeshOptimizer::BuildMeshlets(indexList, positionList.data(), VertexCount);
+    ASSERT_FALSE(meshletList.empty());
+
+    uint32_t nextIndex = 0;
+    for (auto const &meshlet : meshletList)
+    {
+        EXPECT_EQ(meshlet.firstIndex, nextIndex);
+        EXPECT_GT(meshlet.indexCount, 0);
+        EXPECT_LE(meshlet.indexCount, (124 * 3));
+        nextIndex += meshlet.indexCount;
+
+        std::vector<uint32_t> vertexList(std::next(std::begin(indexList), meshlet.firstIndex), std::next(std::begin(indexList), (meshlet.firstIndex + meshlet.indexCount)));
+        std::sort(std::begin(vertexList), std::end(vertexList));
+        vertexList.erase(std::unique(std::begin(vertexList), std::end(vertexList)), std::end(vertexList));
+        EXPECT_LE(vertexList.size(), 64);
+        for (auto vertex : vertexList)
+        {
+            EXPECT_LE(positionList[vertex].getDistance(meshlet.center), (meshlet.radius + 1.0e-4f));
+        }
+
+        // The grid winds clockwise when seen from positive z, so every normal points down
+        EXPECT_NEAR(meshlet.coneAxis.z, -1.0f, 1.0e-4f);
+        EXPECT_NEAR(meshlet.coneCutoff, 0.0f, 1.0e-2f);
+    }
+
+    EXPECT_EQ(nextIndex, indexList.size());
+    EXPECT_LT(meshletList.size(), (indexList.size() / 3 / 16));
+}
@@ -0,0 +1,100 @@
+#include "GEK/Shapes/OcclusionBuffer.hpp"
+#include <gtest/gtest.h>
+
+using namespace Gek::Math;
+
+namespace
+{
+    Gek::Shapes::AlignedBox MakeBox(Float3 const &center, Float3 const &halfSize)
+    {
+        return Gek::Shapes::AlignedBox((center - halfSize), (center + halfSize));
+    }
+
+    Float4x4 GetProjectionMatrix(void)
+    {
+        return Float4x4::MakePerspective(DegreesToRadians(90.0f), 2.0f, 1.0f, 100.0f);
+    }
+}; // namespace
+
+TEST(OcclusionBuffer, Initialize)
+{
+    Gek::Shapes::OcclusionBuffer buffer(250, 100);
+    EXPECT_EQ(buffer.getWidth(), 252);
+    EXPECT_EQ(buffer.getHeight(), 100);
+    EXPECT_FLOAT_EQ(buffer.getDepth(0, 0), 1.0f);
+}
+
+TEST(OcclusionBuffer, NothingOccludedWithoutOccluders)
+{
+    Gek::Shapes::OcclusionBuffer buffer;
+    buffer.clear(Float4x4::Identity, GetProjectionMatrix());
+    buffer.finalize();
+    EXPECT_TRUE(buffer.isVisible(MakeBox(Float3(0.0f, 0.0f, 50.0f), Float3::One), Float4x4::Identity));
+}
+
+TEST(OcclusionBuffer, WallHidesBoxesBehindIt)
+{
+    Gek::Shapes::OcclusionBuffer buffer;
+    buffer.clear(Float4x4::Identity, GetProjectionMatrix());
+    buffer.addOccluder(MakeBox(Float3::Zero, Float3(10.0f, 10.0f, 0.5f)), Float4x4::MakeTranslation(Float3(0.0f, 0.0f, 10.0f)));
+    buffer.finalize();
+    EXPECT_EQ(buffer.getOccluderCount(), 1);
+
+    // Center of the screen sees the front face of the wall
+    auto clip = GetProjectionMatrix().transform(Float4(0.0f, 0.0f, 9.5f, 1.0f));
+    EXPECT_NEAR(buffer.getDepth(buffer.getWidth() / 2, buffer.getHeight() / 2), (clip.z / clip.w), 1.0e-4f);
+
+    EXPECT_FALSE(buffer.isVisible(MakeBox(Float3(0.0f, 0.0f, 30.0f), Float3(2.0f)), Float4x4::Identity));
+    EXPECT_FALSE(buffer.isVisible(MakeBox(Float3(4.0f, -3.0f, 20.0f), Float3::One), Float4x4::Identity));
+    EXPECT_TRUE(buffer.isVisible(MakeBox(Float3(0.0f, 0.0f, 5.0f), Float3::One), Float4x4::Identity));
+
+    // Behind the wall but sticking out past its edge
+    EXPECT_TRUE(buffer.isVisible(MakeBox(Float3(25.0f, 0.0f, 30.0f), Float3(8.0f, 1.0f, 1.0f)), Float4x4::Identity));
+
+    // Crossing the near plane is always visible
+    EXPECT_TRUE(buffer.isVisible(MakeBox(Float3(0.0f, 0.0f, 1.0f), Float3::One), Float4x4::Identity));
+
+    // Rotated and moved through the matrix instead of the box
+    auto matrix(Float4x4::MakeQuaternionRotation(Quaternion::MakeEulerRotation(0.4f, 0.8f, 0.0f), Float3(0.0f, 0.0f, 40.0f)));
+    EXPECT_FALSE(buffer.isVisible(MakeBox(Float3::Zero, Float3(3.0f)), matrix));
+}
+
+TEST(OcclusionBuffer, OccludersCrossingTheNearPlaneAreSkipped)
+{
+    Gek::Shapes::OcclusionBuffer buffer;
+    buffer.clear(Float4x4::Identity, GetProjectionMatrix());
+    buffer.addOccluder(MakeBox(Float3(0.0f, 0.0f, 5.0f), Float3(10.0f, 10.0f, 5.0f)), Float4x4::Identity);
+    buffer.finalize();
+    EXPECT_EQ(buffer.getOccluderCount(), 0);
+    EXPECT_TRUE(buffer.isVisible(MakeBox(Float3(0.0f, 0.0f, 30.0f), Float3::One), Float4x4::Identity));
+}
+
+TEST(OcclusionBuffer, PartiallyCoveredBoxStaysVisible)
+{
+    Gek::Shapes::OcclusionBuffer buffer;
+    buffer.clear(Float4x4::Identity, GetProjectionMatrix());
+
+    // Two pillars with a gap between them
+    buffer.addOccluder(MakeBox(Float3(-6.0f, 0.0f, 10.0f), Float3(5.0f, 10.0f, 0.5f)), Float4x4::Identity);
+    buffer.addOccluder(MakeBox(Float3(6.0f, 0.0f, 10.0f), Float3(5.0f, 10.0f, 0.5f)), Float4x4::Identity);
+    buffer.finalize();
+
+    EXPECT_TRUE(buffer.isVisible(MakeBox(Float3(0.0f, 0.0f, 30.0f), Float3(4.0f, 1.0f, 1.0f)), Float4x4::Identity));
+    EXPECT_FALSE(buffer.isVisible(MakeBox(Float3(-12.0f, 0.0f, 30.0f), Float3(2.0f, 1.0f, 1.0f)), Float4x4::Identity));
+}
+
+TEST(OcclusionBuffer, ReversedDepth)
+{
+    auto projectionMatrix(Float4x4::MakePerspective(DegreesToRadians(90.0f), 2.0f, 100.0f, 1.0f));
+    Gek::Shapes::OcclusionBuffer buffer;
+    buffer.clear(Float4x4::Identity, projectionMatrix);
+    buffer.addOccluder(MakeBox(Float3::Zero, Float3(10.0f, 10.0f, 0.5f)), Float4x4::MakeTranslation(Float3(0.0f, 0.0f, 10.0f)));
+    buffer.finalize();
+    EXPECT_EQ(buffer.getOccluderCount(), 1);
+
+    auto clip = projectionMatrix.transform(Float4(0.0f, 0.0f, 9.5f, 1.0f));
+    EXPECT_NEAR(buffer.getDepth(buffer.getWidth() / 2, buffer.getHeight() / 2), (1.0f - (clip.z / clip.w)), 1.0e-4f);
+    EXPECT_FALSE(buffer.isVisible(MakeBox(Float3(0.0f, 0.0f, 30.0f), Float3(2.0f)), Float4x4::Identity));
+    EXPECT_TRUE(buffer.isVisible(MakeBox(Float3(0.0f, 0.0f, 5.0f), Float3::One), Float4x4::Identity));
+    EXPECT_TRUE(buffer.isVisible(MakeBox(Float3(0.0f, 0.0f, 1.0f), Float3::One), Float4x4::Identity));
+}
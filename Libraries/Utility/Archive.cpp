@@ -0,0 +1,432 @@
+#include "GEK/Utility/Archive.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+
+namespace Gek
+{
+    namespace Archive
+    {
+        namespace
+        {
+            char GetLowerCharacter(char character)
+            {
+                return static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+            }
+
+            // Forward slashes, no leading dot directory and no trailing slash, case is left alone
+            std::string GetNormalPath(std::string_view path)
+            {
+                std::string normalPath(path);
+                std::replace(std::begin(normalPath), std::end(normalPath), '\\', '/');
+                while (normalPath.starts_with("./"))
+                {
+                    normalPath.erase(0, 2);
+                }
+
+                while (!normalPath.empty() && normalPath.back() == '/')
+                {
+                    normalPath.pop_back();
+                }
+
+                return normalPath;
+            }
+
+            int ComparePaths(std::string_view left, std::string_view right)
+            {
+                const size_t length = std::min(left.size(), right.size());
+                for (size_t index = 0; index < length; ++index)
+                {
+                    const char leftCharacter = GetLowerCharacter(left[index]);
+                    const char rightCharacter = GetLowerCharacter(right[index]);
+                    if (leftCharacter != rightCharacter)
+                    {
+                        return (static_cast<unsigned char>(leftCharacter) < static_cast<unsigned char>(rightCharacter) ? -1 : 1);
+                    }
+                }
+
+                return (left.size() == right.size() ? 0 : (left.size() < right.size() ? -1 : 1));
+            }
+
+            bool StartsWithPath(std::string_view path, std::string_view prefix)
+            {
+                return (path.size() >= prefix.size() && ComparePaths(path.substr(0, prefix.size()), prefix) == 0);
+            }
+
+            template <typename TYPE>
+            void WriteValue(std::ofstream &file, TYPE const &value)
+            {
+                file.write(reinterpret_cast<char const *>(&value), sizeof(TYPE));
+            }
+
+            void WritePadding(std::ofstream &file, uint64_t &offset, uint64_t alignment)
+            {
+                static constexpr char Padding[256] = {};
+                const uint64_t alignedOffset = ((offset + alignment - 1) & ~(alignment - 1));
+                for (uint64_t remaining = (alignedOffset - offset); remaining > 0;)
+                {
+                    const uint64_t size = std::min(remaining, uint64_t(sizeof(Padding)));
+                    file.write(Padding, size);
+                    remaining -= size;
+                }
+
+                offset = alignedOffset;
+            }
+
+            struct MountPoint
+            {
+                std::string key;
+                std::shared_ptr<Reader const> reader;
+            };
+
+            std::shared_mutex mountMutex;
+            std::vector<MountPoint> mountList;
+
+            // Lets unmounted lookups skip the lock and the path conversion entirely
+            std::atomic_uint32_t mountCount = 0;
+
+            std::string GetMountKey(FileSystem::Path const &path)
+            {
+                auto key = GetNormalPath(path.data.lexically_normal().generic_string());
+                std::transform(std::begin(key), std::end(key), std::begin(key), GetLowerCharacter);
+                return key;
+            }
+        }; // namespace
+
+        uint64_t GetPathHash(std::string_view path)
+        {
+            uint64_t hash = 14695981039346656037ULL;
+            for (auto character : path)
+            {
+                hash ^= static_cast<uint8_t>(GetLowerCharacter(character == '\\' ? '/' : character));
+                hash *= 1099511628211ULL;
+            }
+
+            return hash;
+        }
+
+        Reader::Reader(FileSystem::Path const &archivePath)
+            : archivePath(archivePath)
+            , archiveView(FileSystem::Map(archivePath))
+        {
+            if (archiveView.getSize() < sizeof(Header))
+            {
+                return;
+            }
+
+            auto data = archiveView.getData();
+            const uint64_t size = archiveView.getSize();
+            auto archiveHeader = reinterpret_cast<Header const *>(data);
+            if (archiveHeader->identifier != Header().identifier || archiveHeader->version != Version)
+            {
+                return;
+            }
+
+            const uint64_t entryCount = archiveHeader->entryCount;
+            if ((archiveHeader->entryOffset % alignof(Entry)) != 0 ||
+                archiveHeader->entryOffset > size || (entryCount * sizeof(Entry)) > (size - archiveHeader->entryOffset) ||
+                archiveHeader->orderOffset > size || (entryCount * sizeof(uint32_t)) > (size - archiveHeader->orderOffset) ||
+                archiveHeader->nameOffset > size || archiveHeader->nameSize > (size - archiveHeader->nameOffset))
+            {
+                return;
+            }
+
+            auto archiveEntryList = reinterpret_cast<Entry const *>(data + archiveHeader->entryOffset);
+            auto archiveOrderList = reinterpret_cast<uint32_t const *>(data + archiveHeader->orderOffset);
+            for (uint32_t entryIndex = 0; entryIndex < entryCount; ++entryIndex)
+            {
+                auto const &entry = archiveEntryList[entryIndex];
+                if ((uint64_t(entry.nameOffset) + entry.nameLength) > archiveHeader->nameSize ||
+                    entry.offset > size || entry.storedSize > (size - entry.offset) ||
+                    archiveOrderList[entryIndex] >= entryCount)
+                {
+                    return;
+                }
+            }
+
+            header = archiveHeader;
+            entryList = archiveEntryList;
+            orderList = archiveOrderList;
+            nameList = reinterpret_cast<char const *>(data + archiveHeader->nameOffset);
+        }
+
+        Entry const *Reader::find(std::string_view path) const
+        {
+            if (!header)
+            {
+                return nullptr;
+            }
+
+            auto normalPath = GetNormalPath(path);
+            const uint64_t pathHash = GetPathHash(normalPath);
+            auto entryListEnd = (entryList + header->entryCount);
+            auto entrySearch = std::lower_bound(entryList, entryListEnd, pathHash, [](Entry const &entry, uint64_t pathHash) -> bool
+            {
+                return (entry.pathHash < pathHash);
+            });
+
+            for (; entrySearch != entryListEnd && entrySearch->pathHash == pathHash; ++entrySearch)
+            {
+                if (ComparePaths(getName(*entrySearch), normalPath) == 0)
+                {
+                    return entrySearch;
+                }
+            }
+
+            return nullptr;
+        }
+
+        FileSystem::FileView Reader::getView(Entry const &entry) const
+        {
+            if (entry.isDirectory())
+            {
+                return {};
+            }
+
+            auto storedView = archiveView.getView(entry.offset, entry.storedSize);
+            if (entry.compression == Compression::Type::None)
+            {
+                return storedView;
+            }
+
+            if (entry.compression == Compression::Type::LZ4)
+            {
+                auto buffer = std::make_shared_for_overwrite<uint8_t[]>(entry.size);
+                if (Compression::Decompress(storedView.getData(), storedView.getSize(), buffer.get(), entry.size))
+                {
+                    return FileSystem::FileView(buffer, buffer.get(), entry.size);
+                }
+            }
+
+            return {};
+        }
+
+        void Reader::findFiles(std::string_view directory, std::function<bool(Entry const &entry)> onEntryFound, bool recursive) const
+        {
+            if (!header)
+            {
+                return;
+            }
+
+            auto prefix = GetNormalPath(directory);
+            if (!prefix.empty())
+            {
+                prefix += '/';
+            }
+
+            // The order list sorts names without regard to case, so everything under the directory is one range
+            auto orderListEnd = (orderList + header->entryCount);
+            auto orderSearch = std::lower_bound(orderList, orderListEnd, prefix, [&](uint32_t entryIndex, std::string const &prefix) -> bool
+            {
+                return (ComparePaths(getName(entryList[entryIndex]), prefix) < 0);
+            });
+
+            for (; orderSearch != orderListEnd; ++orderSearch)
+            {
+                auto const &entry = entryList[*orderSearch];
+                auto name = getName(entry);
+                if (!StartsWithPath(name, prefix))
+                {
+                    break;
+                }
+
+                auto relativeName = name.substr(prefix.size());
+                if (recursive ? entry.isDirectory() : (relativeName.find('/') != std::string_view::npos))
+                {
+                    continue;
+                }
+
+                if (!onEntryFound(entry))
+                {
+                    return;
+                }
+            }
+        }
+
+        void Writer::addFile(std::string_view path, std::vector<uint8_t> &&data, bool compress)
+        {
+            fileList.push_back({ GetNormalPath(path), std::move(data), compress });
+        }
+
+        bool Writer::save(FileSystem::Path const &archivePath, uint32_t alignment) const
+        {
+            if (alignment == 0 || (alignment & (alignment - 1)) != 0 || alignment > 0xFFFF)
+            {
+                return false;
+            }
+
+            struct PathLess
+            {
+                bool operator()(std::string const &left, std::string const &right) const
+                {
+                    return (ComparePaths(left, right) < 0);
+                }
+            };
+
+            // Keyed without regard to case so that two spellings of one path collapse into one entry
+            std::map<std::string, File const *, PathLess> fileMap;
+            std::map<std::string, Entry, PathLess> entryMap;
+            for (auto const &file : fileList)
+            {
+                fileMap[file.path] = &file;
+                for (auto separator = file.path.find('/'); separator != std::string::npos; separator = file.path.find('/', separator + 1))
+                {
+                    auto &directoryEntry = entryMap[file.path.substr(0, separator)];
+                    directoryEntry.flags = Entry::Directory;
+                }
+            }
+
+            archivePath.getParentPath().createChain();
+            std::ofstream file(archivePath.getString(), std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                return false;
+            }
+
+            Header header;
+            header.alignment = static_cast<uint16_t>(alignment);
+            WriteValue(file, header);
+
+            uint64_t offset = sizeof(Header);
+            std::vector<uint8_t> compressedData;
+            for (auto const &[path, sourceFile] : fileMap)
+            {
+                auto &entry = entryMap[path];
+                entry.flags = 0;
+                entry.size = sourceFile->data.size();
+
+                compressedData.clear();
+                if (sourceFile->compress)
+                {
+                    compressedData = Compression::Compress(sourceFile->data.data(), sourceFile->data.size());
+                }
+
+                auto const &storedData = (compressedData.empty() ? sourceFile->data : compressedData);
+                entry.compression = (compressedData.empty() ? Compression::Type::None : Compression::Type::LZ4);
+                entry.storedSize = storedData.size();
+
+                WritePadding(file, offset, alignment);
+                entry.offset = offset;
+                file.write(reinterpret_cast<char const *>(storedData.data()), storedData.size());
+                offset += storedData.size();
+            }
+
+            std::string nameList;
+            std::vector<Entry> entryList;
+            entryList.reserve(entryMap.size());
+            for (auto &[path, entry] : entryMap)
+            {
+                entry.pathHash = GetPathHash(path);
+                entry.nameOffset = static_cast<uint32_t>(nameList.size());
+                entry.nameLength = static_cast<uint16_t>(path.size());
+                nameList += path;
+                entryList.push_back(entry);
+            }
+
+            // The map already holds the entries in name order, remember it before sorting them by hash
+            std::vector<uint32_t> orderList(entryList.size());
+            for (uint32_t entryIndex = 0; entryIndex < orderList.size(); ++entryIndex)
+            {
+                orderList[entryIndex] = entryIndex;
+            }
+
+            std::stable_sort(std::begin(orderList), std::end(orderList), [&](uint32_t leftIndex, uint32_t rightIndex) -> bool
+            {
+                return (entryList[leftIndex].pathHash < entryList[rightIndex].pathHash);
+            });
+
+            std::vector<Entry> sortedEntryList(entryList.size());
+            std::vector<uint32_t> nameOrderList(entryList.size());
+            for (uint32_t sortedIndex = 0; sortedIndex < orderList.size(); ++sortedIndex)
+            {
+                sortedEntryList[sortedIndex] = entryList[orderList[sortedIndex]];
+                nameOrderList[orderList[sortedIndex]] = sortedIndex;
+            }
+
+            WritePadding(file, offset, alignof(Entry));
+            header.entryOffset = offset;
+            header.entryCount = static_cast<uint32_t>(sortedEntryList.size());
+            file.write(reinterpret_cast<char const *>(sortedEntryList.data()), (sortedEntryList.size() * sizeof(Entry)));
+            offset += (sortedEntryList.size() * sizeof(Entry));
+
+            header.orderOffset = offset;
+            file.write(reinterpret_cast<char const *>(nameOrderList.data()), (nameOrderList.size() * sizeof(uint32_t)));
+            offset += (nameOrderList.size() * sizeof(uint32_t));
+
+            header.nameOffset = offset;
+            header.nameSize = static_cast<uint32_t>(nameList.size());
+            file.write(nameList.data(), nameList.size());
+
+            file.seekp(0);
+            WriteValue(file, header);
+            return file.good();
+        }
+
+        bool Mount(FileSystem::Path const &archivePath, FileSystem::Path const &mountPath)
+        {
+            auto reader = std::make_shared<Reader>(archivePath);
+            if (!reader->isValid())
+            {
+                return false;
+            }
+
+            auto key = GetMountKey(mountPath);
+            std::unique_lock lock(mountMutex);
+            std::erase_if(mountList, [&](MountPoint const &mountPoint) -> bool
+            {
+                return (mountPoint.key == key);
+            });
+
+            mountList.push_back({ std::move(key), std::move(reader) });
+            mountCount.store(static_cast<uint32_t>(mountList.size()), std::memory_order_release);
+            return true;
+        }
+
+        void Unmount(FileSystem::Path const &mountPath)
+        {
+            auto key = GetMountKey(mountPath);
+            std::unique_lock lock(mountMutex);
+            std::erase_if(mountList, [&](MountPoint const &mountPoint) -> bool
+            {
+                return (mountPoint.key == key);
+            });
+
+            mountCount.store(static_cast<uint32_t>(mountList.size()), std::memory_order_release);
+        }
+
+        bool Find(FileSystem::Path const &path, Location &location)
+        {
+            if (mountCount.load(std::memory_order_acquire) == 0)
+            {
+                return false;
+            }
+
+            auto key = GetMountKey(path);
+            std::shared_lock lock(mountMutex);
+            for (auto const &mountPoint : mountList)
+            {
+                if (key == mountPoint.key)
+                {
+                    location = { mountPoint.reader, nullptr };
+                    return true;
+                }
+
+                if (key.size() > mountPoint.key.size() && key.starts_with(mountPoint.key) && key[mountPoint.key.size()] == '/')
+                {
+                    auto entry = mountPoint.reader->find(std::string_view(key).substr(mountPoint.key.size() + 1));
+                    if (entry)
+                    {
+                        location = { mountPoint.reader, entry };
+                        return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+    }; // namespace Archive
+}; // namespace Gek
@@ -0,0 +1,288 @@
+#include "GEK/Utility/Compression.hpp"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+namespace Gek
+{
+    namespace Compression
+    {
+        namespace
+        {
+            static constexpr size_t MinimumMatchLength = 4;
+
+            // The format requires the last five bytes to be literals and the last match to start twelve bytes from the end
+            static constexpr size_t LastLiteralCount = 5;
+            static constexpr size_t MatchStartLimit = 12;
+
+            static constexpr size_t MaximumOffset = 65535;
+            static constexpr uint32_t HashBits = 16;
+
+            uint32_t Read32(uint8_t const *data)
+            {
+                uint32_t value;
+                std::memcpy(&value, data, sizeof(uint32_t));
+                return value;
+            }
+
+            uint32_t GetSequenceHash(uint32_t sequence)
+            {
+                return ((sequence * 2654435761U) >> (32 - HashBits));
+            }
+
+            size_t GetLengthSize(size_t length)
+            {
+                return (length >= 15 ? (((length - 15) / 255) + 1) : 0);
+            }
+
+            uint8_t *WriteLength(uint8_t *output, size_t length)
+            {
+                for (length -= 15; length >= 255; length -= 255)
+                {
+                    *output++ = 255;
+                }
+
+                *output++ = static_cast<uint8_t>(length);
+                return output;
+            }
+
+            bool ReadLength(uint8_t const *&input, uint8_t const *inputEnd, size_t &length)
+            {
+                uint8_t value;
+                do
+                {
+                    if (input >= inputEnd)
+                    {
+                        return false;
+                    }
+
+                    value = *input++;
+                    length += value;
+                } while (value == 255);
+
+                return true;
+            }
+
+            // A zero match length writes the final run of literals
+            uint8_t *WriteSequence(uint8_t *output, uint8_t *outputEnd, uint8_t const *literals, size_t literalLength, size_t offset, size_t matchLength)
+            {
+                const size_t matchCode = (matchLength ? (matchLength - MinimumMatchLength) : 0);
+                const size_t requiredSize = (1 + GetLengthSize(literalLength) + literalLength + (matchLength ? (2 + GetLengthSize(matchCode)) : 0));
+                if (requiredSize > size_t(outputEnd - output))
+                {
+                    return nullptr;
+                }
+
+                uint8_t *token = output++;
+                *token = static_cast<uint8_t>(std::min(literalLength, size_t(15)) << 4);
+                if (literalLength >= 15)
+                {
+                    output = WriteLength(output, literalLength);
+                }
+
+                if (literalLength > 0)
+                {
+                    std::memcpy(output, literals, literalLength);
+                    output += literalLength;
+                }
+
+                if (matchLength)
+                {
+                    *output++ = static_cast<uint8_t>(offset & 0xFF);
+                    *output++ = static_cast<uint8_t>(offset >> 8);
+                    *token |= static_cast<uint8_t>(std::min(matchCode, size_t(15)));
+                    if (matchCode >= 15)
+                    {
+                        output = WriteLength(output, matchCode);
+                    }
+                }
+
+                return output;
+            }
+        }; // namespace
+
+        size_t GetMaximumCompressedSize(size_t size)
+        {
+            return (size + (size / 255) + 16);
+        }
+
+        size_t Compress(void const *source, size_t sourceSize, void *destination, size_t destinationCapacity)
+        {
+            auto input = static_cast<uint8_t const *>(source);
+            auto output = static_cast<uint8_t *>(destination);
+            auto outputEnd = (output + destinationCapacity);
+
+            size_t anchor = 0;
+            if (sourceSize > MatchStartLimit)
+            {
+                // Positions are stored plus one so that zero marks an empty slot
+                auto hashTable = std::make_unique<uint32_t[]>(size_t(1) << HashBits);
+                const size_t matchStartEnd = (sourceSize - MatchStartLimit);
+                const size_t matchEnd = (sourceSize - LastLiteralCount);
+                size_t position = 0;
+                while (position < matchStartEnd)
+                {
+                    const uint32_t sequence = Read32(input + position);
+                    auto &slot = hashTable[GetSequenceHash(sequence)];
+                    const size_t candidate = slot;
+                    slot = static_cast<uint32_t>(position + 1);
+                    if (candidate == 0 || (position - (candidate - 1)) > MaximumOffset || Read32(input + candidate - 1) != sequence)
+                    {
+                        ++position;
+                        continue;
+                    }
+
+                    const size_t matchPosition = (candidate - 1);
+                    size_t matchLength = MinimumMatchLength;
+                    while ((position + matchLength) < matchEnd && input[matchPosition + matchLength] == input[position + matchLength])
+                    {
+                        ++matchLength;
+                    }
+
+                    output = WriteSequence(output, outputEnd, (input + anchor), (position - anchor), (position - matchPosition), matchLength);
+                    if (!output)
+                    {
+                        return 0;
+                    }
+
+                    position += matchLength;
+                    anchor = position;
+                }
+            }
+
+            output = WriteSequence(output, outputEnd, (input + anchor), (sourceSize - anchor), 0, 0);
+            return (output ? size_t(output - static_cast<uint8_t *>(destination)) : 0);
+        }
+
+        bool Decompress(void const *source, size_t sourceSize, void *destination, size_t destinationSize)
+        {
+            auto input = static_cast<uint8_t const *>(source);
+            auto inputEnd = (input + sourceSize);
+            auto output = static_cast<uint8_t *>(destination);
+            auto outputStart = output;
+            auto outputEnd = (output + destinationSize);
+            while (input < inputEnd)
+            {
+                const uint8_t token = *input++;
+                size_t literalLength = (token >> 4);
+                if (literalLength == 15 && !ReadLength(input, inputEnd, literalLength))
+                {
+                    return false;
+                }
+
+                if (literalLength > size_t(inputEnd - input) || literalLength > size_t(outputEnd - output))
+                {
+                    return false;
+                }
+
+                if (literalLength > 0)
+                {
+                    std::memcpy(output, input, literalLength);
+                    input += literalLength;
+                    output += literalLength;
+                }
+
+                if (input == inputEnd)
+                {
+                    break;
+                }
+
+                if ((inputEnd - input) < 2)
+                {
+                    return false;
+                }
+
+                const size_t offset = (input[0] | (size_t(input[1]) << 8));
+                input += 2;
+                if (offset == 0 || offset > size_t(output - outputStart))
+                {
+                    return false;
+                }
+
+                size_t matchLength = (token & 15);
+                if (matchLength == 15 && !ReadLength(input, inputEnd, matchLength))
+                {
+                    return false;
+                }
+
+                matchLength += MinimumMatchLength;
+                if (matchLength > size_t(outputEnd - output))
+                {
+                    return false;
+                }
+
+                uint8_t const *match = (output - offset);
+                if (offset >= matchLength)
+                {
+                    std::memcpy(output, match, matchLength);
+                    output += matchLength;
+                }
+                else
+                {
+                    // Overlapping matches repeat the last offset bytes
+                    for (size_t index = 0; index < matchLength; ++index)
+                    {
+                        *output++ = match[index];
+                    }
+                }
+            }
+
+            return (output == outputEnd);
+        }
+
+        std::vector<uint8_t> Compress(void const *source, size_t sourceSize)
+        {
+            std::vector<uint8_t> buffer(GetMaximumCompressedSize(sourceSize));
+            const size_t compressedSize = Compress(source, sourceSize, buffer.data(), buffer.size());
+            if (compressedSize == 0 || compressedSize >= sourceSize)
+            {
+                return {};
+            }
+
+            buffer.resize(compressedSize);
+            buffer.shrink_to_fit();
+            return buffer;
+        }
+
+        // Trailing bytes that do not make up a whole element are copied as they are
+        void Shuffle(void const *source, size_t size, size_t stride, void *destination)
+        {
+            auto input = static_cast<uint8_t const *>(source);
+            auto output = static_cast<uint8_t *>(destination);
+            const size_t elementCount = (size / stride);
+            for (size_t byteIndex = 0; byteIndex < stride; ++byteIndex)
+            {
+                for (size_t elementIndex = 0; elementIndex < elementCount; ++elementIndex)
+                {
+                    *output++ = input[(elementIndex * stride) + byteIndex];
+                }
+            }
+
+            const size_t shuffledSize = (elementCount * stride);
+            if (shuffledSize < size)
+            {
+                std::memcpy(output, (input + shuffledSize), (size - shuffledSize));
+            }
+        }
+
+        void Unshuffle(void const *source, size_t size, size_t stride, void *destination)
+        {
+            auto input = static_cast<uint8_t const *>(source);
+            auto output = static_cast<uint8_t *>(destination);
+            const size_t elementCount = (size / stride);
+            for (size_t byteIndex = 0; byteIndex < stride; ++byteIndex)
+            {
+                for (size_t elementIndex = 0; elementIndex < elementCount; ++elementIndex)
+                {
+                    output[(elementIndex * stride) + byteIndex] = *input++;
+                }
+            }
+
+            const size_t shuffledSize = (elementCount * stride);
+            if (shuffledSize < size)
+            {
+                std::memcpy((output + shuffledSize), input, (size - shuffledSize));
+            }
+        }
+    }; // namespace Compression
+}; // namespace Gek
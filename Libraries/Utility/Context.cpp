@@ -1,13 +1,21 @@
 #include "GEK/Utility/Context.hpp"
+#include "GEK/Utility/Archive.hpp"
 #include "GEK/Utility/ContextUser.hpp"
 #include "GEK/Utility/FileSystem.hpp"
 #include "GEK/Utility/String.hpp"
 #include "GEK/Utility/ThreadPool.hpp"
+#include <chrono>
+#include <csignal>
 #include <cstdlib>
 #include <cstring>
+#include <exception>
+#include <format>
 #include <fstream>
+#include <iterator>
 #include <mutex>
 #include <set>
+#include <tbb/concurrent_queue.h>
+#include <thread>
 #include <unordered_map>
 
 #ifdef _DEBUG
@@ -18,12 +26,18 @@ const char modulePostfix[] = "";
 
 #ifdef _WIN32
 #include <Windows.h>
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
 
 #define LIBRARY HMODULE
 const char *moduleExtension = ".dll";
 #define loadLibrary(PATH) LoadLibraryA(PATH.getString().c_str())
 #define getFunction(HANDLE, FUNCTION) GetProcAddress(HANDLE, FUNCTION)
 #define freeLibrary(HANDLE) FreeLibrary(HANDLE)
+#define openCrashFile(PATH) _open(PATH.getString().c_str(), _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE)
+#define writeCrashFile(FILE, DATA, SIZE) _write(FILE, DATA, static_cast<unsigned int>(SIZE))
+#define closeCrashFile(FILE) _close(FILE)
 
 std::string getLastErrorMessage(DWORD errorCode = GetLastError())
 {
@@ -60,12 +74,17 @@ void outputDebugString(std::string_view message)
 #else
 #include <dlfcn.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #define LIBRARY void *
 const char *moduleExtension = ".so";
 #define loadLibrary(PATH) dlopen(PATH.getString().c_str(), RTLD_LAZY | RTLD_GLOBAL)
 #define getFunction(HANDLE, FUNCTION) dlsym(HANDLE, FUNCTION)
 #define freeLibrary(HANDLE) dlclose(HANDLE)
+#define openCrashFile(PATH) open(PATH.getString().c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644)
+#define writeCrashFile(FILE, DATA, SIZE) write(FILE, DATA, SIZE)
+#define closeCrashFile(FILE) close(FILE)
 
 std::string getLastErrorMessage(int errorCode = errno)
 {
@@ -163,6 +182,104 @@ namespace Gek
         return mask;
     }
 
+    static Context::LogLevel parseLogLevelFromEnvironment(const char *value)
+    {
+        std::string normalized = String::GetLower(value ? value : "");
+        if (normalized == "error")
+        {
+            return Context::Error;
+        }
+        else if (normalized == "warning")
+        {
+            return Context::Warning;
+        }
+        else if (normalized == "debug")
+        {
+            return Context::Debug;
+        }
+
+        return Context::Info;
+    }
+
+    class ContextImplementation;
+
+    // Only installed when the application asks for it, the handlers write the messages the log thread has not
+    // written yet and then hand the crash on to whatever was installed before them
+    static std::atomic<ContextImplementation const *> crashLogContext = nullptr;
+    static std::atomic_flag crashLogWritten;
+    static void WriteCrashLog(void);
+
+    static constexpr int CrashSignalList[] = { SIGSEGV, SIGABRT, SIGFPE, SIGILL };
+#ifdef _WIN32
+    static void (*previousSignalHandlerList[std::size(CrashSignalList)])(int) = {};
+    static LPTOP_LEVEL_EXCEPTION_FILTER previousExceptionFilter = nullptr;
+#else
+    static struct sigaction previousSignalActionList[std::size(CrashSignalList)] = {};
+#endif
+
+    // Restores the previous handler and raises again, the signal is delivered to it once this handler returns
+    static void OnCrashSignal(int signal)
+    {
+        WriteCrashLog();
+        for (size_t signalIndex = 0; signalIndex < std::size(CrashSignalList); ++signalIndex)
+        {
+            if (CrashSignalList[signalIndex] == signal)
+            {
+#ifdef _WIN32
+                std::signal(signal, (previousSignalHandlerList[signalIndex] == SIG_ERR ? SIG_DFL : previousSignalHandlerList[signalIndex]));
+#else
+                sigaction(signal, &previousSignalActionList[signalIndex], nullptr);
+#endif
+                break;
+            }
+        }
+
+        std::raise(signal);
+    }
+
+    static std::terminate_handler previousTerminateHandler = nullptr;
+    static void OnTerminate(void)
+    {
+        WriteCrashLog();
+        if (previousTerminateHandler)
+        {
+            previousTerminateHandler();
+        }
+
+        std::abort();
+    }
+
+#ifdef _WIN32
+    static LONG WINAPI OnUnhandledException(EXCEPTION_POINTERS *exceptionPointers)
+    {
+        WriteCrashLog();
+        return (previousExceptionFilter ? previousExceptionFilter(exceptionPointers) : EXCEPTION_CONTINUE_SEARCH);
+    }
+#endif
+
+    static void InstallCrashLogHandlers(void)
+    {
+        static std::once_flag installFlag;
+        std::call_once(installFlag, [](void) -> void
+        {
+            previousTerminateHandler = std::set_terminate(OnTerminate);
+            for (size_t signalIndex = 0; signalIndex < std::size(CrashSignalList); ++signalIndex)
+            {
+#ifdef _WIN32
+                previousSignalHandlerList[signalIndex] = std::signal(CrashSignalList[signalIndex], OnCrashSignal);
+#else
+                struct sigaction signalAction = {};
+                signalAction.sa_handler = OnCrashSignal;
+                sigemptyset(&signalAction.sa_mask);
+                sigaction(CrashSignalList[signalIndex], &signalAction, &previousSignalActionList[signalIndex]);
+#endif
+            }
+#ifdef _WIN32
+            previousExceptionFilter = SetUnhandledExceptionFilter(OnUnhandledException);
+#endif
+        });
+    }
+
     class ContextImplementation
         : public Context
     {
@@ -171,16 +288,216 @@ namespace Gek
         std::unordered_map<std::string_view, std::function<ContextUserPtr(Context *, void *, std::vector<Hash> &)>> classMap;
         std::unordered_multimap<std::string_view, std::string_view> typeMap;
         std::set<std::string> dataPathList;
-        mutable std::mutex logMutex;
-        mutable std::mutex runtimeMetricsMutex;
-        std::unordered_map<std::string, double> runtimeMetricMap;
-        uint8_t logSinkMask = static_cast<uint8_t>(LogSink_Console | LogSink_Debugger);
+        Metrics::Registry runtimeMetrics;
+        FileSystem::Path cachePath;
+
+        struct LogRecord
+        {
+            LogLevel level = Info;
+            uint8_t sinkMask = 0;
+            std::string message;
+            uint64_t crashLogEnd = 0;
+        };
+
+        std::atomic<uint8_t> logSinkMask = static_cast<uint8_t>(LogSink_Console | LogSink_Debugger);
+        std::atomic<LogLevel> logLevel = Info;
+        mutable tbb::concurrent_queue<LogRecord> logQueue;
+
+        // Counted before the record is queued so that flushLog also waits for records still being pushed
+        mutable std::atomic<uint64_t> queuedLogCount = 0;
+        mutable std::atomic<uint64_t> writtenLogCount = 0;
+        mutable std::atomic<uint64_t> logSignal = 0;
+        std::atomic_bool stopLogWriter = false;
+        std::thread logWriterThread;
+
+        // Held while a batch is written, guards the file and the batch buffers
+        mutable std::mutex logWriteMutex;
         FileSystem::Path logFilePath;
         mutable std::ofstream logFileStream;
-        FileSystem::Path cachePath;
+        mutable std::string fileBatch;
+        mutable std::string consoleBatch;
+        mutable bool consoleBatchIsError = false;
+
+        // Once crash handlers are installed every message is also copied into this ring, everything past
+        // crashLogWrittenPosition has not reached its sinks yet and is what a crash handler writes out
+        static constexpr size_t CrashLogSize = (64 * 1024);
+        std::atomic_bool crashLogEnabled = false;
+        mutable std::unique_ptr<char[]> crashLog;
+        mutable std::atomic<uint64_t> crashLogPosition = 0;
+        mutable std::atomic<uint64_t> crashLogWrittenPosition = 0;
+        std::atomic<int> crashLogFile = -1;
+
+        void startLogWriter(void)
+        {
+            logWriterThread = std::thread([this](void) -> void
+            {
+                while (true)
+                {
+                    auto signal = logSignal.load(std::memory_order_acquire);
+                    {
+                        std::lock_guard<std::mutex> lock(logWriteMutex);
+                        writeLogBatch();
+                    }
+
+                    if (stopLogWriter.load(std::memory_order_acquire) && logQueue.empty())
+                    {
+                        break;
+                    }
+
+                    logSignal.wait(signal, std::memory_order_acquire);
+                };
+            });
+        }
+
+        void stopLogWriting(void)
+        {
+            ContextImplementation const *expected = this;
+            crashLogContext.compare_exchange_strong(expected, nullptr);
+            stopLogWriter.store(true, std::memory_order_release);
+            logSignal.fetch_add(1, std::memory_order_release);
+            logSignal.notify_one();
+            if (logWriterThread.joinable())
+            {
+                logWriterThread.join();
+            }
+
+            auto file = crashLogFile.exchange(-1);
+            if (file >= 0)
+            {
+                closeCrashFile(file);
+            }
+        }
+
+        void flushConsoleBatch(void) const
+        {
+            if (!consoleBatch.empty())
+            {
+                auto &stream = (consoleBatchIsError ? std::cerr : std::cout);
+                stream.write(consoleBatch.data(), consoleBatch.size());
+                stream.flush();
+                consoleBatch.clear();
+            }
+        }
+
+        // Caller holds logWriteMutex
+        void writeLogBatch(void) const
+        {
+            uint64_t recordCount = 0;
+            uint64_t crashLogEnd = 0;
+            LogRecord record;
+            while (logQueue.try_pop(record))
+            {
+                if ((record.sinkMask & LogSink_File) && logFileStream.is_open())
+                {
+                    fileBatch.append(record.message).push_back('\n');
+                }
+
+                if (record.sinkMask & LogSink_Debugger)
+                {
+                    outputDebugString(record.message);
+                }
+
+                if (record.sinkMask & LogSink_Console)
+                {
+                    // Errors and warnings go to stderr, switching streams writes out what is batched so lines stay in order
+                    const bool isError = (record.level <= Warning);
+                    if (isError != consoleBatchIsError)
+                    {
+                        flushConsoleBatch();
+                        consoleBatchIsError = isError;
+                    }
+
+                    consoleBatch.append(record.message).push_back('\n');
+                }
+
+                crashLogEnd = std::max(crashLogEnd, record.crashLogEnd);
+                ++recordCount;
+            }
+
+            if (!fileBatch.empty())
+            {
+                logFileStream.write(fileBatch.data(), fileBatch.size());
+                logFileStream.flush();
+                fileBatch.clear();
+            }
+
+            flushConsoleBatch();
+            if (crashLogEnd > crashLogWrittenPosition.load(std::memory_order_relaxed))
+            {
+                crashLogWrittenPosition.store(crashLogEnd, std::memory_order_release);
+            }
+
+            if (recordCount > 0)
+            {
+                writtenLogCount.fetch_add(recordCount, std::memory_order_release);
+                writtenLogCount.notify_all();
+            }
+        }
 
+        // Producers reserve their range with one atomic add, so concurrent messages never overlap
+        uint64_t appendCrashLog(std::string_view message) const
+        {
+            if (message.size() > CrashLogSize)
+            {
+                message = message.substr(message.size() - CrashLogSize);
+            }
+
+            const uint64_t position = crashLogPosition.fetch_add(message.size(), std::memory_order_acq_rel);
+            const size_t offset = (position % CrashLogSize);
+            const size_t firstSize = std::min(message.size(), (CrashLogSize - offset));
+            std::memcpy(crashLog.get() + offset, message.data(), firstSize);
+            std::memcpy(crashLog.get(), message.data() + firstSize, (message.size() - firstSize));
+            return (position + message.size());
+        }
+
+      public:
+        // Called from signal handlers, so only atomics and write(2) on the file opened by setLogFilePath, or stderr.
+        // A message still being copied by another thread may come out torn.
+        void writeCrashLog(void) const
+        {
+            auto writeAll = [file = crashLogFile.load(std::memory_order_acquire)](char const *data, size_t size) -> void
+            {
+                const int crashFile = (file >= 0 ? file : 2);
+                while (size > 0)
+                {
+                    auto writtenSize = writeCrashFile(crashFile, data, size);
+                    if (writtenSize <= 0)
+                    {
+                        if (writtenSize < 0 && errno == EINTR)
+                        {
+                            continue;
+                        }
+
+                        break;
+                    }
+
+                    data += writtenSize;
+                    size -= static_cast<size_t>(writtenSize);
+                }
+            };
+
+            const uint64_t position = crashLogPosition.load(std::memory_order_acquire);
+            const uint64_t oldestPosition = (position > CrashLogSize ? (position - CrashLogSize) : 0);
+            const uint64_t writtenPosition = std::max(crashLogWrittenPosition.load(std::memory_order_acquire), oldestPosition);
+            if (writtenPosition >= position)
+            {
+                return;
+            }
+
+            static constexpr char header[] = "--- crash, log messages not yet written ---\n";
+            writeAll(header, (sizeof(header) - 1));
+
+            const size_t offset = (writtenPosition % CrashLogSize);
+            const size_t size = (position - writtenPosition);
+            const size_t firstSize = std::min(size, (CrashLogSize - offset));
+            writeAll(crashLog.get() + offset, firstSize);
+            writeAll(crashLog.get(), (size - firstSize));
+        }
+
+      private:
         void configureLogSinkFromEnvironment(void)
         {
+            logLevel = parseLogLevelFromEnvironment(std::getenv("gek_log_level"));
             logSinkMask = parseLogSinkMaskFromEnvironment(std::getenv("gek_log_sinks"));
             auto environmentLogFilePath = std::getenv("gek_log_file");
             if (environmentLogFilePath && std::strlen(environmentLogFilePath) > 0)
@@ -235,12 +552,14 @@ namespace Gek
         ContextImplementation(void)
         {
             SetThreadPoolLogContext(this);
+            startLogWriter();
             configureLogSinkFromEnvironment();
         }
 
         ContextImplementation(std::vector<FileSystem::Path> const &pluginSearchList, std::vector<FileSystem::Path> const &pluginList)
         {
             SetThreadPoolLogContext(this);
+            startLogWriter();
             configureLogSinkFromEnvironment();
             for (auto const &pluginPath : pluginList)
             {
@@ -272,102 +591,79 @@ namespace Gek
             {
                 freeLibrary(library);
             }
+
+            stopLogWriting();
         }
 
         // Context
         void vlog(LogLevel level, const LocationMessage &message, std::format_args args) const
         {
-            std::lock_guard<std::mutex> lock(logMutex);
-            const auto &location = message.location;
-            auto fileName = FileSystem::Path(location.file_name()).getFileName();
-            auto formattedMessage = std::format("{}:{}: {}", fileName, location.line(), std::vformat(message.format, args));
-
-            if (logSinkMask & LogSink_File)
-            {
-                if (logFileStream.is_open())
-                {
-                    logFileStream << formattedMessage << std::endl;
-                }
-            }
-
-            const bool outputDebugger = ((logSinkMask & LogSink_Debugger) != 0);
-            const bool outputConsole = ((logSinkMask & LogSink_Console) != 0);
-            if (!outputDebugger && !outputConsole)
+            const uint8_t sinkMask = logSinkMask.load(std::memory_order_relaxed);
+            if (sinkMask == LogSink_None)
             {
                 return;
             }
 
-            switch (level)
-            {
-            case LogLevel::Error:
-                if (outputDebugger)
-                {
-                    outputDebugString(formattedMessage);
-                }
-
-                if (outputConsole)
-                {
-                    std::cerr << formattedMessage << std::endl;
-                }
-
-                break;
-
-            case LogLevel::Warning:
-                if (outputDebugger)
-                {
-                    outputDebugString(formattedMessage);
-                }
-
-                if (outputConsole)
-                {
-                    std::cerr << formattedMessage << std::endl;
-                }
-
-                break;
+            // Reused by every message from this thread, the record gets an exactly sized copy
+            thread_local std::string formatBuffer;
+            formatBuffer.clear();
 
-            case LogLevel::Debug:
-                if (outputDebugger)
-                {
-                    outputDebugString(formattedMessage);
-                }
+            const auto &location = message.location;
+            auto fileName = FileSystem::Path(location.file_name()).getFileName();
+            std::format_to(std::back_inserter(formatBuffer), "{}:{}: ", fileName, location.line());
+            std::vformat_to(std::back_inserter(formatBuffer), message.format, args);
 
-                if (outputConsole)
-                {
-                    std::cout << formattedMessage << std::endl;
-                }
+            uint64_t crashLogEnd = 0;
+            if (crashLogEnabled.load(std::memory_order_acquire))
+            {
+                formatBuffer.push_back('\n');
+                crashLogEnd = appendCrashLog(formatBuffer);
+                formatBuffer.pop_back();
+            }
 
-                break;
+            queuedLogCount.fetch_add(1, std::memory_order_acq_rel);
+            logQueue.push(LogRecord{ level, sinkMask, formatBuffer, crashLogEnd });
+            logSignal.fetch_add(1, std::memory_order_release);
+            logSignal.notify_one();
+        }
 
-            case LogLevel::Info:
-                if (outputDebugger)
-                {
-                    outputDebugString(formattedMessage);
-                }
+        void flushLog(void) const
+        {
+            const uint64_t queuedCount = queuedLogCount.load(std::memory_order_acquire);
+            logSignal.fetch_add(1, std::memory_order_release);
+            logSignal.notify_one();
+            for (uint64_t writtenCount = writtenLogCount.load(std::memory_order_acquire); writtenCount < queuedCount; writtenCount = writtenLogCount.load(std::memory_order_acquire))
+            {
+                writtenLogCount.wait(writtenCount, std::memory_order_acquire);
+            }
+        }
 
-                if (outputConsole)
-                {
-                    std::cout << formattedMessage << std::endl;
-                }
+        void setLogLevel(LogLevel level)
+        {
+            logLevel.store(level, std::memory_order_relaxed);
+        }
 
-                break;
-            };
+        LogLevel getLogLevel(void) const
+        {
+            return logLevel.load(std::memory_order_relaxed);
         }
 
         void setLogSinkMask(uint8_t sinkMask)
         {
-            std::lock_guard<std::mutex> lock(logMutex);
-            logSinkMask = sinkMask;
+            logSinkMask.store(sinkMask, std::memory_order_relaxed);
         }
 
         uint8_t getLogSinkMask(void) const
         {
-            std::lock_guard<std::mutex> lock(logMutex);
-            return logSinkMask;
+            return logSinkMask.load(std::memory_order_relaxed);
         }
 
+        // Messages queued before the change still go to the old file
         void setLogFilePath(FileSystem::Path const &path, bool append)
         {
-            std::lock_guard<std::mutex> lock(logMutex);
+            flushLog();
+
+            std::lock_guard<std::mutex> lock(logWriteMutex);
             logFilePath = path;
             logFileStream.close();
             if (!path.getString().empty())
@@ -376,31 +672,45 @@ namespace Gek
                 mode |= (append ? std::ios::app : std::ios::trunc);
                 logFileStream.open(path.getString(), mode);
             }
+
+            // Opened up front, a crash handler can not open files
+            auto file = crashLogFile.exchange((path.getString().empty() ? -1 : openCrashFile(path)));
+            if (file >= 0)
+            {
+                closeCrashFile(file);
+            }
+        }
+
+        void installCrashLogHandlers(void)
+        {
+            if (!crashLog)
+            {
+                crashLog = std::make_unique<char[]>(CrashLogSize);
+            }
+
+            crashLogEnabled.store(true, std::memory_order_release);
+            crashLogContext.store(this, std::memory_order_release);
+            InstallCrashLogHandlers();
+        }
+
+        Metrics::Registry &getRuntimeMetrics(void)
+        {
+            return runtimeMetrics;
         }
 
         void setRuntimeMetric(std::string_view name, double value)
         {
-            std::lock_guard<std::mutex> lock(runtimeMetricsMutex);
-            runtimeMetricMap[std::string(name)] = value;
+            runtimeMetrics.set(runtimeMetrics.getHandle(name), value);
         }
 
         bool getRuntimeMetric(std::string_view name, double &value) const
         {
-            std::lock_guard<std::mutex> lock(runtimeMetricsMutex);
-            auto search = runtimeMetricMap.find(std::string(name));
-            if (search == std::end(runtimeMetricMap))
-            {
-                return false;
-            }
-
-            value = search->second;
-            return true;
+            return runtimeMetrics.get(name, value);
         }
 
         std::unordered_map<std::string, double> getRuntimeMetricSnapshot(void) const
         {
-            std::lock_guard<std::mutex> lock(runtimeMetricsMutex);
-            return runtimeMetricMap;
+            return runtimeMetrics.getSnapshot();
         }
 
         void setCachePath(FileSystem::Path const &path)
@@ -415,6 +725,13 @@ namespace Gek
 
         void addDataPath(FileSystem::Path const &path)
         {
+            // A packed copy next to the directory is served in place of the loose files
+            FileSystem::Path archivePath(path.getString() + std::string(Archive::Extension));
+            if (archivePath.isFile() && Archive::Mount(archivePath, path))
+            {
+                log(Info, "Mounted data archive: {}", archivePath.getString());
+            }
+
             dataPathList.insert(path.getString());
         }
 
@@ -509,6 +826,20 @@ namespace Gek
         }
     };
 
+    // Written once, terminate aborts and would otherwise write it again from the SIGABRT handler
+    static void WriteCrashLog(void)
+    {
+        if (crashLogWritten.test_and_set())
+        {
+            return;
+        }
+
+        if (auto context = crashLogContext.load(std::memory_order_acquire))
+        {
+            context->writeCrashLog();
+        }
+    }
+
     ContextPtr Context::Create(std::vector<FileSystem::Path> const *pluginSearchList, std::vector<FileSystem::Path> const *pluginList)
     {
         return std::make_unique<ContextImplementation>(pluginSearchList ? *pluginSearchList : std::vector<FileSystem::Path>(), pluginList ? *pluginList : std::vector<FileSystem::Path>());
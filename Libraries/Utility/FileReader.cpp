@@ -0,0 +1,716 @@
+#include "GEK/Utility/FileReader.hpp"
+#include "GEK/Utility/Archive.hpp"
+#include "GEK/Utility/Profiler.hpp"
+#include <algorithm>
+#include <initializer_list>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Gek
+{
+#ifdef __linux__
+    namespace
+    {
+        // Reads are split so that a single entry never asks for more than the kernel accepts in one go
+        static constexpr size_t MaximumReadSize = (1 << 30);
+
+        static constexpr uint64_t WakeIdentifier = 0;
+        static constexpr uint64_t CancelIdentifier = 1;
+
+        int SetupRing(uint32_t entryCount, io_uring_params &parameters)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_setup, entryCount, &parameters));
+        }
+
+        int EnterRing(int ringDescriptor, uint32_t submitCount, uint32_t waitCount)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_enter, ringDescriptor, submitCount, waitCount, (waitCount ? IORING_ENTER_GETEVENTS : 0), nullptr, 0));
+        }
+
+        int RegisterRing(int ringDescriptor, uint32_t operation, void *argument, uint32_t argumentCount)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_register, ringDescriptor, operation, argument, argumentCount));
+        }
+
+        // Kernels that predate the probe also predate IORING_OP_READ, so a failed probe means no ring
+        bool SupportsOperations(int ringDescriptor, std::initializer_list<uint8_t> operationList)
+        {
+            static constexpr uint32_t ProbeCount = 256;
+            std::vector<uint8_t> probeBuffer(sizeof(io_uring_probe) + (ProbeCount * sizeof(io_uring_probe_op)));
+            auto probe = reinterpret_cast<io_uring_probe *>(probeBuffer.data());
+            if (RegisterRing(ringDescriptor, IORING_REGISTER_PROBE, probe, ProbeCount) < 0)
+            {
+                return false;
+            }
+
+            return std::all_of(std::begin(operationList), std::end(operationList), [&](uint8_t operation) -> bool
+            {
+                return (operation <= probe->last_op && (probe->ops[operation].flags & IO_URING_OP_SUPPORTED));
+            });
+        }
+
+        template <typename TYPE>
+        TYPE *GetRingField(void *mapping, uint32_t offset)
+        {
+            return reinterpret_cast<TYPE *>(static_cast<uint8_t *>(mapping) + offset);
+        }
+    }; // namespace
+
+    // The shared ring memory is written by the kernel, so the indices it updates are read through atomic_ref
+    struct FileReader::Ring
+    {
+        int ringDescriptor = -1;
+        int wakeDescriptor = -1;
+
+        void *queueMapping = MAP_FAILED;
+        size_t queueMappingSize = 0;
+        void *completionMapping = MAP_FAILED;
+        size_t completionMappingSize = 0;
+        io_uring_sqe *submissionEntryList = static_cast<io_uring_sqe *>(MAP_FAILED);
+        size_t submissionEntryListSize = 0;
+
+        uint32_t *submissionHead = nullptr;
+        uint32_t *submissionTail = nullptr;
+        uint32_t submissionMask = 0;
+        uint32_t submissionCount = 0;
+        uint32_t *submissionArray = nullptr;
+        uint32_t *completionHead = nullptr;
+        uint32_t *completionTail = nullptr;
+        uint32_t completionMask = 0;
+        io_uring_cqe *completionEntryList = nullptr;
+
+        uint32_t maximumActiveCount = 0;
+
+        ~Ring(void)
+        {
+            if (submissionEntryList != MAP_FAILED)
+            {
+                munmap(submissionEntryList, submissionEntryListSize);
+            }
+
+            if (completionMapping != MAP_FAILED && completionMapping != queueMapping)
+            {
+                munmap(completionMapping, completionMappingSize);
+            }
+
+            if (queueMapping != MAP_FAILED)
+            {
+                munmap(queueMapping, queueMappingSize);
+            }
+
+            if (ringDescriptor >= 0)
+            {
+                close(ringDescriptor);
+            }
+
+            if (wakeDescriptor >= 0)
+            {
+                close(wakeDescriptor);
+            }
+        }
+
+        bool create(uint32_t queueDepth)
+        {
+            wakeDescriptor = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+            if (wakeDescriptor < 0)
+            {
+                return false;
+            }
+
+            io_uring_params parameters = {};
+            ringDescriptor = SetupRing(queueDepth, parameters);
+            if (ringDescriptor < 0 || !SupportsOperations(ringDescriptor, { IORING_OP_READ, IORING_OP_POLL_ADD, IORING_OP_ASYNC_CANCEL }))
+            {
+                return false;
+            }
+
+            queueMappingSize = (parameters.sq_off.array + (parameters.sq_entries * sizeof(uint32_t)));
+            completionMappingSize = (parameters.cq_off.cqes + (parameters.cq_entries * sizeof(io_uring_cqe)));
+            if (parameters.features & IORING_FEAT_SINGLE_MMAP)
+            {
+                queueMappingSize = completionMappingSize = std::max(queueMappingSize, completionMappingSize);
+            }
+
+            queueMapping = mmap(nullptr, queueMappingSize, (PROT_READ | PROT_WRITE), (MAP_SHARED | MAP_POPULATE), ringDescriptor, IORING_OFF_SQ_RING);
+            if (queueMapping == MAP_FAILED)
+            {
+                return false;
+            }
+
+            completionMapping = ((parameters.features & IORING_FEAT_SINGLE_MMAP) ? queueMapping : mmap(nullptr, completionMappingSize, (PROT_READ | PROT_WRITE), (MAP_SHARED | MAP_POPULATE), ringDescriptor, IORING_OFF_CQ_RING));
+            if (completionMapping == MAP_FAILED)
+            {
+                return false;
+            }
+
+            submissionEntryListSize = (parameters.sq_entries * sizeof(io_uring_sqe));
+            submissionEntryList = static_cast<io_uring_sqe *>(mmap(nullptr, submissionEntryListSize, (PROT_READ | PROT_WRITE), (MAP_SHARED | MAP_POPULATE), ringDescriptor, IORING_OFF_SQES));
+            if (submissionEntryList == MAP_FAILED)
+            {
+                return false;
+            }
+
+            submissionHead = GetRingField<uint32_t>(queueMapping, parameters.sq_off.head);
+            submissionTail = GetRingField<uint32_t>(queueMapping, parameters.sq_off.tail);
+            submissionMask = *GetRingField<uint32_t>(queueMapping, parameters.sq_off.ring_mask);
+            submissionCount = *GetRingField<uint32_t>(queueMapping, parameters.sq_off.ring_entries);
+            submissionArray = GetRingField<uint32_t>(queueMapping, parameters.sq_off.array);
+            completionHead = GetRingField<uint32_t>(completionMapping, parameters.cq_off.head);
+            completionTail = GetRingField<uint32_t>(completionMapping, parameters.cq_off.tail);
+            completionMask = *GetRingField<uint32_t>(completionMapping, parameters.cq_off.ring_mask);
+            completionEntryList = GetRingField<io_uring_cqe>(completionMapping, parameters.cq_off.cqes);
+
+            // Each active read can have a cancel outstanding as well, which keeps the completion queue from overflowing
+            maximumActiveCount = std::max((submissionCount / 2), 1U);
+            return true;
+        }
+
+        // Entries are only handed to the kernel by flush, a full queue is flushed before another entry is used
+        io_uring_sqe *getEntry(void)
+        {
+            const uint32_t tail = *submissionTail;
+            while ((tail - std::atomic_ref<uint32_t>(*submissionHead).load(std::memory_order_acquire)) >= submissionCount)
+            {
+                flush(0);
+            }
+
+            const uint32_t index = (tail & submissionMask);
+            auto entry = &submissionEntryList[index];
+            std::memset(entry, 0, sizeof(io_uring_sqe));
+            submissionArray[index] = index;
+            std::atomic_ref<uint32_t>(*submissionTail).store((tail + 1), std::memory_order_release);
+            return entry;
+        }
+
+        // Submits whatever the kernel has not consumed yet, an interrupted wait is simply repeated
+        void flush(uint32_t waitCount)
+        {
+            while (true)
+            {
+                const uint32_t submitCount = (*submissionTail - std::atomic_ref<uint32_t>(*submissionHead).load(std::memory_order_acquire));
+                if (EnterRing(ringDescriptor, submitCount, waitCount) >= 0 || errno != EINTR)
+                {
+                    break;
+                }
+            }
+        }
+
+        void armWake(void)
+        {
+            auto entry = getEntry();
+            entry->opcode = IORING_OP_POLL_ADD;
+            entry->fd = wakeDescriptor;
+            entry->poll32_events = POLLIN;
+            entry->user_data = WakeIdentifier;
+        }
+
+        void clearWake(void)
+        {
+            eventfd_t value;
+            eventfd_read(wakeDescriptor, &value);
+        }
+
+        void prepareRead(Request &request)
+        {
+            auto entry = getEntry();
+            entry->opcode = IORING_OP_READ;
+            entry->fd = request.fileDescriptor;
+            entry->addr = reinterpret_cast<uint64_t>(request.buffer.get() + request.offset);
+            entry->len = static_cast<uint32_t>(std::min((request.size - request.offset), MaximumReadSize));
+            entry->off = request.offset;
+            entry->user_data = reinterpret_cast<uint64_t>(&request);
+        }
+
+        void prepareCancel(Request &request)
+        {
+            auto entry = getEntry();
+            entry->opcode = IORING_OP_ASYNC_CANCEL;
+            entry->fd = -1;
+            entry->addr = reinterpret_cast<uint64_t>(&request);
+            entry->user_data = CancelIdentifier;
+        }
+
+        template <typename FUNCTION>
+        void reap(FUNCTION &&onCompletion)
+        {
+            uint32_t head = *completionHead;
+            const uint32_t tail = std::atomic_ref<uint32_t>(*completionTail).load(std::memory_order_acquire);
+            for (; head != tail; ++head)
+            {
+                auto const &completion = completionEntryList[head & completionMask];
+                onCompletion(completion.user_data, completion.res);
+            }
+
+            std::atomic_ref<uint32_t>(*completionHead).store(head, std::memory_order_release);
+        }
+    };
+#else
+    struct FileReader::Ring
+    {
+    };
+#endif
+
+    FileReader::ReadAwaiter::ReadAwaiter(FileReader *fileReader, TaskGroup &taskGroup, FileSystem::Path const &filePath, Priority priority, ThreadPool::Queue queue)
+        : fileReader(fileReader)
+    {
+        batch.taskGroup = &taskGroup;
+        batch.priority = priority;
+        batch.queue = queue;
+        request.filePath = filePath;
+    }
+
+    void FileReader::ReadAwaiter::await_suspend(std::coroutine_handle<> coroutine)
+    {
+        batch.coroutine = coroutine;
+        fileReader->submit(batch, &request, 1);
+    }
+
+    FileReader::BatchReadAwaiter::BatchReadAwaiter(FileReader *fileReader, TaskGroup &taskGroup, std::vector<FileSystem::Path> const &filePathList, Priority priority, ThreadPool::Queue queue)
+        : fileReader(fileReader)
+        , requestList(filePathList.size())
+    {
+        batch.taskGroup = &taskGroup;
+        batch.priority = priority;
+        batch.queue = queue;
+        for (size_t requestIndex = 0; requestIndex < filePathList.size(); ++requestIndex)
+        {
+            requestList[requestIndex].filePath = filePathList[requestIndex];
+        }
+    }
+
+    void FileReader::BatchReadAwaiter::await_suspend(std::coroutine_handle<> coroutine)
+    {
+        batch.coroutine = coroutine;
+        fileReader->submit(batch, requestList.data(), requestList.size());
+    }
+
+    std::vector<FileSystem::FileView> FileReader::BatchReadAwaiter::await_resume()
+    {
+        if (batch.cancelled)
+        {
+            throw TaskCancelled();
+        }
+
+        std::vector<FileSystem::FileView> fileViewList;
+        fileViewList.reserve(requestList.size());
+        for (auto &request : requestList)
+        {
+            fileViewList.push_back(std::move(request.fileView));
+        }
+
+        return fileViewList;
+    }
+
+    FileReader::FileReader(ThreadPool &threadPool, uint32_t queueDepth, uint32_t threadCount)
+        : threadPool(threadPool)
+    {
+        if (createRing(queueDepth))
+        {
+            threadList.emplace_back(&FileReader::runRing, this);
+        }
+        else
+        {
+            for (uint32_t threadIndex = 0; threadIndex < std::max(threadCount, 1U); ++threadIndex)
+            {
+                threadList.emplace_back(&FileReader::runReader, this);
+            }
+        }
+    }
+
+    FileReader::~FileReader(void)
+    {
+        std::vector<Request *> cancelList;
+        {
+            std::lock_guard<std::mutex> lock(requestMutex);
+            stop = true;
+            for (auto &pending : pendingList)
+            {
+                cancelList.insert(std::end(cancelList), std::begin(pending), std::end(pending));
+                pending.clear();
+            }
+
+            for (auto request : activeList)
+            {
+                request->cancelled = true;
+            }
+        }
+
+        for (auto request : cancelList)
+        {
+            complete(*request);
+        }
+
+        wake();
+        for (auto &thread : threadList)
+        {
+            thread.join();
+        }
+    }
+
+    // The batch can resume and be destroyed as soon as its last request is queued, so nothing is touched after that
+    void FileReader::submit(Batch &batch, Request *requestList, size_t requestCount)
+    {
+        batch.remainingCount.store(static_cast<uint32_t>(requestCount), std::memory_order_relaxed);
+        batch.taskGroup->acquire();
+
+        bool stopped = false;
+        {
+            std::lock_guard<std::mutex> lock(requestMutex);
+            stopped = stop;
+            if (!stopped)
+            {
+                auto &pending = pendingList[static_cast<size_t>(batch.priority)];
+                for (size_t requestIndex = 0; requestIndex < requestCount; ++requestIndex)
+                {
+                    requestList[requestIndex].batch = &batch;
+                    pending.push_back(&requestList[requestIndex]);
+                }
+            }
+        }
+
+        if (stopped)
+        {
+            for (size_t requestIndex = 0; requestIndex < requestCount; ++requestIndex)
+            {
+                requestList[requestIndex].batch = &batch;
+                complete(requestList[requestIndex]);
+            }
+        }
+        else
+        {
+            wake();
+        }
+    }
+
+    void FileReader::wake(void)
+    {
+#ifdef __linux__
+        if (ring)
+        {
+            eventfd_write(ring->wakeDescriptor, 1);
+            return;
+        }
+#endif
+
+        requestCondition.notify_all();
+    }
+
+    bool FileReader::popPending(Request *&request)
+    {
+        for (auto &pending : pendingList)
+        {
+            if (!pending.empty())
+            {
+                request = pending.front();
+                pending.pop_front();
+                activeList.push_back(request);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void FileReader::finish(Request &request, FileSystem::FileView fileView)
+    {
+        {
+            std::lock_guard<std::mutex> lock(requestMutex);
+            std::erase(activeList, &request);
+            if (!request.cancelled)
+            {
+                request.fileView = std::move(fileView);
+            }
+        }
+
+        idleCondition.notify_all();
+        complete(request);
+    }
+
+    void FileReader::complete(Request &request)
+    {
+        auto &batch = *request.batch;
+        if (batch.remainingCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            // A stopped pool refuses the resume, the coroutine then unwinds here as cancelled
+            auto taskGroup = batch.taskGroup;
+            if (!threadPool.enqueue(ThreadPool::WorkItem{ batch.coroutine, taskGroup, batch.queue, &batch.cancelled }))
+            {
+                batch.cancelled = true;
+                batch.coroutine.resume();
+            }
+
+            taskGroup->release();
+        }
+    }
+
+    void FileReader::cancel(TaskGroup &taskGroup)
+    {
+        std::vector<Request *> cancelList;
+        {
+            std::lock_guard<std::mutex> lock(requestMutex);
+            for (auto &pending : pendingList)
+            {
+                std::erase_if(pending, [&](Request *request) -> bool
+                {
+                    if (request->batch->taskGroup == &taskGroup)
+                    {
+                        cancelList.push_back(request);
+                        return true;
+                    }
+
+                    return false;
+                });
+            }
+
+            for (auto request : activeList)
+            {
+                if (request->batch->taskGroup == &taskGroup)
+                {
+                    request->cancelled = true;
+                }
+            }
+        }
+
+        for (auto request : cancelList)
+        {
+            complete(*request);
+        }
+
+        wake();
+
+        std::unique_lock<std::mutex> lock(requestMutex);
+        idleCondition.wait(lock, [&](void) -> bool
+        {
+            return std::none_of(std::begin(activeList), std::end(activeList), [&](Request *request) -> bool
+            {
+                return (request->batch->taskGroup == &taskGroup);
+            });
+        });
+    }
+
+#ifdef __linux__
+    bool FileReader::createRing(uint32_t queueDepth)
+    {
+        auto newRing = std::make_unique<Ring>();
+        if (!newRing->create(queueDepth))
+        {
+            return false;
+        }
+
+        ring = std::move(newRing);
+        return true;
+    }
+
+    void FileReader::runRing(void)
+    {
+        GEK_PROFILE_THREAD("File Reader");
+
+        ring->armWake();
+        std::vector<Request *> startList;
+        std::vector<Request *> cancelList;
+        while (true)
+        {
+            startList.clear();
+            cancelList.clear();
+            {
+                std::lock_guard<std::mutex> lock(requestMutex);
+                Request *request = nullptr;
+                while (activeList.size() < ring->maximumActiveCount && popPending(request))
+                {
+                    startList.push_back(request);
+                }
+
+                for (auto activeRequest : activeList)
+                {
+                    if (activeRequest->cancelled && !activeRequest->cancelSubmitted && activeRequest->fileDescriptor >= 0)
+                    {
+                        activeRequest->cancelSubmitted = true;
+                        cancelList.push_back(activeRequest);
+                    }
+                }
+
+                if (stop && activeList.empty())
+                {
+                    break;
+                }
+            }
+
+            for (auto request : startList)
+            {
+                startRead(*request);
+            }
+
+            for (auto request : cancelList)
+            {
+                ring->prepareCancel(*request);
+            }
+
+            // Everything prepared above goes to the kernel in one call, which then sleeps until something completes
+            ring->flush(1);
+            ring->reap([&](uint64_t identifier, int32_t result) -> void
+            {
+                if (identifier == WakeIdentifier)
+                {
+                    ring->clearWake();
+                    ring->armWake();
+                }
+                else if (identifier != CancelIdentifier)
+                {
+                    onReadComplete(*reinterpret_cast<Request *>(identifier), result);
+                }
+            });
+        };
+    }
+
+    // Opening is still a blocking call on the service thread, only the reads themselves go through the ring
+    void FileReader::startRead(Request &request)
+    {
+        // Archived files are already mapped, handing out a view is cheaper than a round trip through the ring
+        Archive::Location location;
+        if (Archive::Find(request.filePath, location))
+        {
+            finish(request, FileSystem::Map(request.filePath));
+            return;
+        }
+
+        GEK_PROFILE_ZONE("FileReader::open");
+        request.fileDescriptor = open(request.filePath.getString().data(), (O_RDONLY | O_CLOEXEC));
+        if (request.fileDescriptor < 0)
+        {
+            finish(request, {});
+            return;
+        }
+
+        struct stat fileStatus;
+        if (fstat(request.fileDescriptor, &fileStatus) != 0 || fileStatus.st_size <= 0)
+        {
+            close(request.fileDescriptor);
+            request.fileDescriptor = -1;
+            finish(request, {});
+            return;
+        }
+
+        request.size = static_cast<size_t>(fileStatus.st_size);
+        request.offset = 0;
+        request.buffer = std::make_shared_for_overwrite<uint8_t[]>(request.size);
+        ring->prepareRead(request);
+    }
+
+    void FileReader::onReadComplete(Request &request, int32_t result)
+    {
+        bool cancelled = false;
+        {
+            std::lock_guard<std::mutex> lock(requestMutex);
+            cancelled = request.cancelled;
+        }
+
+        if (!cancelled && (result == -EINTR || result == -EAGAIN))
+        {
+            ring->prepareRead(request);
+            return;
+        }
+
+        // Some files refuse ring reads even though the kernel supports them, those are finished with plain reads
+        if (!cancelled && (result == -EINVAL || result == -EOPNOTSUPP))
+        {
+            GEK_PROFILE_ZONE("FileReader::read");
+            result = 0;
+            while (request.offset < request.size)
+            {
+                auto readSize = pread(request.fileDescriptor, (request.buffer.get() + request.offset), std::min((request.size - request.offset), MaximumReadSize), request.offset);
+                if (readSize < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                else if (readSize <= 0)
+                {
+                    result = (readSize < 0 ? -errno : 0);
+                    break;
+                }
+
+                request.offset += static_cast<size_t>(readSize);
+            }
+        }
+
+        if (result > 0)
+        {
+            request.offset += static_cast<size_t>(result);
+            if (!cancelled && request.offset < request.size)
+            {
+                ring->prepareRead(request);
+                return;
+            }
+        }
+
+        close(request.fileDescriptor);
+        request.fileDescriptor = -1;
+
+        // A file that shrank after it was opened is returned with whatever could still be read
+        FileSystem::FileView fileView;
+        if (result >= 0 && request.offset > 0)
+        {
+            auto buffer = std::move(request.buffer);
+            fileView = FileSystem::FileView(buffer, buffer.get(), request.offset);
+        }
+
+        request.buffer.reset();
+        finish(request, std::move(fileView));
+    }
+#else
+    bool FileReader::createRing(uint32_t queueDepth)
+    {
+        return false;
+    }
+
+    void FileReader::runRing(void)
+    {
+    }
+
+    void FileReader::startRead(Request &request)
+    {
+    }
+
+    void FileReader::onReadComplete(Request &request, int32_t result)
+    {
+    }
+#endif
+
+    void FileReader::runReader(void)
+    {
+        GEK_PROFILE_THREAD("File Reader");
+        while (true)
+        {
+            Request *request = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(requestMutex);
+                requestCondition.wait(lock, [&](void) -> bool
+                {
+                    return (stop || std::any_of(std::begin(pendingList), std::end(pendingList), [](auto const &pending) -> bool
+                    {
+                        return !pending.empty();
+                    }));
+                });
+
+                if (!popPending(request))
+                {
+                    break;
+                }
+            }
+
+            GEK_PROFILE_ZONE("FileReader::read");
+            auto buffer = std::make_shared<std::vector<uint8_t>>(FileSystem::Load(request->filePath));
+            finish(*request, (buffer->empty() ? FileSystem::FileView() : FileSystem::FileView(buffer, buffer->data(), buffer->size())));
+        };
+    }
+}; // namespace Gek
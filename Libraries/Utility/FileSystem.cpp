@@ -1,7 +1,13 @@
 #include "GEK/Utility/FileSystem.hpp"
+#include "GEK/Utility/Archive.hpp"
 
 #ifdef _WIN32
 #include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 namespace Gek
@@ -157,26 +163,51 @@ namespace Gek
 
         bool Path::isNewerThan(Path const &path) const
         {
+            // Archived files carry the time the archive itself was written
+            auto getWriteTimePath = [](Path const &path) -> std::filesystem::path
+            {
+                Archive::Location location;
+                return (Archive::Find(path, location) ? location.reader->getArchivePath().data : path.data);
+            };
+
             std::error_code errorCode;
-            auto thisWriteTime = std::filesystem::last_write_time(data, errorCode);
-            auto thatWriteTime = std::filesystem::last_write_time(path.data, errorCode);
+            auto thisWriteTime = std::filesystem::last_write_time(getWriteTimePath(*this), errorCode);
+            auto thatWriteTime = std::filesystem::last_write_time(getWriteTimePath(path), errorCode);
             return (thisWriteTime > thatWriteTime);
         }
 
         bool Path::isFile(void) const
         {
+            Archive::Location location;
+            if (Archive::Find(*this, location))
+            {
+                return !location.isDirectory();
+            }
+
             std::error_code errorCode;
             return std::filesystem::is_regular_file(data, errorCode);
         }
 
         size_t Path::getFileSize(void) const
         {
+            Archive::Location location;
+            if (Archive::Find(*this, location))
+            {
+                return (location.isDirectory() ? 0 : location.entry->size);
+            }
+
             std::error_code errorCode;
             return std::filesystem::file_size(data, errorCode);
         }
 
         bool Path::isDirectory(void) const
         {
+            Archive::Location location;
+            if (Archive::Find(*this, location))
+            {
+                return location.isDirectory();
+            }
+
             std::error_code errorCode;
             return std::filesystem::is_directory(data, errorCode);
         }
@@ -196,10 +227,48 @@ namespace Gek
 
         void Path::findFiles(std::function<bool(Path const &filePath)> onFileFound, bool recursive) const
         {
+            // Archived entries come first, loose files only add what the archive does not already hold
+            Archive::Location location;
+            const bool archived = (Archive::Find(*this, location) && location.isDirectory());
+            if (archived)
+            {
+                bool searching = true;
+                auto directory = (location.entry ? location.reader->getName(*location.entry) : std::string_view());
+                location.reader->findFiles(directory, [&](Archive::Entry const &entry) -> bool
+                {
+                    auto name = location.reader->getName(entry);
+                    Path filePath(*this / name.substr(directory.empty() ? 0 : (directory.size() + 1)));
+                    if (entry.isDirectory())
+                    {
+                        if (recursive)
+                        {
+                            filePath.findFiles(onFileFound, recursive);
+                        }
+                    }
+                    else
+                    {
+                        searching = onFileFound(filePath);
+                    }
+
+                    return searching;
+                }, false);
+
+                if (!searching)
+                {
+                    return;
+                }
+            }
+
             std::error_code errorCode;
             for (auto const &fileSearch : std::filesystem::directory_iterator(data, errorCode))
             {
                 Path filePath(fileSearch.path());
+                Archive::Location fileLocation;
+                if (archived && Archive::Find(filePath, fileLocation))
+                {
+                    continue;
+                }
+
                 if (recursive && filePath.isDirectory())
                 {
                     filePath.findFiles(onFileFound, recursive);
@@ -219,7 +288,13 @@ namespace Gek
         std::string Read(Path const &filePath)
         {
             std::string buffer;
-            if (filePath.isFile())
+            Archive::Location location;
+            if (Archive::Find(filePath, location))
+            {
+                auto fileView = (location.isDirectory() ? FileView() : location.reader->getView(*location.entry));
+                buffer.assign(reinterpret_cast<char const *>(fileView.getData()), fileView.getSize());
+            }
+            else if (filePath.isFile())
             {
                 std::ifstream file;
                 file.open(filePath.getString().data(), std::ios::in);
@@ -238,7 +313,14 @@ namespace Gek
         std::vector<uint8_t> Load(Path const &filePath, std::uintmax_t limitReadSize)
         {
             std::vector<uint8_t> buffer;
-            if (filePath.isFile())
+            Archive::Location location;
+            if (Archive::Find(filePath, location))
+            {
+                auto fileView = (location.isDirectory() ? FileView() : location.reader->getView(*location.entry));
+                auto size = (limitReadSize == 0 ? fileView.getSize() : std::min(fileView.getSize(), size_t(limitReadSize)));
+                buffer.assign(fileView.getData(), (fileView.getData() + size));
+            }
+            else if (filePath.isFile())
             {
                 std::uintmax_t fileSize = filePath.getFileSize();
                 auto size = (limitReadSize == 0 ? fileSize : std::min(fileSize, limitReadSize));
@@ -258,6 +340,155 @@ namespace Gek
             return buffer;
         }
 
+        MappedFile::MappedFile(Path const &filePath)
+        {
+#ifdef _WIN32
+            fileHandle = CreateFileA(filePath.getString().data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (fileHandle == INVALID_HANDLE_VALUE)
+            {
+                fileHandle = nullptr;
+                return;
+            }
+
+            LARGE_INTEGER fileSize;
+            if (GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart > 0)
+            {
+                mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mappingHandle)
+                {
+                    data = static_cast<uint8_t const *>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+                    size = (data ? static_cast<size_t>(fileSize.QuadPart) : 0);
+                }
+            }
+
+            if (!data)
+            {
+                close();
+            }
+#else
+            int fileDescriptor = open(filePath.getString().data(), O_RDONLY);
+            if (fileDescriptor < 0)
+            {
+                return;
+            }
+
+            struct stat fileStatus;
+            if (fstat(fileDescriptor, &fileStatus) == 0 && fileStatus.st_size > 0)
+            {
+                auto mapping = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+                if (mapping != MAP_FAILED)
+                {
+                    data = static_cast<uint8_t const *>(mapping);
+                    size = static_cast<size_t>(fileStatus.st_size);
+                    madvise(mapping, size, MADV_SEQUENTIAL);
+                }
+            }
+
+            // The mapping keeps its own reference to the file
+            ::close(fileDescriptor);
+#endif
+        }
+
+        MappedFile::MappedFile(MappedFile &&mappedFile) noexcept
+        {
+            *this = std::move(mappedFile);
+        }
+
+        MappedFile::~MappedFile(void)
+        {
+            close();
+        }
+
+        MappedFile &MappedFile::operator=(MappedFile &&mappedFile) noexcept
+        {
+            if (this != &mappedFile)
+            {
+                close();
+                std::swap(data, mappedFile.data);
+                std::swap(size, mappedFile.size);
+#ifdef _WIN32
+                std::swap(fileHandle, mappedFile.fileHandle);
+                std::swap(mappingHandle, mappedFile.mappingHandle);
+#endif
+            }
+
+            return *this;
+        }
+
+        FileView::FileView(std::shared_ptr<void const> owner, uint8_t const *data, size_t size)
+            : owner(std::move(owner))
+            , data(data)
+            , size(data ? size : 0)
+        {
+        }
+
+        FileView FileView::getView(size_t offset, size_t viewSize) const
+        {
+            if (!data || offset > size)
+            {
+                return FileView();
+            }
+
+            return FileView(owner, (data + offset), std::min(viewSize, (size - offset)));
+        }
+
+        FileView Map(Path const &filePath)
+        {
+            Archive::Location location;
+            if (Archive::Find(filePath, location))
+            {
+                return (location.isDirectory() ? FileView() : location.reader->getView(*location.entry));
+            }
+
+            auto mappedFile = std::make_shared<MappedFile>(filePath);
+            if (mappedFile->isValid())
+            {
+                auto data = mappedFile->getData();
+                auto size = mappedFile->getSize();
+                return FileView(std::move(mappedFile), data, size);
+            }
+
+            auto buffer = std::make_shared<std::vector<uint8_t>>(Load(filePath));
+            if (buffer->empty())
+            {
+                return FileView();
+            }
+
+            auto data = buffer->data();
+            auto size = buffer->size();
+            return FileView(std::move(buffer), data, size);
+        }
+
+        void MappedFile::close(void)
+        {
+#ifdef _WIN32
+            if (data)
+            {
+                UnmapViewOfFile(data);
+            }
+
+            if (mappingHandle)
+            {
+                CloseHandle(mappingHandle);
+            }
+
+            if (fileHandle)
+            {
+                CloseHandle(fileHandle);
+            }
+
+            fileHandle = nullptr;
+            mappingHandle = nullptr;
+#else
+            if (data)
+            {
+                munmap(const_cast<uint8_t *>(data), size);
+            }
+#endif
+            data = nullptr;
+            size = 0;
+        }
+
         Path GetCanonicalPath(Path const &path)
         {
             std::error_code errorCode;
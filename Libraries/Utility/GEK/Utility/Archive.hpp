@@ -0,0 +1,150 @@
+/// @file
+/// @author Todd Zupan <toddzupan@gmail.com>
+/// @version $Revision$
+/// @section LICENSE
+/// https://en.wikipedia.org/wiki/MIT_License
+/// @section DESCRIPTION
+/// Last Changed: $Date$
+#pragma once
+
+#include "GEK/Utility/Compression.hpp"
+#include "GEK/Utility/FileSystem.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Gek
+{
+    // Packed data directory, mapped once and looked up through a sorted index of path hashes.  Paths are matched
+    // without regard to case and always use forward slashes, relative to the directory that was packed.
+    namespace Archive
+    {
+        static constexpr std::string_view Extension = ".gekpak";
+        static constexpr uint32_t Version = 1;
+        static constexpr uint32_t DefaultAlignment = 16;
+
+        struct Header
+        {
+            uint32_t identifier = *(uint32_t *)"GEKP";
+            uint16_t version = Version;
+            uint16_t alignment = DefaultAlignment;
+            uint32_t entryCount = 0;
+            uint32_t nameSize = 0;
+            uint64_t entryOffset = 0;
+            uint64_t orderOffset = 0;
+            uint64_t nameOffset = 0;
+        };
+
+        struct Entry
+        {
+            enum Flags : uint8_t
+            {
+                Directory = 1 << 0,
+            };
+
+            uint64_t pathHash = 0;
+            uint64_t offset = 0;
+            uint64_t storedSize = 0;
+            uint64_t size = 0;
+            uint32_t nameOffset = 0;
+            uint16_t nameLength = 0;
+            Compression::Type compression = Compression::Type::None;
+            uint8_t flags = 0;
+
+            bool isDirectory(void) const
+            {
+                return (flags & Directory);
+            }
+        };
+
+        // Stable across builds and platforms, unlike std::hash
+        uint64_t GetPathHash(std::string_view path);
+
+        class Reader
+        {
+          private:
+            FileSystem::Path archivePath;
+            FileSystem::FileView archiveView;
+            Header const *header = nullptr;
+            Entry const *entryList = nullptr;
+            uint32_t const *orderList = nullptr;
+            char const *nameList = nullptr;
+
+          public:
+            Reader(FileSystem::Path const &archivePath);
+
+            bool isValid(void) const
+            {
+                return (header != nullptr);
+            }
+
+            FileSystem::Path const &getArchivePath(void) const
+            {
+                return archivePath;
+            }
+
+            uint32_t getEntryCount(void) const
+            {
+                return (header ? header->entryCount : 0);
+            }
+
+            std::string_view getName(Entry const &entry) const
+            {
+                return std::string_view((nameList + entry.nameOffset), entry.nameLength);
+            }
+
+            Entry const *find(std::string_view path) const;
+
+            // Stored entries share the mapping, compressed entries are expanded into their own buffer
+            FileSystem::FileView getView(Entry const &entry) const;
+
+            // Mirrors Path::findFiles, a recursive search only reports files
+            void findFiles(std::string_view directory, std::function<bool(Entry const &entry)> onEntryFound, bool recursive) const;
+        };
+
+        class Writer
+        {
+          private:
+            struct File
+            {
+                std::string path;
+                std::vector<uint8_t> data;
+                bool compress = false;
+            };
+
+            std::vector<File> fileList;
+
+          public:
+            void addFile(std::string_view path, std::vector<uint8_t> &&data, bool compress);
+
+            size_t getFileCount(void) const
+            {
+                return fileList.size();
+            }
+
+            // Directory entries are added for every parent of the files, data is aligned to the given power of two
+            bool save(FileSystem::Path const &archivePath, uint32_t alignment = DefaultAlignment) const;
+        };
+
+        // Where a path resolved to inside a mounted archive, the entry is null for the mount point itself
+        struct Location
+        {
+            std::shared_ptr<Reader const> reader;
+            Entry const *entry = nullptr;
+
+            bool isDirectory(void) const
+            {
+                return (!entry || entry->isDirectory());
+            }
+        };
+
+        // Paths under the mount point are served from the archive before the disk is checked
+        bool Mount(FileSystem::Path const &archivePath, FileSystem::Path const &mountPath);
+        void Unmount(FileSystem::Path const &mountPath);
+
+        bool Find(FileSystem::Path const &path, Location &location);
+    }; // namespace Archive
+}; // namespace Gek
@@ -0,0 +1,40 @@
+/// @file
+/// @author Todd Zupan <toddzupan@gmail.com>
+/// @version $Revision$
+/// @section LICENSE
+/// https://en.wikipedia.org/wiki/MIT_License
+/// @section DESCRIPTION
+/// Last Changed: $Date$
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Gek
+{
+    // Byte oriented LZ77 in the LZ4 block format, built for decompression speed rather than ratio
+    namespace Compression
+    {
+        enum class Type : uint8_t
+        {
+            None = 0,
+            LZ4,
+        };
+
+        size_t GetMaximumCompressedSize(size_t size);
+
+        // Returns the compressed size, or zero when the data does not fit in the destination
+        size_t Compress(void const *source, size_t sourceSize, void *destination, size_t destinationCapacity);
+
+        // Fails on malformed input or when the result is not exactly the expected size
+        bool Decompress(void const *source, size_t sourceSize, void *destination, size_t destinationSize);
+
+        // Empty when compressing would not make the data any smaller
+        std::vector<uint8_t> Compress(void const *source, size_t sourceSize);
+
+        // Gathers byte n of every element together, runs in the high bytes of float data are otherwise invisible to LZ4
+        void Shuffle(void const *source, size_t size, size_t stride, void *destination);
+        void Unshuffle(void const *source, size_t size, size_t stride, void *destination);
+    }; // namespace Compression
+}; // namespace Gek
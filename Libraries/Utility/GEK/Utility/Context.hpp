@@ -9,6 +9,7 @@
 
 #include "GEK/Utility/FileSystem.hpp"
 #include "GEK/Utility/Hash.hpp"
+#include "GEK/Utility/Metrics.hpp"
 #include "GEK/Utility/String.hpp"
 #include <functional>
 #include <iostream>
@@ -26,6 +27,11 @@
     using TYPE##Ptr = std::unique_ptr<TYPE>; \
     struct TYPE
 
+// Log calls above this level are compiled out, 0 keeps only errors and 3 keeps everything
+#ifndef GEK_LOG_LEVEL
+#define GEK_LOG_LEVEL 3
+#endif
+
 namespace Gek
 {
     GEK_PREDECLARE(ContextUser);
@@ -64,22 +70,41 @@ namespace Gek
             }
         };
 
+        static constexpr LogLevel CompiledLogLevel = static_cast<LogLevel>(GEK_LOG_LEVEL);
+
         static ContextPtr Create(std::vector<FileSystem::Path> const *pluginSearchList, std::vector<FileSystem::Path> const *pluginList = nullptr);
 
         virtual ~Context(void) = default;
 
+        // Disabled levels return before the message is formatted
         template <typename... PARAMETERS>
         void log(LogLevel level, const LocationMessage &message, PARAMETERS &&...args) const
         {
-            vlog(level, message, std::make_format_args(args...));
+            if (level <= CompiledLogLevel && level <= getLogLevel())
+            {
+                vlog(level, message, std::make_format_args(args...));
+            }
         }
 
+        // Formats on the calling thread and queues the message for a background writer
         virtual void vlog(LogLevel level, const LocationMessage &message, std::format_args args) const = 0;
 
+        // Blocks until every message queued so far has been written
+        virtual void flushLog(void) const = 0;
+
+        virtual void setLogLevel(LogLevel level) = 0;
+        virtual LogLevel getLogLevel(void) const = 0;
+
         virtual void setLogSinkMask(uint8_t sinkMask) = 0;
         virtual uint8_t getLogSinkMask(void) const = 0;
         virtual void setLogFilePath(FileSystem::Path const &path, bool append = true) = 0;
 
+        // Left to the application since the handlers are process wide, on a crash they write the messages not yet
+        // written to the log file, or stderr, and then pass the crash on to the handlers installed before them
+        virtual void installCrashLogHandlers(void) = 0;
+
+        // Hot paths should keep a handle from getRuntimeMetrics instead of setting metrics by name
+        virtual Metrics::Registry &getRuntimeMetrics(void) = 0;
         virtual void setRuntimeMetric(std::string_view name, double value) = 0;
         virtual bool getRuntimeMetric(std::string_view name, double &value) const = 0;
         virtual std::unordered_map<std::string, double> getRuntimeMetricSnapshot(void) const = 0;
@@ -0,0 +1,182 @@
+/// @file
+/// @author Todd Zupan <toddzupan@gmail.com>
+/// @version $Revision$
+/// @section LICENSE
+/// https://en.wikipedia.org/wiki/MIT_License
+/// @section DESCRIPTION
+/// Last Changed: $Date$
+#pragma once
+
+#include "GEK/Utility/FileSystem.hpp"
+#include "GEK/Utility/ThreadPool.hpp"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Gek
+{
+    // Reads whole files for coroutines without blocking a pool worker.  Linux submits the reads to an io_uring
+    // from a single service thread, other platforms, or kernels without io_uring, use a few blocking reader
+    // threads instead.  The awaiting coroutine resumes on the pool once its files are in memory.
+    class FileReader final
+    {
+      public:
+        enum class Priority : uint8_t
+        {
+            High = 0,
+            Normal,
+            Low,
+            Count,
+        };
+
+      private:
+        static constexpr size_t PriorityCount = static_cast<size_t>(Priority::Count);
+
+        struct Ring;
+
+        // Shared by the requests of one co_await, the coroutine resumes when the last of them finishes
+        struct Batch
+        {
+            std::coroutine_handle<> coroutine;
+            TaskGroup *taskGroup = nullptr;
+            Priority priority = Priority::Normal;
+            ThreadPool::Queue queue = ThreadPool::Queue::Streaming;
+            std::atomic_uint32_t remainingCount = 0;
+            bool cancelled = false;
+        };
+
+        struct Request
+        {
+            FileSystem::Path filePath;
+            FileSystem::FileView fileView;
+            Batch *batch = nullptr;
+            bool cancelled = false;
+
+            // Only touched by the io_uring service thread
+            int fileDescriptor = -1;
+            bool cancelSubmitted = false;
+            std::shared_ptr<uint8_t[]> buffer;
+            size_t size = 0;
+            size_t offset = 0;
+        };
+
+        class ReadAwaiter
+        {
+          private:
+            FileReader *fileReader;
+            Batch batch;
+            Request request;
+
+          public:
+            ReadAwaiter(FileReader *fileReader, TaskGroup &taskGroup, FileSystem::Path const &filePath, Priority priority, ThreadPool::Queue queue);
+
+            constexpr bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> coroutine);
+
+            // Invalid if the file could not be read or the read was cancelled, throws TaskCancelled if the pool
+            // dropped the coroutine before it could resume
+            FileSystem::FileView await_resume()
+            {
+                if (batch.cancelled)
+                {
+                    throw TaskCancelled();
+                }
+
+                return std::move(request.fileView);
+            }
+        };
+
+        class BatchReadAwaiter
+        {
+          private:
+            FileReader *fileReader;
+            Batch batch;
+            std::vector<Request> requestList;
+
+          public:
+            BatchReadAwaiter(FileReader *fileReader, TaskGroup &taskGroup, std::vector<FileSystem::Path> const &filePathList, Priority priority, ThreadPool::Queue queue);
+
+            bool await_ready() const noexcept
+            {
+                return requestList.empty();
+            }
+
+            void await_suspend(std::coroutine_handle<> coroutine);
+
+            // One view per path, in the same order, throws TaskCancelled like ReadAwaiter
+            std::vector<FileSystem::FileView> await_resume();
+        };
+
+      private:
+        ThreadPool &threadPool;
+        std::unique_ptr<Ring> ring;
+        std::vector<std::thread> threadList;
+
+        mutable std::mutex requestMutex;
+        std::condition_variable requestCondition;
+        std::condition_variable idleCondition;
+        std::array<std::deque<Request *>, PriorityCount> pendingList;
+        std::vector<Request *> activeList;
+        bool stop = false;
+
+      private:
+        void submit(Batch &batch, Request *requestList, size_t requestCount);
+        void wake(void);
+
+        bool popPending(Request *&request);
+        void finish(Request &request, FileSystem::FileView fileView);
+        void complete(Request &request);
+
+        bool createRing(uint32_t queueDepth);
+        void runRing(void);
+        void startRead(Request &request);
+        void onReadComplete(Request &request, int32_t result);
+
+        void runReader(void);
+
+      public:
+        // The queue depth bounds how many reads io_uring has in flight, the thread count only applies to the fallback
+        FileReader(ThreadPool &threadPool, uint32_t queueDepth = 256, uint32_t threadCount = 2);
+
+        // Cancels everything still queued or in flight, the pool has to outlive the reader
+        ~FileReader(void);
+
+        FileReader(FileReader const &) = delete;
+        FileReader(FileReader &&) = delete;
+
+        FileReader &operator=(FileReader const &) = delete;
+        FileReader &operator=(FileReader &&) = delete;
+
+        bool isAsynchronous(void) const
+        {
+            return static_cast<bool>(ring);
+        }
+
+        // Higher priority files are always started first, the coroutine then resumes on the given pool queue
+        ReadAwaiter read(TaskGroup &taskGroup, FileSystem::Path const &filePath, Priority priority = Priority::Normal, ThreadPool::Queue queue = ThreadPool::Queue::Streaming)
+        {
+            return ReadAwaiter(this, taskGroup, filePath, priority, queue);
+        }
+
+        // Every file is queued at once and the coroutine resumes a single time when all of them have finished
+        BatchReadAwaiter read(TaskGroup &taskGroup, std::vector<FileSystem::Path> const &filePathList, Priority priority = Priority::Normal, ThreadPool::Queue queue = ThreadPool::Queue::Streaming)
+        {
+            return BatchReadAwaiter(this, taskGroup, filePathList, priority, queue);
+        }
+
+        // Finishes every read of the group with an invalid view and waits for reads already in flight to stop,
+        // cancel the reads before cancelling the same group on the pool
+        void cancel(TaskGroup &taskGroup);
+    };
+}; // namespace Gek
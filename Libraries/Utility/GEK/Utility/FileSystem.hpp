@@ -13,6 +13,8 @@
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <vector>
 
 namespace Gek
@@ -75,6 +77,79 @@ namespace Gek
         std::string Read(Path const &filePath);
         std::vector<uint8_t> Load(Path const &filePath, std::uintmax_t limitReadSize = 0);
 
+        // Read only view of an entire file, mapped into the address space instead of copied
+        class MappedFile
+        {
+          private:
+            uint8_t const *data = nullptr;
+            size_t size = 0;
+#ifdef _WIN32
+            void *fileHandle = nullptr;
+            void *mappingHandle = nullptr;
+#endif
+
+          public:
+            MappedFile(void) = default;
+            MappedFile(Path const &filePath);
+            MappedFile(MappedFile &&mappedFile) noexcept;
+            ~MappedFile(void);
+
+            MappedFile(MappedFile const &) = delete;
+            MappedFile &operator=(MappedFile const &) = delete;
+            MappedFile &operator=(MappedFile &&mappedFile) noexcept;
+
+            void close(void);
+
+            bool isValid(void) const
+            {
+                return (data != nullptr);
+            }
+
+            uint8_t const *getData(void) const
+            {
+                return data;
+            }
+
+            size_t getSize(void) const
+            {
+                return size;
+            }
+        };
+
+        // Shared read only view of a file, copies and sub views keep the whole file alive until the last one is gone
+        class FileView
+        {
+          private:
+            std::shared_ptr<void const> owner;
+            uint8_t const *data = nullptr;
+            size_t size = 0;
+
+          public:
+            FileView(void) = default;
+            FileView(std::shared_ptr<void const> owner, uint8_t const *data, size_t size);
+
+            bool isValid(void) const
+            {
+                return (data != nullptr);
+            }
+
+            uint8_t const *getData(void) const
+            {
+                return data;
+            }
+
+            size_t getSize(void) const
+            {
+                return size;
+            }
+
+            // Clamped to the end of this view
+            FileView getView(size_t offset, size_t size = std::numeric_limits<size_t>::max()) const;
+        };
+
+        // Maps the file without copying it, files that cannot be mapped are read into memory instead
+        FileView Map(Path const &filePath);
+
         template <typename DATA>
         void Write(std::ofstream &file, DATA *data, uint32_t size)
         {
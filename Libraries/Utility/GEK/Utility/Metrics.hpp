@@ -0,0 +1,130 @@
+/// @file
+/// @author Todd Zupan <toddzupan@gmail.com>
+/// @version $Revision$
+/// @section LICENSE
+/// https://en.wikipedia.org/wiki/MIT_License
+/// @section DESCRIPTION
+/// Last Changed: $Date$
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Gek
+{
+    namespace Metrics
+    {
+        enum class Type : uint8_t
+        {
+            // Last value written wins
+            Gauge = 0,
+            // Summed over every thread
+            Counter,
+            // Keeps the last value like a gauge and adds every sample to a histogram
+            Timing,
+        };
+
+        using Handle = uint32_t;
+        static constexpr Handle InvalidHandle = 0xFFFFFFFF;
+
+        // Samples are counted in buckets a quarter octave wide, starting at one microsecond when recording milliseconds
+        struct Histogram
+        {
+            static constexpr uint32_t BucketCount = 96;
+            static constexpr uint32_t BucketsPerOctave = 4;
+            static constexpr double MinimumValue = 0.001;
+
+            std::array<uint64_t, BucketCount> bucketList = {};
+            uint64_t count = 0;
+            double sum = 0.0;
+
+            static uint32_t GetBucket(double value) noexcept;
+            static double GetBucketValue(uint32_t bucket) noexcept;
+
+            double getMean(void) const noexcept
+            {
+                return (count ? (sum / double(count)) : 0.0);
+            }
+
+            // Returns the middle of the bucket holding the percentile, so it is within about ten percent of the sample
+            double getPercentile(double percentile) const noexcept;
+
+            // Samples recorded since the older histogram was taken
+            Histogram operator-(Histogram const &previous) const noexcept;
+        };
+
+        // Names are interned once into handles.  Updating through a handle never locks or allocates, counters and
+        // histograms are written to a shard owned by the calling thread and merged when a snapshot is taken.
+        class Registry
+        {
+          public:
+            static constexpr uint32_t MaximumMetricCount = 1024;
+            static constexpr uint32_t MaximumHistogramCount = 128;
+
+          private:
+            struct Shard;
+
+            struct Metric
+            {
+                std::string name;
+                Type type = Type::Gauge;
+            };
+
+            struct NameHash
+            {
+                using is_transparent = void;
+
+                size_t operator()(std::string_view name) const noexcept
+                {
+                    return std::hash<std::string_view>()(name);
+                }
+            };
+
+            const uint64_t identifier;
+
+            mutable std::shared_mutex metricMutex;
+            std::vector<Metric> metricList;
+            std::unordered_map<std::string, Handle, NameHash, std::equal_to<>> metricMap;
+            uint32_t histogramCount = 0;
+
+            // Fixed size so that the update path can index them while new names are being added
+            std::unique_ptr<std::atomic<double>[]> gaugeList;
+            std::unique_ptr<std::atomic_bool[]> writtenList;
+            std::unique_ptr<uint32_t[]> histogramIndexList;
+
+            mutable std::mutex shardMutex;
+            std::vector<std::unique_ptr<Shard>> shardList;
+
+          public:
+            Registry(void);
+            ~Registry(void);
+
+            // Returns the existing handle if the name was already registered, the type is only used the first time
+            Handle getHandle(std::string_view name, Type type = Type::Gauge);
+
+            void set(Handle handle, double value) noexcept;
+            void add(Handle handle, double value = 1.0) noexcept;
+            void record(Handle handle, double value) noexcept;
+
+            bool get(std::string_view name, double &value) const;
+
+            // Gauges and timings report their last value, counters their total
+            std::unordered_map<std::string, double> getSnapshot(void) const;
+
+            // Histograms are cumulative, subtract an earlier snapshot to look at a window of time
+            std::unordered_map<std::string, Histogram> getHistogramSnapshot(void) const;
+
+          private:
+            Shard &getShard(void);
+            double getValue(Handle handle) const;
+        };
+    }; // namespace Metrics
+}; // namespace Gek
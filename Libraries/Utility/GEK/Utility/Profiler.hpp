@@ -0,0 +1,81 @@
+/// @file
+/// @author Todd Zupan <toddzupan@gmail.com>
+/// @version $Revision$
+/// @section LICENSE
+/// https://en.wikipedia.org/wiki/MIT_License
+/// @section DESCRIPTION
+/// Last Changed: $Date$
+#pragma once
+
+#ifdef GEK_ENABLE_PROFILER
+
+#include "GEK/Utility/FileSystem.hpp"
+#include "GEK/Utility/Timer.hpp"
+#include <cstdint>
+#include <string_view>
+
+namespace Gek
+{
+    namespace Profiler
+    {
+        // Each thread records into its own ring buffer, once it wraps the oldest zones of the capture are lost
+        static constexpr uint32_t ThreadEventCount = 65536;
+
+        // Clears every thread's buffer and starts recording zones
+        void StartCapture(void);
+
+        // Stops recording and writes the capture as a Chrome trace, which Perfetto also opens, returns the zone count
+        size_t StopCapture(FileSystem::Path const &filePath);
+
+        bool IsCapturing(void) noexcept;
+
+        // Zone names are stored by pointer, names that are not string literals have to be interned first
+        char const *Intern(std::string_view name);
+
+        void SetThreadName(std::string_view name);
+
+        void Record(char const *name, uint64_t startTime, uint64_t endTime);
+
+        // Zones nested on the same thread show up as a hierarchy in the trace viewer
+        class Zone
+        {
+          private:
+            char const *name;
+            uint64_t startTime;
+
+          public:
+            Zone(char const *name) noexcept
+                : name(name)
+                , startTime(IsCapturing() ? Timer::GetNanoseconds() : 0)
+            {
+            }
+
+            ~Zone(void)
+            {
+                if (startTime)
+                {
+                    Record(name, startTime, Timer::GetNanoseconds());
+                }
+            }
+
+            Zone(Zone const &) = delete;
+            Zone &operator=(Zone const &) = delete;
+        };
+    }; // namespace Profiler
+}; // namespace Gek
+
+#define GEK_PROFILE_CONCATENATE_INNER(LEFT, RIGHT) LEFT##RIGHT
+#define GEK_PROFILE_CONCATENATE(LEFT, RIGHT) GEK_PROFILE_CONCATENATE_INNER(LEFT, RIGHT)
+#define GEK_PROFILE_ZONE(NAME) Gek::Profiler::Zone GEK_PROFILE_CONCATENATE(profileZone, __LINE__)(NAME)
+#define GEK_PROFILE_FUNCTION() GEK_PROFILE_ZONE(__func__)
+#define GEK_PROFILE_THREAD(NAME) Gek::Profiler::SetThreadName(NAME)
+#define GEK_PROFILE_INTERN(NAME) Gek::Profiler::Intern(NAME)
+
+#else
+
+#define GEK_PROFILE_ZONE(NAME)
+#define GEK_PROFILE_FUNCTION()
+#define GEK_PROFILE_THREAD(NAME)
+#define GEK_PROFILE_INTERN(NAME) nullptr
+
+#endif
@@ -9,9 +9,21 @@
 
 #include "GEK/Utility/Context.hpp"
 #include "GEK/Utility/String.hpp"
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <coroutine>
+#include <deque>
+#include <exception>
 #include <execution>
 #include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <tbb/concurrent_queue.h>
 
 namespace Gek
@@ -35,218 +47,496 @@ namespace Gek
         }
     }
 
-    struct TaskPromise;
+    // Thrown out of a co_await on the pool when the work was cancelled or the pool was stopped before it could run
+    struct TaskCancelled
+        : public std::exception
+    {
+        char const *what() const noexcept
+        {
+            return "Task cancelled";
+        }
+    };
 
-    class Task
+    // Shared state between a running coroutine and the Task that was returned for it.  The coroutine and the Task
+    // each hold a reference, so a discarded Task lets the coroutine finish and release itself.
+    struct TaskPromiseBase
     {
-      public:
-        struct promise_type
+        std::atomic<void *> continuation = nullptr;
+        std::atomic_uint32_t referenceCount = 2;
+        std::atomic_bool completed = false;
+        std::exception_ptr exception;
+
+        static void *GetCompletedState(void) noexcept
         {
-            Task get_return_object() noexcept
-            {
-                return {};
-            };
+            return reinterpret_cast<void *>(uintptr_t(1));
+        }
 
-            std::suspend_never initial_suspend() const noexcept
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept
             {
-                return {};
+                return false;
             }
 
-            std::suspend_never final_suspend() const noexcept
+            template <typename PROMISE>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<PROMISE> coroutine) const noexcept
             {
-                return {};
+                auto &promise = coroutine.promise();
+                auto continuation = promise.continuation.exchange(GetCompletedState(), std::memory_order_acq_rel);
+                promise.completed.store(true, std::memory_order_release);
+                promise.completed.notify_all();
+                if (promise.referenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    coroutine.destroy();
+                }
+
+                return (continuation ? std::coroutine_handle<>::from_address(continuation) : std::noop_coroutine());
             }
 
-            void return_void() noexcept
+            void await_resume() const noexcept
             {
             }
+        };
+
+        std::suspend_never initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        FinalAwaiter final_suspend() const noexcept
+        {
+            return {};
+        }
 
-            void unhandled_exception() noexcept
+        void unhandled_exception() noexcept
+        {
+            exception = std::current_exception();
+            try
+            {
+                std::rethrow_exception(exception);
+            }
+            catch (TaskCancelled const &)
+            {
+            }
+            catch (...)
             {
                 LogThreadPoolError("Unhandled Exception Occurred");
             }
-        };
+        }
+
+        bool release(void) noexcept
+        {
+            return (referenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1);
+        }
     };
 
-    class ThreadPool final
+    template <typename TYPE>
+    struct TaskPromise
+        : public TaskPromiseBase
     {
-        using Lock = std::unique_lock<std::mutex>;
+        std::optional<TYPE> result;
 
-      private:
-        uint32_t threadCount;
-        std::vector<std::thread> workerList;
-        tbb::concurrent_queue<std::coroutine_handle<void>> coroutineQueue;
+        template <typename VALUE>
+        void return_value(VALUE &&value)
+        {
+            result.emplace(std::forward<VALUE>(value));
+        }
 
-        std::mutex activeMutex;
-        std::condition_variable activeCondition;
-        std::atomic_bool stop = false;
-        std::atomic_uint32_t activeCount = 0;
+        TYPE getResult(void)
+        {
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
 
-      private:
-        void initializeWorker(void);
-        void releaseWorker(void);
+            return std::move(*result);
+        }
+    };
+
+    template <>
+    struct TaskPromise<void>
+        : public TaskPromiseBase
+    {
+        void return_void() noexcept
+        {
+        }
+
+        void getResult(void)
+        {
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+        }
+    };
 
-        void create(void)
+    // Coroutines returning a Task start immediately, the Task can be awaited by one other coroutine, waited on
+    // from a regular thread, or simply discarded to leave the coroutine running on its own
+    template <typename TYPE = void>
+    class Task
+    {
+      public:
+        struct promise_type
+            : public TaskPromise<TYPE>
         {
-            stop.store(false);
-            workerList.clear();
-            workerList.reserve(threadCount);
-            for (size_t count = 0; count < threadCount; ++count)
+            Task get_return_object() noexcept
             {
-                // Worker execution loop
-                workerList.emplace_back([&](void) -> void
-                                        {
-                    initializeWorker();
-					while (true)
-                    {
-						// Wait for additional work signal
-                        // Wait to be notified of work
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+        };
 
-                        Lock lock(activeMutex);
-                        activeCondition.wait(lock, [&](void) -> bool
-                        {
-                            return stop.load() || !coroutineQueue.empty();
-                        });
+      private:
+        std::coroutine_handle<promise_type> coroutine;
 
-                        // If stopping and no work remains, exit the work loop and thread
-                        if (stop.load() && coroutineQueue.empty())
-                        {
-                            break;
-                        }
+      private:
+        explicit Task(std::coroutine_handle<promise_type> coroutine)
+            : coroutine(coroutine)
+        {
+        }
 
-						// Task to execute
-                        std::coroutine_handle<void> coroutine;
-						
-						// Dequeue the next Task
-                        if (coroutineQueue.try_pop(coroutine))
-						{
-							// Execute
-                            try
-                            {
-                                coroutine.resume();
-                            }
-                            catch (const std::exception &exception)
-                            {
-                                LogThreadPoolError(std::string("ThreadPool worker exception: ") + exception.what());
-                            }
-                            catch (...)
-                            {
-                                LogThreadPoolError("ThreadPool worker exception: unknown");
-                            }
+      public:
+        Task(void) = default;
 
-                            activeCount--;
-                        }
-                    };
+        Task(Task &&task) noexcept
+            : coroutine(std::exchange(task.coroutine, nullptr))
+        {
+        }
 
-                    releaseWorker(); });
+        ~Task(void)
+        {
+            if (coroutine && coroutine.promise().release())
+            {
+                coroutine.destroy();
             }
         }
 
-        void enqueue(std::coroutine_handle<void> coroutine)
+        Task(Task const &) = delete;
+        Task &operator=(Task const &) = delete;
+
+        Task &operator=(Task &&task) noexcept
         {
-            if (stop.load())
+            if (this != &task)
             {
-                activeCount--;
-                return;
+                if (coroutine && coroutine.promise().release())
+                {
+                    coroutine.destroy();
+                }
+
+                coroutine = std::exchange(task.coroutine, nullptr);
             }
 
-            coroutineQueue.push(coroutine);
-            activeCondition.notify_one();
+            return *this;
         }
 
-      public:
-        ThreadPool(uint32_t threadCount)
-            : threadCount(threadCount)
+        bool isValid(void) const
         {
-            create();
+            return static_cast<bool>(coroutine);
         }
 
-        // Destructor joins all worker threads
-        ~ThreadPool(void)
+        bool isReady(void) const
         {
-            drain();
+            return (!coroutine || coroutine.promise().completed.load(std::memory_order_acquire));
         }
 
-        ThreadPool(ThreadPool const &) = delete;
-        ThreadPool(ThreadPool &&) = delete;
-
-        ThreadPool &operator=(ThreadPool const &) = delete;
-        ThreadPool &operator=(ThreadPool const &&) = delete;
+        // Blocks the calling thread, never call this from a pool worker that the task itself is waiting on
+        void wait(void) const
+        {
+            if (coroutine)
+            {
+                auto &completed = coroutine.promise().completed;
+                while (!completed.load(std::memory_order_acquire))
+                {
+                    completed.wait(false, std::memory_order_acquire);
+                }
+            }
+        }
 
-        bool empty(void) const
+        TYPE get(void)
         {
-            return coroutineQueue.empty();
+            wait();
+            return coroutine.promise().getResult();
         }
 
-        void join(void)
+        auto operator co_await() noexcept
         {
-            while (activeCount.load() > 0)
+            struct Awaiter
             {
-                std::this_thread::sleep_for(std::chrono::seconds(0));
+                std::coroutine_handle<promise_type> coroutine;
+
+                bool await_ready() const noexcept
+                {
+                    return coroutine.promise().completed.load(std::memory_order_acquire);
+                }
+
+                bool await_suspend(std::coroutine_handle<> awaitingCoroutine) const noexcept
+                {
+                    void *expected = nullptr;
+                    return coroutine.promise().continuation.compare_exchange_strong(expected, awaitingCoroutine.address(), std::memory_order_acq_rel);
+                }
+
+                TYPE await_resume()
+                {
+                    return coroutine.promise().getResult();
+                }
             };
+
+            return Awaiter{ coroutine };
         }
+    };
 
-        void drain(bool executePendingTasks = true)
+    // Counts the work scheduled against it so that a set of jobs can be joined without waiting on the whole pool
+    class TaskGroup
+    {
+        friend class ThreadPool;
+        friend class FileReader;
+
+      private:
+        std::atomic_uint32_t activeCount = 0;
+        std::atomic_uint32_t releasingCount = 0;
+
+        void acquire(void)
         {
-            if (executePendingTasks)
+            activeCount.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        // releasingCount covers the notify, so a joined group is never touched again and can be destroyed
+        void release(void)
+        {
+            releasingCount.fetch_add(1, std::memory_order_acq_rel);
+            if (activeCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
             {
-                join();
+                activeCount.notify_all();
             }
-            else
+
+            releasingCount.fetch_sub(1, std::memory_order_release);
+        }
+
+      public:
+        TaskGroup(void) = default;
+        TaskGroup(TaskGroup const &) = delete;
+        TaskGroup &operator=(TaskGroup const &) = delete;
+
+        bool empty(void) const
+        {
+            return (activeCount.load(std::memory_order_acquire) == 0);
+        }
+
+        void join(void)
+        {
+            for (auto count = activeCount.load(std::memory_order_acquire); count > 0; count = activeCount.load(std::memory_order_acquire))
             {
-                coroutineQueue.clear();
+                activeCount.wait(count, std::memory_order_acquire);
             }
 
-            if (!workerList.empty())
+            while (releasingCount.load(std::memory_order_acquire) > 0)
             {
-                stop.store(true);
-                activeCondition.notify_all();
+                std::this_thread::yield();
+            }
+        }
+    };
 
-                // Wait for threads to complete work
-                for (std::thread &worker : workerList)
-                {
-                    worker.join();
-                }
+    // Work stealing scheduler, each worker keeps its own deques that it runs newest first while idle workers
+    // steal the oldest work from each other.  Work is always taken from the first named queue that has any.
+    class ThreadPool final
+    {
+        friend class FileReader;
 
-                workerList.clear();
-            }
+      public:
+        enum class Queue : uint8_t
+        {
+            Frame = 0,
+            Streaming,
+            Background,
+            Count,
+        };
 
-            activeCount = 0;
-        }
+        struct Occupancy
+        {
+            uint32_t queued = 0;
+            uint32_t running = 0;
+        };
+
+      private:
+        static constexpr size_t QueueCount = static_cast<size_t>(Queue::Count);
 
-        void reset(void)
+        // Dropped work is still resumed, with cancelled set so that its awaiter throws TaskCancelled
+        struct WorkItem
         {
-            drain();
-            create();
-        }
+            std::coroutine_handle<> coroutine;
+            TaskGroup *taskGroup = nullptr;
+            Queue queue = Queue::Frame;
+            bool *cancelled = nullptr;
+        };
 
-        auto schedule()
+        struct Worker
         {
-            activeCount++;
-            struct Awaiter
+            std::mutex mutex;
+            std::array<std::deque<WorkItem>, QueueCount> queueList;
+        };
+
+        struct QueueCounter
+        {
+            std::atomic_uint32_t queued = 0;
+            std::atomic_uint32_t running = 0;
+        };
+
+        struct ScheduleAwaiter
+        {
+            ThreadPool *threadPool;
+            TaskGroup *taskGroup;
+            Queue queue;
+            bool cancelled = false;
+
+            constexpr bool await_ready() const noexcept
             {
-                ThreadPool *threadPool;
+                return false;
+            }
 
-                constexpr bool await_ready() const noexcept
+            // A stopped pool refuses the work, the coroutine then resumes straight away as cancelled.  Once enqueue
+            // accepts it a worker may already be resuming and destroying the frame, so the awaiter is not touched again.
+            bool await_suspend(std::coroutine_handle<> coroutine)
+            {
+                const bool accepted = threadPool->enqueue(WorkItem{ coroutine, taskGroup, queue, &cancelled });
+                if (!accepted)
                 {
-                    return false;
+                    cancelled = true;
                 }
 
-                constexpr void await_resume() const noexcept
-                {
-                }
+                return accepted;
+            }
 
-                void await_suspend(std::coroutine_handle<> coroutine) const noexcept
+            void await_resume() const
+            {
+                if (cancelled)
                 {
-                    threadPool->enqueue(coroutine);
+                    throw TaskCancelled();
                 }
+            }
+        };
 
-                void return_void() noexcept
-                {
-                }
+      private:
+        uint32_t threadCount;
+        std::vector<std::thread> threadList;
+        std::vector<std::unique_ptr<Worker>> workerList;
+        std::array<tbb::concurrent_queue<WorkItem>, QueueCount> injectionQueueList;
+        std::array<QueueCounter, QueueCount> queueCounterList;
+
+        TaskGroup activeGroup;
+        std::atomic_bool stop = false;
+        std::atomic_uint32_t pendingCount = 0;
+        std::atomic_uint32_t sleepingCount = 0;
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
+
+      private:
+        void initializeWorker(void);
+        void releaseWorker(void);
+
+        void create(void);
+        void runWorker(uint32_t workerIndex);
+        bool dequeue(uint32_t workerIndex, WorkItem &workItem);
+        void execute(WorkItem const &workItem);
+        bool enqueue(WorkItem &&workItem);
+        void discard(WorkItem const &workItem);
+
+      public:
+        // A thread count of zero sizes the pool to the hardware, leaving one core for the calling thread
+        ThreadPool(uint32_t threadCount = 0);
+
+        // Destructor joins all worker threads
+        ~ThreadPool(void);
+
+        ThreadPool(ThreadPool const &) = delete;
+        ThreadPool(ThreadPool &&) = delete;
+
+        ThreadPool &operator=(ThreadPool const &) = delete;
+        ThreadPool &operator=(ThreadPool const &&) = delete;
+
+        uint32_t getThreadCount(void) const
+        {
+            return threadCount;
+        }
+
+        bool empty(void) const
+        {
+            return (pendingCount.load(std::memory_order_acquire) == 0);
+        }
+
+        Occupancy getOccupancy(Queue queue) const
+        {
+            auto &queueCounter = queueCounterList[static_cast<size_t>(queue)];
+            return { queueCounter.queued.load(std::memory_order_relaxed), queueCounter.running.load(std::memory_order_relaxed) };
+        }
+
+        static std::string_view GetQueueName(Queue queue)
+        {
+            switch (queue)
+            {
+            case Queue::Frame:
+                return "frame";
+
+            case Queue::Streaming:
+                return "streaming";
+
+            case Queue::Background:
+                return "background";
+
+            default:
+                return "unknown";
             };
+        }
+
+        // Waits for everything scheduled on the pool, use a TaskGroup to wait on a subset
+        void join(void)
+        {
+            activeGroup.join();
+        }
+
+        // Drops work of the group that has not started yet, then waits for whatever is still running, never call
+        // this from inside the group itself.  Dropped coroutines resume on the calling thread with TaskCancelled.
+        void cancel(TaskGroup &taskGroup);
+
+        // Without executePendingTasks, queued work is dropped the same way cancel drops it
+        void drain(bool executePendingTasks = true);
+        void reset(void);
 
-            return Awaiter{ this };
+        auto schedule(Queue queue)
+        {
+            return ScheduleAwaiter{ this, nullptr, queue };
+        }
+
+        auto schedule(TaskGroup &taskGroup, Queue queue)
+        {
+            return ScheduleAwaiter{ this, &taskGroup, queue };
+        }
+
+        // Runs a callable on the pool, the returned task can be awaited or waited on for the result
+        template <typename FUNCTION>
+        Task<std::invoke_result_t<FUNCTION>> run(FUNCTION function, Queue queue)
+        {
+            co_await schedule(queue);
+            if constexpr (std::is_void_v<std::invoke_result_t<FUNCTION>>)
+            {
+                function();
+            }
+            else
+            {
+                co_return function();
+            }
+        }
+
+        template <typename FUNCTION>
+        Task<std::invoke_result_t<FUNCTION>> run(TaskGroup &taskGroup, FUNCTION function, Queue queue)
+        {
+            co_await schedule(taskGroup, queue);
+            if constexpr (std::is_void_v<std::invoke_result_t<FUNCTION>>)
+            {
+                function();
+            }
+            else
+            {
+                co_return function();
+            }
         }
     };
 }; // namespace Gek
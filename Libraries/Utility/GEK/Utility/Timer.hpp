@@ -8,6 +8,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 
 namespace Gek
 {
@@ -33,5 +34,8 @@ namespace Gek
         double getUpdateTime(void) const;
         double getAbsoluteTime(void) const;
         double getImmediateTime(void) const;
+
+        // Monotonic, only meaningful as a difference between two calls
+        static uint64_t GetNanoseconds(void) noexcept;
     };
 }; // namespace Gek
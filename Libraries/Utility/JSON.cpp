@@ -6,10 +6,9 @@ namespace Gek
     {
         Object Load(FileSystem::Path const &filePath)
         {
-            std::ifstream file(filePath.getString());
-            if (file.is_open())
+            if (filePath.isFile())
             {
-                return nlohmann::json::parse(file);
+                return nlohmann::json::parse(FileSystem::Read(filePath));
             }
             else
             {
@@ -0,0 +1,265 @@
+#include "GEK/Utility/Metrics.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Gek
+{
+    namespace Metrics
+    {
+        uint32_t Histogram::GetBucket(double value) noexcept
+        {
+            if (!(value > MinimumValue))
+            {
+                return 0;
+            }
+
+            const double bucket = (std::log2(value / MinimumValue) * BucketsPerOctave);
+            return std::min(static_cast<uint32_t>(bucket), (BucketCount - 1));
+        }
+
+        double Histogram::GetBucketValue(uint32_t bucket) noexcept
+        {
+            return (MinimumValue * std::exp2((double(bucket) + 0.5) / BucketsPerOctave));
+        }
+
+        double Histogram::getPercentile(double percentile) const noexcept
+        {
+            if (count == 0)
+            {
+                return 0.0;
+            }
+
+            const uint64_t rank = std::max(uint64_t(1), static_cast<uint64_t>(std::ceil(percentile * double(count))));
+            uint64_t seen = 0;
+            for (uint32_t bucket = 0; bucket < BucketCount; ++bucket)
+            {
+                seen += bucketList[bucket];
+                if (seen >= rank)
+                {
+                    return GetBucketValue(bucket);
+                }
+            }
+
+            return GetBucketValue(BucketCount - 1);
+        }
+
+        Histogram Histogram::operator-(Histogram const &previous) const noexcept
+        {
+            Histogram difference;
+            for (uint32_t bucket = 0; bucket < BucketCount; ++bucket)
+            {
+                difference.bucketList[bucket] = (bucketList[bucket] - std::min(bucketList[bucket], previous.bucketList[bucket]));
+                difference.count += difference.bucketList[bucket];
+            }
+
+            difference.sum = std::max(0.0, (sum - previous.sum));
+            return difference;
+        }
+
+        // Only the owning thread writes to a shard, so updates are a relaxed load and store instead of a read-modify-write
+        struct Registry::Shard
+        {
+            std::array<std::atomic<double>, MaximumMetricCount> counterList;
+            std::array<std::array<std::atomic<uint32_t>, Histogram::BucketCount>, MaximumHistogramCount> bucketList;
+            std::array<std::atomic<double>, MaximumHistogramCount> sumList;
+        };
+
+        template <typename TYPE>
+        void Accumulate(std::atomic<TYPE> &value, TYPE amount) noexcept
+        {
+            value.store((value.load(std::memory_order_relaxed) + amount), std::memory_order_relaxed);
+        }
+
+        static std::atomic<uint64_t> nextRegistryIdentifier = 1;
+
+        Registry::Registry(void)
+            : identifier(nextRegistryIdentifier++)
+            , gaugeList(std::make_unique<std::atomic<double>[]>(MaximumMetricCount))
+            , writtenList(std::make_unique<std::atomic_bool[]>(MaximumMetricCount))
+            , histogramIndexList(std::make_unique<uint32_t[]>(MaximumMetricCount))
+        {
+            metricList.reserve(MaximumMetricCount);
+        }
+
+        Registry::~Registry(void) = default;
+
+        Handle Registry::getHandle(std::string_view name, Type type)
+        {
+            {
+                std::shared_lock lock(metricMutex);
+                auto search = metricMap.find(name);
+                if (search != std::end(metricMap))
+                {
+                    return search->second;
+                }
+            }
+
+            std::unique_lock lock(metricMutex);
+            auto search = metricMap.find(name);
+            if (search != std::end(metricMap))
+            {
+                return search->second;
+            }
+
+            if (metricList.size() >= MaximumMetricCount)
+            {
+                return InvalidHandle;
+            }
+
+            // Timings fall back to plain gauges once every histogram is in use
+            if (type == Type::Timing && histogramCount >= MaximumHistogramCount)
+            {
+                type = Type::Gauge;
+            }
+
+            Handle handle = static_cast<Handle>(metricList.size());
+            histogramIndexList[handle] = (type == Type::Timing ? histogramCount++ : InvalidHandle);
+            metricList.push_back({ std::string(name), type });
+            metricMap.emplace(name, handle);
+            return handle;
+        }
+
+        void Registry::set(Handle handle, double value) noexcept
+        {
+            if (handle < MaximumMetricCount)
+            {
+                gaugeList[handle].store(value, std::memory_order_relaxed);
+                if (!writtenList[handle].load(std::memory_order_relaxed))
+                {
+                    writtenList[handle].store(true, std::memory_order_release);
+                }
+            }
+        }
+
+        void Registry::add(Handle handle, double value) noexcept
+        {
+            if (handle < MaximumMetricCount)
+            {
+                Accumulate(getShard().counterList[handle], value);
+                if (!writtenList[handle].load(std::memory_order_relaxed))
+                {
+                    writtenList[handle].store(true, std::memory_order_release);
+                }
+            }
+        }
+
+        void Registry::record(Handle handle, double value) noexcept
+        {
+            set(handle, value);
+            if (handle < MaximumMetricCount && histogramIndexList[handle] != InvalidHandle)
+            {
+                auto &shard = getShard();
+                auto histogram = histogramIndexList[handle];
+                Accumulate(shard.bucketList[histogram][Histogram::GetBucket(value)], 1U);
+                Accumulate(shard.sumList[histogram], value);
+            }
+        }
+
+        bool Registry::get(std::string_view name, double &value) const
+        {
+            Handle handle = InvalidHandle;
+            {
+                std::shared_lock lock(metricMutex);
+                auto search = metricMap.find(name);
+                if (search == std::end(metricMap))
+                {
+                    return false;
+                }
+
+                handle = search->second;
+            }
+
+            if (!writtenList[handle].load(std::memory_order_acquire))
+            {
+                return false;
+            }
+
+            value = getValue(handle);
+            return true;
+        }
+
+        std::unordered_map<std::string, double> Registry::getSnapshot(void) const
+        {
+            std::unordered_map<std::string, double> snapshot;
+            std::shared_lock lock(metricMutex);
+            snapshot.reserve(metricList.size());
+            for (Handle handle = 0; handle < metricList.size(); ++handle)
+            {
+                if (writtenList[handle].load(std::memory_order_acquire))
+                {
+                    snapshot.emplace(metricList[handle].name, getValue(handle));
+                }
+            }
+
+            return snapshot;
+        }
+
+        std::unordered_map<std::string, Histogram> Registry::getHistogramSnapshot(void) const
+        {
+            std::unordered_map<std::string, Histogram> snapshot;
+            std::shared_lock lock(metricMutex);
+            std::lock_guard shardLock(shardMutex);
+            for (Handle handle = 0; handle < metricList.size(); ++handle)
+            {
+                auto histogramIndex = histogramIndexList[handle];
+                if (histogramIndex == InvalidHandle)
+                {
+                    continue;
+                }
+
+                Histogram histogram;
+                for (auto const &shard : shardList)
+                {
+                    auto const &bucketList = shard->bucketList[histogramIndex];
+                    for (uint32_t bucket = 0; bucket < Histogram::BucketCount; ++bucket)
+                    {
+                        uint32_t bucketCount = bucketList[bucket].load(std::memory_order_relaxed);
+                        histogram.bucketList[bucket] += bucketCount;
+                        histogram.count += bucketCount;
+                    }
+
+                    histogram.sum += shard->sumList[histogramIndex].load(std::memory_order_relaxed);
+                }
+
+                snapshot.emplace(metricList[handle].name, histogram);
+            }
+
+            return snapshot;
+        }
+
+        // Keyed by registry identifier rather than address so that a registry created where an old one lived starts clean
+        Registry::Shard &Registry::getShard(void)
+        {
+            thread_local std::vector<std::pair<uint64_t, Shard *>> threadShardList;
+            for (auto const &[registryIdentifier, shard] : threadShardList)
+            {
+                if (registryIdentifier == identifier)
+                {
+                    return *shard;
+                }
+            }
+
+            std::lock_guard lock(shardMutex);
+            auto shard = shardList.emplace_back(std::make_unique<Shard>()).get();
+            threadShardList.emplace_back(identifier, shard);
+            return *shard;
+        }
+
+        double Registry::getValue(Handle handle) const
+        {
+            if (metricList[handle].type != Type::Counter)
+            {
+                return gaugeList[handle].load(std::memory_order_relaxed);
+            }
+
+            double total = 0.0;
+            std::lock_guard lock(shardMutex);
+            for (auto const &shard : shardList)
+            {
+                total += shard->counterList[handle].load(std::memory_order_relaxed);
+            }
+
+            return total;
+        }
+    }; // namespace Metrics
+}; // namespace Gek
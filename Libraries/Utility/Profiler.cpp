@@ -0,0 +1,220 @@
+#ifdef GEK_ENABLE_PROFILER
+
+#include "GEK/Utility/Profiler.hpp"
+#include <atomic>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace Gek
+{
+    namespace Profiler
+    {
+        namespace
+        {
+            struct Event
+            {
+                char const *name;
+                uint64_t startTime;
+                uint64_t endTime;
+            };
+
+            struct ThreadBuffer
+            {
+                uint32_t threadIdentifier = 0;
+                std::string name;
+
+                // A buffer left over from an older capture is reset by its own thread the next time it records
+                std::atomic<uint32_t> generation = 0;
+                std::atomic<uint64_t> writeCount = 0;
+                std::unique_ptr<Event[]> eventList;
+
+                // Set while the owning thread writes an event, StopCapture waits for it to clear before reading
+                std::atomic_bool recording = false;
+            };
+
+            std::atomic_bool capturing = false;
+            std::atomic<uint32_t> captureGeneration = 0;
+            uint64_t captureStartTime = 0;
+
+            // Buffers outlive their threads so that zones from short lived threads still make it into the capture
+            std::mutex bufferMutex;
+            std::vector<std::unique_ptr<ThreadBuffer>> bufferList;
+
+            std::mutex nameMutex;
+            std::unordered_set<std::string> nameSet;
+
+            thread_local ThreadBuffer *threadBuffer = nullptr;
+
+            ThreadBuffer &GetThreadBuffer(void)
+            {
+                if (!threadBuffer)
+                {
+                    std::lock_guard lock(bufferMutex);
+                    threadBuffer = bufferList.emplace_back(std::make_unique<ThreadBuffer>()).get();
+                    threadBuffer->threadIdentifier = static_cast<uint32_t>(bufferList.size());
+                }
+
+                return *threadBuffer;
+            }
+
+            void AppendEscaped(std::string &output, std::string_view text)
+            {
+                for (auto character : text)
+                {
+                    switch (character)
+                    {
+                    case '"':
+                        output += "\\\"";
+                        break;
+
+                    case '\\':
+                        output += "\\\\";
+                        break;
+
+                    default:
+                        if (static_cast<unsigned char>(character) < 0x20)
+                        {
+                            output += std::format("\\u{:04x}", static_cast<uint32_t>(character));
+                        }
+                        else
+                        {
+                            output += character;
+                        }
+
+                        break;
+                    };
+                }
+            }
+        }; // namespace
+
+        void StartCapture(void)
+        {
+            captureStartTime = Timer::GetNanoseconds();
+            captureGeneration.fetch_add(1, std::memory_order_acq_rel);
+            capturing.store(true, std::memory_order_release);
+        }
+
+        size_t StopCapture(FileSystem::Path const &filePath)
+        {
+            if (!capturing.exchange(false))
+            {
+                return 0;
+            }
+
+            // Threads that saw the capture still running finish their event first, everything after sees it stopped
+            std::lock_guard lock(bufferMutex);
+            for (auto const &buffer : bufferList)
+            {
+                while (buffer->recording.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            const uint32_t generation = captureGeneration.load(std::memory_order_acquire);
+            std::string output("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+            size_t zoneCount = 0;
+            bool firstEvent = true;
+            auto beginEvent = [&](void) -> void
+            {
+                output += (firstEvent ? "\n" : ",\n");
+                firstEvent = false;
+            };
+
+            for (auto const &buffer : bufferList)
+            {
+                beginEvent();
+                output += std::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"", buffer->threadIdentifier);
+                AppendEscaped(output, (buffer->name.empty() ? std::format("Thread {}", buffer->threadIdentifier) : buffer->name));
+                output += "\"}}";
+
+                if (buffer->generation.load(std::memory_order_acquire) != generation)
+                {
+                    continue;
+                }
+
+                const uint64_t writeCount = buffer->writeCount.load(std::memory_order_acquire);
+                const uint64_t firstIndex = (writeCount > ThreadEventCount ? (writeCount - ThreadEventCount) : 0);
+                for (uint64_t index = firstIndex; index < writeCount; ++index)
+                {
+                    auto const &event = buffer->eventList[index % ThreadEventCount];
+                    if (event.startTime < captureStartTime)
+                    {
+                        continue;
+                    }
+
+                    beginEvent();
+                    output += "{\"name\":\"";
+                    AppendEscaped(output, event.name);
+                    output += std::format("\",\"cat\":\"gek\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                                          buffer->threadIdentifier,
+                                          (double(event.startTime - captureStartTime) * 0.001),
+                                          (double(event.endTime - event.startTime) * 0.001));
+                    ++zoneCount;
+                }
+            }
+
+            output += "\n]}\n";
+            FileSystem::Save(filePath, output);
+            return zoneCount;
+        }
+
+        bool IsCapturing(void) noexcept
+        {
+            return capturing.load(std::memory_order_relaxed);
+        }
+
+        char const *Intern(std::string_view name)
+        {
+            std::lock_guard lock(nameMutex);
+            return nameSet.emplace(name).first->data();
+        }
+
+        void SetThreadName(std::string_view name)
+        {
+            auto &buffer = GetThreadBuffer();
+            std::lock_guard lock(bufferMutex);
+            buffer.name = name;
+        }
+
+        void Record(char const *name, uint64_t startTime, uint64_t endTime)
+        {
+            if (!capturing.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+
+            auto &buffer = GetThreadBuffer();
+            buffer.recording.store(true);
+            if (!capturing.load())
+            {
+                buffer.recording.store(false, std::memory_order_release);
+                return;
+            }
+
+            const uint32_t generation = captureGeneration.load(std::memory_order_acquire);
+            if (buffer.generation.load(std::memory_order_relaxed) != generation)
+            {
+                if (!buffer.eventList)
+                {
+                    buffer.eventList = std::make_unique<Event[]>(ThreadEventCount);
+                }
+
+                buffer.writeCount.store(0, std::memory_order_relaxed);
+                buffer.generation.store(generation, std::memory_order_release);
+            }
+
+            const uint64_t index = buffer.writeCount.load(std::memory_order_relaxed);
+            buffer.eventList[index % ThreadEventCount] = { name, startTime, endTime };
+            buffer.writeCount.store((index + 1), std::memory_order_release);
+            buffer.recording.store(false, std::memory_order_release);
+        }
+    }; // namespace Profiler
+}; // namespace Gek
+
+#endif
@@ -183,8 +183,16 @@ namespace Gek
     }
 
     ShuntingYard::ShuntingYard(ShuntingYard const &shuntingYard)
-        : seed(shuntingYard.seed), variableMap(shuntingYard.variableMap), operationsMap(shuntingYard.operationsMap), functionsMap(shuntingYard.functionsMap), mersineTwister(shuntingYard.mersineTwister), cache(shuntingYard.cache)
+        : seed(shuntingYard.seed), variableMap(shuntingYard.variableMap), operationsMap(shuntingYard.operationsMap), functionsMap(shuntingYard.functionsMap), mersineTwister(shuntingYard.mersineTwister)
     {
+        // Cached operands point into the source function map, and random captured the source generator, so neither can be shared
+        functionsMap["random"].function = [&](std::stack<float> &stack) -> float
+        {
+            float value2 = PopTop(stack);
+            float value1 = PopTop(stack);
+            std::uniform_real_distribution<float> uniformRealDistribution(value1, value2);
+            return uniformRealDistribution(mersineTwister);
+        };
     }
 
     void ShuntingYard::setVariable(std::string const &name, float value)
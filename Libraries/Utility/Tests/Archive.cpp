@@ -0,0 +1,272 @@
+#include "GEK/Utility/Archive.hpp"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace Gek;
+
+namespace
+{
+    std::vector<uint8_t> GetBytes(std::string_view text)
+    {
+        return std::vector<uint8_t>(std::begin(text), std::end(text));
+    }
+
+    std::vector<uint8_t> GetCompressibleData(void)
+    {
+        std::vector<uint8_t> data(8 * 1024);
+        for (size_t index = 0; index < data.size(); ++index)
+        {
+            data[index] = static_cast<uint8_t>(index % 23);
+        }
+
+        return data;
+    }
+
+    std::vector<uint8_t> GetIncompressibleData(void)
+    {
+        std::mt19937 generator(5678);
+        std::uniform_int_distribution<uint32_t> distribution(0, 255);
+        std::vector<uint8_t> data(1024);
+        for (auto &value : data)
+        {
+            value = static_cast<uint8_t>(distribution(generator));
+        }
+
+        return data;
+    }
+
+    std::vector<uint8_t> GetView(FileSystem::FileView const &view)
+    {
+        return std::vector<uint8_t>(view.getData(), (view.getData() + view.getSize()));
+    }
+
+    std::vector<uint8_t> ReadFile(std::filesystem::path const &path)
+    {
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    void WriteFile(std::filesystem::path const &path, std::vector<uint8_t> const &data)
+    {
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<char const *>(data.data()), data.size());
+    }
+
+    // Every test works in its own directory, removed again once the test is done
+    class ArchiveTest
+        : public testing::Test
+    {
+      protected:
+        std::filesystem::path rootPath;
+
+        void SetUp(void) override
+        {
+            auto testName = testing::UnitTest::GetInstance()->current_test_info()->name();
+            rootPath = (std::filesystem::temp_directory_path() / "gek_archive_test" / testName);
+            std::filesystem::remove_all(rootPath);
+            std::filesystem::create_directories(rootPath);
+        }
+
+        void TearDown(void) override
+        {
+            std::error_code errorCode;
+            std::filesystem::remove_all(rootPath, errorCode);
+        }
+
+        std::filesystem::path saveArchive(void)
+        {
+            Archive::Writer writer;
+            writer.addFile("Textures/Stone.png", GetCompressibleData(), true);
+            writer.addFile("models\\box.gek", GetIncompressibleData(), true);
+            writer.addFile("readme.txt", GetBytes("archived"), false);
+
+            auto archivePath = (rootPath / "data.gekpak");
+            EXPECT_TRUE(writer.save(archivePath));
+            return archivePath;
+        }
+    };
+}; // namespace
+
+TEST_F(ArchiveTest, ReaderFindsSavedFiles)
+{
+    Archive::Reader reader(saveArchive());
+    ASSERT_TRUE(reader.isValid());
+    EXPECT_EQ(reader.getEntryCount(), 5U);
+
+    auto stone = reader.find("textures\\STONE.png");
+    ASSERT_NE(stone, nullptr);
+    EXPECT_FALSE(stone->isDirectory());
+    EXPECT_EQ(stone->compression, Compression::Type::LZ4);
+    EXPECT_LT(stone->storedSize, stone->size);
+    EXPECT_EQ(stone->offset % Archive::DefaultAlignment, 0U);
+    EXPECT_EQ(GetView(reader.getView(*stone)), GetCompressibleData());
+
+    // Compressing would not have made it any smaller, so it is stored as it is
+    auto box = reader.find("./models/box.gek");
+    ASSERT_NE(box, nullptr);
+    EXPECT_EQ(box->compression, Compression::Type::None);
+    EXPECT_EQ(GetView(reader.getView(*box)), GetIncompressibleData());
+
+    auto readme = reader.find("readme.txt");
+    ASSERT_NE(readme, nullptr);
+    EXPECT_EQ(GetView(reader.getView(*readme)), GetBytes("archived"));
+
+    auto textures = reader.find("Textures/");
+    ASSERT_NE(textures, nullptr);
+    EXPECT_TRUE(textures->isDirectory());
+    EXPECT_EQ(reader.getView(*textures).getSize(), 0U);
+
+    EXPECT_EQ(reader.find("missing.txt"), nullptr);
+    EXPECT_EQ(reader.find("Textures/Stone"), nullptr);
+}
+
+TEST_F(ArchiveTest, ReaderFindsFilesByDirectory)
+{
+    Archive::Reader reader(saveArchive());
+    ASSERT_TRUE(reader.isValid());
+
+    std::set<std::string> nameList;
+    reader.findFiles("", [&](Archive::Entry const &entry) -> bool
+    {
+        nameList.insert(std::string(reader.getName(entry)));
+        return true;
+    }, true);
+    EXPECT_EQ(nameList, (std::set<std::string>{ "Textures/Stone.png", "models/box.gek", "readme.txt" }));
+
+    nameList.clear();
+    reader.findFiles("", [&](Archive::Entry const &entry) -> bool
+    {
+        nameList.insert(std::string(reader.getName(entry)));
+        return true;
+    }, false);
+    EXPECT_EQ(nameList, (std::set<std::string>{ "Textures", "models", "readme.txt" }));
+
+    nameList.clear();
+    reader.findFiles("TEXTURES", [&](Archive::Entry const &entry) -> bool
+    {
+        nameList.insert(std::string(reader.getName(entry)));
+        return true;
+    }, false);
+    EXPECT_EQ(nameList, (std::set<std::string>{ "Textures/Stone.png" }));
+}
+
+TEST_F(ArchiveTest, ReaderRejectsCorruptHeaders)
+{
+    auto data = ReadFile(saveArchive());
+    ASSERT_GE(data.size(), sizeof(Archive::Header));
+
+    auto writeAndRead = [&](std::vector<uint8_t> const &archiveData) -> bool
+    {
+        auto corruptPath = (rootPath / "corrupt.gekpak");
+        WriteFile(corruptPath, archiveData);
+        return Archive::Reader(corruptPath).isValid();
+    };
+
+    EXPECT_TRUE(writeAndRead(data));
+    EXPECT_FALSE(writeAndRead({}));
+    EXPECT_FALSE(writeAndRead(std::vector<uint8_t>(std::begin(data), (std::begin(data) + sizeof(Archive::Header) - 1))));
+    EXPECT_FALSE(writeAndRead(std::vector<uint8_t>(std::begin(data), (std::end(data) - 1))));
+
+    auto modifyHeader = [&](auto &&modify) -> std::vector<uint8_t>
+    {
+        auto corruptData = data;
+        Archive::Header header;
+        std::memcpy(&header, corruptData.data(), sizeof(Archive::Header));
+        modify(header);
+        std::memcpy(corruptData.data(), &header, sizeof(Archive::Header));
+        return corruptData;
+    };
+
+    EXPECT_FALSE(writeAndRead(modifyHeader([](Archive::Header &header) { header.identifier = 0; })));
+    EXPECT_FALSE(writeAndRead(modifyHeader([](Archive::Header &header) { ++header.version; })));
+    EXPECT_FALSE(writeAndRead(modifyHeader([](Archive::Header &header) { header.entryOffset += 1; })));
+    EXPECT_FALSE(writeAndRead(modifyHeader([&](Archive::Header &header) { header.nameOffset = data.size(); })));
+}
+
+TEST_F(ArchiveTest, ReaderRejectsCorruptEntries)
+{
+    auto data = ReadFile(saveArchive());
+    Archive::Header header;
+    std::memcpy(&header, data.data(), sizeof(Archive::Header));
+
+    auto modifyEntry = [&](std::string_view name, auto &&modify) -> std::filesystem::path
+    {
+        auto corruptData = data;
+        for (uint32_t entryIndex = 0; entryIndex < header.entryCount; ++entryIndex)
+        {
+            Archive::Entry entry;
+            auto entryData = (corruptData.data() + header.entryOffset + (entryIndex * sizeof(Archive::Entry)));
+            std::memcpy(&entry, entryData, sizeof(Archive::Entry));
+            if (std::string_view(reinterpret_cast<char const *>(corruptData.data() + header.nameOffset + entry.nameOffset), entry.nameLength) == name)
+            {
+                modify(entry);
+                std::memcpy(entryData, &entry, sizeof(Archive::Entry));
+            }
+        }
+
+        auto corruptPath = (rootPath / "corrupt.gekpak");
+        WriteFile(corruptPath, corruptData);
+        return corruptPath;
+    };
+
+    // Stored data that runs past the end of the archive fails the whole archive
+    EXPECT_FALSE(Archive::Reader(modifyEntry("readme.txt", [&](Archive::Entry &entry) { entry.storedSize = data.size(); })).isValid());
+
+    // Blocks that do not expand to exactly the recorded size are refused when they are read
+    for (auto modify : { +[](Archive::Entry &entry) { --entry.storedSize; }, +[](Archive::Entry &entry) { ++entry.size; }, +[](Archive::Entry &entry) { --entry.size; } })
+    {
+        Archive::Reader reader(modifyEntry("Textures/Stone.png", modify));
+        ASSERT_TRUE(reader.isValid());
+
+        auto stone = reader.find("Textures/Stone.png");
+        ASSERT_NE(stone, nullptr);
+        EXPECT_EQ(reader.getView(*stone).getSize(), 0U);
+    }
+}
+
+TEST_F(ArchiveTest, MountOverlaysDirectory)
+{
+    auto archivePath = saveArchive();
+    auto mountPath = (rootPath / "data");
+    WriteFile(mountPath / "readme.txt", GetBytes("loose"));
+    WriteFile(mountPath / "loose" / "notes.txt", GetBytes("notes"));
+
+    ASSERT_FALSE(Archive::Mount((rootPath / "missing.gekpak"), mountPath));
+    ASSERT_TRUE(Archive::Mount(archivePath, mountPath));
+
+    EXPECT_TRUE(FileSystem::Path(mountPath / "Textures" / "Stone.png").isFile());
+    EXPECT_TRUE(FileSystem::Path(mountPath / "Textures").isDirectory());
+    EXPECT_FALSE(FileSystem::Path(mountPath / "Textures").isFile());
+    EXPECT_TRUE(FileSystem::Path(mountPath / "loose" / "notes.txt").isFile());
+    EXPECT_EQ(FileSystem::Load(mountPath / "readme.txt"), GetBytes("archived"));
+    EXPECT_EQ(FileSystem::Load(mountPath / "Textures" / "Stone.png"), GetCompressibleData());
+    EXPECT_EQ(FileSystem::Load(mountPath / "loose" / "notes.txt"), GetBytes("notes"));
+
+    // Archived entries hide the loose file of the same name, every file is reported once
+    std::multiset<std::string> fileList;
+    FileSystem::Path(mountPath).findFiles([&](FileSystem::Path const &filePath) -> bool
+    {
+        fileList.insert(filePath.lexicallyRelative(mountPath).data.generic_string());
+        return true;
+    });
+    EXPECT_EQ(fileList, (std::multiset<std::string>{ "Textures/Stone.png", "loose/notes.txt", "models/box.gek", "readme.txt" }));
+
+    Archive::Unmount(mountPath);
+    EXPECT_FALSE(FileSystem::Path(mountPath / "Textures" / "Stone.png").isFile());
+    EXPECT_EQ(FileSystem::Load(mountPath / "readme.txt"), GetBytes("loose"));
+
+    fileList.clear();
+    FileSystem::Path(mountPath).findFiles([&](FileSystem::Path const &filePath) -> bool
+    {
+        fileList.insert(filePath.lexicallyRelative(mountPath).data.generic_string());
+        return true;
+    });
+    EXPECT_EQ(fileList, (std::multiset<std::string>{ "loose/notes.txt", "readme.txt" }));
+}
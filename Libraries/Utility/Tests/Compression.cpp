@@ -0,0 +1,140 @@
+#include "GEK/Utility/Compression.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace Gek;
+
+namespace
+{
+    std::vector<uint8_t> GetPatternData(size_t size)
+    {
+        std::vector<uint8_t> data(size);
+        for (size_t index = 0; index < size; ++index)
+        {
+            data[index] = static_cast<uint8_t>((index % 37) ^ ((index / 512) & 0x3));
+        }
+
+        return data;
+    }
+
+    std::vector<uint8_t> GetRandomData(size_t size)
+    {
+        std::mt19937 generator(1234);
+        std::uniform_int_distribution<uint32_t> distribution(0, 255);
+        std::vector<uint8_t> data(size);
+        for (auto &value : data)
+        {
+            value = static_cast<uint8_t>(distribution(generator));
+        }
+
+        return data;
+    }
+
+    // Raw block, compressed even when it does not come out any smaller
+    std::vector<uint8_t> CompressBlock(std::vector<uint8_t> const &data)
+    {
+        std::vector<uint8_t> block(Compression::GetMaximumCompressedSize(data.size()));
+        block.resize(Compression::Compress(data.data(), data.size(), block.data(), block.size()));
+        return block;
+    }
+}; // namespace
+
+TEST(Compression, RoundTripsCompressibleData)
+{
+    auto data = GetPatternData(64 * 1024);
+    auto compressed = Compression::Compress(data.data(), data.size());
+    ASSERT_FALSE(compressed.empty());
+    EXPECT_LT(compressed.size(), data.size());
+
+    std::vector<uint8_t> decompressed(data.size());
+    ASSERT_TRUE(Compression::Decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size()));
+    EXPECT_EQ(decompressed, data);
+}
+
+TEST(Compression, RoundTripsEmptyAndSingleByteData)
+{
+    for (size_t size : { size_t(0), size_t(1) })
+    {
+        auto data = GetPatternData(size);
+        EXPECT_TRUE(Compression::Compress(data.data(), data.size()).empty());
+
+        auto block = CompressBlock(data);
+        ASSERT_FALSE(block.empty());
+
+        std::vector<uint8_t> decompressed(data.size());
+        EXPECT_TRUE(Compression::Decompress(block.data(), block.size(), decompressed.data(), decompressed.size()));
+        EXPECT_EQ(decompressed, data);
+    }
+}
+
+TEST(Compression, RoundTripsIncompressibleData)
+{
+    auto data = GetRandomData(16 * 1024);
+    EXPECT_TRUE(Compression::Compress(data.data(), data.size()).empty());
+
+    auto block = CompressBlock(data);
+    ASSERT_FALSE(block.empty());
+    EXPECT_LE(block.size(), Compression::GetMaximumCompressedSize(data.size()));
+
+    std::vector<uint8_t> decompressed(data.size());
+    ASSERT_TRUE(Compression::Decompress(block.data(), block.size(), decompressed.data(), decompressed.size()));
+    EXPECT_EQ(decompressed, data);
+}
+
+TEST(Compression, RejectsTruncatedBlocks)
+{
+    auto data = GetPatternData(4 * 1024);
+    auto block = CompressBlock(data);
+    std::vector<uint8_t> decompressed(data.size());
+    for (size_t size = 0; size < block.size(); ++size)
+    {
+        EXPECT_FALSE(Compression::Decompress(block.data(), size, decompressed.data(), decompressed.size())) << "size " << size;
+    }
+}
+
+TEST(Compression, RejectsCorruptBlocks)
+{
+    auto data = GetPatternData(4 * 1024);
+    auto block = CompressBlock(data);
+    std::vector<uint8_t> decompressed(data.size() + 1);
+    EXPECT_FALSE(Compression::Decompress(block.data(), block.size(), decompressed.data(), (data.size() - 1)));
+    EXPECT_FALSE(Compression::Decompress(block.data(), block.size(), decompressed.data(), (data.size() + 1)));
+
+    // One literal followed by a match that reaches back before the start of the output
+    const uint8_t backReference[] = { 0x10, 'a', 0x02, 0x00 };
+    EXPECT_FALSE(Compression::Decompress(backReference, sizeof(backReference), decompressed.data(), 5));
+
+    // A zero offset never refers to anything
+    const uint8_t zeroOffset[] = { 0x10, 'a', 0x00, 0x00 };
+    EXPECT_FALSE(Compression::Decompress(zeroOffset, sizeof(zeroOffset), decompressed.data(), 5));
+
+    // The literal run claims more bytes than the block holds
+    const uint8_t longLiterals[] = { 0x50, 'a', 'b' };
+    EXPECT_FALSE(Compression::Decompress(longLiterals, sizeof(longLiterals), decompressed.data(), 5));
+}
+
+TEST(Compression, ShuffleRoundTrips)
+{
+    for (size_t size : { size_t(0), size_t(1), size_t(7), size_t(4 * 255 + 3) })
+    {
+        auto data = GetRandomData(size);
+        for (size_t stride : { size_t(1), size_t(4), size_t(12) })
+        {
+            std::vector<uint8_t> shuffled(size);
+            std::vector<uint8_t> unshuffled(size);
+            Compression::Shuffle(data.data(), size, stride, shuffled.data());
+            Compression::Unshuffle(shuffled.data(), size, stride, unshuffled.data());
+            EXPECT_EQ(unshuffled, data) << "size " << size << " stride " << stride;
+        }
+    }
+}
+
+TEST(Compression, ShuffleGathersBytePlanes)
+{
+    const uint8_t data[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+    const uint8_t expected[] = { 0, 4, 1, 5, 2, 6, 3, 7, 8 };
+    uint8_t shuffled[sizeof(data)];
+    Compression::Shuffle(data, sizeof(data), 4, shuffled);
+    EXPECT_EQ(std::vector<uint8_t>(std::begin(shuffled), std::end(shuffled)), std::vector<uint8_t>(std::begin(expected), std::end(expected)));
+}
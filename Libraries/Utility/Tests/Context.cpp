@@ -0,0 +1,186 @@
+#include "GEK/Utility/Context.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Gek;
+
+namespace
+{
+    static constexpr uint32_t ThreadCount = 8;
+    static constexpr uint32_t MessageCount = 2000;
+
+    // Messages written by each thread, in the order they appear in the file
+    std::vector<std::vector<uint32_t>> ReadMessages(std::filesystem::path const &path)
+    {
+        std::vector<std::vector<uint32_t>> threadMessageList(ThreadCount);
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            uint32_t threadIndex = 0;
+            uint32_t messageIndex = 0;
+            auto position = line.find(": writer ");
+            if (position != std::string::npos && std::sscanf(line.c_str() + position, ": writer %u message %u", &threadIndex, &messageIndex) == 2 && threadIndex < ThreadCount)
+            {
+                threadMessageList[threadIndex].push_back(messageIndex);
+            }
+        }
+
+        return threadMessageList;
+    }
+
+    bool HasEveryMessage(std::vector<uint32_t> const &messageList, uint32_t messageCount)
+    {
+        if (messageList.size() != messageCount)
+        {
+            return false;
+        }
+
+        for (uint32_t messageIndex = 0; messageIndex < messageCount; ++messageIndex)
+        {
+            if (messageList[messageIndex] != messageIndex)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Every test logs to its own file, removed again once the test is done
+    class ContextLogTest
+        : public testing::Test
+    {
+      protected:
+        std::filesystem::path logPath;
+
+        void SetUp(void) override
+        {
+            auto testName = testing::UnitTest::GetInstance()->current_test_info()->name();
+            auto directory = (std::filesystem::temp_directory_path() / "gek_context_test");
+            std::filesystem::create_directories(directory);
+            logPath = (directory / std::format("{}.log", testName));
+        }
+
+        void TearDown(void) override
+        {
+            std::error_code errorCode;
+            std::filesystem::remove(logPath, errorCode);
+        }
+
+        ContextPtr createContext(void)
+        {
+            auto context = Context::Create(nullptr);
+            context->setLogLevel(Context::Info);
+            context->setLogSinkMask(Context::LogSink_File);
+            context->setLogFilePath(FileSystem::Path(logPath), false);
+            return context;
+        }
+
+        void runWriters(Context *context, bool flushEach, std::vector<uint8_t> *flushedList = nullptr)
+        {
+            std::atomic_bool started = false;
+            std::vector<std::thread> threadList;
+            for (uint32_t threadIndex = 0; threadIndex < ThreadCount; ++threadIndex)
+            {
+                threadList.emplace_back([&, threadIndex](void) -> void
+                {
+                    started.wait(false);
+                    for (uint32_t messageIndex = 0; messageIndex < MessageCount; ++messageIndex)
+                    {
+                        context->log(Context::Info, "writer {} message {}", threadIndex, messageIndex);
+                    }
+
+                    // Other threads are still logging, but everything this one queued has to be in the file already
+                    if (flushEach)
+                    {
+                        context->flushLog();
+                        (*flushedList)[threadIndex] = HasEveryMessage(ReadMessages(logPath)[threadIndex], MessageCount);
+                    }
+                });
+            }
+
+            started.store(true);
+            started.notify_all();
+            for (auto &thread : threadList)
+            {
+                thread.join();
+            }
+        }
+    };
+}; // namespace
+
+TEST_F(ContextLogTest, FlushWritesEveryQueuedMessage)
+{
+    auto context = createContext();
+    for (uint32_t messageIndex = 0; messageIndex < MessageCount; ++messageIndex)
+    {
+        context->log(Context::Info, "writer {} message {}", 0, messageIndex);
+    }
+
+    context->flushLog();
+    auto threadMessageList = ReadMessages(logPath);
+    EXPECT_TRUE(HasEveryMessage(threadMessageList[0], MessageCount)) << threadMessageList[0].size() << " messages";
+
+    // Nothing queued, returns straight away
+    context->flushLog();
+}
+
+TEST_F(ContextLogTest, FlushWaitsForMessagesFromEveryThread)
+{
+    auto context = createContext();
+    std::vector<uint8_t> flushedList(ThreadCount, 0);
+    runWriters(context.get(), true, &flushedList);
+    for (uint32_t threadIndex = 0; threadIndex < ThreadCount; ++threadIndex)
+    {
+        EXPECT_TRUE(flushedList[threadIndex]) << "writer " << threadIndex;
+    }
+
+    context->flushLog();
+    auto threadMessageList = ReadMessages(logPath);
+    for (uint32_t threadIndex = 0; threadIndex < ThreadCount; ++threadIndex)
+    {
+        EXPECT_TRUE(HasEveryMessage(threadMessageList[threadIndex], MessageCount)) << "writer " << threadIndex;
+    }
+}
+
+TEST_F(ContextLogTest, ShutdownWritesEveryQueuedMessage)
+{
+    auto context = createContext();
+    runWriters(context.get(), false);
+
+    // Destroying the context straight away has to drain the queue before the writer stops
+    context.reset();
+    auto threadMessageList = ReadMessages(logPath);
+    for (uint32_t threadIndex = 0; threadIndex < ThreadCount; ++threadIndex)
+    {
+        EXPECT_TRUE(HasEveryMessage(threadMessageList[threadIndex], MessageCount)) << "writer " << threadIndex << ", " << threadMessageList[threadIndex].size() << " messages";
+    }
+}
+
+TEST_F(ContextLogTest, MessagesFollowTheLogFile)
+{
+    auto context = createContext();
+    context->log(Context::Info, "writer {} message {}", 0, 0);
+
+    // Messages queued before the file changes still go to the old one
+    auto secondPath = (logPath.parent_path() / "second.log");
+    context->setLogFilePath(FileSystem::Path(secondPath), false);
+    context->log(Context::Info, "writer {} message {}", 1, 0);
+    context.reset();
+
+    EXPECT_TRUE(HasEveryMessage(ReadMessages(logPath)[0], 1));
+    EXPECT_TRUE(ReadMessages(logPath)[1].empty());
+    EXPECT_TRUE(ReadMessages(secondPath)[0].empty());
+    EXPECT_TRUE(HasEveryMessage(ReadMessages(secondPath)[1], 1));
+
+    std::error_code errorCode;
+    std::filesystem::remove(secondPath, errorCode);
+}
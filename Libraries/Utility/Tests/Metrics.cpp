@@ -0,0 +1,163 @@
+#include "GEK/Utility/Metrics.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <format>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Gek;
+
+namespace
+{
+    static constexpr uint32_t ThreadCount = 8;
+
+    // Runs the function on every thread at once, each one is given its own index
+    template <typename FUNCTION>
+    void RunThreads(FUNCTION &&function)
+    {
+        std::atomic_bool started = false;
+        std::vector<std::thread> threadList;
+        for (uint32_t threadIndex = 0; threadIndex < ThreadCount; ++threadIndex)
+        {
+            threadList.emplace_back([&, threadIndex](void) -> void
+            {
+                started.wait(false);
+                function(threadIndex);
+            });
+        }
+
+        started.store(true);
+        started.notify_all();
+        for (auto &thread : threadList)
+        {
+            thread.join();
+        }
+    }
+}; // namespace
+
+TEST(Metrics, HandlesAreSharedAcrossThreads)
+{
+    static constexpr uint32_t NameCount = 64;
+
+    Metrics::Registry registry;
+    std::vector<std::vector<Metrics::Handle>> threadHandleList(ThreadCount, std::vector<Metrics::Handle>(NameCount, Metrics::InvalidHandle));
+    RunThreads([&](uint32_t threadIndex) -> void
+    {
+        // Every thread registers the same names, starting from a different one so that they race on new names
+        for (uint32_t step = 0; step < NameCount; ++step)
+        {
+            auto nameIndex = ((step + (threadIndex * 7)) % NameCount);
+            auto type = ((threadIndex % 2) ? Metrics::Type::Counter : Metrics::Type::Gauge);
+            threadHandleList[threadIndex][nameIndex] = registry.getHandle(std::format("test.metric{}", nameIndex), type);
+        }
+    });
+
+    for (uint32_t nameIndex = 0; nameIndex < NameCount; ++nameIndex)
+    {
+        auto handle = threadHandleList[0][nameIndex];
+        ASSERT_LT(handle, NameCount);
+        for (uint32_t threadIndex = 1; threadIndex < ThreadCount; ++threadIndex)
+        {
+            EXPECT_EQ(threadHandleList[threadIndex][nameIndex], handle) << "name " << nameIndex << " thread " << threadIndex;
+        }
+
+        for (uint32_t otherIndex = 0; otherIndex < nameIndex; ++otherIndex)
+        {
+            EXPECT_NE(threadHandleList[0][otherIndex], handle);
+        }
+
+        EXPECT_EQ(registry.getHandle(std::format("test.metric{}", nameIndex)), handle);
+    }
+
+    // Nothing is reported until a value has been written
+    EXPECT_TRUE(registry.getSnapshot().empty());
+    double value = 0.0;
+    EXPECT_FALSE(registry.get("test.metric0", value));
+}
+
+TEST(Metrics, ConcurrentUpdatesMergeIntoSnapshots)
+{
+    static constexpr uint32_t UpdateCount = 10000;
+
+    Metrics::Registry registry;
+    auto counter = registry.getHandle("test.counter", Metrics::Type::Counter);
+    auto gauge = registry.getHandle("test.gauge");
+    auto timing = registry.getHandle("test.timing", Metrics::Type::Timing);
+
+    std::atomic_uint32_t finishedCount = 0;
+    std::thread reader([&](void) -> void
+    {
+        // Counters only ever grow while threads are still adding to them
+        double lastTotal = 0.0;
+        while (finishedCount.load() < ThreadCount)
+        {
+            auto snapshot = registry.getSnapshot();
+            auto search = snapshot.find("test.counter");
+            if (search != std::end(snapshot))
+            {
+                EXPECT_GE(search->second, lastTotal);
+                lastTotal = search->second;
+            }
+        }
+    });
+
+    RunThreads([&](uint32_t threadIndex) -> void
+    {
+        for (uint32_t update = 0; update < UpdateCount; ++update)
+        {
+            registry.add(counter);
+            registry.add(counter, 2.0);
+            registry.set(gauge, double(threadIndex + 1));
+            registry.record(timing, 1.0);
+        }
+
+        ++finishedCount;
+    });
+
+    reader.join();
+
+    auto snapshot = registry.getSnapshot();
+    ASSERT_EQ(snapshot.size(), 3U);
+    EXPECT_EQ(snapshot["test.counter"], (3.0 * ThreadCount * UpdateCount));
+    EXPECT_GE(snapshot["test.gauge"], 1.0);
+    EXPECT_LE(snapshot["test.gauge"], double(ThreadCount));
+    EXPECT_EQ(snapshot["test.timing"], 1.0);
+
+    double value = 0.0;
+    ASSERT_TRUE(registry.get("test.counter", value));
+    EXPECT_EQ(value, (3.0 * ThreadCount * UpdateCount));
+
+    auto histogramSnapshot = registry.getHistogramSnapshot();
+    ASSERT_EQ(histogramSnapshot.size(), 1U);
+    auto const &histogram = histogramSnapshot["test.timing"];
+    EXPECT_EQ(histogram.count, (uint64_t(ThreadCount) * UpdateCount));
+    EXPECT_EQ(histogram.sum, (double(ThreadCount) * UpdateCount));
+    EXPECT_EQ(histogram.bucketList[Metrics::Histogram::GetBucket(1.0)], histogram.count);
+
+    // Updates from the threads that have since exited stay in the totals
+    registry.add(counter);
+    ASSERT_TRUE(registry.get("test.counter", value));
+    EXPECT_EQ(value, ((3.0 * ThreadCount * UpdateCount) + 1.0));
+}
+
+TEST(Metrics, NewRegistriesStartClean)
+{
+    for (uint32_t pass = 0; pass < 2; ++pass)
+    {
+        Metrics::Registry registry;
+        auto counter = registry.getHandle("test.counter", Metrics::Type::Counter);
+        RunThreads([&](uint32_t) -> void
+        {
+            registry.add(counter, 5.0);
+        });
+
+        double value = 0.0;
+        ASSERT_TRUE(registry.get("test.counter", value));
+        EXPECT_EQ(value, (5.0 * ThreadCount)) << "pass " << pass;
+
+        registry.add(Metrics::InvalidHandle);
+        registry.set(Metrics::InvalidHandle, 1.0);
+        EXPECT_EQ(registry.getSnapshot().size(), 1U);
+    }
+}
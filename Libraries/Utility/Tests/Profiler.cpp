@@ -0,0 +1,177 @@
+#ifdef GEK_ENABLE_PROFILER
+
+#include "GEK/Utility/Profiler.hpp"
+#include "GEK/Utility/JSON.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <format>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Gek;
+
+namespace
+{
+    static constexpr uint32_t ThreadCount = 4;
+    static constexpr uint32_t ZoneLimit = 20000;
+
+    struct Zone
+    {
+        std::string name;
+        double start = 0.0;
+        double duration = 0.0;
+    };
+
+    struct Trace
+    {
+        std::map<uint32_t, std::string> threadNameMap;
+        std::map<uint32_t, std::vector<Zone>> threadZoneMap;
+        size_t zoneCount = 0;
+    };
+
+    Trace LoadTrace(FileSystem::Path const &filePath)
+    {
+        Trace trace;
+        auto object = JSON::Load(filePath);
+        EXPECT_EQ(object.value("displayTimeUnit", ""), "ms");
+        for (auto const &event : object.at("traceEvents"))
+        {
+            auto threadIdentifier = event.at("tid").get<uint32_t>();
+            auto phase = event.at("ph").get<std::string>();
+            if (phase == "M")
+            {
+                EXPECT_EQ(event.at("name").get<std::string>(), "thread_name");
+                trace.threadNameMap[threadIdentifier] = event.at("args").at("name").get<std::string>();
+            }
+            else
+            {
+                EXPECT_EQ(phase, "X");
+                Zone zone;
+                zone.name = event.at("name").get<std::string>();
+                zone.start = event.at("ts").get<double>();
+                zone.duration = event.at("dur").get<double>();
+                trace.threadZoneMap[threadIdentifier].push_back(zone);
+                ++trace.zoneCount;
+            }
+        }
+
+        return trace;
+    }
+
+    std::filesystem::path GetTracePath(std::string_view name)
+    {
+        auto directory = (std::filesystem::temp_directory_path() / "gek_profiler_test");
+        std::filesystem::create_directories(directory);
+        return (directory / name);
+    }
+}; // namespace
+
+TEST(Profiler, StopWhileRecordingWritesCompleteTrace)
+{
+    auto innerName = Profiler::Intern("inner \"zone\"\\path");
+    Profiler::StartCapture();
+    ASSERT_TRUE(Profiler::IsCapturing());
+
+    std::atomic_bool stopping = false;
+    std::atomic_uint32_t readyCount = 0;
+    std::vector<std::thread> threadList;
+    for (uint32_t threadIndex = 0; threadIndex < ThreadCount; ++threadIndex)
+    {
+        threadList.emplace_back([&, threadIndex](void) -> void
+        {
+            Profiler::SetThreadName(std::format("Worker \"{}\"", threadIndex));
+            for (uint32_t zoneIndex = 0; zoneIndex < ZoneLimit && !stopping.load(); ++zoneIndex)
+            {
+                {
+                    Profiler::Zone outer("outer");
+                    Profiler::Zone inner(innerName);
+                }
+
+                // Every thread is known to be recording before the capture is stopped
+                if (zoneIndex == 100)
+                {
+                    ++readyCount;
+                }
+            }
+
+            // Stay under the ring buffer size so that no zone of the capture is overwritten
+            while (!stopping.load())
+            {
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    auto tracePath = GetTracePath("stop.json");
+    while (readyCount.load() < ThreadCount)
+    {
+        std::this_thread::yield();
+    }
+
+    auto zoneCount = Profiler::StopCapture(tracePath);
+    EXPECT_FALSE(Profiler::IsCapturing());
+    stopping.store(true);
+    for (auto &thread : threadList)
+    {
+        thread.join();
+    }
+
+    auto trace = LoadTrace(tracePath);
+    EXPECT_EQ(trace.zoneCount, zoneCount);
+    EXPECT_GE(zoneCount, (ThreadCount * 200));
+
+    uint32_t workerCount = 0;
+    for (auto const &[threadIdentifier, zoneList] : trace.threadZoneMap)
+    {
+        auto threadName = trace.threadNameMap[threadIdentifier];
+        ASSERT_TRUE(threadName.starts_with("Worker \"")) << threadName;
+        ++workerCount;
+
+        // Inner zones finish first, so a thread stopped between the two has one more inner than outer zone
+        std::vector<Zone> outerList;
+        std::vector<Zone> innerList;
+        for (auto const &zone : zoneList)
+        {
+            EXPECT_GE(zone.start, 0.0);
+            EXPECT_GE(zone.duration, 0.0);
+            if (zone.name == "outer")
+            {
+                outerList.push_back(zone);
+            }
+            else
+            {
+                EXPECT_EQ(zone.name, innerName) << threadName;
+                innerList.push_back(zone);
+            }
+        }
+
+        EXPECT_GE(outerList.size(), 100U) << threadName;
+        ASSERT_GE(innerList.size(), outerList.size()) << threadName;
+        EXPECT_LE(innerList.size(), (outerList.size() + 1)) << threadName;
+        for (size_t zoneIndex = 0; zoneIndex < outerList.size(); ++zoneIndex)
+        {
+            auto const &outer = outerList[zoneIndex];
+            auto const &inner = innerList[zoneIndex];
+            EXPECT_LE(outer.start, inner.start) << threadName;
+            EXPECT_GE((outer.start + outer.duration + 0.001), (inner.start + inner.duration)) << threadName;
+        }
+    }
+
+    EXPECT_EQ(workerCount, ThreadCount);
+
+    // Stopping twice writes nothing, and a new capture does not pick up zones left over from the last one
+    EXPECT_EQ(Profiler::StopCapture(tracePath), 0U);
+    auto emptyPath = GetTracePath("empty.json");
+    Profiler::StartCapture();
+    EXPECT_EQ(Profiler::StopCapture(emptyPath), 0U);
+    EXPECT_EQ(LoadTrace(emptyPath).zoneCount, 0U);
+
+    std::error_code errorCode;
+    std::filesystem::remove_all(tracePath.parent_path(), errorCode);
+}
+
+#endif
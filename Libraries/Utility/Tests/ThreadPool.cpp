@@ -0,0 +1,261 @@
+#include "GEK/Utility/ThreadPool.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace Gek;
+
+namespace
+{
+    // Keeps the only worker busy until released, so that everything queued behind it is still pending
+    struct WorkerGate
+    {
+        std::atomic_bool entered = false;
+        std::atomic_bool released = false;
+
+        Task<> block(ThreadPool &threadPool)
+        {
+            co_await threadPool.schedule(ThreadPool::Queue::Frame);
+            entered.store(true);
+            entered.notify_all();
+            while (!released.load())
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        void waitUntilEntered(void)
+        {
+            entered.wait(false);
+        }
+    };
+
+    Task<bool> awaitCancelled(Task<int> &task)
+    {
+        try
+        {
+            co_await task;
+        }
+        catch (TaskCancelled const &)
+        {
+            co_return true;
+        }
+
+        co_return false;
+    }
+}; // namespace
+
+TEST(ThreadPool, CancelResumesWaiters)
+{
+    ThreadPool threadPool(1);
+    WorkerGate workerGate;
+    auto gateTask = workerGate.block(threadPool);
+    workerGate.waitUntilEntered();
+
+    TaskGroup taskGroup;
+    std::atomic_uint32_t executedCount = 0;
+    std::vector<Task<int>> taskList;
+    for (int taskIndex = 0; taskIndex < 8; ++taskIndex)
+    {
+        taskList.push_back(threadPool.run(taskGroup, [&executedCount, taskIndex](void) -> int
+        {
+            executedCount.fetch_add(1);
+            return taskIndex;
+        }, ThreadPool::Queue::Streaming));
+    }
+
+    auto awaitingTask = awaitCancelled(taskList.front());
+    threadPool.cancel(taskGroup);
+    EXPECT_TRUE(taskGroup.empty());
+
+    for (auto &task : taskList)
+    {
+        task.wait();
+        EXPECT_TRUE(task.isReady());
+        EXPECT_THROW(task.get(), TaskCancelled);
+    }
+
+    EXPECT_TRUE(awaitingTask.get());
+
+    workerGate.released.store(true);
+    gateTask.wait();
+    threadPool.join();
+    EXPECT_EQ(executedCount.load(), 0U);
+}
+
+TEST(ThreadPool, CancelKeepsOtherGroups)
+{
+    ThreadPool threadPool(1);
+    WorkerGate workerGate;
+    auto gateTask = workerGate.block(threadPool);
+    workerGate.waitUntilEntered();
+
+    TaskGroup cancelledGroup;
+    TaskGroup keptGroup;
+    auto cancelledTask = threadPool.run(cancelledGroup, [](void) -> int { return 1; }, ThreadPool::Queue::Streaming);
+    auto keptTask = threadPool.run(keptGroup, [](void) -> int { return 2; }, ThreadPool::Queue::Streaming);
+    threadPool.cancel(cancelledGroup);
+
+    workerGate.released.store(true);
+    EXPECT_THROW(cancelledTask.get(), TaskCancelled);
+    EXPECT_EQ(keptTask.get(), 2);
+    gateTask.wait();
+}
+
+TEST(ThreadPool, DrainWithoutExecutingResumesWaiters)
+{
+    ThreadPool threadPool(1);
+    WorkerGate workerGate;
+    auto gateTask = workerGate.block(threadPool);
+    workerGate.waitUntilEntered();
+
+    auto pendingTask = threadPool.run([](void) -> int { return 1; }, ThreadPool::Queue::Background);
+    std::thread releaseThread([&](void) -> void
+    {
+        pendingTask.wait();
+        workerGate.released.store(true);
+    });
+
+    threadPool.drain(false);
+    releaseThread.join();
+    EXPECT_THROW(pendingTask.get(), TaskCancelled);
+
+    // Work queued on a stopped pool is cancelled straight away
+    auto stoppedTask = threadPool.run([](void) -> int { return 1; }, ThreadPool::Queue::Frame);
+    EXPECT_TRUE(stoppedTask.isReady());
+    EXPECT_THROW(stoppedTask.get(), TaskCancelled);
+    gateTask.wait();
+}
+
+TEST(ThreadPool, ConcurrentScheduleStress)
+{
+    static constexpr uint32_t ThreadCount = 4;
+    static constexpr uint32_t TaskCount = 500;
+    static constexpr uint32_t HopCount = 16;
+
+    ThreadPool threadPool(4);
+    auto hop = [](ThreadPool &threadPool, uint32_t value) -> Task<uint32_t>
+    {
+        for (uint32_t hopIndex = 0; hopIndex < HopCount; ++hopIndex)
+        {
+            co_await threadPool.schedule(static_cast<ThreadPool::Queue>(hopIndex % 3));
+        }
+
+        co_return value;
+    };
+
+    std::atomic_uint64_t total = 0;
+    std::vector<std::thread> threadList;
+    for (uint32_t threadIndex = 0; threadIndex < ThreadCount; ++threadIndex)
+    {
+        threadList.emplace_back([&, threadIndex](void) -> void
+        {
+            std::vector<Task<uint32_t>> taskList;
+            for (uint32_t taskIndex = 0; taskIndex < TaskCount; ++taskIndex)
+            {
+                taskList.push_back(hop(threadPool, (threadIndex * TaskCount) + taskIndex));
+            }
+
+            for (auto &task : taskList)
+            {
+                total.fetch_add(task.get());
+            }
+        });
+    }
+
+    for (auto &thread : threadList)
+    {
+        thread.join();
+    }
+
+    const uint64_t valueCount = (ThreadCount * TaskCount);
+    EXPECT_EQ(total.load(), ((valueCount * (valueCount - 1)) / 2));
+    threadPool.join();
+    EXPECT_TRUE(threadPool.empty());
+}
+
+TEST(ThreadPool, IdleWorkersStealLocalWork)
+{
+    static constexpr uint32_t ChildCount = 64;
+
+    ThreadPool threadPool(4);
+    std::mutex threadMutex;
+    std::set<std::thread::id> childThreadSet;
+    std::atomic_uint32_t finishedCount = 0;
+    std::thread::id parentThread;
+
+    // The children go on the parent worker's own deque and the parent never yields it, so only stealing runs them
+    auto parentTask = threadPool.run([&](void) -> void
+    {
+        parentThread = std::this_thread::get_id();
+        for (uint32_t childIndex = 0; childIndex < ChildCount; ++childIndex)
+        {
+            threadPool.run([&](void) -> void
+            {
+                {
+                    std::lock_guard<std::mutex> lock(threadMutex);
+                    childThreadSet.insert(std::this_thread::get_id());
+                }
+
+                finishedCount.fetch_add(1);
+            }, ThreadPool::Queue::Frame);
+        }
+
+        while (finishedCount.load() < ChildCount)
+        {
+            std::this_thread::yield();
+        }
+    }, ThreadPool::Queue::Frame);
+
+    parentTask.get();
+    threadPool.join();
+    EXPECT_EQ(finishedCount.load(), ChildCount);
+    EXPECT_EQ(childThreadSet.count(parentThread), 0U);
+}
+
+TEST(ThreadPool, EarlierQueuesRunFirst)
+{
+    ThreadPool threadPool(1);
+    WorkerGate workerGate;
+    auto gateTask = workerGate.block(threadPool);
+    workerGate.waitUntilEntered();
+
+    std::vector<ThreadPool::Queue> orderList;
+    std::vector<Task<>> taskList;
+    for (auto queue : { ThreadPool::Queue::Background, ThreadPool::Queue::Streaming, ThreadPool::Queue::Frame, ThreadPool::Queue::Background, ThreadPool::Queue::Frame })
+    {
+        taskList.push_back(threadPool.run([&orderList, queue](void) -> void
+        {
+            orderList.push_back(queue);
+        }, queue));
+    }
+
+    workerGate.released.store(true);
+    gateTask.wait();
+    threadPool.join();
+    EXPECT_EQ(orderList, std::vector<ThreadPool::Queue>({ ThreadPool::Queue::Frame, ThreadPool::Queue::Frame, ThreadPool::Queue::Streaming, ThreadPool::Queue::Background, ThreadPool::Queue::Background }));
+}
+
+TEST(ThreadPool, AwaitedTasksReturnResults)
+{
+    ThreadPool threadPool(2);
+    auto sum = [](ThreadPool &threadPool) -> Task<int>
+    {
+        int total = 0;
+        for (int value = 1; value <= 10; ++value)
+        {
+            total += co_await threadPool.run([value](void) -> int { return (value * value); }, ThreadPool::Queue::Frame);
+        }
+
+        co_return total;
+    };
+
+    auto task = sum(threadPool);
+    EXPECT_EQ(task.get(), 385);
+
+    auto failedTask = threadPool.run([](void) -> int { throw std::runtime_error("failed"); }, ThreadPool::Queue::Frame);
+    EXPECT_THROW(failedTask.get(), std::runtime_error);
+}
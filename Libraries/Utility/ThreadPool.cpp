@@ -1,4 +1,8 @@
 #include "GEK/Utility/ThreadPool.hpp"
+#include "GEK/Utility/Profiler.hpp"
+#include <algorithm>
+#include <format>
+#include <vector>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -6,6 +10,22 @@
 
 namespace Gek
 {
+    namespace
+    {
+        struct CurrentWorker
+        {
+            ThreadPool *threadPool = nullptr;
+            uint32_t workerIndex = 0;
+        };
+
+        thread_local CurrentWorker currentWorker;
+
+        uint32_t GetDefaultThreadCount(void)
+        {
+            return (std::max(std::thread::hardware_concurrency(), 2U) - 1);
+        }
+    }; // namespace
+
     void ThreadPool::initializeWorker(void)
     {
 #ifdef _WIN32
@@ -19,4 +39,320 @@ namespace Gek
         CoUninitialize();
 #endif
     }
-}; // namespace Gek
\ No newline at end of file
+
+    ThreadPool::ThreadPool(uint32_t threadCount)
+        : threadCount((threadCount > 0 ? threadCount : GetDefaultThreadCount()))
+    {
+        create();
+    }
+
+    ThreadPool::~ThreadPool(void)
+    {
+        drain();
+    }
+
+    void ThreadPool::create(void)
+    {
+        stop.store(false);
+        workerList.clear();
+        threadList.clear();
+        workerList.reserve(threadCount);
+        threadList.reserve(threadCount);
+        for (uint32_t workerIndex = 0; workerIndex < threadCount; ++workerIndex)
+        {
+            workerList.push_back(std::make_unique<Worker>());
+        }
+
+        for (uint32_t workerIndex = 0; workerIndex < threadCount; ++workerIndex)
+        {
+            threadList.emplace_back(&ThreadPool::runWorker, this, workerIndex);
+        }
+    }
+
+    void ThreadPool::runWorker(uint32_t workerIndex)
+    {
+        initializeWorker();
+        currentWorker = { this, workerIndex };
+        GEK_PROFILE_THREAD(std::format("Worker {}", workerIndex));
+        while (true)
+        {
+            WorkItem workItem;
+            if (dequeue(workerIndex, workItem))
+            {
+                execute(workItem);
+                continue;
+            }
+
+            // Sleep until more work is queued, sleepingCount lets enqueue skip the lock while every worker is busy
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepingCount.fetch_add(1);
+            sleepCondition.wait(lock, [&](void) -> bool
+            {
+                return stop.load() || pendingCount.load() > 0;
+            });
+
+            sleepingCount.fetch_sub(1);
+            if (stop.load() && pendingCount.load() == 0)
+            {
+                break;
+            }
+        };
+
+        currentWorker = {};
+        releaseWorker();
+    }
+
+    bool ThreadPool::dequeue(uint32_t workerIndex, WorkItem &workItem)
+    {
+        for (size_t queueIndex = 0; queueIndex < QueueCount; ++queueIndex)
+        {
+            // Newest local work first, it is the most likely to still be in cache
+            {
+                auto &worker = *workerList[workerIndex];
+                std::lock_guard<std::mutex> lock(worker.mutex);
+                auto &queue = worker.queueList[queueIndex];
+                if (!queue.empty())
+                {
+                    workItem = queue.back();
+                    queue.pop_back();
+                    pendingCount.fetch_sub(1);
+                    return true;
+                }
+            }
+
+            if (injectionQueueList[queueIndex].try_pop(workItem))
+            {
+                pendingCount.fetch_sub(1);
+                return true;
+            }
+
+            // Steal the oldest work from the other workers
+            for (uint32_t offset = 1; offset < threadCount; ++offset)
+            {
+                auto &worker = *workerList[(workerIndex + offset) % threadCount];
+                std::lock_guard<std::mutex> lock(worker.mutex);
+                auto &queue = worker.queueList[queueIndex];
+                if (!queue.empty())
+                {
+                    workItem = queue.front();
+                    queue.pop_front();
+                    pendingCount.fetch_sub(1);
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    void ThreadPool::execute(WorkItem const &workItem)
+    {
+        auto taskGroup = workItem.taskGroup;
+        auto &queueCounter = queueCounterList[static_cast<size_t>(workItem.queue)];
+        queueCounter.queued.fetch_sub(1, std::memory_order_relaxed);
+        queueCounter.running.fetch_add(1, std::memory_order_relaxed);
+        try
+        {
+            GEK_PROFILE_ZONE(GetQueueName(workItem.queue).data());
+            workItem.coroutine.resume();
+        }
+        catch (const std::exception &exception)
+        {
+            LogThreadPoolError(std::string("ThreadPool worker exception: ") + exception.what());
+        }
+        catch (...)
+        {
+            LogThreadPoolError("ThreadPool worker exception: unknown");
+        }
+
+        queueCounter.running.fetch_sub(1, std::memory_order_relaxed);
+        if (taskGroup)
+        {
+            taskGroup->release();
+        }
+
+        activeGroup.release();
+    }
+
+    // pendingCount is raised before stop is checked, so workers can not exit while work is still being queued
+    bool ThreadPool::enqueue(WorkItem &&workItem)
+    {
+        pendingCount.fetch_add(1);
+        if (stop.load())
+        {
+            pendingCount.fetch_sub(1);
+            return false;
+        }
+
+        if (workItem.taskGroup)
+        {
+            workItem.taskGroup->acquire();
+        }
+
+        activeGroup.acquire();
+        auto queueIndex = static_cast<size_t>(workItem.queue);
+        queueCounterList[queueIndex].queued.fetch_add(1, std::memory_order_relaxed);
+        if (currentWorker.threadPool == this)
+        {
+            auto &worker = *workerList[currentWorker.workerIndex];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.queueList[queueIndex].push_back(workItem);
+        }
+        else
+        {
+            injectionQueueList[queueIndex].push(workItem);
+        }
+
+        if (sleepingCount.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            sleepCondition.notify_one();
+        }
+
+        return true;
+    }
+
+    // Discarded work is resumed as cancelled so that its frame unwinds and anything awaiting it completes, then it
+    // is released from its groups like executed work
+    void ThreadPool::discard(WorkItem const &workItem)
+    {
+        queueCounterList[static_cast<size_t>(workItem.queue)].queued.fetch_sub(1, std::memory_order_relaxed);
+        pendingCount.fetch_sub(1);
+        if (workItem.cancelled)
+        {
+            *workItem.cancelled = true;
+        }
+
+        try
+        {
+            workItem.coroutine.resume();
+        }
+        catch (const std::exception &exception)
+        {
+            LogThreadPoolError(std::string("ThreadPool cancelled work exception: ") + exception.what());
+        }
+        catch (...)
+        {
+            LogThreadPoolError("ThreadPool cancelled work exception: unknown");
+        }
+
+        if (workItem.taskGroup)
+        {
+            workItem.taskGroup->release();
+        }
+
+        activeGroup.release();
+    }
+
+    // Dropped work is collected first and only resumed once no queue lock is held, resuming can queue more work
+    void ThreadPool::cancel(TaskGroup &taskGroup)
+    {
+        std::vector<WorkItem> discardList;
+        std::vector<WorkItem> keepList;
+        WorkItem workItem;
+        for (auto &injectionQueue : injectionQueueList)
+        {
+            keepList.clear();
+            while (injectionQueue.try_pop(workItem))
+            {
+                if (workItem.taskGroup == &taskGroup)
+                {
+                    discardList.push_back(workItem);
+                }
+                else
+                {
+                    keepList.push_back(workItem);
+                }
+            }
+
+            for (auto const &keepItem : keepList)
+            {
+                injectionQueue.push(keepItem);
+            }
+        }
+
+        for (auto &worker : workerList)
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            for (auto &queue : worker->queueList)
+            {
+                std::erase_if(queue, [&](WorkItem const &queuedItem) -> bool
+                {
+                    if (queuedItem.taskGroup == &taskGroup)
+                    {
+                        discardList.push_back(queuedItem);
+                        return true;
+                    }
+
+                    return false;
+                });
+            }
+        }
+
+        for (auto const &discardItem : discardList)
+        {
+            discard(discardItem);
+        }
+
+        taskGroup.join();
+    }
+
+    void ThreadPool::drain(bool executePendingTasks)
+    {
+        if (executePendingTasks)
+        {
+            join();
+        }
+        else
+        {
+            std::vector<WorkItem> discardList;
+            WorkItem workItem;
+            for (auto &injectionQueue : injectionQueueList)
+            {
+                while (injectionQueue.try_pop(workItem))
+                {
+                    discardList.push_back(workItem);
+                }
+            }
+
+            for (auto &worker : workerList)
+            {
+                std::lock_guard<std::mutex> lock(worker->mutex);
+                for (auto &queue : worker->queueList)
+                {
+                    discardList.insert(std::end(discardList), std::begin(queue), std::end(queue));
+                    queue.clear();
+                }
+            }
+
+            for (auto const &discardItem : discardList)
+            {
+                discard(discardItem);
+            }
+        }
+
+        if (!threadList.empty())
+        {
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                stop.store(true);
+            }
+
+            sleepCondition.notify_all();
+
+            // Wait for threads to complete work
+            for (std::thread &thread : threadList)
+            {
+                thread.join();
+            }
+
+            threadList.clear();
+        }
+    }
+
+    void ThreadPool::reset(void)
+    {
+        drain();
+        create();
+    }
+}; // namespace Gek
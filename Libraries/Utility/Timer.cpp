@@ -53,4 +53,9 @@ namespace Gek
     {
         return std::chrono::duration<double>(clock.now().time_since_epoch()).count();
     }
+
+    uint64_t Timer::GetNanoseconds(void) noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
 }; // namespace Gek
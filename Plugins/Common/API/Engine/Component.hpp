@@ -9,6 +9,7 @@
 
 #include "GEK/Utility/Context.hpp"
 #include "GEK/Utility/JSON.hpp"
+#include <vector>
 
 #pragma warning(disable : 4503)
 
@@ -49,8 +50,24 @@ namespace Gek
             virtual Hash getIdentifier(void) const = 0;
 
             virtual std::unique_ptr<Data> create(void) = 0;
+
+            // Raw storage description used by the population to pack component data into archetype chunks
+            virtual size_t getDataSize(void) const = 0;
+            virtual size_t getDataAlignment(void) const = 0;
+
+            // Move constructs source into uninitialized destination storage, source must still be destroyed by the caller
+            virtual Data *moveData(void *destination, Data *source) const = 0;
+
             virtual void save(Data const *const data, JSON::Object &exportData) const = 0;
             virtual void load(Data *const data, JSON::Object const &exportData) = 0;
+
+            // Cooked scenes store already evaluated data, uncook returns the position just past what it consumed
+            // or nullptr if the data is truncated or corrupt
+            virtual void cook(Data const *const data, std::vector<uint8_t> &buffer) const = 0;
+            virtual uint8_t const *uncook(Data *const data, uint8_t const *buffer, uint8_t const *bufferEnd) = 0;
+
+            // Changes whenever the cooked layout changes, cooked blocks with a different layout are rejected
+            virtual uint64_t getCookedLayout(void) const = 0;
         };
     }; // namespace Plugin
 }; // namespace Gek
@@ -10,11 +10,17 @@
 #include "API/Engine/Component.hpp"
 #include "API/Engine/Population.hpp"
 #include "API/Engine/Processor.hpp"
+#include <cstring>
 #include <execution>
 #include <mutex>
 #include <new>
 #include <shared_mutex>
-#include <tbb/concurrent_unordered_map.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 #include <imgui.h>
 
@@ -55,6 +61,21 @@ namespace Gek
                 return std::make_unique<COMPONENT>();
             }
 
+            size_t getDataSize(void) const
+            {
+                return sizeof(COMPONENT);
+            }
+
+            size_t getDataAlignment(void) const
+            {
+                return alignof(COMPONENT);
+            }
+
+            Plugin::Component::Data *moveData(void *destination, Plugin::Component::Data *source) const
+            {
+                return new (destination) COMPONENT(std::move(*static_cast<COMPONENT *>(source)));
+            }
+
             template <typename TYPE>
             TYPE evaluate(JSON::Object const &object, TYPE defaultValue)
             {
@@ -67,9 +88,85 @@ namespace Gek
                 return JSON::Evaluate(object, key, population->getShuntingYard(), defaultValue);
             }
 
+            template <typename TYPE>
+            static void cookValue(std::vector<uint8_t> &buffer, TYPE const &value)
+            {
+                static_assert(std::is_standard_layout_v<TYPE> && std::is_trivially_destructible_v<TYPE>, "Cooked values must be plain data");
+                auto data = reinterpret_cast<uint8_t const *>(&value);
+                buffer.insert(std::end(buffer), data, (data + sizeof(TYPE)));
+            }
+
+            static void cookValue(std::vector<uint8_t> &buffer, std::string const &value)
+            {
+                cookValue(buffer, static_cast<uint32_t>(value.size()));
+                buffer.insert(std::end(buffer), std::begin(value), std::end(value));
+            }
+
+            // Returns nullptr once the data would run past bufferEnd, a nullptr buffer passes straight through so reads can be chained
+            template <typename TYPE>
+            static uint8_t const *uncookValue(uint8_t const *buffer, uint8_t const *bufferEnd, TYPE &value)
+            {
+                static_assert(std::is_standard_layout_v<TYPE> && std::is_trivially_destructible_v<TYPE>, "Cooked values must be plain data");
+                if (!buffer || size_t(bufferEnd - buffer) < sizeof(TYPE))
+                {
+                    return nullptr;
+                }
+
+                std::memcpy(&value, buffer, sizeof(TYPE));
+                return (buffer + sizeof(TYPE));
+            }
+
+            static uint8_t const *uncookValue(uint8_t const *buffer, uint8_t const *bufferEnd, std::string &value)
+            {
+                uint32_t length = 0;
+                buffer = uncookValue(buffer, bufferEnd, length);
+                if (!buffer || size_t(bufferEnd - buffer) < length)
+                {
+                    return nullptr;
+                }
+
+                value.assign(reinterpret_cast<char const *>(buffer), length);
+                return (buffer + length);
+            }
+
             virtual void save(COMPONENT const *const component, JSON::Object &exportData) const {};
             virtual void load(COMPONENT *const component, JSON::Object const &importData) {};
 
+            // Components without a raw layout fall back to their saved JSON, packed as MessagePack
+            virtual void cook(COMPONENT const *const component, std::vector<uint8_t> &buffer) const
+            {
+                JSON::Object exportData;
+                save(component, exportData);
+                auto packedData = JSON::Object::to_msgpack(exportData);
+                cookValue(buffer, static_cast<uint32_t>(packedData.size()));
+                buffer.insert(std::end(buffer), std::begin(packedData), std::end(packedData));
+            }
+
+            virtual uint8_t const *uncook(COMPONENT *const component, uint8_t const *buffer, uint8_t const *bufferEnd)
+            {
+                uint32_t packedSize = 0;
+                buffer = uncookValue(buffer, bufferEnd, packedSize);
+                if (!buffer || size_t(bufferEnd - buffer) < packedSize)
+                {
+                    return nullptr;
+                }
+
+                auto importData = JSON::Object::from_msgpack(buffer, (buffer + packedSize), true, false);
+                if (importData.is_discarded())
+                {
+                    return nullptr;
+                }
+
+                load(component, importData);
+                return (buffer + packedSize);
+            }
+
+            // Bumped by components whose cooked fields change without changing the size of the component
+            virtual uint32_t getCookedVersion(void) const
+            {
+                return 0;
+            }
+
             void save(Plugin::Component::Data const *const component, JSON::Object &exportData) const
             {
                 save(static_cast<COMPONENT const *const>(component), exportData);
@@ -80,6 +177,24 @@ namespace Gek
                 load(static_cast<COMPONENT *const>(component), importData);
             }
 
+            void cook(Plugin::Component::Data const *const component, std::vector<uint8_t> &buffer) const
+            {
+                cook(static_cast<COMPONENT const *const>(component), buffer);
+            }
+
+            uint8_t const *uncook(Plugin::Component::Data *const component, uint8_t const *buffer, uint8_t const *bufferEnd)
+            {
+                return uncook(static_cast<COMPONENT *const>(component), buffer, bufferEnd);
+            }
+
+            uint64_t getCookedLayout(void) const
+            {
+                COMPONENT defaultComponent;
+                std::vector<uint8_t> defaultBuffer;
+                cook(&defaultComponent, defaultBuffer);
+                return GetHash(getName(), sizeof(COMPONENT), alignof(COMPONENT), defaultBuffer.size(), getCookedVersion());
+            }
+
             bool editorElement(std::string_view const &text, std::function<bool(void)> &&element)
             {
                 ImGui::AlignTextToFramePadding();
@@ -101,19 +216,97 @@ namespace Gek
             {
             };
 
+            // Dense query entry, component pointers are re-resolved whenever the population moves the storage of the entity
+            struct Entry
+            {
+                Plugin::Entity *entity = nullptr;
+                Data data;
+                std::tuple<REQUIRED *...> componentList;
+                uint64_t storageVersion = 0;
+            };
+
+            static constexpr size_t ParallelGrainSize = 64;
+
           protected:
-            using EntityDataMap = tbb::concurrent_unordered_map<Plugin::Entity *, Data>;
-            EntityDataMap entityDataMap;
-            mutable std::shared_mutex entityDataMapMutex;
+            using EntryList = std::vector<Entry>;
+            Plugin::Population *processorPopulation = nullptr;
+            EntryList entryList;
+            std::unordered_map<Plugin::Entity *, size_t> entryIndexMap;
+            uint64_t entryStorageVersion = 0;
+            mutable std::shared_mutex entryListMutex;
+
+          private:
+            bool resolveComponents(Entry &entry)
+            {
+                entry.storageVersion = processorPopulation->getStorageVersion(entry.entity);
+                entry.componentList = std::make_tuple(static_cast<REQUIRED *>(entry.entity->getComponent(REQUIRED::GetIdentifier()))...);
+                return ((std::get<REQUIRED *>(entry.componentList) != nullptr) && ...);
+            }
+
+            // Processors can define onEntryRemoved(entity, data) to release per entity state, it is called with the
+            // entry list locked whenever an entity leaves the processor, clear() drops every entry without calling it
+            void eraseEntry(size_t entryIndex)
+            {
+                auto &entry = entryList[entryIndex];
+                if constexpr (requires(CLASS &processor) { processor.onEntryRemoved(entry.entity, entry.data); })
+                {
+                    static_cast<CLASS *>(this)->onEntryRemoved(entry.entity, entry.data);
+                }
+
+                entryIndexMap.erase(entryList[entryIndex].entity);
+                if (entryIndex != (entryList.size() - 1))
+                {
+                    entryList[entryIndex] = std::move(entryList.back());
+                    entryIndexMap[entryList[entryIndex].entity] = entryIndex;
+                }
+
+                entryList.pop_back();
+            }
+
+            void refreshComponents(void)
+            {
+                auto storageVersion = processorPopulation->getStorageVersion();
+                {
+                    std::shared_lock<std::shared_mutex> lock(entryListMutex);
+                    if (storageVersion == entryStorageVersion)
+                    {
+                        return;
+                    }
+                }
+
+                // Only entries whose archetype has moved rows since they were resolved need new pointers
+                std::unique_lock<std::shared_mutex> lock(entryListMutex);
+                for (size_t entryIndex = 0; entryIndex < entryList.size();)
+                {
+                    auto &entry = entryList[entryIndex];
+                    if (entry.storageVersion == processorPopulation->getStorageVersion(entry.entity) || resolveComponents(entry))
+                    {
+                        ++entryIndex;
+                    }
+                    else
+                    {
+                        eraseEntry(entryIndex);
+                    }
+                }
+
+                entryStorageVersion = storageVersion;
+            }
 
           public:
+            EntityProcessor(Plugin::Population *population)
+                : processorPopulation(population)
+            {
+                assert(processorPopulation);
+            }
+
             virtual ~EntityProcessor(void) = default;
 
             // ProcessorMixin
             void clear(void)
             {
-                std::unique_lock<std::shared_mutex> lock(entityDataMapMutex);
-                entityDataMap.clear();
+                std::unique_lock<std::shared_mutex> lock(entryListMutex);
+                entryList.clear();
+                entryIndexMap.clear();
             }
 
             void addEntity(Plugin::Entity *const entity, std::function<void(bool isNewInsert, Data &data, REQUIRED &...components)> onAdded = nullptr)
@@ -122,12 +315,19 @@ namespace Gek
 
                 if (entity->hasComponents<REQUIRED...>())
                 {
-                    std::unique_lock<std::shared_mutex> lock(entityDataMapMutex);
-                    static const Data BlankData;
-                    auto insertSearch = entityDataMap.insert(std::make_pair(entity, BlankData));
+                    std::unique_lock<std::shared_mutex> lock(entryListMutex);
+                    auto insertSearch = entryIndexMap.insert(std::make_pair(entity, entryList.size()));
+                    if (insertSearch.second)
+                    {
+                        auto &entry = entryList.emplace_back();
+                        entry.entity = entity;
+                    }
+
+                    auto &entry = entryList[insertSearch.first->second];
+                    resolveComponents(entry);
                     if (onAdded)
                     {
-                        onAdded(insertSearch.second, insertSearch.first->second, entity->getComponent<REQUIRED>()...);
+                        onAdded(insertSearch.second, entry.data, *std::get<REQUIRED *>(entry.componentList)...);
                     }
                 }
             }
@@ -136,36 +336,45 @@ namespace Gek
             {
                 assert(entity);
 
-                std::unique_lock<std::shared_mutex> lock(entityDataMapMutex);
-                auto entitySearch = entityDataMap.find(entity);
-                if (entitySearch != std::end(entityDataMap))
+                std::unique_lock<std::shared_mutex> lock(entryListMutex);
+                auto entitySearch = entryIndexMap.find(entity);
+                if (entitySearch != std::end(entryIndexMap))
                 {
-                    entityDataMap.unsafe_erase(entitySearch);
+                    eraseEntry(entitySearch->second);
                 }
             }
 
             size_t getEntityCount(void)
             {
-                std::shared_lock<std::shared_mutex> lock(entityDataMapMutex);
-                return entityDataMap.size();
+                std::shared_lock<std::shared_mutex> lock(entryListMutex);
+                return entryList.size();
             }
 
             void listEntities(std::function<void(Plugin::Entity *const entity, Data &data, REQUIRED &...components)> &&onEntity)
             {
                 assert(onEntity);
 
-                std::shared_lock<std::shared_mutex> lock(entityDataMapMutex);
-                std::for_each(std::begin(entityDataMap), std::end(entityDataMap), [&](auto &entitySearch) -> void
-                              { onEntity(entitySearch.first, entitySearch.second, entitySearch.first->template getComponent<REQUIRED>()...); });
+                refreshComponents();
+                std::shared_lock<std::shared_mutex> lock(entryListMutex);
+                for (auto &entry : entryList)
+                {
+                    onEntity(entry.entity, entry.data, *std::get<REQUIRED *>(entry.componentList)...);
+                }
             }
 
             void parallelListEntities(std::function<void(Plugin::Entity *const entity, Data &data, REQUIRED &...components)> &&onEntity)
             {
                 assert(onEntity);
 
-                std::shared_lock<std::shared_mutex> lock(entityDataMapMutex);
-                std::for_each(std::execution::par, std::begin(entityDataMap), std::end(entityDataMap), [&](auto &entitySearch) -> void
-                              { onEntity(entitySearch.first, entitySearch.second, entitySearch.first->template getComponent<REQUIRED>()...); });
+                refreshComponents();
+                std::shared_lock<std::shared_mutex> lock(entryListMutex);
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, entryList.size(), ParallelGrainSize), [&](tbb::blocked_range<size_t> const &range) -> void
+                                  {
+                    for (size_t entryIndex = range.begin(); entryIndex != range.end(); ++entryIndex)
+                    {
+                        auto &entry = entryList[entryIndex];
+                        onEntity(entry.entity, entry.data, *std::get<REQUIRED *>(entry.componentList)...);
+                    } });
             }
         };
     }; // namespace Plugin
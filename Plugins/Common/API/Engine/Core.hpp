@@ -14,6 +14,9 @@
 
 namespace Gek
 {
+    class ThreadPool;
+    class FileReader;
+
     namespace Plugin
     {
         GEK_PREDECLARE(Population);
@@ -43,6 +46,12 @@ namespace Gek
             virtual Plugin::Resources *getResources(void) const = 0;
             virtual Plugin::Visualizer *getVisualizer(void) const = 0;
 
+            // Shared by every subsystem, schedule onto the queue that matches the work instead of creating threads
+            virtual ThreadPool *getThreadPool(void) const = 0;
+
+            // Streams whole files into memory off the pool, the awaiting coroutine resumes on the pool afterwards
+            virtual FileReader *getFileReader(void) const = 0;
+
             virtual void listProcessors(std::function<void(Plugin::Processor *)> onProcessor) = 0;
         };
     }; // namespace Plugin
@@ -25,8 +25,8 @@ namespace Gek
         {
             virtual ~Entity(void) = default;
 
-            using Components = std::unordered_map<Hash, std::unique_ptr<Plugin::Component::Data>>;
-            virtual Components &getComponents(void) = 0;
+            using Components = std::vector<std::pair<Hash, Plugin::Component::Data *>>;
+            virtual Components getComponents(void) = 0;
         };
 
         GEK_INTERFACE(Component)
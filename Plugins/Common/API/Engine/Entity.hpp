@@ -35,8 +35,7 @@ namespace Gek
             template <typename... PARAMETERS>
             bool hasComponents(void) const
             {
-                std::vector<bool> hasComponentList({ hasComponent<PARAMETERS>()... });
-                return (std::accumulate(std::begin(hasComponentList), std::end(hasComponentList), 0U) == hasComponentList.size());
+                return (hasComponent<PARAMETERS>() && ...);
             }
 
             template <typename COMPONENT>
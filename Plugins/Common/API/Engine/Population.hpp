@@ -8,12 +8,14 @@
 #pragma once
 
 #include "API/Engine/Entity.hpp"
+#include "GEK/Shapes/BoundingVolumeHierarchy.hpp"
 #include "GEK/Utility/Context.hpp"
 #include "GEK/Utility/ShuntingYard.hpp"
 #include "GEK/Utility/String.hpp"
 #include <functional>
 #include <map>
 #include <typeindex>
+#include <utility>
 #include <vector>
 #include <wink/signal.hpp>
 
@@ -53,17 +55,40 @@ namespace Gek
                 }
             };
 
+            // Per-frame work declared with the component types it reads and writes.  Stages that do not conflict run
+            // concurrently on the job system, conflicting stages run by order and then by registration.
+            struct UpdateStage
+            {
+                std::string name;
+                int32_t order = 0;
+                std::vector<Hash> readList;
+                std::vector<Hash> writeList;
+
+                // Waits on every earlier stage that writes anything
+                bool readsEverything = false;
+
+                // Runs on the thread calling update, for work that has to stay with the device
+                bool callingThread = false;
+
+                // Writes are only consumed next frame, so later readers do not wait on this stage
+                bool pipelined = false;
+
+                std::function<void(float frameTime)> onUpdate;
+            };
+
             virtual ~Population(void) = default;
 
             wink::signal<wink::slot<void(std::string const &populationName)>> onLoad;
             wink::signal<wink::slot<void(std::string const &populationName)>> onSave;
 
+            // Slots connected here run on the calling thread with no update stage in flight
             std::map<int32_t, wink::signal<wink::slot<void(float frameTime)>>> onUpdate;
             wink::signal<wink::slot<void(Action const &action)>> onAction;
 
             wink::signal<wink::slot<void(void)>> onReset;
 
             wink::signal<wink::slot<void(Plugin::Entity *const entity)>> onEntityCreated;
+            wink::signal<wink::slot<void(std::vector<Plugin::Entity *> const &entityList)>> onEntityListCreated;
             wink::signal<wink::slot<void(Plugin::Entity *const entity)>> onEntityDestroyed;
 
             wink::signal<wink::slot<void(Plugin::Entity *const entity)>> onComponentAdded;
@@ -82,7 +107,59 @@ namespace Gek
 
             virtual void listEntities(std::function<void(Plugin::Entity *const entity)> && onEntity) const = 0;
 
+            // Incremented whenever component data may have moved in memory, cached component pointers are stale once it changes
+            virtual uint64_t getStorageVersion(void) const = 0;
+
+            // Version of the storage holding the entity components, it only changes when the archetype the entity
+            // belongs to has moved rows or the entity has moved to another archetype
+            virtual uint64_t getStorageVersion(Plugin::Entity const *entity) const = 0;
+
+            // Component data is stored in archetype chunks, one contiguous column per component type for every
+            // entity that shares the same set of components.  componentLists follows the order of typeList.
+            using ChunkFunction = std::function<void(size_t count, Plugin::Entity *const *entityList, void *const *componentLists)>;
+            virtual void listChunks(std::vector<Hash> const &typeList, ChunkFunction &&onChunk) const = 0;
+            virtual void parallelListChunks(std::vector<Hash> const &typeList, ChunkFunction &&onChunk) const = 0;
+
+            template <typename... COMPONENTS, typename FUNCTION>
+            void listChunks(FUNCTION &&onChunk) const
+            {
+                listChunks({ COMPONENTS::GetIdentifier()... }, [&onChunk](size_t count, Plugin::Entity *const *entityList, void *const *componentLists) -> void
+                           { CallChunk<COMPONENTS...>(onChunk, count, entityList, componentLists, std::index_sequence_for<COMPONENTS...>()); });
+            }
+
+            template <typename... COMPONENTS, typename FUNCTION>
+            void parallelListChunks(FUNCTION &&onChunk) const
+            {
+                parallelListChunks({ COMPONENTS::GetIdentifier()... }, [&onChunk](size_t count, Plugin::Entity *const *entityList, void *const *componentLists) -> void
+                                   { CallChunk<COMPONENTS...>(onChunk, count, entityList, componentLists, std::index_sequence_for<COMPONENTS...>()); });
+            }
+
             virtual void action(Action const &action) = 0;
+
+            virtual uint32_t addUpdateStage(UpdateStage &&stage) = 0;
+            virtual void removeUpdateStage(uint32_t stageIdentifier) = 0;
+
+            // Incremented at the start of every update
+            virtual uint64_t getFrameIndex(void) const = 0;
+
+            // Scene wide trees used for culling.  Each layer is filled and locked by the one processor that owns
+            // those objects, the population only keeps them alive.
+            enum class SpatialLayer : uint8_t
+            {
+                Models = 0,
+                PointLights,
+                SpotLights,
+                Count,
+            };
+
+            virtual Shapes::BoundingVolumeHierarchy &getSpatialIndex(SpatialLayer layer) = 0;
+
+          private:
+            template <typename... COMPONENTS, typename FUNCTION, size_t... INDICES>
+            static void CallChunk(FUNCTION &onChunk, size_t count, Plugin::Entity *const *entityList, void *const *componentLists, std::index_sequence<INDICES...>)
+            {
+                onChunk(count, entityList, static_cast<COMPONENTS *>(componentLists[INDICES])...);
+            }
         };
     }; // namespace Plugin
 }; // namespace Gek
\ No newline at end of file
@@ -33,6 +33,9 @@ namespace Gek
             virtual VisualHandle loadVisual(std::string_view pluginName) = 0;
             virtual MaterialHandle loadMaterial(std::string_view materialName) = 0;
 
+            // Materials that are still loading report no culling so that nothing they draw is dropped early
+            virtual Render::RenderState::CullMode getMaterialCullMode(MaterialHandle material) const = 0;
+
             virtual ResourceHandle loadTexture(std::string_view textureName, uint32_t flags, ResourceHandle fallbackResource = ResourceHandle()) = 0;
             virtual ResourceHandle createPattern(std::string_view pattern, JSON::Object const &parameters) = 0;
 
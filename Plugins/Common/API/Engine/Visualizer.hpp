@@ -21,11 +21,18 @@ namespace Gek
     {
         GEK_INTERFACE(Visualizer)
         {
-            wink::signal<wink::slot<void(const Shapes::Frustum &viewFrustum, Math::Float4x4 const &viewMatrix, Math::Float4x4 const &projectionMatrix)>> onQueueDrawCalls;
+            // The camera name stays the same between frames, listeners can keep state for each camera with it
+            wink::signal<wink::slot<void(const Shapes::Frustum &viewFrustum, Math::Float4x4 const &viewMatrix, Math::Float4x4 const &projectionMatrix, std::string const &cameraName)>> onQueueDrawCalls;
             wink::signal<wink::slot<void(void)>> onShowUserInterface;
 
             virtual ~Visualizer(void) = default;
 
+            // Written by update stages that queue cameras so that rendering is ordered after them
+            static Hash GetCameraListIdentifier(void)
+            {
+                return typeid(Visualizer).hash_code();
+            }
+
             virtual Render::Device *getRenderDevice(void) const = 0;
             virtual ImGuiContext *const getGuiContext(void) const = 0;
 
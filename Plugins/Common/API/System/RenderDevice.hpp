@@ -838,6 +838,8 @@ namespace Gek
             virtual TexturePtr createTexture(const Texture::Description &description, const void *data = nullptr) = 0;
             virtual TexturePtr loadTexture(void const *buffer, size_t size, uint32_t flags) = 0;
             virtual TexturePtr loadTexture(FileSystem::Path const &filePath, uint32_t flags) = 0;
+            // Decodes a file that was already read, the path picks the format and names the texture
+            virtual TexturePtr loadTexture(FileSystem::Path const &filePath, FileSystem::FileView const &fileView, uint32_t flags) = 0;
             virtual Texture::Description loadTextureDescription(FileSystem::Path const &filePath) = 0;
 
             virtual BufferPtr createBuffer(const Buffer::Description &description, const void *staticData = nullptr) = 0;
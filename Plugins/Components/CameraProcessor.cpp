@@ -54,6 +54,23 @@ namespace Gek
             data->target = evaluate(importData, "target", String::Empty);
         }
 
+        void cook(Components::FirstPersonCamera const * const data, std::vector<uint8_t> &buffer) const
+        {
+            cookValue(buffer, data->fieldOfView);
+            cookValue(buffer, data->nearClip);
+            cookValue(buffer, data->farClip);
+            cookValue(buffer, data->target);
+        }
+
+        uint8_t const *uncook(Components::FirstPersonCamera * const data, uint8_t const *buffer, uint8_t const *bufferEnd)
+        {
+            buffer = uncookValue(buffer, bufferEnd, data->fieldOfView);
+            buffer = uncookValue(buffer, bufferEnd, data->nearClip);
+            buffer = uncookValue(buffer, bufferEnd, data->farClip);
+            buffer = uncookValue(buffer, bufferEnd, data->target);
+            return buffer;
+        }
+
         // Edit::Component
         bool onUserInterface(ImGuiContext * const guiContext, Plugin::Entity * const entity, Plugin::Component::Data *data)
         {
@@ -96,10 +113,12 @@ namespace Gek
         Plugin::Population *population = nullptr;
         Plugin::Resources *resources = nullptr;
         Plugin::Visualizer *visualizer = nullptr;
+        uint32_t updateStageIdentifier = 0;
 
     public:
         CameraProcessor(Context *context, Plugin::Core *core)
             : ContextRegistration(context)
+            , EntityProcessor(core->getPopulation())
             , core(core)
             , population(core->getPopulation())
             , resources(core->getResources())
@@ -112,10 +131,23 @@ namespace Gek
             core->onShutdown.connect(this, &CameraProcessor::onShutdown);
             population->onReset.connect(this, &CameraProcessor::onReset);
             population->onEntityCreated.connect(this, &CameraProcessor::onEntityCreated);
+            population->onEntityListCreated.connect(this, &CameraProcessor::onEntityListCreated);
             population->onEntityDestroyed.connect(this, &CameraProcessor::onEntityDestroyed);
             population->onComponentAdded.connect(this, &CameraProcessor::onComponentAdded);
             population->onComponentRemoved.connect(this, &CameraProcessor::onComponentRemoved);
-            population->onUpdate[90].connect(this, &CameraProcessor::onUpdate);
+
+            // With overlapped camera setup the visualizer renders these cameras next frame, alongside this stage
+            updateStageIdentifier = population->addUpdateStage({
+                .name = "camera",
+                .order = 90,
+                .readList = { Components::FirstPersonCamera::GetIdentifier(), Components::Transform::GetIdentifier(), Components::Name::GetIdentifier() },
+                .writeList = { Plugin::Visualizer::GetCameraListIdentifier() },
+                .pipelined = core->getOption("render", "overlapCameraSetup", false),
+                .onUpdate = [this](float frameTime) -> void
+                {
+                    onUpdate(frameTime);
+                },
+            });
         }
 
         void addEntity(Plugin::Entity * const entity)
@@ -141,10 +173,11 @@ namespace Gek
         {
             population->onReset.disconnect(this, &CameraProcessor::onReset);
             population->onEntityCreated.disconnect(this, &CameraProcessor::onEntityCreated);
+            population->onEntityListCreated.disconnect(this, &CameraProcessor::onEntityListCreated);
             population->onEntityDestroyed.disconnect(this, &CameraProcessor::onEntityDestroyed);
             population->onComponentAdded.disconnect(this, &CameraProcessor::onComponentAdded);
             population->onComponentRemoved.disconnect(this, &CameraProcessor::onComponentRemoved);
-            population->onUpdate[90].disconnect(this, &CameraProcessor::onUpdate);
+            population->removeUpdateStage(updateStageIdentifier);
             clear();
         }
 
@@ -159,6 +192,14 @@ namespace Gek
             addEntity(entity);
         }
 
+        void onEntityListCreated(std::vector<Plugin::Entity *> const &entityList)
+        {
+            for (auto entity : entityList)
+            {
+                addEntity(entity);
+            }
+        }
+
         void onEntityDestroyed(Plugin::Entity * const entity)
         {
             removeEntity(entity);
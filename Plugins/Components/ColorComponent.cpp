@@ -33,6 +33,17 @@ namespace Gek
             data->value = evaluate(importData, Math::Float4::White);
         }
 
+        void cook(Components::Color const * const data, std::vector<uint8_t> &buffer) const
+        {
+            cookValue(buffer, data->value);
+        }
+
+        uint8_t const *uncook(Components::Color * const data, uint8_t const *buffer, uint8_t const *bufferEnd)
+        {
+            buffer = uncookValue(buffer, bufferEnd, data->value);
+            return buffer;
+        }
+
         // Edit::Component
         bool onUserInterface(ImGuiContext * const guiContext, Plugin::Entity * const entity, Plugin::Component::Data *data)
         {
@@ -24,6 +24,9 @@ namespace Gek
             Math::Quaternion rotation = Math::Quaternion::Identity;
             Math::Float3 scale = Math::Float3::One;
 
+            // Bumped by everything that moves the entity at runtime, lets caches skip entities that never move
+            uint32_t version = 0;
+
             inline Math::Float4x4 getMatrix(void) const
             {
                 return Math::Float4x4::MakeQuaternionRotation(rotation, position);
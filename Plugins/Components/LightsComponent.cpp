@@ -32,6 +32,21 @@ namespace Gek
             getContext()->log(Context::Info, "Range: {}, Radius: {}, Intensity: {}", data->range, data->radius, data->intensity);
         }
 
+        void cook(Components::PointLight const * const data, std::vector<uint8_t> &buffer) const
+        {
+            cookValue(buffer, data->range);
+            cookValue(buffer, data->radius);
+            cookValue(buffer, data->intensity);
+        }
+
+        uint8_t const *uncook(Components::PointLight * const data, uint8_t const *buffer, uint8_t const *bufferEnd)
+        {
+            buffer = uncookValue(buffer, bufferEnd, data->range);
+            buffer = uncookValue(buffer, bufferEnd, data->radius);
+            buffer = uncookValue(buffer, bufferEnd, data->intensity);
+            return buffer;
+        }
+
         // Edit::Component
         bool onUserInterface(ImGuiContext * const guiContext, Plugin::Entity * const entity, Plugin::Component::Data *data)
         {
@@ -91,6 +106,27 @@ namespace Gek
             data->coneFalloff = evaluate(importData, "coneFalloff", 0.0f);
         }
 
+        void cook(Components::SpotLight const * const data, std::vector<uint8_t> &buffer) const
+        {
+            cookValue(buffer, data->range);
+            cookValue(buffer, data->radius);
+            cookValue(buffer, data->intensity);
+            cookValue(buffer, data->innerAngle);
+            cookValue(buffer, data->outerAngle);
+            cookValue(buffer, data->coneFalloff);
+        }
+
+        uint8_t const *uncook(Components::SpotLight * const data, uint8_t const *buffer, uint8_t const *bufferEnd)
+        {
+            buffer = uncookValue(buffer, bufferEnd, data->range);
+            buffer = uncookValue(buffer, bufferEnd, data->radius);
+            buffer = uncookValue(buffer, bufferEnd, data->intensity);
+            buffer = uncookValue(buffer, bufferEnd, data->innerAngle);
+            buffer = uncookValue(buffer, bufferEnd, data->outerAngle);
+            buffer = uncookValue(buffer, bufferEnd, data->coneFalloff);
+            return buffer;
+        }
+
         // Edit::Component
         bool onUserInterface(ImGuiContext * const guiContext, Plugin::Entity * const entity, Plugin::Component::Data *data)
         {
@@ -155,6 +191,17 @@ namespace Gek
             data->intensity = evaluate(importData, "intensity", 0.0f);
         }
 
+        void cook(Components::DirectionalLight const * const data, std::vector<uint8_t> &buffer) const
+        {
+            cookValue(buffer, data->intensity);
+        }
+
+        uint8_t const *uncook(Components::DirectionalLight * const data, uint8_t const *buffer, uint8_t const *bufferEnd)
+        {
+            buffer = uncookValue(buffer, bufferEnd, data->intensity);
+            return buffer;
+        }
+
         // Edit::Component
         bool onUserInterface(ImGuiContext * const guiContext, Plugin::Entity * const entity, Plugin::Component::Data *data)
         {
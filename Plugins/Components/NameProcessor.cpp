@@ -29,6 +29,17 @@ namespace Gek
             data->name = importData.get<std::string>();
         }
 
+        void cook(Components::Name const * const data, std::vector<uint8_t> &buffer) const
+        {
+            cookValue(buffer, data->name);
+        }
+
+        uint8_t const *uncook(Components::Name * const data, uint8_t const *buffer, uint8_t const *bufferEnd)
+        {
+            buffer = uncookValue(buffer, bufferEnd, data->name);
+            return buffer;
+        }
+
         // Edit::Component
         bool onUserInterface(ImGuiContext * const guiContext, Plugin::Entity * const entity, Plugin::Component::Data *data)
         {
@@ -67,6 +78,7 @@ namespace Gek
     public:
         NameProcessor(Context *context, Plugin::Core *core)
             : ContextRegistration(context)
+            , EntityProcessor(core->getPopulation())
             , core(core)
             , population(core->getPopulation())
         {
@@ -76,6 +88,7 @@ namespace Gek
             core->onShutdown.connect(this, &NameProcessor::onShutdown);
             population->onReset.connect(this, &NameProcessor::onReset);
             population->onEntityCreated.connect(this, &NameProcessor::onEntityCreated);
+            population->onEntityListCreated.connect(this, &NameProcessor::onEntityListCreated);
             population->onEntityDestroyed.connect(this, &NameProcessor::onEntityDestroyed);
             population->onComponentAdded.connect(this, &NameProcessor::onComponentAdded);
             population->onComponentRemoved.connect(this, &NameProcessor::onComponentRemoved);
@@ -148,6 +161,7 @@ namespace Gek
 
             population->onReset.disconnect(this, &NameProcessor::onReset);
             population->onEntityCreated.disconnect(this, &NameProcessor::onEntityCreated);
+            population->onEntityListCreated.disconnect(this, &NameProcessor::onEntityListCreated);
             population->onEntityDestroyed.disconnect(this, &NameProcessor::onEntityDestroyed);
             population->onComponentAdded.disconnect(this, &NameProcessor::onComponentAdded);
             population->onComponentRemoved.disconnect(this, &NameProcessor::onComponentRemoved);
@@ -179,6 +193,14 @@ namespace Gek
             addEntity(entity);
         }
 
+        void onEntityListCreated(std::vector<Plugin::Entity *> const &entityList)
+        {
+            for (auto entity : entityList)
+            {
+                addEntity(entity);
+            }
+        }
+
         void onEntityDestroyed(Plugin::Entity * const entity)
         {
             removeEntity(entity);
@@ -43,6 +43,17 @@ namespace Gek
 			data->torque.y = population->getShuntingYard().evaluate("random(-pi,pi)").value_or(0.0f);
 			data->torque.z = population->getShuntingYard().evaluate("random(-pi,pi)").value_or(0.0f);
 		}
+
+		void cook(Components::Spin const * const data, std::vector<uint8_t> &buffer) const
+		{
+			cookValue(buffer, data->torque);
+		}
+
+		uint8_t const *uncook(Components::Spin * const data, uint8_t const *buffer, uint8_t const *bufferEnd)
+		{
+			buffer = uncookValue(buffer, bufferEnd, data->torque);
+			return buffer;
+		}
 	};
 
 	GEK_CONTEXT_USER(SpinProcessor, Plugin::Core *)
@@ -51,6 +62,7 @@ namespace Gek
 	private:
 		Plugin::Core *core = nullptr;
 		Plugin::Population *population = nullptr;
+		uint32_t updateStageIdentifier = 0;
 
 	public:
 		SpinProcessor(Context *context, Plugin::Core *core)
@@ -61,13 +73,22 @@ namespace Gek
 			assert(population);
 
 			core->onShutdown.connect(this, &SpinProcessor::onShutdown);
-			population->onUpdate[50].connect(this, &SpinProcessor::onUpdate);
+			updateStageIdentifier = population->addUpdateStage({
+				.name = "spin",
+				.order = 50,
+				.readList = { Components::Spin::GetIdentifier() },
+				.writeList = { Components::Transform::GetIdentifier() },
+				.onUpdate = [this](float frameTime) -> void
+				{
+					onUpdate(frameTime);
+				},
+			});
 		}
 
 		// Plugin::Core
 		void onShutdown(void)
 		{
-			population->onUpdate[50].disconnect(this, &SpinProcessor::onUpdate);
+			population->removeUpdateStage(updateStageIdentifier);
 		}
 
 		// Plugin::Population Slots
@@ -78,19 +99,15 @@ namespace Gek
 			bool editorActive = core->getOption("editor", "active", false);
 			if (frameTime > 0.0f && !editorActive)
 			{
-				auto onEntity = [&](Plugin::Entity * const entity) -> void
+				population->parallelListChunks<Components::Transform, Components::Spin>([&](size_t count, Plugin::Entity * const *entityList, Components::Transform *transformList, Components::Spin *spinList) -> void
 				{
-                    if (entity->hasComponents<Components::Transform, Components::Spin>())
-                    {
-						auto &spinComponent = entity->getComponent<Components::Spin>();
-						auto omega(spinComponent.torque * frameTime);
-
-						auto &transformComponent = entity->getComponent<Components::Transform>();
-						transformComponent.rotation *= Math::Quaternion::MakeEulerRotation(omega.x, omega.y, omega.z);
-                    }
-				};
-
-				population->listEntities(onEntity);
+					for (size_t index = 0; index < count; ++index)
+					{
+						auto omega(spinList[index].torque * frameTime);
+						transformList[index].rotation *= Math::Quaternion::MakeEulerRotation(omega.x, omega.y, omega.z);
+						++transformList[index].version;
+					}
+				});
 			}
 		}
 	};
@@ -27,6 +27,21 @@ void load(Components::Transform *const data, JSON::Object const &importData)
     data->scale = evaluate(importData, "scale", Math::Float3::One);
 }
 
+void cook(Components::Transform const *const data, std::vector<uint8_t> &buffer) const
+{
+    cookValue(buffer, data->position);
+    cookValue(buffer, data->rotation);
+    cookValue(buffer, data->scale);
+}
+
+uint8_t const *uncook(Components::Transform *const data, uint8_t const *buffer, uint8_t const *bufferEnd)
+{
+    buffer = uncookValue(buffer, bufferEnd, data->position);
+    buffer = uncookValue(buffer, bufferEnd, data->rotation);
+    buffer = uncookValue(buffer, bufferEnd, data->scale);
+    return buffer;
+}
+
 // Edit::Component
 bool onUserInterface(ImGuiContext *const guiContext, Plugin::Entity *const entity, Plugin::Component::Data *data)
 {
@@ -44,6 +59,11 @@ bool onUserInterface(ImGuiContext *const guiContext, Plugin::Entity *const entit
     changed |= editorElement("Scale", [&](void) -> bool
                              { return ImGui::InputFloat3("##scale", transformComponent.scale.data, "%.4f", ImGuiInputTextFlags_CharsDecimal | ImGuiInputTextFlags_CharsNoBlank); });
 
+    if (changed)
+    {
+        ++transformComponent.version;
+    }
+
     ImGui::SetCurrentContext(nullptr);
     return changed;
 }
@@ -5,20 +5,27 @@
 #include "GEK/Engine/Population.hpp"
 #include "GEK/Engine/Resources.hpp"
 #include "GEK/GUI/Utilities.hpp"
+#include "GEK/Math/SIMD.hpp"
 #include "GEK/Utility/ContextUser.hpp"
+#include "GEK/Utility/FileReader.hpp"
 #include "GEK/Utility/FileSystem.hpp"
+#include "GEK/Utility/Profiler.hpp"
 #include "GEK/Utility/String.hpp"
+#include "GEK/Utility/ThreadPool.hpp"
 #include "GEK/Utility/Timer.hpp"
 #include <algorithm>
 #include <array>
 #include <atomic>
 #include <cfloat>
+#include <chrono>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <imgui_internal.h>
 #include <limits>
+#include <map>
 #include <numeric>
+#include <tbb/global_control.h>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -146,7 +153,7 @@ namespace Gek
             return ImGui::IsKeyDown(imguiKey);
         }
 
-        GEK_CONTEXT_USER_BASE(Core)
+        GEK_CONTEXT_USER(Core, Engine::Core::Benchmark)
         , virtual Engine::Core
         {
           private:
@@ -186,7 +193,7 @@ namespace Gek
                 size_t sampleCount = 0;
             };
 
-            std::array<RuntimeMetricPlot, 71> runtimeMetricPlots = { {
+            std::array<RuntimeMetricPlot, 77> runtimeMetricPlots = { {
                 { "render.fpsInstant", "FPS (Instant)", ImVec4(0.95f, 0.82f, 0.26f, 1.0f) },
                 { "render.fpsSmoothed", "FPS (Smoothed)", ImVec4(0.95f, 0.62f, 0.20f, 1.0f) },
                 { "render.frameTimeMs", "Frame CPU (ms)", ImVec4(0.88f, 0.88f, 0.30f, 1.0f) },
@@ -258,22 +265,44 @@ namespace Gek
                 { "render.sceneDraws", "Render Scene Draws", ImVec4(0.35f, 0.50f, 0.95f, 1.0f) },
                 { "visualizer.queuedDrawCalls", "Queued Draw Calls", ImVec4(0.95f, 0.30f, 0.30f, 1.0f) },
                 { "model.visibleModels", "Visible Models", ImVec4(0.40f, 0.78f, 0.33f, 1.0f) },
+                { "jobs.frame.queued", "Jobs Frame Queued", ImVec4(0.30f, 0.86f, 0.92f, 1.0f) },
+                { "jobs.frame.running", "Jobs Frame Running", ImVec4(0.22f, 0.72f, 0.86f, 1.0f) },
+                { "jobs.streaming.queued", "Jobs Streaming Queued", ImVec4(0.42f, 0.92f, 0.58f, 1.0f) },
+                { "jobs.streaming.running", "Jobs Streaming Running", ImVec4(0.32f, 0.80f, 0.48f, 1.0f) },
+                { "jobs.background.queued", "Jobs Background Queued", ImVec4(0.80f, 0.80f, 0.80f, 1.0f) },
+                { "jobs.background.running", "Jobs Background Running", ImVec4(0.62f, 0.62f, 0.62f, 1.0f) },
             } };
-            std::array<bool, 71> runtimeMetricVisible = []() -> std::array<bool, 71>
+            std::array<bool, 77> runtimeMetricVisible = []() -> std::array<bool, 77>
             {
-                std::array<bool, 71> initialVisibility{};
+                std::array<bool, 77> initialVisibility{};
                 initialVisibility.fill(true);
                 return initialVisibility;
             }();
             bool runtimeMetricViewAll = true;
             uint64_t runtimeMetricsLastFrame = 0;
             std::array<char, 260> runtimeLogFilePath = {};
+#ifdef GEK_ENABLE_PROFILER
+            std::array<char, 260> traceFilePath = { "trace.json" };
+#endif
             bool runtimeLogFileAppend = true;
             double runtimeFpsSmoothed = 0.0;
             bool runtimeFpsSmoothedInitialized = false;
             bool runtimeEnableVulkanCharts = false;
             bool runtimeDumpMetricsOnExit = true;
             bool runtimeDumpMetricsCsvFormat = true;
+            std::chrono::steady_clock::time_point runtimeHistogramTime;
+            std::unordered_map<std::string, Metrics::Histogram> runtimeHistogramBaseline;
+            std::vector<std::pair<std::string, Metrics::Histogram>> runtimeHistogramWindow;
+
+            struct MetricHandles
+            {
+                Metrics::Handle frameTime;
+                Metrics::Handle fpsInstant;
+                Metrics::Handle fpsSmoothed;
+                Metrics::Handle update;
+                std::array<Metrics::Handle, static_cast<size_t>(ThreadPool::Queue::Count)> jobsQueued;
+                std::array<Metrics::Handle, static_cast<size_t>(ThreadPool::Queue::Count)> jobsRunning;
+            } metricHandles;
 
             bool showModeChange = false;
             float modeChangeTimer = 0.0f;
@@ -285,6 +314,9 @@ namespace Gek
             bool enableInterfaceControl = true;
 
             std::string renderDeviceName;
+            std::unique_ptr<tbb::global_control> parallelismControl;
+            std::unique_ptr<ThreadPool> threadPool;
+            std::unique_ptr<FileReader> fileReader;
             Render::DevicePtr renderDevice;
             Plugin::VisualizerPtr visualizer;
             Engine::ResourcesPtr resources;
@@ -374,6 +406,17 @@ namespace Gek
                 }
             }
 
+            void updateJobMetrics(void)
+            {
+                auto &metrics = getContext()->getRuntimeMetrics();
+                for (uint8_t queueIndex = 0; queueIndex < static_cast<uint8_t>(ThreadPool::Queue::Count); ++queueIndex)
+                {
+                    auto occupancy = threadPool->getOccupancy(static_cast<ThreadPool::Queue>(queueIndex));
+                    metrics.set(metricHandles.jobsQueued[queueIndex], occupancy.queued);
+                    metrics.set(metricHandles.jobsRunning[queueIndex], occupancy.running);
+                }
+            }
+
             void logRuntimeMetricSnapshot(bool visibleOnly, char const *reason)
             {
                 auto runtimeMetrics = getContext()->getRuntimeMetricSnapshot();
@@ -382,10 +425,16 @@ namespace Gek
 
             bool loadingPopulation = false;
 
+            Benchmark benchmark;
+            uint32_t benchmarkFrame = 0;
+            std::map<std::string, std::vector<double>> benchmarkSampleMap;
+
           public:
-            Core(Context * context)
+            Core(Context * context, Engine::Core::Benchmark benchmark)
                 : ContextRegistration(context)
+                , benchmark(benchmark)
             {
+                GEK_PROFILE_THREAD("Main");
 #ifdef _WIN32
                 HRESULT resultValue = CoInitializeEx(nullptr, COINITBASE_MULTITHREADED);
                 if (FAILED(resultValue))
@@ -396,7 +445,7 @@ namespace Gek
 #endif
                 configuration = JSON::Load(getContext()->findDataPath("config.json"s));
 
-                auto devicePlugin = Plugin::Core::getOption("render", "device", "renderd3d11"s);
+                auto devicePlugin = (benchmark.isEnabled() && !benchmark.device.empty() ? benchmark.device : Plugin::Core::getOption("render", "device", "renderd3d11"s));
                 Gek::String::Replace(devicePlugin, "render", "");
                 renderDeviceName = devicePlugin;
 
@@ -411,11 +460,26 @@ namespace Gek
 
                 getContext()->log(Context::Info, "Starting GEK Engine");
 
+                auto &metrics = getContext()->getRuntimeMetrics();
+                metricHandles.frameTime = metrics.getHandle("render.frameTimeMs", Metrics::Type::Timing);
+                metricHandles.fpsInstant = metrics.getHandle("render.fpsInstant");
+                metricHandles.fpsSmoothed = metrics.getHandle("render.fpsSmoothed");
+                metricHandles.update = metrics.getHandle("core.updateMs", Metrics::Type::Timing);
+                for (uint8_t queueIndex = 0; queueIndex < static_cast<uint8_t>(ThreadPool::Queue::Count); ++queueIndex)
+                {
+                    auto queueName = ThreadPool::GetQueueName(static_cast<ThreadPool::Queue>(queueIndex));
+                    metricHandles.jobsQueued[queueIndex] = metrics.getHandle(std::format("jobs.{}.queued", queueName));
+                    metricHandles.jobsRunning[queueIndex] = metrics.getHandle(std::format("jobs.{}.running", queueName));
+                }
+
                 const uint32_t defaultSinkMask = static_cast<uint32_t>(getContext()->getLogSinkMask());
                 uint32_t configuredSinkMask = JSON::Value(getOption("logging", "sinkMask"), defaultSinkMask);
                 configuredSinkMask &= static_cast<uint32_t>(Context::LogSink_Console | Context::LogSink_Debugger | Context::LogSink_File);
                 getContext()->setLogSinkMask(static_cast<uint8_t>(configuredSinkMask));
 
+                uint32_t configuredLogLevel = JSON::Value(getOption("logging", "level"), static_cast<uint32_t>(getContext()->getLogLevel()));
+                getContext()->setLogLevel(static_cast<Context::LogLevel>(std::min(configuredLogLevel, static_cast<uint32_t>(Context::Info))));
+
                 runtimeLogFileAppend = JSON::Value(getOption("logging", "appendFile"), true);
                 runtimeDumpMetricsOnExit = JSON::Value(getOption("logging", "dumpRuntimeMetricsOnExit"), true);
                 runtimeDumpMetricsCsvFormat = JSON::Value(getOption("logging", "dumpRuntimeMetricsCsvFormat"), true);
@@ -495,6 +559,9 @@ namespace Gek
                 visualizer = nullptr;
                 resources = nullptr;
                 population = nullptr;
+                fileReader = nullptr;
+                threadPool = nullptr;
+                parallelismControl = nullptr;
                 renderDevice = nullptr;
                 window = nullptr;
 
@@ -674,6 +741,19 @@ namespace Gek
                     renderDevice->setDisplayMode(Render::DisplayMode(fallbackWidth, fallbackHeight, deviceDescription.displayFormat));
                 }
 
+                // One thread budget split between the job pool and the parallel loops that still run on TBB, the calling
+                // thread takes part in those loops so it counts towards TBB's share and is left out of the pool
+                const uint32_t hardwareThreadCount = std::max(std::thread::hardware_concurrency(), 2U);
+                const uint32_t parallelThreadCount = std::clamp(Plugin::Core::getOption("core", "parallelThreadCount", (hardwareThreadCount / 4)), 1U, (hardwareThreadCount - 1));
+                const uint32_t workerThreadCount = Plugin::Core::getOption("core", "workerThreadCount", std::max((hardwareThreadCount - parallelThreadCount), 1U));
+                threadPool = std::make_unique<ThreadPool>(workerThreadCount);
+                parallelismControl = std::make_unique<tbb::global_control>(tbb::global_control::max_allowed_parallelism, parallelThreadCount);
+                getContext()->log(Context::Info, "Job system started with {} worker threads, {} threads for parallel loops", threadPool->getThreadCount(), parallelThreadCount);
+
+                fileReader = std::make_unique<FileReader>(*threadPool, Plugin::Core::getOption("core", "fileReadQueueDepth", 256U));
+                getContext()->log(Context::Info, "File reads {}", (fileReader->isAsynchronous() ? "submitted through io_uring" : "handled by reader threads"));
+                getContext()->log(Context::Info, "Culling kernels using {}", Math::SIMD::GetInstructionSetName(Math::SIMD::GetSupportedInstructionSet()));
+
                 population = getContext()->createClass<Engine::Population>("Engine::Population", (Engine::Core *)this);
                 population->onLoad.connect(this, &Core::onPopulationLoaded);
 
@@ -727,6 +807,7 @@ namespace Gek
 
             void onWindowIdle(void)
             {
+                GEK_PROFILE_ZONE("Core::onWindowIdle");
                 static uint64_t idleTraceCounter = 0;
                 ++idleTraceCounter;
                 if (idleTraceCounter <= 8 || (idleTraceCounter % 600) == 0)
@@ -767,14 +848,22 @@ namespace Gek
                             runtimeFpsSmoothed += ((fpsInstant - runtimeFpsSmoothed) * FpsSmoothingAlpha);
                         }
 
-                        getContext()->setRuntimeMetric("render.frameTimeMs", frameTimeMs);
-                        getContext()->setRuntimeMetric("render.fpsInstant", fpsInstant);
-                        getContext()->setRuntimeMetric("render.fpsSmoothed", runtimeFpsSmoothed);
+                        auto &metrics = getContext()->getRuntimeMetrics();
+                        metrics.record(metricHandles.frameTime, frameTimeMs);
+                        metrics.set(metricHandles.fpsInstant, fpsInstant);
+                        metrics.set(metricHandles.fpsSmoothed, runtimeFpsSmoothed);
                     }
 
+                    updateJobMetrics();
+
                     modeChangeTimer -= frameTime;
 
-                    const float updateFrameTime = (enableInterfaceControl || loadingPopulation) ? 0.0f : frameTime;
+                    float updateFrameTime = (enableInterfaceControl || loadingPopulation) ? 0.0f : frameTime;
+                    if (benchmark.isEnabled())
+                    {
+                        updateFrameTime = (loadingPopulation ? 0.0f : benchmark.timeStep);
+                    }
+
                     if (population)
                     {
                         if (idleTraceCounter <= 8 || (idleTraceCounter % 600) == 0)
@@ -783,7 +872,9 @@ namespace Gek
                             std::fflush(stderr);
                         }
 
+                        auto updateStartTime = std::chrono::steady_clock::now();
                         population->update(updateFrameTime);
+                        getContext()->getRuntimeMetrics().record(metricHandles.update, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - updateStartTime).count());
 
                         if (idleTraceCounter <= 8 || (idleTraceCounter % 600) == 0)
                         {
@@ -814,6 +905,11 @@ namespace Gek
                             population->action(Plugin::Population::Action("tilt", yMovement * mouseSensitivity));
                         }
                     }
+
+                    if (benchmark.isEnabled() && !loadingPopulation && !pendingPopulationLoad)
+                    {
+                        updateBenchmark();
+                    }
                 }
 
                 if (idleTraceCounter <= 8 || (idleTraceCounter % 600) == 0)
@@ -1079,6 +1175,33 @@ namespace Gek
                 showLoading();
             }
 
+            // Histograms are cumulative, the window is the difference from the snapshot taken a second earlier
+            void updateRuntimeHistogramWindow(void)
+            {
+                auto currentTime = std::chrono::steady_clock::now();
+                if ((currentTime - runtimeHistogramTime) < std::chrono::seconds(1))
+                {
+                    return;
+                }
+
+                runtimeHistogramTime = currentTime;
+                auto histogramMap = getContext()->getRuntimeMetrics().getHistogramSnapshot();
+                runtimeHistogramWindow.clear();
+                for (auto const &[name, histogram] : histogramMap)
+                {
+                    auto baselineSearch = runtimeHistogramBaseline.find(name);
+                    auto window = (baselineSearch == std::end(runtimeHistogramBaseline) ? histogram : (histogram - baselineSearch->second));
+                    if (window.count > 0)
+                    {
+                        runtimeHistogramWindow.emplace_back(name, window);
+                    }
+                }
+
+                std::sort(std::begin(runtimeHistogramWindow), std::end(runtimeHistogramWindow), [](auto const &left, auto const &right) -> bool
+                          { return (left.first < right.first); });
+                runtimeHistogramBaseline = std::move(histogramMap);
+            }
+
             void showRuntimeDiagnosticsWindow(std::unordered_map<std::string, double> const &runtimeMetrics)
             {
                 if (!showRuntimeDiagnostics)
@@ -1225,6 +1348,40 @@ namespace Gek
                         ImGui::Text("D3D11 present: %.3f ms", readMetricValue("d3d11.presentCpuMs"));
                     }
 
+                    if (ImGui::CollapsingHeader("Timing Percentiles (last second)", ImGuiTreeNodeFlags_DefaultOpen))
+                    {
+                        updateRuntimeHistogramWindow();
+                        for (auto const &[name, histogram] : runtimeHistogramWindow)
+                        {
+                            ImGui::Text("%-28s n %-6llu mean %7.3f | p50 %7.3f | p95 %7.3f | p99 %7.3f ms",
+                                        name.data(),
+                                        static_cast<unsigned long long>(histogram.count),
+                                        histogram.getMean(),
+                                        histogram.getPercentile(0.5),
+                                        histogram.getPercentile(0.95),
+                                        histogram.getPercentile(0.99));
+                        }
+                    }
+
+#ifdef GEK_ENABLE_PROFILER
+                    if (ImGui::CollapsingHeader("CPU Trace"))
+                    {
+                        ImGui::InputText("Trace File", traceFilePath.data(), traceFilePath.size());
+                        if (!Profiler::IsCapturing())
+                        {
+                            if (ImGui::Button("Start Capture") && traceFilePath[0] != '\0')
+                            {
+                                Profiler::StartCapture();
+                            }
+                        }
+                        else if (ImGui::Button("Stop and Save"))
+                        {
+                            auto zoneCount = Profiler::StopCapture(FileSystem::Path(traceFilePath.data()));
+                            getContext()->log(Context::Info, "Trace of {} zones written to {}", zoneCount, traceFilePath.data());
+                        }
+                    }
+
+#endif
                     if (ImGui::CollapsingHeader("Metric Visibility", ImGuiTreeNodeFlags_DefaultOpen))
                     {
                         ImGui::BeginChild("##RuntimeMetricList", ImVec2(0.0f, 190.0f), true, ImGuiWindowFlags_AlwaysVerticalScrollbar);
@@ -1562,15 +1719,6 @@ namespace Gek
                         ImGui::EndChild();
                     }
 
-                    auto fallbackEntitySearch = runtimeMetrics.find("model.entityCullingFallback");
-                    auto fallbackModelSearch = runtimeMetrics.find("model.modelCullingFallback");
-                    if ((fallbackEntitySearch != std::end(runtimeMetrics) && fallbackEntitySearch->second > 0.0) ||
-                        (fallbackModelSearch != std::end(runtimeMetrics) && fallbackModelSearch->second > 0.0))
-                    {
-                        ImGui::Separator();
-                        ImGui::TextUnformatted("Model culling fallback triggered this frame.");
-                    }
-
                     ImGui::Separator();
                     if (ImGui::Button("Dump visible metrics to log"))
                     {
@@ -1634,6 +1782,14 @@ namespace Gek
                     }
                 }
 
+                static const char *LogLevelNameList[] = { "Error", "Warning", "Debug", "Info" };
+                int logLevel = static_cast<int>(getContext()->getLogLevel());
+                if (ImGui::Combo("Log Level", &logLevel, LogLevelNameList, static_cast<int>(std::size(LogLevelNameList))))
+                {
+                    getContext()->setLogLevel(static_cast<Context::LogLevel>(logLevel));
+                    setOption("logging"s, "level"s, static_cast<uint32_t>(logLevel));
+                }
+
                 if (ImGui::Checkbox("Append File", &runtimeLogFileAppend))
                 {
                     setOption("logging"s, "appendFile"s, runtimeLogFileAppend);
@@ -2133,8 +2289,102 @@ namespace Gek
                 pendingPopulationLoad = true;
             }
 
+            void updateBenchmark(void)
+            {
+                if (++benchmarkFrame <= benchmark.warmupFrameCount)
+                {
+#ifdef GEK_ENABLE_PROFILER
+                    if (benchmarkFrame == benchmark.warmupFrameCount && !benchmark.tracePath.empty())
+                    {
+                        Profiler::StartCapture();
+                    }
+#endif
+                    return;
+                }
+
+                for (auto const &[name, value] : getContext()->getRuntimeMetricSnapshot())
+                {
+                    benchmarkSampleMap[name].push_back(value);
+                }
+
+                if (benchmarkFrame == (benchmark.warmupFrameCount + benchmark.frameCount))
+                {
+#ifdef GEK_ENABLE_PROFILER
+                    if (Profiler::IsCapturing())
+                    {
+                        auto zoneCount = Profiler::StopCapture(benchmark.tracePath);
+                        getContext()->log(Context::Info, "Trace of {} zones written to {}", zoneCount, benchmark.tracePath);
+                    }
+#endif
+                    saveBenchmark();
+                    forceClose();
+                }
+            }
+
+            void saveBenchmark(void)
+            {
+                static constexpr std::array<double, 3> PercentileList = { 0.5, 0.95, 0.99 };
+
+                const bool saveAsCSV = (String::GetLower(benchmark.outputPath.getExtension()) == ".csv");
+                std::string csvOutput("metric,count,mean,minimum,maximum,p50,p95,p99\n");
+                JSON::Object metricsNode = JSON::Object::object();
+                for (auto &[name, sampleList] : benchmarkSampleMap)
+                {
+                    std::sort(std::begin(sampleList), std::end(sampleList));
+                    const double mean = (std::accumulate(std::begin(sampleList), std::end(sampleList), 0.0) / double(sampleList.size()));
+                    std::array<double, PercentileList.size()> percentileValueList;
+                    for (size_t index = 0; index < PercentileList.size(); ++index)
+                    {
+                        auto rank = static_cast<size_t>(std::ceil(PercentileList[index] * double(sampleList.size())));
+                        percentileValueList[index] = sampleList[std::clamp(rank, size_t(1), sampleList.size()) - 1];
+                    }
+
+                    if (saveAsCSV)
+                    {
+                        csvOutput += std::format("{},{},{},{},{},{},{},{}\n", name, sampleList.size(), mean, sampleList.front(), sampleList.back(),
+                                                 percentileValueList[0], percentileValueList[1], percentileValueList[2]);
+                    }
+                    else
+                    {
+                        metricsNode[name] = {
+                            { "count", sampleList.size() },
+                            { "mean", mean },
+                            { "minimum", sampleList.front() },
+                            { "maximum", sampleList.back() },
+                            { "p50", percentileValueList[0] },
+                            { "p95", percentileValueList[1] },
+                            { "p99", percentileValueList[2] },
+                        };
+                    }
+                }
+
+                if (saveAsCSV)
+                {
+                    FileSystem::Save(benchmark.outputPath, csvOutput);
+                }
+                else
+                {
+                    JSON::Object rootNode = JSON::Object::object();
+                    rootNode["scene"] = benchmark.scene;
+                    rootNode["device"] = renderDeviceName;
+                    rootNode["frames"] = benchmark.frameCount;
+                    rootNode["timeStep"] = benchmark.timeStep;
+                    rootNode["metrics"] = metricsNode;
+                    JSON::Save(rootNode, benchmark.outputPath);
+                }
+
+                getContext()->log(Context::Info, "Benchmark of '{}' written to {}", benchmark.scene, benchmark.outputPath.getString());
+            }
+
             void queueStartupSceneLoad(void)
             {
+                if (benchmark.isEnabled())
+                {
+                    queuePopulationLoad(benchmark.scene);
+                    getContext()->log(Context::Info, "Benchmarking scene '{}' for {} frames after {} warmup frames", benchmark.scene, benchmark.frameCount, benchmark.warmupFrameCount);
+                    return;
+                }
+
                 const bool autoLoadScene = JSON::Value(getOption("application", "autoLoadDemoScene"), false);
                 if (!autoLoadScene || pendingPopulationLoad || loadingPopulation)
                 {
@@ -2390,6 +2640,16 @@ namespace Gek
                 return visualizer.get();
             }
 
+            ThreadPool *getThreadPool(void) const
+            {
+                return threadPool.get();
+            }
+
+            FileReader *getFileReader(void) const
+            {
+                return fileReader.get();
+            }
+
             void listProcessors(std::function<void(Plugin::Processor *)> onProcessor)
             {
                 for (auto const &processor : processorList)
@@ -315,6 +315,7 @@ namespace Gek
                                             break;
                                         };
 
+                                        ++transformComponent.version;
                                         modify(selectedEntity, Components::Transform::GetIdentifier());
                                     }
                                 }
@@ -626,7 +627,7 @@ namespace Gek
                                     for (auto &componentSearch : entityComponents)
                                     {
                                         Edit::Component *component = population->getComponent(componentSearch.first);
-                                        Plugin::Component::Data *componentDefintion = componentSearch.second.get();
+                                        Plugin::Component::Data *componentDefintion = componentSearch.second;
                                         if (component && componentDefintion)
                                         {
                                             ImGui::PushID(component->getIdentifier());
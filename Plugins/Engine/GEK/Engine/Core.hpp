@@ -11,6 +11,7 @@
 #include "API/System/RenderDevice.hpp"
 #include "API/System/WindowDevice.hpp"
 #include "GEK/Utility/Context.hpp"
+#include "GEK/Utility/FileSystem.hpp"
 #include "GEK/Utility/JSON.hpp"
 #include <imgui.h>
 #include <wink/signal.hpp>
@@ -25,6 +26,25 @@ namespace Gek
         GEK_INTERFACE(Core)
             : public Plugin::Core
         {
+            // Loads a scene, runs it at a fixed time step without input, writes the runtime metrics and closes
+            struct Benchmark
+            {
+                std::string scene;
+                std::string device;
+                uint32_t warmupFrameCount = 120;
+                uint32_t frameCount = 0;
+                float timeStep = (1.0f / 60.0f);
+                FileSystem::Path outputPath = "benchmark.json";
+
+                // Zones from the measured frames are written here when set
+                std::string tracePath;
+
+                bool isEnabled(void) const
+                {
+                    return (frameCount > 0);
+                }
+            };
+
             wink::signal<wink::slot<void(void)>> onChangedDisplay;
             wink::signal<wink::slot<void(void)>> onChangedSettings;
 
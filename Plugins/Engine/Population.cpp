@@ -7,11 +7,19 @@
 #include "GEK/Utility/ContextUser.hpp"
 #include "GEK/Utility/FileSystem.hpp"
 #include "GEK/Utility/JSON.hpp"
+#include "GEK/Utility/Profiler.hpp"
 #include "GEK/Utility/String.hpp"
 #include "GEK/Utility/ThreadPool.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <execution>
 #include <map>
+#include <new>
 #include <tbb/concurrent_queue.h>
+#include <tbb/parallel_for.h>
 #include <tbb/parallel_for_each.h>
 #include <unordered_map>
 #include <vector>
@@ -20,73 +28,610 @@ namespace Gek
 {
     namespace Implementation
     {
-        class Entity
-            : public Edit::Entity
+        class Entity;
+        class ArchetypeRegistry;
+
+        using ComponentDataList = std::vector<std::pair<Plugin::Component *, std::unique_ptr<Plugin::Component::Data>>>;
+
+        // Set while an entity worker is loading a batch so that component expressions use the batch shunting yard
+        thread_local ShuntingYard *LoadingShuntingYard = nullptr;
+
+        // Stores the component data for every entity that shares the same set of component types.  Data is packed
+        // into cache line aligned chunks, with one contiguous column per component type and one for the owning entity.
+        class Archetype
         {
+          public:
+            static constexpr size_t ChunkSize = (16 * 1024);
+            static constexpr size_t CacheLineSize = 64;
+
+            struct Column
+            {
+                Plugin::Component *component = nullptr;
+                Hash type = 0;
+                size_t size = 0;
+                size_t offset = 0;
+            };
+
+            struct Location
+            {
+                uint32_t chunk = 0;
+                uint32_t row = 0;
+            };
+
+          private:
+            struct ChunkDeleter
+            {
+                void operator()(uint8_t *memory) const
+                {
+                    ::operator delete[](memory, std::align_val_t(CacheLineSize));
+                }
+            };
+
+            struct Chunk
+            {
+                std::unique_ptr<uint8_t[], ChunkDeleter> memory;
+                uint32_t count = 0;
+            };
+
+            static size_t AlignSize(size_t size, size_t alignment)
+            {
+                return (((size + alignment - 1) / alignment) * alignment);
+            }
+
           private:
-            Components components;
+            std::vector<Hash> typeList;
+            std::vector<Column> columnList;
+            std::vector<Chunk> chunkList;
+            size_t chunkSize = 0;
+            uint32_t capacity = 0;
+            std::atomic_uint64_t storageVersion = 0;
+
+          public:
+            std::unordered_map<Hash, Archetype *> addEdgeMap;
+            std::unordered_map<Hash, Archetype *> removeEdgeMap;
 
           public:
-            void addComponent(Plugin::Component *component, std::unique_ptr<Plugin::Component::Data> &&data)
+            Archetype(std::vector<Plugin::Component *> const &componentList)
+            {
+                size_t rowSize = sizeof(Plugin::Entity *);
+                size_t paddingSize = CacheLineSize;
+                for (auto component : componentList)
+                {
+                    Column column;
+                    column.component = component;
+                    column.type = component->getIdentifier();
+                    column.size = component->getDataSize();
+                    typeList.push_back(column.type);
+                    columnList.push_back(column);
+
+                    rowSize += column.size;
+                    paddingSize += std::max(CacheLineSize, component->getDataAlignment());
+                }
+
+                capacity = static_cast<uint32_t>(std::max<size_t>(1, (ChunkSize > paddingSize ? ((ChunkSize - paddingSize) / rowSize) : 0)));
+
+                size_t offset = (sizeof(Plugin::Entity *) * capacity);
+                for (size_t columnIndex = 0; columnIndex < columnList.size(); ++columnIndex)
+                {
+                    auto &column = columnList[columnIndex];
+                    offset = AlignSize(offset, std::max(CacheLineSize, componentList[columnIndex]->getDataAlignment()));
+                    column.offset = offset;
+                    offset += (column.size * capacity);
+                }
+
+                chunkSize = AlignSize(offset, CacheLineSize);
+            }
+
+            ~Archetype(void)
+            {
+                for (uint32_t chunkIndex = 0; chunkIndex < chunkList.size(); ++chunkIndex)
+                {
+                    for (uint32_t row = 0; row < chunkList[chunkIndex].count; ++row)
+                    {
+                        for (size_t columnIndex = 0; columnIndex < columnList.size(); ++columnIndex)
+                        {
+                            getData(columnIndex, { chunkIndex, row })->~Data();
+                        }
+                    }
+                }
+            }
+
+            std::vector<Hash> const &getTypeList(void) const
+            {
+                return typeList;
+            }
+
+            size_t getColumnCount(void) const
+            {
+                return columnList.size();
+            }
+
+            Column const &getColumn(size_t columnIndex) const
+            {
+                return columnList[columnIndex];
+            }
+
+            int32_t getColumnIndex(Hash type) const
+            {
+                for (size_t columnIndex = 0; columnIndex < typeList.size(); ++columnIndex)
+                {
+                    if (typeList[columnIndex] == type)
+                    {
+                        return static_cast<int32_t>(columnIndex);
+                    }
+                }
+
+                return -1;
+            }
+
+            bool hasTypes(std::vector<Hash> const &sortedTypeList) const
+            {
+                return std::includes(std::begin(typeList), std::end(typeList), std::begin(sortedTypeList), std::end(sortedTypeList));
+            }
+
+            uint8_t *getAddress(size_t columnIndex, Location location) const
+            {
+                auto const &column = columnList[columnIndex];
+                return (chunkList[location.chunk].memory.get() + column.offset + (column.size * location.row));
+            }
+
+            Plugin::Component::Data *getData(size_t columnIndex, Location location) const
+            {
+                return reinterpret_cast<Plugin::Component::Data *>(getAddress(columnIndex, location));
+            }
+
+            size_t getChunkCount(void) const
+            {
+                return chunkList.size();
+            }
+
+            // Drawn from the registry wide counter so that no two archetypes ever share a version
+            uint64_t getStorageVersion(void) const
+            {
+                return storageVersion.load(std::memory_order_acquire);
+            }
+
+            void setStorageVersion(uint64_t version)
+            {
+                storageVersion.store(version, std::memory_order_release);
+            }
+
+            uint32_t getChunkEntityCount(size_t chunkIndex) const
+            {
+                return chunkList[chunkIndex].count;
+            }
+
+            Plugin::Entity *const *getChunkEntityList(size_t chunkIndex) const
             {
-                components[component->getIdentifier()] = std::move(data);
+                return reinterpret_cast<Plugin::Entity *const *>(chunkList[chunkIndex].memory.get());
             }
 
-            void removeComponent(Hash type)
+            void *getChunkColumn(size_t chunkIndex, size_t columnIndex) const
             {
-                auto componentSearch = components.find(type);
-                if (componentSearch != std::end(components))
+                return (chunkList[chunkIndex].memory.get() + columnList[columnIndex].offset);
+            }
+
+            // Reserves a row for the entity, the component columns are left uninitialized for the caller to fill
+            Location allocate(Plugin::Entity *entity)
+            {
+                if (chunkList.empty() || chunkList.back().count == capacity)
                 {
-                    components.erase(componentSearch);
+                    auto &chunk = chunkList.emplace_back();
+                    chunk.memory.reset(static_cast<uint8_t *>(::operator new[](chunkSize, std::align_val_t(CacheLineSize))));
                 }
+
+                Location location;
+                location.chunk = static_cast<uint32_t>(chunkList.size() - 1);
+                location.row = chunkList.back().count++;
+                reinterpret_cast<Plugin::Entity **>(chunkList.back().memory.get())[location.row] = entity;
+                return location;
+            }
+
+            // Fills the released row with the last entity in the archetype so that every chunk but the last stays full
+            void release(Location location, bool destroyData);
+        };
+
+        class Entity
+            : public Edit::Entity
+        {
+          private:
+            ArchetypeRegistry *archetypeRegistry = nullptr;
+            Archetype *archetype = nullptr;
+            Archetype::Location location;
+
+            void moveToArchetype(Archetype *targetArchetype, Plugin::Component *addedComponent = nullptr, Plugin::Component::Data *addedData = nullptr);
+
+          public:
+            Entity(ArchetypeRegistry *archetypeRegistry)
+                : archetypeRegistry(archetypeRegistry)
+            {
             }
 
+            ~Entity(void);
+
+            void setLocation(Archetype::Location newLocation)
+            {
+                location = newLocation;
+            }
+
+            void addComponent(Plugin::Component *component, std::unique_ptr<Plugin::Component::Data> &&data);
+            void addComponentList(ComponentDataList &&componentDataList);
+            void removeComponent(Hash type);
+
             void listComponents(std::function<void(Hash, Plugin::Component::Data const *)> onComponent)
             {
-                for (auto const &component : components)
+                if (archetype)
                 {
-                    onComponent(component.first, component.second.get());
+                    for (size_t columnIndex = 0; columnIndex < archetype->getColumnCount(); ++columnIndex)
+                    {
+                        onComponent(archetype->getColumn(columnIndex).type, archetype->getData(columnIndex, location));
+                    }
                 }
             }
 
             // Edit::Entity
-            Components &getComponents(void)
+            Components getComponents(void)
             {
+                Components components;
+                if (archetype)
+                {
+                    components.reserve(archetype->getColumnCount());
+                    for (size_t columnIndex = 0; columnIndex < archetype->getColumnCount(); ++columnIndex)
+                    {
+                        components.emplace_back(archetype->getColumn(columnIndex).type, archetype->getData(columnIndex, location));
+                    }
+                }
+
                 return components;
             }
 
             // Plugin::Entity
             bool hasComponent(Hash type) const
             {
-                return (components.count(type) > 0);
+                return (archetype && archetype->getColumnIndex(type) >= 0);
+            }
+
+            uint64_t getStorageVersion(void) const
+            {
+                return (archetype ? archetype->getStorageVersion() : 0);
             }
 
             Plugin::Component::Data *getComponent(Hash type)
             {
-                auto componentSearch = components.find(type);
-                if (componentSearch == std::end(components))
+                auto columnIndex = (archetype ? archetype->getColumnIndex(type) : -1);
+                return (columnIndex >= 0 ? archetype->getData(columnIndex, location) : nullptr);
+            }
+
+            const Plugin::Component::Data *getComponent(Hash type) const
+            {
+                auto columnIndex = (archetype ? archetype->getColumnIndex(type) : -1);
+                return (columnIndex >= 0 ? archetype->getData(columnIndex, location) : nullptr);
+            }
+        };
+
+        void Archetype::release(Location location, bool destroyData)
+        {
+            if (destroyData)
+            {
+                for (size_t columnIndex = 0; columnIndex < columnList.size(); ++columnIndex)
                 {
-                    return nullptr;
+                    getData(columnIndex, location)->~Data();
+                }
+            }
+
+            Location lastLocation;
+            lastLocation.chunk = static_cast<uint32_t>(chunkList.size() - 1);
+            lastLocation.row = (chunkList.back().count - 1);
+            if (lastLocation.chunk != location.chunk || lastLocation.row != location.row)
+            {
+                for (size_t columnIndex = 0; columnIndex < columnList.size(); ++columnIndex)
+                {
+                    auto lastData = getData(columnIndex, lastLocation);
+                    columnList[columnIndex].component->moveData(getAddress(columnIndex, location), lastData);
+                    lastData->~Data();
                 }
 
-                return componentSearch->second.get();
+                auto entityList = reinterpret_cast<Plugin::Entity **>(chunkList[location.chunk].memory.get());
+                auto lastEntity = getChunkEntityList(lastLocation.chunk)[lastLocation.row];
+                entityList[location.row] = lastEntity;
+                static_cast<Entity *>(lastEntity)->setLocation(location);
             }
 
-            const Plugin::Component::Data *getComponent(Hash type) const
+            if (--chunkList.back().count == 0)
             {
-                auto componentSearch = components.find(type);
-                if (componentSearch == std::end(components))
+                chunkList.pop_back();
+            }
+        }
+
+        class ArchetypeRegistry
+        {
+          private:
+            std::map<std::vector<Hash>, std::unique_ptr<Archetype>> archetypeMap;
+            std::atomic_uint64_t storageVersion = 0;
+
+          public:
+            uint64_t getStorageVersion(void) const
+            {
+                return storageVersion.load(std::memory_order_acquire);
+            }
+
+            void invalidateStorage(void)
+            {
+                storageVersion.fetch_add(1, std::memory_order_acq_rel);
+            }
+
+            // Rows of the archetype have moved, only pointers into that archetype need to be resolved again
+            void invalidateStorage(Archetype *archetype)
+            {
+                archetype->setStorageVersion(storageVersion.fetch_add(1, std::memory_order_acq_rel) + 1);
+            }
+
+            void clear(void)
+            {
+                archetypeMap.clear();
+            }
+
+            Archetype *getArchetype(std::vector<Plugin::Component *> componentList)
+            {
+                if (componentList.empty())
                 {
                     return nullptr;
                 }
 
-                return componentSearch->second.get();
+                std::sort(std::begin(componentList), std::end(componentList), [](auto left, auto right) -> bool
+                          { return (left->getIdentifier() < right->getIdentifier()); });
+
+                std::vector<Hash> typeList;
+                typeList.reserve(componentList.size());
+                for (auto component : componentList)
+                {
+                    typeList.push_back(component->getIdentifier());
+                }
+
+                auto &archetype = archetypeMap[typeList];
+                if (!archetype)
+                {
+                    archetype = std::make_unique<Archetype>(componentList);
+                    invalidateStorage(archetype.get());
+                }
+
+                return archetype.get();
+            }
+
+            Archetype *getAddArchetype(Archetype *archetype, Plugin::Component *component)
+            {
+                if (!archetype)
+                {
+                    return getArchetype({ component });
+                }
+
+                auto &edge = archetype->addEdgeMap[component->getIdentifier()];
+                if (!edge)
+                {
+                    std::vector<Plugin::Component *> componentList({ component });
+                    for (size_t columnIndex = 0; columnIndex < archetype->getColumnCount(); ++columnIndex)
+                    {
+                        componentList.push_back(archetype->getColumn(columnIndex).component);
+                    }
+
+                    edge = getArchetype(componentList);
+                }
+
+                return edge;
+            }
+
+            Archetype *getRemoveArchetype(Archetype *archetype, Hash type)
+            {
+                auto edgeSearch = archetype->removeEdgeMap.find(type);
+                if (edgeSearch != std::end(archetype->removeEdgeMap))
+                {
+                    return edgeSearch->second;
+                }
+
+                std::vector<Plugin::Component *> componentList;
+                for (size_t columnIndex = 0; columnIndex < archetype->getColumnCount(); ++columnIndex)
+                {
+                    auto const &column = archetype->getColumn(columnIndex);
+                    if (column.type != type)
+                    {
+                        componentList.push_back(column.component);
+                    }
+                }
+
+                auto edge = getArchetype(componentList);
+                archetype->removeEdgeMap[type] = edge;
+                return edge;
+            }
+
+            void listChunks(std::vector<Hash> const &typeList, std::function<void(Archetype const *archetype, size_t chunkIndex, std::vector<int32_t> const &columnIndexList)> onChunk) const
+            {
+                std::vector<Hash> sortedTypeList(typeList);
+                std::sort(std::begin(sortedTypeList), std::end(sortedTypeList));
+                for (auto const &archetypeSearch : archetypeMap)
+                {
+                    auto const archetype = archetypeSearch.second.get();
+                    if (archetype->getChunkCount() > 0 && archetype->hasTypes(sortedTypeList))
+                    {
+                        std::vector<int32_t> columnIndexList;
+                        columnIndexList.reserve(typeList.size());
+                        for (auto type : typeList)
+                        {
+                            columnIndexList.push_back(archetype->getColumnIndex(type));
+                        }
+
+                        for (size_t chunkIndex = 0; chunkIndex < archetype->getChunkCount(); ++chunkIndex)
+                        {
+                            onChunk(archetype, chunkIndex, columnIndexList);
+                        }
+                    }
+                }
             }
         };
 
+        Entity::~Entity(void)
+        {
+            if (archetype)
+            {
+                archetype->release(location, true);
+                archetypeRegistry->invalidateStorage(archetype);
+            }
+        }
+
+        void Entity::moveToArchetype(Archetype *targetArchetype, Plugin::Component *addedComponent, Plugin::Component::Data *addedData)
+        {
+            Archetype::Location targetLocation;
+            if (targetArchetype)
+            {
+                targetLocation = targetArchetype->allocate(this);
+            }
+
+            if (archetype)
+            {
+                for (size_t columnIndex = 0; columnIndex < archetype->getColumnCount(); ++columnIndex)
+                {
+                    auto const &column = archetype->getColumn(columnIndex);
+                    auto sourceData = archetype->getData(columnIndex, location);
+                    auto targetColumnIndex = (targetArchetype ? targetArchetype->getColumnIndex(column.type) : -1);
+                    if (targetColumnIndex >= 0)
+                    {
+                        column.component->moveData(targetArchetype->getAddress(targetColumnIndex, targetLocation), sourceData);
+                    }
+
+                    sourceData->~Data();
+                }
+
+                archetype->release(location, false);
+                archetypeRegistry->invalidateStorage(archetype);
+            }
+
+            if (addedComponent)
+            {
+                auto targetColumnIndex = targetArchetype->getColumnIndex(addedComponent->getIdentifier());
+                addedComponent->moveData(targetArchetype->getAddress(targetColumnIndex, targetLocation), addedData);
+            }
+
+            archetype = targetArchetype;
+            location = targetLocation;
+        }
+
+        void Entity::addComponent(Plugin::Component *component, std::unique_ptr<Plugin::Component::Data> &&data)
+        {
+            auto columnIndex = (archetype ? archetype->getColumnIndex(component->getIdentifier()) : -1);
+            if (columnIndex >= 0)
+            {
+                auto existingData = archetype->getData(columnIndex, location);
+                existingData->~Data();
+                component->moveData(existingData, data.get());
+            }
+            else
+            {
+                moveToArchetype(archetypeRegistry->getAddArchetype(archetype, component), component, data.get());
+            }
+        }
+
+        void Entity::addComponentList(ComponentDataList &&componentDataList)
+        {
+            if (archetype)
+            {
+                for (auto &[component, data] : componentDataList)
+                {
+                    addComponent(component, std::move(data));
+                }
+
+                return;
+            }
+
+            // A new entity goes straight to its final archetype instead of moving through one per component
+            std::vector<Plugin::Component *> componentList;
+            componentList.reserve(componentDataList.size());
+            for (auto const &componentData : componentDataList)
+            {
+                componentList.push_back(componentData.first);
+            }
+
+            archetype = archetypeRegistry->getArchetype(componentList);
+            if (archetype)
+            {
+                location = archetype->allocate(this);
+                for (auto &[component, data] : componentDataList)
+                {
+                    component->moveData(archetype->getAddress(archetype->getColumnIndex(component->getIdentifier()), location), data.get());
+                }
+
+                archetypeRegistry->invalidateStorage();
+            }
+        }
+
+        void Entity::removeComponent(Hash type)
+        {
+            if (hasComponent(type))
+            {
+                moveToArchetype(archetypeRegistry->getRemoveArchetype(archetype, type));
+            }
+        }
+
         GEK_CONTEXT_USER(Population, Engine::Core *)
         , public Engine::Population
         {
+          private:
+            static constexpr size_t LoadBatchSize = 256;
+            static constexpr uint16_t CurrentSceneVersion = 2;
+
+            struct LoadState
+            {
+                std::vector<EntityDefinition> definitionList;
+                std::vector<uint32_t> definitionIndexList;
+                std::vector<ComponentDataList> stagedEntityList;
+                std::atomic_size_t stagedEntityCount = 0;
+                uint32_t seed = 0;
+            };
+
+            // Cooked scenes are a header followed by one block per component type, each block holding the
+            // entity index of every row followed by the cooked data for those rows, padded to 8 bytes
+            struct SceneHeader
+            {
+                uint32_t identifier = *(uint32_t *)"GEKS";
+                uint16_t type = 0;
+                uint16_t version = CurrentSceneVersion;
+                uint32_t seed = 0;
+                uint32_t entityCount = 0;
+                uint32_t blockCount = 0;
+                uint32_t reserved = 0;
+            };
+
+            struct BlockHeader
+            {
+                char component[64] = "";
+                uint32_t rowCount = 0;
+                uint32_t reserved = 0;
+                uint64_t dataSize = 0;
+                uint64_t layout = 0;
+            };
+
+            struct CookedBlock
+            {
+                Plugin::Component *component = nullptr;
+                uint32_t rowCount = 0;
+                uint32_t const *entityIndexList = nullptr;
+                uint8_t const *data = nullptr;
+                uint8_t const *dataEnd = nullptr;
+                std::vector<std::unique_ptr<Plugin::Component::Data>> dataList;
+                bool valid = false;
+            };
+
+            // One node per update stage, plus one per onUpdate level which acts as a barrier for everything else.
+            // Levels are looked up by order when they run, onUpdate is public and may change between frames.
+            struct StageNode
+            {
+                UpdateStage const *stage = nullptr;
+                int32_t order = 0;
+                Metrics::Handle metric = Metrics::InvalidHandle;
+                char const *profileName = nullptr;
+                std::vector<uint32_t> successorList;
+                uint32_t dependencyCount = 0;
+                std::atomic_uint32_t pendingCount = 0;
+            };
+
           private:
             Engine::Core *core = nullptr;
 
@@ -97,19 +642,47 @@ namespace Gek
             std::unordered_map<Hash, std::string> componentNameTypeMap;
             AvailableComponents availableComponents;
 
-            ThreadPool sceneWorkerPool;
-            ThreadPool entityWorkerPool;
+            ThreadPool *threadPool = nullptr;
+            TaskGroup loadTaskGroup;
+            ArchetypeRegistry archetypeRegistry;
             Registry registry;
 
             uint32_t uniqueEntityIdentifier = 0;
 
-            bool shuttingDown = false;
+            std::map<uint32_t, UpdateStage> updateStageMap;
+            uint32_t nextStageIdentifier = 0;
+            bool stageGraphChanged = true;
+            std::vector<int32_t> stageGraphLevelList;
+            std::vector<StageNode> stageNodeList;
+            tbb::concurrent_queue<uint32_t> callingThreadQueue;
+            std::atomic_uint32_t completedStageCount = 0;
+            std::atomic_uint32_t stageSignal = 0;
+            TaskGroup frameTaskGroup;
+            std::atomic_uint64_t frameIndex = 0;
+            std::array<Shapes::BoundingVolumeHierarchy, static_cast<size_t>(SpatialLayer::Count)> spatialIndexList;
+
+            std::atomic_bool shuttingDown = false;
+
+            struct MetricHandles
+            {
+                Metrics::Handle loadProgress;
+                Metrics::Handle loadCooked;
+                Metrics::Handle loadEntities;
+                Metrics::Handle loadTimeMs;
+            } metricHandles;
 
           public:
             Population(Context * context, Engine::Core * core)
-                : ContextRegistration(context), core(core), sceneWorkerPool(1), entityWorkerPool(5)
+                : ContextRegistration(context), core(core), threadPool(core->getThreadPool())
             {
                 assert(core);
+                assert(threadPool);
+
+                auto &metrics = getContext()->getRuntimeMetrics();
+                metricHandles.loadProgress = metrics.getHandle("population.loadProgress");
+                metricHandles.loadCooked = metrics.getHandle("population.loadCooked");
+                metricHandles.loadEntities = metrics.getHandle("population.loadEntities");
+                metricHandles.loadTimeMs = metrics.getHandle("population.loadTimeMs");
 
                 getContext()->log(Context::Info, "Loading component plugins");
                 getContext()->listTypes("ComponentType", [&](std::string_view className) -> void
@@ -137,8 +710,8 @@ namespace Gek
 
             ~Population(void)
             {
-                entityWorkerPool.drain();
-                sceneWorkerPool.drain();
+                registry.clear();
+                loadTaskGroup.join();
                 componentTypeNameMap.clear();
                 availableComponents.clear();
             }
@@ -147,8 +720,7 @@ namespace Gek
             void onShutdown(void)
             {
                 shuttingDown = true;
-                entityWorkerPool.drain(false);
-                sceneWorkerPool.drain(false);
+                threadPool->cancel(loadTaskGroup);
                 registry.clear();
             }
 
@@ -177,11 +749,161 @@ namespace Gek
             // Plugin::Population
             ShuntingYard &getShuntingYard(void)
             {
-                return shuntingYard;
+                return (LoadingShuntingYard ? *LoadingShuntingYard : shuntingYard);
+            }
+
+            static bool Intersects(std::vector<Hash> const &leftList, std::vector<Hash> const &rightList)
+            {
+                return std::any_of(std::begin(leftList), std::end(leftList), [&](Hash type) -> bool
+                {
+                    return (std::find(std::begin(rightList), std::end(rightList), type) != std::end(rightList));
+                });
+            }
+
+            static bool MustFollow(StageNode const &earlierNode, StageNode const &laterNode)
+            {
+                if (!earlierNode.stage || !laterNode.stage)
+                {
+                    return true;
+                }
+
+                auto const &earlier = *earlierNode.stage;
+                auto const &later = *laterNode.stage;
+                if (!later.writeList.empty() && (earlier.readsEverything || Intersects(later.writeList, earlier.readList) || Intersects(later.writeList, earlier.writeList)))
+                {
+                    return true;
+                }
+
+                return (!earlier.pipelined && !earlier.writeList.empty() && (later.readsEverything || Intersects(earlier.writeList, later.readList)));
+            }
+
+            void buildStageGraph(void)
+            {
+                struct StageEntry
+                {
+                    int32_t order;
+                    uint32_t sequence;
+                    UpdateStage const *stage;
+                };
+
+                std::vector<StageEntry> stageEntryList;
+                stageGraphLevelList.clear();
+                for (auto const &[order, signal] : onUpdate)
+                {
+                    stageEntryList.push_back({ order, 0, nullptr });
+                    stageGraphLevelList.push_back(order);
+                }
+
+                for (auto const &[stageIdentifier, stage] : updateStageMap)
+                {
+                    stageEntryList.push_back({ stage.order, (stageIdentifier + 1), &stage });
+                }
+
+                std::stable_sort(std::begin(stageEntryList), std::end(stageEntryList), [](StageEntry const &left, StageEntry const &right) -> bool
+                {
+                    return (left.order < right.order || (left.order == right.order && left.sequence < right.sequence));
+                });
+
+                stageNodeList = std::vector<StageNode>(stageEntryList.size());
+                for (uint32_t nodeIndex = 0; nodeIndex < stageNodeList.size(); ++nodeIndex)
+                {
+                    auto &node = stageNodeList[nodeIndex];
+                    node.stage = stageEntryList[nodeIndex].stage;
+                    node.order = stageEntryList[nodeIndex].order;
+                    node.metric = getContext()->getRuntimeMetrics().getHandle((node.stage ? std::format("update.{}Ms", node.stage->name) : std::format("update.level{}Ms", stageEntryList[nodeIndex].order)), Metrics::Type::Timing);
+                    node.profileName = GEK_PROFILE_INTERN((node.stage ? std::format("onUpdate.{}", node.stage->name) : std::format("onUpdate.level{}", stageEntryList[nodeIndex].order)));
+                    for (uint32_t earlierIndex = 0; earlierIndex < nodeIndex; ++earlierIndex)
+                    {
+                        if (MustFollow(stageNodeList[earlierIndex], node))
+                        {
+                            stageNodeList[earlierIndex].successorList.push_back(nodeIndex);
+                            ++node.dependencyCount;
+                        }
+                    }
+                }
+
+                stageGraphChanged = false;
+            }
+
+            // A stage dropped by a stopping pool is skipped but still completed, so the frame never waits on it
+            Task<> scheduleStage(uint32_t nodeIndex, float frameTime)
+            {
+                try
+                {
+                    co_await threadPool->schedule(frameTaskGroup, ThreadPool::Queue::Frame);
+                }
+                catch (TaskCancelled const &)
+                {
+                    completeStage(nodeIndex, frameTime);
+                    co_return;
+                }
+
+                runStage(nodeIndex, frameTime);
+            }
+
+            void launchStage(uint32_t nodeIndex, float frameTime)
+            {
+                auto const &node = stageNodeList[nodeIndex];
+                if (node.stage && !node.stage->callingThread)
+                {
+                    scheduleStage(nodeIndex, frameTime);
+                }
+                else
+                {
+                    callingThreadQueue.push(nodeIndex);
+                    stageSignal.fetch_add(1, std::memory_order_release);
+                    stageSignal.notify_all();
+                }
+            }
+
+            void runStage(uint32_t nodeIndex, float frameTime)
+            {
+                auto const &node = stageNodeList[nodeIndex];
+                auto startTime = std::chrono::steady_clock::now();
+                try
+                {
+                    GEK_PROFILE_ZONE(node.profileName);
+                    if (node.stage)
+                    {
+                        node.stage->onUpdate(frameTime);
+                    }
+                    else
+                    {
+                        auto signalSearch = onUpdate.find(node.order);
+                        if (signalSearch != std::end(onUpdate))
+                        {
+                            signalSearch->second(frameTime);
+                        }
+                    }
+                }
+                catch (std::exception const &exception)
+                {
+                    getContext()->log(Context::Error, "Update stage {} failed: {}", (node.stage ? node.stage->name : "onUpdate"s), exception.what());
+                }
+
+                getContext()->getRuntimeMetrics().record(node.metric, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+                completeStage(nodeIndex, frameTime);
+            }
+
+            void completeStage(uint32_t nodeIndex, float frameTime)
+            {
+                auto const &node = stageNodeList[nodeIndex];
+                for (auto successorIndex : node.successorList)
+                {
+                    if (stageNodeList[successorIndex].pendingCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    {
+                        launchStage(successorIndex, frameTime);
+                    }
+                }
+
+                completedStageCount.fetch_add(1, std::memory_order_release);
+                stageSignal.fetch_add(1, std::memory_order_release);
+                stageSignal.notify_all();
             }
 
             void update(float frameTime)
             {
+                GEK_PROFILE_ZONE("Population::update");
                 if (frameTime == 0.0f)
                 {
                     actionQueue.clear();
@@ -195,10 +917,72 @@ namespace Gek
                     };
                 }
 
-                for (auto &slot : onUpdate)
+                frameIndex.fetch_add(1, std::memory_order_release);
+                auto levelsChanged = !std::equal(std::begin(onUpdate), std::end(onUpdate), std::begin(stageGraphLevelList), std::end(stageGraphLevelList), [](auto const &level, int32_t order) -> bool
                 {
-                    slot.second(frameTime);
+                    return (level.first == order);
+                });
+
+                if (stageGraphChanged || levelsChanged)
+                {
+                    buildStageGraph();
+                }
+
+                completedStageCount.store(0, std::memory_order_release);
+                for (auto &node : stageNodeList)
+                {
+                    node.pendingCount.store(node.dependencyCount, std::memory_order_relaxed);
+                }
+
+                for (uint32_t nodeIndex = 0; nodeIndex < stageNodeList.size(); ++nodeIndex)
+                {
+                    if (stageNodeList[nodeIndex].dependencyCount == 0)
+                    {
+                        launchStage(nodeIndex, frameTime);
+                    }
+                }
+
+                // The calling thread runs its own stages as they become ready and sleeps otherwise
+                auto stageCount = static_cast<uint32_t>(stageNodeList.size());
+                while (completedStageCount.load(std::memory_order_acquire) < stageCount)
+                {
+                    auto signal = stageSignal.load(std::memory_order_acquire);
+                    uint32_t nodeIndex;
+                    if (callingThreadQueue.try_pop(nodeIndex))
+                    {
+                        runStage(nodeIndex, frameTime);
+                    }
+                    else if (completedStageCount.load(std::memory_order_acquire) < stageCount)
+                    {
+                        stageSignal.wait(signal, std::memory_order_acquire);
+                    }
                 }
+
+                frameTaskGroup.join();
+            }
+
+            uint32_t addUpdateStage(UpdateStage &&stage)
+            {
+                auto stageIdentifier = nextStageIdentifier++;
+                updateStageMap.emplace(stageIdentifier, std::move(stage));
+                stageGraphChanged = true;
+                return stageIdentifier;
+            }
+
+            void removeUpdateStage(uint32_t stageIdentifier)
+            {
+                updateStageMap.erase(stageIdentifier);
+                stageGraphChanged = true;
+            }
+
+            uint64_t getFrameIndex(void) const
+            {
+                return frameIndex.load(std::memory_order_acquire);
+            }
+
+            Shapes::BoundingVolumeHierarchy &getSpatialIndex(SpatialLayer layer)
+            {
+                return spatialIndexList[static_cast<size_t>(layer)];
             }
 
             void action(Action const &action)
@@ -224,39 +1008,69 @@ namespace Gek
                 scheduleReset();
             }
 
-            void scheduleLoad(std::string const &_populationName)
+            Task<> loadEntityBatch(LoadState &loadState, size_t firstEntity, size_t lastEntity)
             {
-                std::string populationName(_populationName);
-
-                if (shuttingDown)
+                co_await threadPool->schedule(loadTaskGroup, ThreadPool::Queue::Streaming);
+                GEK_PROFILE_ZONE("Population::loadEntityBatch");
+
+                // Expressions are evaluated against a private copy so that batches never share random state or caches
+                ShuntingYard batchShuntingYard(shuntingYard);
+                batchShuntingYard.setRandomSeed(loadState.seed + static_cast<uint32_t>(firstEntity / LoadBatchSize));
+                LoadingShuntingYard = &batchShuntingYard;
+                for (size_t entityIndex = firstEntity; entityIndex < lastEntity && !shuttingDown; ++entityIndex)
                 {
-                    return;
+                    auto const &entityDefinition = loadState.definitionList[loadState.definitionIndexList[entityIndex]];
+                    auto &componentDataList = loadState.stagedEntityList[entityIndex];
+                    componentDataList.reserve(entityDefinition.size());
+                    for (auto const &componentDefinition : entityDefinition)
+                    {
+                        std::unique_ptr<Plugin::Component::Data> data;
+                        auto component = loadComponentData(componentDefinition, data);
+                        if (component)
+                        {
+                            componentDataList.emplace_back(component, std::move(data));
+                        }
+                    }
                 }
 
-                fullReset();
-
-                getContext()->log(Context::Info, "Loading population: {}", populationName);
+                LoadingShuntingYard = nullptr;
+                auto stagedEntityCount = (loadState.stagedEntityCount += (lastEntity - firstEntity));
+                getContext()->getRuntimeMetrics().set(metricHandles.loadProgress, (double(stagedEntityCount) / double(loadState.stagedEntityList.size())));
+            }
 
-                JSON::Object worldNode = JSON::Load(getContext()->findDataPath(FileSystem::CreatePath("scenes", populationName).withExtension(".json")));
+            void loadSceneDefinitions(FileSystem::Path const &scenePath, LoadState &loadState)
+            {
+                JSON::Object worldNode = JSON::Load(scenePath);
                 shuntingYard.setRandomSeed(JSON::Value(worldNode, "Seed", uint32_t(std::time(nullptr) & 0xFFFFFFFF)));
 
-                auto templatesNode = worldNode["Templates"];
-                auto populationNode = worldNode["Population"];
-                getContext()->log(Context::Info, "Found {} Entity Definitions", populationNode.size());
-                for (auto &entityNode : populationNode)
+                // Templates are merged into definitions once, up front, instead of once per entity that references them
+                std::unordered_map<std::string, EntityDefinition> templateDefinitionMap;
+                auto &templatesNode = worldNode["Templates"];
+                if (templatesNode.is_object())
                 {
-                    if (shuttingDown)
+                    for (auto const &[templateName, templateNode] : templatesNode.items())
                     {
-                        return;
+                        auto &templateDefinition = templateDefinitionMap[templateName];
+                        for (auto const &[componentName, componentData] : templateNode.items())
+                        {
+                            templateDefinition[componentName] = componentData;
+                        }
                     }
+                }
 
+                loadState.seed = shuntingYard.getRandomSeed();
+
+                auto &populationNode = worldNode["Population"];
+                loadState.definitionList.reserve(populationNode.size());
+                for (auto &entityNode : populationNode)
+                {
                     uint32_t count = 1;
                     EntityDefinition entityDefinition;
                     auto templateSearch = entityNode.find("Template");
                     if (templateSearch != std::end(entityNode))
                     {
                         std::string templateName;
-                        auto entityTemplateNode = entityNode["Template"];
+                        auto const &entityTemplateNode = *templateSearch;
                         if (entityTemplateNode.is_string())
                         {
                             templateName = entityTemplateNode.get<std::string>();
@@ -274,10 +1088,14 @@ namespace Gek
                             }
                         }
 
-                        auto &templateNode = templatesNode[templateName];
-                        for (auto const &[key, value] : templateNode.items())
+                        auto templateDefinitionSearch = templateDefinitionMap.find(templateName);
+                        if (templateDefinitionSearch != std::end(templateDefinitionMap))
+                        {
+                            entityDefinition = templateDefinitionSearch->second;
+                        }
+                        else
                         {
-                            entityDefinition[key] = value;
+                            getContext()->log(Context::Error, "Entity references unknown template: {}", templateName);
                         }
 
                         entityNode.erase(templateSearch);
@@ -299,47 +1117,263 @@ namespace Gek
                         }
                     }
 
-                    while (count-- > 0)
+                    loadState.definitionIndexList.insert(std::end(loadState.definitionIndexList), count, static_cast<uint32_t>(loadState.definitionList.size()));
+                    loadState.definitionList.push_back(std::move(entityDefinition));
+                }
+
+                auto entityCount = loadState.definitionIndexList.size();
+                getContext()->log(Context::Info, "Found {} Entity Definitions, {} Entities", loadState.definitionList.size(), entityCount);
+
+                // Component data is created and loaded on the streaming queue, scheduleLoad commits it to the registry
+                loadState.stagedEntityList.resize(entityCount);
+                for (size_t firstEntity = 0; firstEntity < entityCount; firstEntity += LoadBatchSize)
+                {
+                    loadEntityBatch(loadState, firstEntity, std::min(firstEntity + LoadBatchSize, entityCount));
+                }
+
+                loadTaskGroup.join();
+            }
+
+            Task<> uncookBlock(CookedBlock &cookedBlock, uint32_t blockIndex)
+            {
+                co_await threadPool->schedule(loadTaskGroup, ThreadPool::Queue::Streaming);
+                GEK_PROFILE_ZONE("Population::uncookBlock");
+
+                // Components without a raw layout load through JSON and may still evaluate expressions
+                ShuntingYard blockShuntingYard(shuntingYard);
+                blockShuntingYard.setRandomSeed(shuntingYard.getRandomSeed() + blockIndex);
+                LoadingShuntingYard = &blockShuntingYard;
+
+                auto data = cookedBlock.data;
+                cookedBlock.dataList.reserve(cookedBlock.rowCount);
+                for (uint32_t rowIndex = 0; rowIndex < cookedBlock.rowCount && data && !shuttingDown; ++rowIndex)
+                {
+                    auto &componentData = cookedBlock.dataList.emplace_back(cookedBlock.component->create());
+                    data = cookedBlock.component->uncook(componentData.get(), data, cookedBlock.dataEnd);
+                }
+
+                LoadingShuntingYard = nullptr;
+                cookedBlock.valid = (data == cookedBlock.dataEnd && cookedBlock.dataList.size() == cookedBlock.rowCount);
+            }
+
+            bool loadCookedScene(FileSystem::Path const &cookedPath, LoadState &loadState)
+            {
+                FileSystem::MappedFile mappedFile(cookedPath);
+                if (!mappedFile.isValid() || mappedFile.getSize() < sizeof(SceneHeader))
+                {
+                    return false;
+                }
+
+                auto fileData = mappedFile.getData();
+                auto fileEnd = (fileData + mappedFile.getSize());
+
+                SceneHeader header;
+                std::memcpy(&header, fileData, sizeof(SceneHeader));
+                if (header.identifier != SceneHeader().identifier || header.version != CurrentSceneVersion)
+                {
+                    getContext()->log(Context::Warning, "Ignoring cooked scene with unsupported version: {}", cookedPath.getString());
+                    return false;
+                }
+
+                std::vector<CookedBlock> cookedBlockList(header.blockCount);
+                auto blockData = (fileData + sizeof(SceneHeader));
+                for (auto &cookedBlock : cookedBlockList)
+                {
+                    BlockHeader blockHeader;
+                    if (size_t(fileEnd - blockData) < sizeof(BlockHeader))
+                    {
+                        getContext()->log(Context::Error, "Cooked scene is truncated: {}", cookedPath.getString());
+                        return false;
+                    }
+
+                    std::memcpy(&blockHeader, blockData, sizeof(BlockHeader));
+                    auto blockRemaining = size_t(fileEnd - blockData) - sizeof(BlockHeader);
+                    auto entityIndexSize = (sizeof(uint32_t) * size_t(blockHeader.rowCount));
+                    if (entityIndexSize > blockRemaining || blockHeader.dataSize > (blockRemaining - entityIndexSize))
+                    {
+                        getContext()->log(Context::Error, "Cooked scene is truncated: {}", cookedPath.getString());
+                        return false;
+                    }
+
+                    cookedBlock.rowCount = blockHeader.rowCount;
+                    cookedBlock.entityIndexList = reinterpret_cast<uint32_t const *>(blockData + sizeof(BlockHeader));
+                    cookedBlock.data = reinterpret_cast<uint8_t const *>(cookedBlock.entityIndexList + blockHeader.rowCount);
+                    cookedBlock.dataEnd = (cookedBlock.data + blockHeader.dataSize);
+
+                    std::string componentName(blockHeader.component, strnlen(blockHeader.component, sizeof(blockHeader.component)));
+                    auto componentNameSearch = componentTypeNameMap.find(componentName);
+                    if (componentNameSearch != std::end(componentTypeNameMap))
                     {
-                        if (shuttingDown)
+                        cookedBlock.component = availableComponents.find(componentNameSearch->second)->second.get();
+                        if (blockHeader.layout != cookedBlock.component->getCookedLayout())
                         {
-                            return;
+                            getContext()->log(Context::Warning, "Ignoring cooked scene with outdated {} layout: {}", componentName, cookedPath.getString());
+                            return false;
                         }
+                    }
+                    else
+                    {
+                        getContext()->log(Context::Error, "Cooked scene contains unknown component: {}", componentName);
+                    }
 
-                        auto populationEntity = new Entity();
-                        for (auto const &componentDefinition : entityDefinition)
-                        {
-                            if (shuttingDown)
-                            {
-                                delete populationEntity;
-                                return;
-                            }
+                    auto blockSize = static_cast<size_t>(cookedBlock.dataEnd - blockData);
+                    blockData += std::min(((blockSize + 7) & ~size_t(7)), size_t(fileEnd - blockData));
+                }
+
+                shuntingYard.setRandomSeed(header.seed);
+                loadState.seed = header.seed;
+
+                // Every component type is uncooked independently, straight out of the mapped file
+                for (uint32_t blockIndex = 0; blockIndex < header.blockCount; ++blockIndex)
+                {
+                    if (cookedBlockList[blockIndex].component)
+                    {
+                        uncookBlock(cookedBlockList[blockIndex], blockIndex);
+                    }
+                }
+
+                loadTaskGroup.join();
+                loadState.stagedEntityList.resize(header.entityCount);
+                for (auto &cookedBlock : cookedBlockList)
+                {
+                    if (!cookedBlock.component)
+                    {
+                        continue;
+                    }
+
+                    if (!cookedBlock.valid)
+                    {
+                        getContext()->log(Context::Error, "Cooked scene contains corrupt {} data: {}", cookedBlock.component->getName(), cookedPath.getString());
+                        loadState.stagedEntityList.clear();
+                        return false;
+                    }
 
-                            addComponent(populationEntity, componentDefinition);
+                    for (uint32_t rowIndex = 0; rowIndex < cookedBlock.rowCount; ++rowIndex)
+                    {
+                        auto entityIndex = cookedBlock.entityIndexList[rowIndex];
+                        if (entityIndex < header.entityCount)
+                        {
+                            loadState.stagedEntityList[entityIndex].emplace_back(cookedBlock.component, std::move(cookedBlock.dataList[rowIndex]));
                         }
+                    }
+                }
+
+                getContext()->getRuntimeMetrics().set(metricHandles.loadProgress, 1.0);
+                return true;
+            }
 
-                        auto entity = dynamic_cast<Plugin::Entity *>(populationEntity);
-                        if (shuttingDown)
+            // Writes the registry as a cooked scene, the registry order defines the entity indices
+            void cookScene(FileSystem::Path const &cookedPath)
+            {
+                struct BlockData
+                {
+                    std::vector<uint32_t> entityIndexList;
+                    std::vector<uint8_t> buffer;
+                };
+
+                std::map<Hash, BlockData> blockDataMap;
+                uint32_t entityIndex = 0;
+                for (auto const &entity : registry)
+                {
+                    static_cast<Entity *>(entity.get())->listComponents([&](Hash type, Plugin::Component::Data const *data) -> void
+                    {
+                        auto componentSearch = availableComponents.find(type);
+                        if (componentSearch != std::end(availableComponents))
                         {
-                            delete populationEntity;
-                            return;
+                            auto &blockData = blockDataMap[type];
+                            blockData.entityIndexList.push_back(entityIndex);
+                            componentSearch->second->cook(data, blockData.buffer);
                         }
+                    });
 
-                        loadEntityTask(entity);
-                    };
+                    ++entityIndex;
+                }
+
+                SceneHeader header;
+                header.seed = shuntingYard.getRandomSeed();
+                header.entityCount = entityIndex;
+                header.blockCount = static_cast<uint32_t>(blockDataMap.size());
+
+                std::vector<uint8_t> fileBuffer;
+                auto appendData = [&fileBuffer](void const *data, size_t size) -> void
+                {
+                    auto bytes = static_cast<uint8_t const *>(data);
+                    fileBuffer.insert(std::end(fileBuffer), bytes, (bytes + size));
+                };
+
+                appendData(&header, sizeof(SceneHeader));
+                for (auto const &[type, blockData] : blockDataMap)
+                {
+                    BlockHeader blockHeader;
+                    auto const &componentName = componentNameTypeMap[type];
+                    std::strncpy(blockHeader.component, componentName.data(), (sizeof(blockHeader.component) - 1));
+                    blockHeader.rowCount = static_cast<uint32_t>(blockData.entityIndexList.size());
+                    blockHeader.dataSize = blockData.buffer.size();
+                    blockHeader.layout = availableComponents.find(type)->second->getCookedLayout();
+                    appendData(&blockHeader, sizeof(BlockHeader));
+                    appendData(blockData.entityIndexList.data(), (sizeof(uint32_t) * blockData.entityIndexList.size()));
+                    appendData(blockData.buffer.data(), blockData.buffer.size());
+                    fileBuffer.resize((fileBuffer.size() + 7) & ~size_t(7));
                 }
 
+                FileSystem::Save(cookedPath, fileBuffer);
+            }
+
+            void scheduleLoad(std::string const &populationName)
+            {
                 if (shuttingDown)
                 {
                     return;
                 }
 
-                if (!shuttingDown)
+                fullReset();
+
+                auto loadStartTime = std::chrono::steady_clock::now();
+                getContext()->log(Context::Info, "Loading population: {}", populationName);
+                getContext()->getRuntimeMetrics().set(metricHandles.loadProgress, 0.0);
+
+                // JSON stays the authoring format, the cooked copy in the cache is used until the JSON is newer
+                auto scenePath = getContext()->findDataPath(FileSystem::CreatePath("scenes", populationName).withExtension(".json"));
+                auto cookedPath = getContext()->getCachePath(FileSystem::CreatePath("scenes", populationName).withExtension(".scene"));
+
+                LoadState loadState;
+                bool loadedCookedScene = (cookedPath.isFile() && !scenePath.isNewerThan(cookedPath) && loadCookedScene(cookedPath, loadState));
+                if (!loadedCookedScene)
                 {
-                    onLoad.emit(populationName);
+                    loadSceneDefinitions(scenePath, loadState);
                 }
 
-                return;
+                if (shuttingDown)
+                {
+                    return;
+                }
+
+                auto entityCount = loadState.stagedEntityList.size();
+                std::vector<Plugin::Entity *> entityList;
+                entityList.reserve(entityCount);
+                for (auto &componentDataList : loadState.stagedEntityList)
+                {
+                    auto populationEntity = new Entity(&archetypeRegistry);
+                    populationEntity->addComponentList(std::move(componentDataList));
+                    registry.push_back(Plugin::EntityPtr(populationEntity));
+                    entityList.push_back(populationEntity);
+                }
+
+                onEntityListCreated.emit(entityList);
+                if (!loadedCookedScene)
+                {
+                    cookScene(cookedPath);
+                }
+
+                auto loadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStartTime).count();
+                auto &metrics = getContext()->getRuntimeMetrics();
+                metrics.set(metricHandles.loadProgress, 1.0);
+                metrics.set(metricHandles.loadCooked, (loadedCookedScene ? 1.0 : 0.0));
+                metrics.set(metricHandles.loadEntities, static_cast<double>(entityCount));
+                metrics.set(metricHandles.loadTimeMs, loadTime);
+                getContext()->log(Context::Info, "Loaded {} entities in {:.2f}ms", entityCount, loadTime);
+
+                onLoad.emit(populationName);
             }
 
             void load(std::string const &populationName)
@@ -383,17 +1417,27 @@ namespace Gek
                 scene["Population"] = population;
                 scene["Seed"] = shuntingYard.getRandomSeed();
                 JSON::Save(scene, getContext()->getCachePath(FileSystem::CreatePath("scenes", populationName).withExtension(".json")));
+                cookScene(getContext()->getCachePath(FileSystem::CreatePath("scenes", populationName).withExtension(".scene")));
                 onSave.emit(populationName);
             }
 
             Plugin::Entity *createEntity(EntityDefinition const &entityDefinition)
             {
-                auto populationEntity = new Entity();
+                ComponentDataList componentDataList;
+                componentDataList.reserve(entityDefinition.size());
                 for (auto const &componentDefinition : entityDefinition)
                 {
-                    addComponent(populationEntity, componentDefinition);
+                    std::unique_ptr<Plugin::Component::Data> data;
+                    auto component = loadComponentData(componentDefinition, data);
+                    if (component)
+                    {
+                        componentDataList.emplace_back(component, std::move(data));
+                    }
                 }
 
+                auto populationEntity = new Entity(&archetypeRegistry);
+                populationEntity->addComponentList(std::move(componentDataList));
+
                 auto entity = dynamic_cast<Plugin::Entity *>(populationEntity);
                 loadEntityTask(entity);
                 return entity;
@@ -432,42 +1476,39 @@ namespace Gek
                 return;
             }
 
-            bool addComponentData(Entity * entity, ComponentDefinition const &definition)
+            // Creates and loads the data for a component definition without touching the entity storage
+            Plugin::Component *loadComponentData(ComponentDefinition const &definition, std::unique_ptr<Plugin::Component::Data> &data)
             {
-                assert(entity);
-
-                getContext()->log(Context::Info, "Adding component data: {}", definition.first);
-                auto componentNameSearch = std::find_if(std::begin(componentTypeNameMap), std::end(componentTypeNameMap), [&definition](auto const &componentPair) -> bool
-                                                        { return (definition.first == componentPair.first); });
-
-                if (componentNameSearch != std::end(componentTypeNameMap))
+                auto componentNameSearch = componentTypeNameMap.find(definition.first);
+                if (componentNameSearch == std::end(componentTypeNameMap))
                 {
-                    auto componentSearch = availableComponents.find(componentNameSearch->second);
-                    if (componentSearch != std::end(availableComponents))
-                    {
-                        Plugin::Component *componentManager = componentSearch->second.get();
-                        getContext()->log(Context::Info, "Creating component data: {}, {}", definition.first, componentNameSearch->second);
-                        auto component(componentManager->create());
-                        fprintf(stderr, "[addComponentData] pre-load: %s\n", definition.first.c_str()); fflush(stderr);
-                        getContext()->log(Context::Info, "Loading component data: {}, {}", definition.first, componentNameSearch->second);
-                        componentManager->load(component.get(), definition.second);
-                        fprintf(stderr, "[addComponentData] post-load: %s\n", definition.first.c_str()); fflush(stderr);
+                    getContext()->log(Context::Error, "Entity contains unknown component: {}", definition.first);
+                    return nullptr;
+                }
 
-                        getContext()->log(Context::Info, "Adding component data to entity: {}, {}, {}", definition.first, componentNameSearch->second, componentManager->getIdentifier());
-                        entity->addComponent(componentManager, std::move(component));
-                        fprintf(stderr, "[addComponentData] post-entity-addComponent: %s\n", definition.first.c_str()); fflush(stderr);
-                        getContext()->log(Context::Info, "Added component data to entity: {}, {}, {}", definition.first, componentNameSearch->second, componentManager->getIdentifier());
-                        fprintf(stderr, "[addComponentData] returning true: %s\n", definition.first.c_str()); fflush(stderr);
-                        return true;
-                    }
-                    else
-                    {
-                        getContext()->log(Context::Error, "Entity contains unknown component identifier: {}, {}", definition.first, componentNameSearch->second);
-                    }
+                auto componentSearch = availableComponents.find(componentNameSearch->second);
+                if (componentSearch == std::end(availableComponents))
+                {
+                    getContext()->log(Context::Error, "Entity contains unknown component identifier: {}, {}", definition.first, componentNameSearch->second);
+                    return nullptr;
                 }
-                else
+
+                Plugin::Component *componentManager = componentSearch->second.get();
+                data = componentManager->create();
+                componentManager->load(data.get(), definition.second);
+                return componentManager;
+            }
+
+            bool addComponentData(Entity * entity, ComponentDefinition const &definition)
+            {
+                assert(entity);
+
+                std::unique_ptr<Plugin::Component::Data> data;
+                auto componentManager = loadComponentData(definition, data);
+                if (componentManager)
                 {
-                    getContext()->log(Context::Error, "Entity contains unknown component: {}", definition.first);
+                    entity->addComponent(componentManager, std::move(data));
+                    return true;
                 }
 
                 return false;
@@ -477,10 +1518,7 @@ namespace Gek
             {
                 if (addComponentData(static_cast<Entity *>(entity), definition))
                 {
-                    fprintf(stderr, "[addComponent] addComponentData returned, pre-onComponentAdded: %s\n", definition.first.c_str()); fflush(stderr);
-                    getContext()->log(Context::Info, "Added component to entity: {}", definition.first);
                     onComponentAdded(static_cast<Plugin::Entity *>(entity));
-                    fprintf(stderr, "[addComponent] onComponentAdded returned: %s\n", definition.first.c_str()); fflush(stderr);
                 }
             }
 
@@ -502,6 +1540,47 @@ namespace Gek
                     onEntity(entity.get());
                 }
             }
+
+            uint64_t getStorageVersion(void) const
+            {
+                return archetypeRegistry.getStorageVersion();
+            }
+
+            uint64_t getStorageVersion(Plugin::Entity const *entity) const
+            {
+                return static_cast<Entity const *>(entity)->getStorageVersion();
+            }
+
+            void listChunks(std::vector<Hash> const &typeList, ChunkFunction && onChunk) const
+            {
+                std::vector<void *> componentLists(typeList.size());
+                archetypeRegistry.listChunks(typeList, [&](Archetype const *archetype, size_t chunkIndex, std::vector<int32_t> const &columnIndexList) -> void
+                                             {
+                    for (size_t typeIndex = 0; typeIndex < columnIndexList.size(); ++typeIndex)
+                    {
+                        componentLists[typeIndex] = archetype->getChunkColumn(chunkIndex, columnIndexList[typeIndex]);
+                    }
+
+                    onChunk(archetype->getChunkEntityCount(chunkIndex), archetype->getChunkEntityList(chunkIndex), componentLists.data()); });
+            }
+
+            void parallelListChunks(std::vector<Hash> const &typeList, ChunkFunction && onChunk) const
+            {
+                std::vector<std::vector<void *>> chunkColumnList;
+                std::vector<std::pair<size_t, Plugin::Entity *const *>> chunkEntityList;
+                archetypeRegistry.listChunks(typeList, [&](Archetype const *archetype, size_t chunkIndex, std::vector<int32_t> const &columnIndexList) -> void
+                                             {
+                    auto &componentLists = chunkColumnList.emplace_back(typeList.size());
+                    for (size_t typeIndex = 0; typeIndex < columnIndexList.size(); ++typeIndex)
+                    {
+                        componentLists[typeIndex] = archetype->getChunkColumn(chunkIndex, columnIndexList[typeIndex]);
+                    }
+
+                    chunkEntityList.emplace_back(archetype->getChunkEntityCount(chunkIndex), archetype->getChunkEntityList(chunkIndex)); });
+
+                tbb::parallel_for(size_t(0), chunkEntityList.size(), [&](size_t chunkIndex) -> void
+                                  { onChunk(chunkEntityList[chunkIndex].first, chunkEntityList[chunkIndex].second, chunkColumnList[chunkIndex].data()); });
+            }
         };
 
         GEK_REGISTER_CONTEXT_USER(Population);
@@ -16,8 +16,10 @@
 #include "GEK/GUI/Utilities.hpp"
 #include "GEK/Shapes/Sphere.hpp"
 #include "GEK/Utility/ContextUser.hpp"
+#include "GEK/Utility/FileReader.hpp"
 #include "GEK/Utility/FileSystem.hpp"
 #include "GEK/Utility/JSON.hpp"
+#include "GEK/Utility/Profiler.hpp"
 #include "GEK/Utility/ShuntingYard.hpp"
 #include "GEK/Utility/String.hpp"
 #include "GEK/Utility/ThreadPool.hpp"
@@ -176,19 +178,48 @@ namespace Gek
             using ResourceType = ResourceMap::value_type;
             using HandleType = HANDLE;
 
+            // A load that only needs one file can name it, the file is then read before the load takes a pool worker
+            struct Load
+            {
+                using FileLoad = std::function<TypePtr(HandleType, FileSystem::FileView const &)>;
+
+                std::function<TypePtr(HandleType)> onLoad;
+                FileSystem::Path filePath;
+                FileLoad onLoadFile;
+
+                template <typename FUNCTION, typename = typename std::enable_if<std::is_invocable_r<TypePtr, FUNCTION &, HandleType>::value>::type>
+                Load(FUNCTION &&function)
+                    : onLoad(std::forward<FUNCTION>(function))
+                {
+                }
+
+                Load(FileSystem::Path const &filePath, FileLoad &&onLoadFile)
+                    : filePath(filePath), onLoadFile(std::move(onLoadFile))
+                {
+                }
+
+                // Immediate loads still run on the calling thread
+                TypePtr operator()(HandleType handle) const
+                {
+                    return (onLoadFile ? onLoadFile(handle, FileSystem::Map(filePath)) : onLoad(handle));
+                }
+            };
+
           private:
             uint32_t validationIdentifier = 0;
             std::atomic_uint32_t nextIdentifier = 0;
 
           protected:
-            ThreadPool &loadPool;
+            ThreadPool &threadPool;
+            FileReader &fileReader;
+            TaskGroup &loadTaskGroup;
             ResourceHandleMap resourceHandleMap;
             ResourceMap resourceMap;
             mutable std::shared_mutex cacheMutex;
 
           public:
-            ResourceCache(ThreadPool &loadPool)
-                : loadPool(loadPool)
+            ResourceCache(ThreadPool &threadPool, FileReader &fileReader, TaskGroup &loadTaskGroup)
+                : threadPool(threadPool), fileReader(fileReader), loadTaskGroup(loadTaskGroup)
             {
             }
 
@@ -242,11 +273,23 @@ namespace Gek
                 return false;
             }
 
-            Task scheduleResource(HANDLE handle, std::function<TypePtr(HandleType)> &&load, HANDLE *fallback = nullptr)
+            Task<> scheduleResource(HANDLE handle, Load &&load, HANDLE *fallback = nullptr)
             {
                 auto localLoad = std::move(load);
-                co_await loadPool.schedule();
-                auto resource = localLoad(handle);
+                TypePtr resource;
+                if (localLoad.onLoadFile)
+                {
+                    auto fileView = co_await fileReader.read(loadTaskGroup, localLoad.filePath);
+                    GEK_PROFILE_ZONE("Resources::load");
+                    resource = localLoad.onLoadFile(handle, fileView);
+                }
+                else
+                {
+                    co_await threadPool.schedule(loadTaskGroup, ThreadPool::Queue::Streaming);
+                    GEK_PROFILE_ZONE("Resources::load");
+                    resource = localLoad.onLoad(handle);
+                }
+
                 setResource(handle, std::move(resource), fallback);
             }
 
@@ -283,8 +326,8 @@ namespace Gek
             tbb::concurrent_unordered_set<std::size_t> requestedLoadSet;
 
           public:
-            GeneralResourceCache(ThreadPool &loadPool)
-                : ResourceCache<HANDLE, TYPE>(loadPool)
+            GeneralResourceCache(ThreadPool &threadPool, FileReader &fileReader, TaskGroup &loadTaskGroup)
+                : ResourceCache<HANDLE, TYPE>(threadPool, fileReader, loadTaskGroup)
             {
             }
 
@@ -343,8 +386,8 @@ namespace Gek
             tbb::concurrent_unordered_map<HANDLE, std::size_t> loadParameters;
 
           public:
-            DynamicResourceCache(ThreadPool &loadPool)
-                : ResourceCache<HANDLE, TYPE>(loadPool)
+            DynamicResourceCache(ThreadPool &threadPool, FileReader &fileReader, TaskGroup &loadTaskGroup)
+                : ResourceCache<HANDLE, TYPE>(threadPool, fileReader, loadTaskGroup)
             {
             }
 
@@ -361,7 +404,7 @@ namespace Gek
                 ResourceCache<HANDLE, TYPE>::setResource(handle, data);
             }
 
-            std::pair<bool, HANDLE> getHandle(std::size_t hash, std::size_t parameters, std::function<TypePtr(HandleType)> &&load, uint32_t flags, HANDLE *fallback = nullptr)
+            std::pair<bool, HANDLE> getHandle(std::size_t hash, std::size_t parameters, typename ResourceCache<HANDLE, TYPE>::Load &&load, uint32_t flags, HANDLE *fallback = nullptr)
             {
                 auto primeFallback = [&](HANDLE targetHandle)
                 {
@@ -476,8 +519,8 @@ namespace Gek
             using HandleType = ResourceCache<HANDLE, TYPE>::HandleType;
 
           public:
-            ProgramResourceCache(ThreadPool &loadPool)
-                : ResourceCache<HANDLE, TYPE>(loadPool)
+            ProgramResourceCache(ThreadPool &threadPool, FileReader &fileReader, TaskGroup &loadTaskGroup)
+                : ResourceCache<HANDLE, TYPE>(threadPool, fileReader, loadTaskGroup)
             {
             }
 
@@ -499,8 +542,8 @@ namespace Gek
             : public ResourceCache<HANDLE, TYPE>
         {
           public:
-            StaticProgramResourceCache(ThreadPool &loadPool)
-                : ResourceCache<HANDLE, TYPE>(loadPool)
+            StaticProgramResourceCache(ThreadPool &threadPool, FileReader &fileReader, TaskGroup &loadTaskGroup)
+                : ResourceCache<HANDLE, TYPE>(threadPool, fileReader, loadTaskGroup)
             {
             }
 
@@ -526,8 +569,8 @@ namespace Gek
             tbb::concurrent_unordered_set<std::size_t> requestedLoadSet;
 
           public:
-            ReloadResourceCache(ThreadPool &loadPool)
-                : ResourceCache<HANDLE, TYPE>(loadPool)
+            ReloadResourceCache(ThreadPool &threadPool, FileReader &fileReader, TaskGroup &loadTaskGroup)
+                : ResourceCache<HANDLE, TYPE>(threadPool, fileReader, loadTaskGroup)
             {
             }
 
@@ -671,7 +714,9 @@ namespace Gek
             Plugin::Visualizer *renderer = nullptr;
             std::string renderDeviceName;
 
-            ThreadPool loadPool;
+            ThreadPool *threadPool = nullptr;
+            FileReader *fileReader = nullptr;
+            TaskGroup loadTaskGroup;
             std::recursive_mutex &shaderMutex;
 
             StaticProgramResourceCache<ProgramHandle, Render::Program> staticProgramCache;
@@ -714,6 +759,9 @@ namespace Gek
             uint64_t drawCallAttemptCount = 0;
             uint64_t drawCallSubmittedCount = 0;
             uint64_t drawCallSuppressedCount = 0;
+            Metrics::Handle drawAttemptsMetric;
+            Metrics::Handle drawSubmittedMetric;
+            Metrics::Handle drawSuppressedMetric;
             bool loggedMissingMaterial = false;
             bool loggedMissingMaterialData = false;
             bool loggedMissingVisual = false;
@@ -726,7 +774,7 @@ namespace Gek
 
           public:
             Resources(Context * context, Engine::Core * core)
-                : ContextRegistration(context), core(core), videoDevice(core->getRenderDevice()), loadPool(5), shaderMutex(GetResourcesShaderMutex()), staticProgramCache(loadPool), programCache(loadPool), visualCache(loadPool), materialCache(loadPool), shaderCache(loadPool), filterCache(loadPool), dynamicCache(loadPool), renderStateCache(loadPool), depthStateCache(loadPool), blendStateCache(loadPool)
+                : ContextRegistration(context), core(core), videoDevice(core->getRenderDevice()), threadPool(core->getThreadPool()), fileReader(core->getFileReader()), shaderMutex(GetResourcesShaderMutex()), staticProgramCache(*threadPool, *fileReader, loadTaskGroup), programCache(*threadPool, *fileReader, loadTaskGroup), visualCache(*threadPool, *fileReader, loadTaskGroup), materialCache(*threadPool, *fileReader, loadTaskGroup), shaderCache(*threadPool, *fileReader, loadTaskGroup), filterCache(*threadPool, *fileReader, loadTaskGroup), dynamicCache(*threadPool, *fileReader, loadTaskGroup), renderStateCache(*threadPool, *fileReader, loadTaskGroup), depthStateCache(*threadPool, *fileReader, loadTaskGroup), blendStateCache(*threadPool, *fileReader, loadTaskGroup)
             {
                 assert(core);
                 assert(videoDevice);
@@ -735,6 +783,11 @@ namespace Gek
                 String::Replace(renderDevice, "render", "");
                 renderDeviceName = renderDevice;
 
+                auto &metrics = getContext()->getRuntimeMetrics();
+                drawAttemptsMetric = metrics.getHandle("resources.drawAttempts");
+                drawSubmittedMetric = metrics.getHandle("resources.drawSubmitted");
+                drawSuppressedMetric = metrics.getHandle("resources.drawSuppressed");
+
                 core->onChangedDisplay.connect(this, &Resources::onReload);
                 core->onChangedSettings.connect(this, &Resources::onReload);
                 core->onInitialized.connect(this, &Resources::onInitialized);
@@ -743,7 +796,7 @@ namespace Gek
 
             ~Resources(void)
             {
-                loadPool.drain();
+                loadTaskGroup.join();
 
                 if (core)
                 {
@@ -767,9 +820,10 @@ namespace Gek
             bool showResources = false;
             void onShowUserInterface(void)
             {
-                getContext()->setRuntimeMetric("resources.drawAttempts", static_cast<double>(drawCallAttemptCount));
-                getContext()->setRuntimeMetric("resources.drawSubmitted", static_cast<double>(drawCallSubmittedCount));
-                getContext()->setRuntimeMetric("resources.drawSuppressed", static_cast<double>(drawCallSuppressedCount));
+                auto &metrics = getContext()->getRuntimeMetrics();
+                metrics.set(drawAttemptsMetric, static_cast<double>(drawCallAttemptCount));
+                metrics.set(drawSubmittedMetric, static_cast<double>(drawCallSubmittedCount));
+                metrics.set(drawSuppressedMetric, static_cast<double>(drawCallSuppressedCount));
 
                 ImGuiIO &imGuiIo = ImGui::GetIO();
                 auto mainMenu = ImGui::FindWindowByName("##MainMenuBar");
@@ -1078,7 +1132,8 @@ namespace Gek
             void onShutdown(void)
             {
                 shuttingDown.store(true, std::memory_order_release);
-                loadPool.drain(false);
+                fileReader->cancel(loadTaskGroup);
+                threadPool->cancel(loadTaskGroup);
                 if (renderer)
                 {
                     renderer->onShowUserInterface.disconnect(this, &Resources::onShowUserInterface);
@@ -1111,6 +1166,13 @@ namespace Gek
                     .second;
             }
 
+            Render::RenderState::CullMode getMaterialCullMode(MaterialHandle handle) const
+            {
+                auto material = materialCache.getResource(handle);
+                auto renderState = (material ? renderStateCache.getResource(material->getRenderState()) : nullptr);
+                return (renderState ? renderState->getDescription().cullMode : Render::RenderState::CullMode::None);
+            }
+
             ResourceHandle loadTexture(std::string_view textureName, uint32_t flags, ResourceHandle fallback)
             {
                 if (shuttingDown.load(std::memory_order_acquire))
@@ -1141,7 +1203,7 @@ namespace Gek
                     auto texturePath(getContext()->findDataPath(FileSystem::CreatePath("textures", normalizedTextureName).withExtension(format)));
                     if (texturePath.isFile())
                     {
-                        auto resource = dynamicCache.getHandle(hash, flags, [this, texturePath = texturePath, flags](ResourceHandle) -> Render::TexturePtr
+                        auto resource = dynamicCache.getHandle(hash, flags, { texturePath, [this, texturePath = texturePath, flags](ResourceHandle, FileSystem::FileView const &fileView) -> Render::TexturePtr
                                                                {
                             if (shuttingDown.load(std::memory_order_acquire))
                             {
@@ -1149,7 +1211,7 @@ namespace Gek
                             }
 
                             getContext()->log(Context::Info, "Loading texture: {}", texturePath.getString());
-                            return videoDevice->loadTexture(texturePath, flags); }, 0, &fallback);
+                            return videoDevice->loadTexture(texturePath, fileView, flags); } }, 0, &fallback);
 
                         if (resource.first)
                         {
@@ -1165,7 +1227,7 @@ namespace Gek
                 if (findTexturePathCaseInsensitive(getContext(), normalizedTextureName, texturePath) && texturePath.isFile())
                 {
                     auto hash = GetHash(normalizedTextureName);
-                    auto resource = dynamicCache.getHandle(hash, flags, [this, texturePath = texturePath, flags](ResourceHandle) -> Render::TexturePtr
+                    auto resource = dynamicCache.getHandle(hash, flags, { texturePath, [this, texturePath = texturePath, flags](ResourceHandle, FileSystem::FileView const &fileView) -> Render::TexturePtr
                                                            {
                         if (shuttingDown.load(std::memory_order_acquire))
                         {
@@ -1173,7 +1235,7 @@ namespace Gek
                         }
 
                         getContext()->log(Context::Info, "Loading texture (case-insensitive match): {}", texturePath.getString());
-                        return videoDevice->loadTexture(texturePath, flags); }, 0, &fallback);
+                        return videoDevice->loadTexture(texturePath, fileView, flags); } }, 0, &fallback);
 
                     if (resource.first)
                     {
@@ -1609,7 +1671,7 @@ namespace Gek
             {
                 textureDescriptionMap.clear();
                 bufferDescriptionMap.clear();
-                loadPool.drain();
+                loadTaskGroup.join();
                 materialShaderMap.clear();
                 programCache.clear();
                 materialCache.clear();
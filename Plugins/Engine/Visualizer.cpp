@@ -19,6 +19,7 @@
 #include "GEK/Utility/ContextUser.hpp"
 #include "GEK/Utility/FileSystem.hpp"
 #include "GEK/Utility/JSON.hpp"
+#include "GEK/Utility/Profiler.hpp"
 #include "GEK/Utility/String.hpp"
 #include "GEK/Utility/ThreadPool.hpp"
 #include "Passes.hpp"
@@ -33,6 +34,7 @@
 #include <tbb/concurrent_queue.h>
 #include <tbb/concurrent_unordered_set.h>
 #include <tbb/concurrent_vector.h>
+#include <tbb/parallel_for.h>
 #include <vector>
 
 namespace Gek
@@ -169,13 +171,14 @@ namespace Gek
                 float farClip = 0.0f;
                 ResourceHandle cameraTarget;
                 ShaderHandle forceShader;
+                uint64_t frameIndex = 0;
 
                 Camera(void)
                 {
                 }
 
                 Camera(Camera const &renderCall)
-                    : name(renderCall.name), viewFrustum(renderCall.viewFrustum), viewMatrix(renderCall.viewMatrix), projectionMatrix(renderCall.projectionMatrix), nearClip(renderCall.nearClip), farClip(renderCall.farClip), cameraTarget(renderCall.cameraTarget), forceShader(renderCall.forceShader)
+                    : name(renderCall.name), viewFrustum(renderCall.viewFrustum), viewMatrix(renderCall.viewMatrix), projectionMatrix(renderCall.projectionMatrix), nearClip(renderCall.nearClip), farClip(renderCall.farClip), cameraTarget(renderCall.cameraTarget), forceShader(renderCall.forceShader), frameIndex(renderCall.frameIndex)
                 {
                 }
             };
@@ -265,57 +268,157 @@ namespace Gek
                 }
             };
 
+            // Lights are kept in one of the population spatial indices, proxies follow the entity list index for index
             template <typename COMPONENT, typename DATA, size_t RESERVE = 200>
             struct LightVisibilityData
                 : public LightData<COMPONENT, DATA, RESERVE>
             {
+                struct Proxy
+                {
+                    uint32_t proxy = Shapes::BoundingVolumeHierarchy::InvalidProxy;
+                    uint32_t transformVersion = 0;
+                    float radius = 0.0f;
+                };
+
+                Shapes::BoundingVolumeHierarchy *spatialIndex = nullptr;
+                std::vector<Proxy> proxyList;
+                tbb::concurrent_vector<size_t> changedIndexList;
+
+                // Lights the tree could not fully accept, tested as spheres
+                std::vector<Plugin::Entity *> candidateEntityList;
                 std::vector<float, AlignedAllocator<float, 16>> shapeXPositionList;
                 std::vector<float, AlignedAllocator<float, 16>> shapeYPositionList;
                 std::vector<float, AlignedAllocator<float, 16>> shapeZPositionList;
                 std::vector<float, AlignedAllocator<float, 16>> shapeRadiusList;
-                std::vector<bool> visibilityList;
+                std::vector<uint8_t> visibilityList;
 
-                LightVisibilityData(Engine::Core *core)
+                std::vector<Plugin::Entity *> visibleEntityList;
+
+                LightVisibilityData(Engine::Core *core, Plugin::Population::SpatialLayer layer)
                     : LightData<COMPONENT, DATA, RESERVE>(core->getRenderDevice())
+                    , spatialIndex(&core->getPopulation()->getSpatialIndex(layer))
+                {
+                }
+
+                void addEntity(Plugin::Entity *const entity)
+                {
+                    LightData<COMPONENT, DATA, RESERVE>::addEntity(entity);
+                    proxyList.resize(this->entityList.size());
+                }
+
+                void removeEntity(Plugin::Entity *const entity)
+                {
+                    auto search = std::find(std::begin(this->entityList), std::end(this->entityList), entity);
+                    if (search != std::end(this->entityList))
+                    {
+                        auto proxySearch = std::next(std::begin(proxyList), std::distance(std::begin(this->entityList), search));
+                        if (proxySearch->proxy != Shapes::BoundingVolumeHierarchy::InvalidProxy)
+                        {
+                            spatialIndex->destroyProxy(proxySearch->proxy);
+                        }
+
+                        proxyList.erase(proxySearch);
+                        this->entityList.erase(search);
+                    }
+                }
+
+                void clearEntityData(void)
                 {
+                    LightData<COMPONENT, DATA, RESERVE>::clearEntityData();
+                    proxyList.clear();
+                    spatialIndex->clear();
                 }
 
                 void clearLightData(void)
                 {
+                    candidateEntityList.clear();
                     shapeXPositionList.clear();
                     shapeYPositionList.clear();
                     shapeZPositionList.clear();
                     shapeRadiusList.clear();
                     visibilityList.clear();
+                    visibleEntityList.clear();
                 }
 
-                void cull(Math::SIMD::Frustum const &frustum)
+                // Only lights that moved or changed range touch the tree
+                void updateProxies(void)
                 {
-                    const auto entityCount = this->entityList.size();
-                    auto buffer = (entityCount % 4);
-                    buffer = (buffer ? (4 - buffer) : buffer);
-                    auto bufferedEntityCount = (entityCount + buffer);
-                    shapeXPositionList.resize(bufferedEntityCount);
-                    shapeYPositionList.resize(bufferedEntityCount);
-                    shapeZPositionList.resize(bufferedEntityCount);
-                    shapeRadiusList.resize(bufferedEntityCount);
-
-                    auto entityRange = std::ranges::iota_view{ size_t(0), entityCount };
-                    std::for_each(std::execution::par, std::begin(entityRange), std::end(entityRange), [&](size_t entityIndex) -> void
-                                  {
-						Plugin::Entity *entity = this->entityList[entityIndex];
-						auto &transformComponent = entity->getComponent<Components::Transform>();
-						auto &lightComponent = entity->getComponent<COMPONENT>();
-
-						shapeXPositionList[entityIndex] = transformComponent.position.x;
-						shapeYPositionList[entityIndex] = transformComponent.position.y;
-						shapeZPositionList[entityIndex] = transformComponent.position.z;
-						shapeRadiusList[entityIndex] = (lightComponent.range + lightComponent.radius); });
-
-                    visibilityList.resize(bufferedEntityCount);
-                    this->lightList.clear();
+                    changedIndexList.clear();
+                    tbb::parallel_for(size_t(0), this->entityList.size(), [&](size_t entityIndex) -> void
+                    {
+                        Plugin::Entity *entity = this->entityList[entityIndex];
+                        auto &transformComponent = entity->getComponent<Components::Transform>();
+                        auto &lightComponent = entity->getComponent<COMPONENT>();
+                        auto const &proxy = proxyList[entityIndex];
+                        if (proxy.proxy == Shapes::BoundingVolumeHierarchy::InvalidProxy ||
+                            proxy.transformVersion != transformComponent.version ||
+                            proxy.radius != (lightComponent.range + lightComponent.radius))
+                        {
+                            changedIndexList.push_back(entityIndex);
+                        }
+                    });
+
+                    for (auto entityIndex : changedIndexList)
+                    {
+                        Plugin::Entity *entity = this->entityList[entityIndex];
+                        auto &transformComponent = entity->getComponent<Components::Transform>();
+                        auto &lightComponent = entity->getComponent<COMPONENT>();
+                        auto &proxy = proxyList[entityIndex];
+                        proxy.transformVersion = transformComponent.version;
+                        proxy.radius = (lightComponent.range + lightComponent.radius);
+
+                        Shapes::AlignedBox box((transformComponent.position - proxy.radius), (transformComponent.position + proxy.radius));
+                        if (proxy.proxy == Shapes::BoundingVolumeHierarchy::InvalidProxy)
+                        {
+                            proxy.proxy = spatialIndex->createProxy(box, reinterpret_cast<uintptr_t>(entity));
+                        }
+                        else
+                        {
+                            spatialIndex->moveProxy(proxy.proxy, box);
+                        }
+                    }
+                }
+
+                void cull(Shapes::Frustum const &frustum)
+                {
+                    updateProxies();
+
+                    visibleEntityList.clear();
+                    candidateEntityList.clear();
+                    spatialIndex->query(frustum, [&](uint64_t userData, bool isInside) -> void
+                    {
+                        auto entity = reinterpret_cast<Plugin::Entity *>(static_cast<uintptr_t>(userData));
+                        (isInside ? visibleEntityList : candidateEntityList).push_back(entity);
+                    });
+
+                    const auto candidateCount = candidateEntityList.size();
+                    auto bufferedCandidateCount = Math::SIMD::GetPaddedCount(candidateCount);
+                    shapeXPositionList.assign(bufferedCandidateCount, 0.0f);
+                    shapeYPositionList.assign(bufferedCandidateCount, 0.0f);
+                    shapeZPositionList.assign(bufferedCandidateCount, 0.0f);
+                    shapeRadiusList.assign(bufferedCandidateCount, 0.0f);
+                    visibilityList.resize(bufferedCandidateCount);
+                    for (size_t candidateIndex = 0; candidateIndex < candidateCount; ++candidateIndex)
+                    {
+                        Plugin::Entity *entity = candidateEntityList[candidateIndex];
+                        auto &transformComponent = entity->getComponent<Components::Transform>();
+                        auto &lightComponent = entity->getComponent<COMPONENT>();
+                        shapeXPositionList[candidateIndex] = transformComponent.position.x;
+                        shapeYPositionList[candidateIndex] = transformComponent.position.y;
+                        shapeZPositionList[candidateIndex] = transformComponent.position.z;
+                        shapeRadiusList[candidateIndex] = (lightComponent.range + lightComponent.radius);
+                    }
 
-                    Math::SIMD::cullSpheres(frustum, bufferedEntityCount, shapeXPositionList, shapeYPositionList, shapeZPositionList, shapeRadiusList, visibilityList);
+                    Math::SIMD::cullSpheres(Math::SIMD::loadFrustum(&frustum.planeList[0].vector), bufferedCandidateCount, shapeXPositionList, shapeYPositionList, shapeZPositionList, shapeRadiusList, visibilityList);
+                    for (size_t candidateIndex = 0; candidateIndex < candidateCount; ++candidateIndex)
+                    {
+                        if (visibilityList[candidateIndex])
+                        {
+                            visibleEntityList.push_back(candidateEntityList[candidateIndex]);
+                        }
+                    }
+
+                    this->lightList.clear();
                 }
             };
 
@@ -351,7 +454,8 @@ namespace Gek
             Render::RenderStatePtr renderState;
             Render::DepthStatePtr depthState;
 
-            ThreadPool workerPool;
+            TaskGroup lightTaskGroup;
+            ThreadPool *threadPool = nullptr;
             LightData<Components::DirectionalLight, DirectionalLightData> directionalLightData;
             LightVisibilityData<Components::PointLight, PointLightData> pointLightData;
             LightVisibilityData<Components::SpotLight, SpotLightData> spotLightData;
@@ -368,12 +472,30 @@ namespace Gek
 
             DrawCallList drawCallList;
             tbb::concurrent_queue<Camera> cameraQueue;
+            std::vector<Camera> frameCameraList;
+            std::vector<Camera> deferredCameraList;
+            bool overlapCameraSetup = false;
+            uint32_t updateStageIdentifier = 0;
             Camera currentCamera;
             float clipDistance;
             float reciprocalClipDistance;
             float depthScale;
             uint64_t renderFrameCounter = 0;
 
+            struct MetricHandles
+            {
+                Metrics::Handle frame;
+                Metrics::Handle processedCameras;
+                Metrics::Handle queuedDrawCalls;
+                Metrics::Handle shaderGroups;
+                Metrics::Handle preparedPasses;
+                Metrics::Handle forwardPasses;
+                Metrics::Handle deferredPasses;
+                Metrics::Handle computePasses;
+                Metrics::Handle forwardDrawDispatches;
+                Metrics::Handle deferredDrawDispatches;
+            } metricHandles;
+
             struct GUI
             {
                 struct DataBuffer
@@ -399,17 +521,40 @@ namespace Gek
 
           public:
             Visualizer(Context * context, Engine::Core * core)
-                : ContextRegistration(context), core(core), renderDevice(core->getRenderDevice()), population(core->getPopulation()), resources(core->getFullResources()), directionalLightData(core->getRenderDevice()), pointLightData(core), spotLightData(core), workerPool(3)
+                : ContextRegistration(context), core(core), renderDevice(core->getRenderDevice()), population(core->getPopulation()), resources(core->getFullResources()), threadPool(core->getThreadPool()), directionalLightData(core->getRenderDevice()), pointLightData(core, Plugin::Population::SpatialLayer::PointLights), spotLightData(core, Plugin::Population::SpatialLayer::SpotLights)
             {
                 population->onReset.connect(this, &Visualizer::onReset);
                 population->onEntityCreated.connect(this, &Visualizer::onEntityCreated);
+                population->onEntityListCreated.connect(this, &Visualizer::onEntityListCreated);
                 population->onEntityDestroyed.connect(this, &Visualizer::onEntityDestroyed);
                 population->onComponentAdded.connect(this, &Visualizer::onComponentAdded);
                 population->onComponentRemoved.connect(this, &Visualizer::onComponentRemoved);
-                population->onUpdate[1000].connect(this, &Visualizer::onUpdate);
+                overlapCameraSetup = core->getOption("render", "overlapCameraSetup", false);
+                updateStageIdentifier = population->addUpdateStage({
+                    .name = "render",
+                    .order = 1000,
+                    .readsEverything = true,
+                    .callingThread = true,
+                    .onUpdate = [this](float frameTime) -> void
+                    {
+                        onUpdate(frameTime);
+                    },
+                });
 
                 core->setOption("render"s, "invertedDepthBuffer"s, true);
 
+                auto &metrics = getContext()->getRuntimeMetrics();
+                metricHandles.frame = metrics.getHandle("visualizer.frame");
+                metricHandles.processedCameras = metrics.getHandle("visualizer.processedCameras");
+                metricHandles.queuedDrawCalls = metrics.getHandle("visualizer.queuedDrawCalls");
+                metricHandles.shaderGroups = metrics.getHandle("visualizer.shaderGroups");
+                metricHandles.preparedPasses = metrics.getHandle("visualizer.preparedPasses");
+                metricHandles.forwardPasses = metrics.getHandle("visualizer.forwardPasses");
+                metricHandles.deferredPasses = metrics.getHandle("visualizer.deferredPasses");
+                metricHandles.computePasses = metrics.getHandle("visualizer.computePasses");
+                metricHandles.forwardDrawDispatches = metrics.getHandle("visualizer.forwardDrawDispatches");
+                metricHandles.deferredDrawDispatches = metrics.getHandle("visualizer.deferredDrawDispatches");
+
                 initializeSystem();
                 initializeUI();
             }
@@ -729,7 +874,8 @@ float4 main(PixelInput input) : SV_Target
 
             ~Visualizer(void)
             {
-                workerPool.drain();
+                population->removeUpdateStage(updateStageIdentifier);
+                lightTaskGroup.join();
 
                 ImGui::GetIO().Fonts->SetTexID(nullptr);
                 ImGui::DestroyContext(gui.context);
@@ -1105,6 +1251,15 @@ float4 main(PixelInput input) : SV_Target
                 addEntity(entity);
             }
 
+            void onEntityListCreated(std::vector<Plugin::Entity *> const &entityList)
+            {
+                std::lock_guard<std::mutex> lock(lightDataMutex);
+                for (auto entity : entityList)
+                {
+                    addEntity(entity);
+                }
+            }
+
             void onEntityDestroyed(Plugin::Entity *const entity)
             {
                 std::lock_guard<std::mutex> lock(lightDataMutex);
@@ -1144,6 +1299,7 @@ float4 main(PixelInput input) : SV_Target
                 renderCall.farClip = farClip;
                 renderCall.cameraTarget = cameraTarget;
                 renderCall.name = name;
+                renderCall.frameIndex = population->getFrameIndex();
                 if (!forceShader.empty())
                 {
                     renderCall.forceShader = resources->getShader(forceShader);
@@ -1181,9 +1337,9 @@ float4 main(PixelInput input) : SV_Target
                 }
             }
 
-            Task scheduleDirectionalLights(void)
+            Task<> scheduleDirectionalLights(void)
             {
-                co_await workerPool.schedule();
+                co_await threadPool->schedule(lightTaskGroup, ThreadPool::Queue::Frame);
                 std::lock_guard<std::mutex> lock(lightDataMutex);
 
                 directionalLightData.lightList.clear();
@@ -1202,48 +1358,38 @@ float4 main(PixelInput input) : SV_Target
                 directionalLightData.createBuffer();
             }
 
-            Task schedulePointLights(const Math::SIMD::Frustum &sceneFrustum)
+            Task<> schedulePointLights(const Shapes::Frustum &sceneFrustum)
             {
-                Math::SIMD::Frustum frustum = sceneFrustum;
-                co_await workerPool.schedule();
+                Shapes::Frustum frustum = sceneFrustum;
+                co_await threadPool->schedule(lightTaskGroup, ThreadPool::Queue::Frame);
                 std::lock_guard<std::mutex> lock(lightDataMutex);
 
                 std::for_each(std::execution::par, std::begin(tilePointLightIndexList), std::end(tilePointLightIndexList), [&](auto &gridData) -> void
                               { gridData.clear(); });
 
                 pointLightData.cull(frustum);
-                auto visibilityRange = std::ranges::iota_view{ size_t(0), pointLightData.entityList.size() };
-                std::for_each(std::execution::par, std::begin(visibilityRange), std::end(visibilityRange), [&](size_t index) -> void
+                std::for_each(std::execution::par, std::begin(pointLightData.visibleEntityList), std::end(pointLightData.visibleEntityList), [&](Plugin::Entity *entity) -> void
                               {
-					if (pointLightData.visibilityList[index])
-					{
-						Plugin::Entity *entity = pointLightData.entityList[index];
-						auto& lightComponent = entity->getComponent<Components::PointLight>();
-						addPointLight(entity, lightComponent);
-					} });
+					auto& lightComponent = entity->getComponent<Components::PointLight>();
+					addPointLight(entity, lightComponent); });
 
                 pointLightData.createBuffer();
             }
 
-            Task scheduleSpotLights(const Math::SIMD::Frustum &sceneFrustum)
+            Task<> scheduleSpotLights(const Shapes::Frustum &sceneFrustum)
             {
-                Math::SIMD::Frustum frustum = sceneFrustum;
-                co_await workerPool.schedule();
+                Shapes::Frustum frustum = sceneFrustum;
+                co_await threadPool->schedule(lightTaskGroup, ThreadPool::Queue::Frame);
                 std::lock_guard<std::mutex> lock(lightDataMutex);
 
                 std::for_each(std::execution::par, std::begin(tileSpotLightIndexList), std::end(tileSpotLightIndexList), [&](auto &gridData) -> void
                               { gridData.clear(); });
 
                 spotLightData.cull(frustum);
-                auto visibilityRange = std::ranges::iota_view{ size_t(0), spotLightData.entityList.size() };
-                std::for_each(std::execution::par, std::begin(visibilityRange), std::end(visibilityRange), [&](size_t index) -> void
+                std::for_each(std::execution::par, std::begin(spotLightData.visibleEntityList), std::end(spotLightData.visibleEntityList), [&](Plugin::Entity *entity) -> void
                               {
-					if (spotLightData.visibilityList[index])
-					{
-						auto entity = spotLightData.entityList[index];
-						auto& lightComponent = entity->getComponent<Components::SpotLight>();
-						addSpotLight(entity, lightComponent);
-					} });
+					auto& lightComponent = entity->getComponent<Components::SpotLight>();
+					addSpotLight(entity, lightComponent); });
 
                 spotLightData.createBuffer();
             }
@@ -1251,6 +1397,7 @@ float4 main(PixelInput input) : SV_Target
             // Plugin::Core Slots
             void onUpdate(float frameTime)
             {
+                GEK_PROFILE_ZONE("Visualizer::onUpdate");
                 assert(renderDevice);
                 assert(population);
 
@@ -1272,15 +1419,28 @@ float4 main(PixelInput input) : SV_Target
                 renderDevice->updateResource(engineConstantBuffer.get(), &engineConstantData);
                 Render::Device::Context *videoContext = renderDevice->getDefaultContext();
 
-                while (cameraQueue.try_pop(currentCamera))
+                // Cameras queued while this frame renders belong to the next one when camera setup is overlapped
+                auto currentFrameIndex = population->getFrameIndex();
+                frameCameraList.swap(deferredCameraList);
+                deferredCameraList.clear();
+
+                Camera queuedCamera;
+                while (cameraQueue.try_pop(queuedCamera))
+                {
+                    auto &cameraList = ((overlapCameraSetup && queuedCamera.frameIndex >= currentFrameIndex) ? deferredCameraList : frameCameraList);
+                    cameraList.push_back(queuedCamera);
+                }
+
+                for (auto const &frameCamera : frameCameraList)
                 {
+                    currentCamera = frameCamera;
                     ++processedCameras;
                     clipDistance = (currentCamera.farClip - currentCamera.nearClip);
                     reciprocalClipDistance = (1.0f / clipDistance);
                     depthScale = ((ReciprocalGridDepth * clipDistance) + currentCamera.nearClip);
 
                     drawCallList.clear();
-                    onQueueDrawCalls(currentCamera.viewFrustum, currentCamera.viewMatrix, currentCamera.projectionMatrix);
+                    onQueueDrawCalls(currentCamera.viewFrustum, currentCamera.viewMatrix, currentCamera.projectionMatrix, currentCamera.name);
                     queuedDrawCalls += static_cast<uint32_t>(drawCallList.size());
                     if (!drawCallList.empty())
                     {
@@ -1323,11 +1483,10 @@ float4 main(PixelInput input) : SV_Target
 
                         if (isLightingRequired)
                         {
-                            auto frustum = Math::SIMD::loadFrustum((Math::Float4 *)currentCamera.viewFrustum.planeList);
                             scheduleDirectionalLights();
-                            schedulePointLights(frustum);
-                            scheduleSpotLights(frustum);
-                            workerPool.join();
+                            schedulePointLights(currentCamera.viewFrustum);
+                            scheduleSpotLights(currentCamera.viewFrustum);
+                            lightTaskGroup.join();
 
                             tbb::combinable<size_t> lightIndexCount;
                             std::for_each(std::execution::par, std::begin(tilePointLightIndexList), std::end(tilePointLightIndexList), [&](auto &gridData) -> void
@@ -1648,16 +1807,17 @@ float4 main(PixelInput input) : SV_Target
 
                 renderUI(ImGui::GetDrawData());
 
-                getContext()->setRuntimeMetric("visualizer.frame", static_cast<double>(renderFrameCounter));
-                getContext()->setRuntimeMetric("visualizer.processedCameras", static_cast<double>(processedCameras));
-                getContext()->setRuntimeMetric("visualizer.queuedDrawCalls", static_cast<double>(queuedDrawCalls));
-                getContext()->setRuntimeMetric("visualizer.shaderGroups", static_cast<double>(shaderGroupCount));
-                getContext()->setRuntimeMetric("visualizer.preparedPasses", static_cast<double>(preparedPassCount));
-                getContext()->setRuntimeMetric("visualizer.forwardPasses", static_cast<double>(forwardPassCount));
-                getContext()->setRuntimeMetric("visualizer.deferredPasses", static_cast<double>(deferredPassCount));
-                getContext()->setRuntimeMetric("visualizer.computePasses", static_cast<double>(computePassCount));
-                getContext()->setRuntimeMetric("visualizer.forwardDrawDispatches", static_cast<double>(forwardDrawDispatchCount));
-                getContext()->setRuntimeMetric("visualizer.deferredDrawDispatches", static_cast<double>(deferredDrawDispatchCount));
+                auto &metrics = getContext()->getRuntimeMetrics();
+                metrics.set(metricHandles.frame, static_cast<double>(renderFrameCounter));
+                metrics.set(metricHandles.processedCameras, static_cast<double>(processedCameras));
+                metrics.set(metricHandles.queuedDrawCalls, static_cast<double>(queuedDrawCalls));
+                metrics.set(metricHandles.shaderGroups, static_cast<double>(shaderGroupCount));
+                metrics.set(metricHandles.preparedPasses, static_cast<double>(preparedPassCount));
+                metrics.set(metricHandles.forwardPasses, static_cast<double>(forwardPassCount));
+                metrics.set(metricHandles.deferredPasses, static_cast<double>(deferredPassCount));
+                metrics.set(metricHandles.computePasses, static_cast<double>(computePassCount));
+                metrics.set(metricHandles.forwardDrawDispatches, static_cast<double>(forwardDrawDispatchCount));
+                metrics.set(metricHandles.deferredDrawDispatches, static_cast<double>(deferredDrawDispatchCount));
 
                 renderDevice->present(true);
                 if (reloadRequired)
@@ -21,6 +21,12 @@ namespace Gek
 
             std::string name;
         };
+
+        // Marks models that fill their bounding box well enough to hide whatever is behind them
+        GEK_COMPONENT(Occluder)
+        {
+            GEK_COMPONENT_DATA(Occluder);
+        };
     }; // namespace Components
 
     namespace Processor
@@ -0,0 +1,286 @@
+﻿/// @file
+/// @author Todd Zupan <toddzupan@gmail.com>
+/// @version $Revision$
+/// @section LICENSE
+/// https://en.wikipedia.org/wiki/MIT_License
+/// @section DESCRIPTION
+/// Last Changed: $Date$
+#pragma once
+
+#include "GEK/Math/Vector2.hpp"
+#include "GEK/Math/Vector3.hpp"
+#include "GEK/Math/Vector4.hpp"
+#include "GEK/Shapes/AlignedBox.hpp"
+#include "GEK/Utility/Compression.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Gek
+{
+    // Layout of the .gek model files written by createmodel, shared with the loader so both sides agree on every version
+    namespace ModelFormat
+    {
+        enum class NormalEncoding : uint8_t
+        {
+            RG = 0,
+            RGB = 1,
+        };
+
+        enum class StreamCodec : uint8_t
+        {
+            None = 0,
+            LZ4 = 1,
+            ShuffledLZ4 = 2,
+        };
+
+        // Quantized meshes store 16 bit positions inside their bounds, half float texture coordinates and octahedral
+        // tangents and normals
+        enum class VertexEncoding : uint8_t
+        {
+            Float = 0,
+            Quantized = 1,
+            Count,
+        };
+
+        static constexpr uint32_t Identifier = (uint32_t('G') | (uint32_t('E') << 8) | (uint32_t('K') << 16) | (uint32_t('X') << 24));
+
+        static constexpr uint16_t LegacyVersion = 8;
+        static constexpr uint16_t UncompressedVersion = 9;
+        static constexpr uint16_t CompressedVersion = 10;
+        static constexpr uint16_t IndexedVersion = 11;
+        static constexpr uint16_t QuantizedVersion = 12;
+        static constexpr uint16_t LevelVersion = 13;
+        static constexpr uint16_t CurrentVersion = 14;
+
+        inline bool IsSupportedVersion(uint16_t version)
+        {
+            return ((version >= LegacyVersion) && (version <= CurrentVersion));
+        }
+
+        // Positions, texture coordinates, tangents and normals, in the order they are stored
+        static constexpr size_t VertexEncodingCount = static_cast<size_t>(VertexEncoding::Count);
+        static constexpr uint32_t StreamCount = 4;
+        static constexpr std::array<std::array<uint32_t, StreamCount>, VertexEncodingCount> StreamStrideList =
+        {{
+            { sizeof(Math::Float3), sizeof(Math::Float2), sizeof(Math::Float4), sizeof(Math::Float3) },
+            { (sizeof(uint16_t) * 4), (sizeof(uint16_t) * 2), (sizeof(uint16_t) * 4), (sizeof(uint16_t) * 2) },
+        }};
+
+        static constexpr std::array<size_t, VertexEncodingCount> StreamElementSizeList = { sizeof(float), sizeof(uint16_t) };
+
+        static constexpr uint32_t MaxLevelCount = 4;
+
+        struct FileHeader
+        {
+            uint32_t identifier = Identifier;
+            uint16_t type = 0;
+            uint16_t version = CurrentVersion;
+
+            Shapes::AlignedBox boundingBox;
+
+            uint32_t meshCount = 0;
+        };
+
+        struct LegacyMeshHeader
+        {
+            char material[64] = "";
+            uint32_t vertexCount = 0;
+            uint32_t faceCount = 0;
+        };
+
+        struct UncompressedMeshHeader
+        {
+            char material[64] = "";
+            uint32_t vertexCount = 0;
+            uint32_t faceCount = 0;
+            uint8_t normalEncoding = static_cast<uint8_t>(NormalEncoding::RGB);
+            uint8_t reserved[3] = { 0, 0, 0 };
+        };
+
+        struct MeshHeader
+        {
+            struct Stream
+            {
+                uint32_t storedSize = 0;
+                uint8_t codec = static_cast<uint8_t>(StreamCodec::None);
+                uint8_t reserved[3] = { 0, 0, 0 };
+            };
+
+            char material[64] = "";
+            uint32_t vertexCount = 0;
+            uint32_t faceCount = 0;
+            uint8_t normalEncoding = static_cast<uint8_t>(NormalEncoding::RGB);
+            uint8_t indexSize = 0;
+            uint8_t vertexEncoding = static_cast<uint8_t>(VertexEncoding::Float);
+            uint8_t reserved[1] = { 0 };
+            Stream streamList[StreamCount];
+
+            // Added in version 11, meshes without an index size are drawn as plain triangle lists
+            Stream indexStream;
+
+            // Added in version 12, quantized positions are fractions of a uniform cube placed at the minimum
+            Math::Float3 positionMinimum = Math::Float3::Zero;
+            float positionScale = 1.0f;
+
+            // Added in version 13, the indices of each simplified level follow the previous level in the index stream
+            uint32_t levelCount = 0;
+            uint32_t levelIndexCountList[MaxLevelCount] = {};
+            float levelErrorList[MaxLevelCount] = {};
+
+            // Added in version 14, meshlets split the full detail indices in to ranges that are culled separately
+            uint32_t meshletCount = 0;
+            Stream meshletStream;
+        };
+
+        struct Meshlet
+        {
+            uint32_t firstIndex = 0;
+            uint32_t indexCount = 0;
+            Math::Float3 center = Math::Float3::Zero;
+            float radius = 0.0f;
+            Math::Float3 coneAxis = Math::Float3::Zero;
+            float coneCutoff = 1.0f;
+        };
+
+        // Size of each stored mesh header, later versions only ever append fields
+        inline size_t GetMeshHeaderSize(uint16_t version)
+        {
+            if (version >= CurrentVersion)
+            {
+                return sizeof(MeshHeader);
+            }
+            else if (version >= LevelVersion)
+            {
+                return offsetof(MeshHeader, meshletCount);
+            }
+            else if (version >= QuantizedVersion)
+            {
+                return offsetof(MeshHeader, levelCount);
+            }
+            else if (version >= IndexedVersion)
+            {
+                return offsetof(MeshHeader, positionMinimum);
+            }
+            else if (version >= CompressedVersion)
+            {
+                return offsetof(MeshHeader, indexStream);
+            }
+            else if (version >= UncompressedVersion)
+            {
+                return sizeof(UncompressedMeshHeader);
+            }
+
+            return sizeof(LegacyMeshHeader);
+        }
+
+        // Brings a stored mesh header of any version up to the current one, fields added since keep their defaults and
+        // the streams of versions without codecs are stored as they are
+        inline MeshHeader ReadMeshHeader(uint16_t version, uint8_t const *data)
+        {
+            MeshHeader meshHeader;
+            if (version >= CompressedVersion)
+            {
+                std::memcpy(&meshHeader, data, GetMeshHeaderSize(version));
+                return meshHeader;
+            }
+            else if (version >= UncompressedVersion)
+            {
+                UncompressedMeshHeader uncompressedMeshHeader;
+                std::memcpy(&uncompressedMeshHeader, data, sizeof(UncompressedMeshHeader));
+                std::memcpy(meshHeader.material, uncompressedMeshHeader.material, sizeof(meshHeader.material));
+                meshHeader.vertexCount = uncompressedMeshHeader.vertexCount;
+                meshHeader.faceCount = uncompressedMeshHeader.faceCount;
+                meshHeader.normalEncoding = uncompressedMeshHeader.normalEncoding;
+            }
+            else
+            {
+                LegacyMeshHeader legacyMeshHeader;
+                std::memcpy(&legacyMeshHeader, data, sizeof(LegacyMeshHeader));
+                std::memcpy(meshHeader.material, legacyMeshHeader.material, sizeof(meshHeader.material));
+                meshHeader.vertexCount = legacyMeshHeader.vertexCount;
+                meshHeader.faceCount = legacyMeshHeader.faceCount;
+                meshHeader.normalEncoding = static_cast<uint8_t>(NormalEncoding::RGB);
+            }
+
+            for (uint32_t streamIndex = 0; streamIndex < StreamCount; ++streamIndex)
+            {
+                meshHeader.streamList[streamIndex].storedSize = (meshHeader.vertexCount * StreamStrideList[0][streamIndex]);
+            }
+
+            return meshHeader;
+        }
+
+        // Keeps whichever codec stores the stream in the fewest bytes, shuffling groups the bytes of each element together
+        inline std::vector<uint8_t> EncodeStream(void const *data, size_t size, size_t elementSize, bool compress, MeshHeader::Stream &stream)
+        {
+            auto rawData = static_cast<uint8_t const *>(data);
+            std::vector<uint8_t> encodedData(rawData, (rawData + size));
+            stream.codec = static_cast<uint8_t>(StreamCodec::None);
+            if (compress && size > 0)
+            {
+                auto compressedData = Compression::Compress(data, size);
+                if (!compressedData.empty() && compressedData.size() < encodedData.size())
+                {
+                    encodedData = std::move(compressedData);
+                    stream.codec = static_cast<uint8_t>(StreamCodec::LZ4);
+                }
+
+                std::vector<uint8_t> shuffledData(size);
+                Compression::Shuffle(data, size, elementSize, shuffledData.data());
+                compressedData = Compression::Compress(shuffledData.data(), size);
+                if (!compressedData.empty() && compressedData.size() < encodedData.size())
+                {
+                    encodedData = std::move(compressedData);
+                    stream.codec = static_cast<uint8_t>(StreamCodec::ShuffledLZ4);
+                }
+            }
+
+            stream.storedSize = static_cast<uint32_t>(encodedData.size());
+            return encodedData;
+        }
+
+        // Decodes straight in to the buffer that is handed over to the device, empty if the stream is malformed
+        inline std::vector<uint8_t> DecodeStream(MeshHeader::Stream const &stream, uint8_t const *storedData, size_t size, size_t elementSize)
+        {
+            std::vector<uint8_t> buffer;
+            if (!storedData || size == 0)
+            {
+                return buffer;
+            }
+
+            switch (static_cast<StreamCodec>(stream.codec))
+            {
+            case StreamCodec::None:
+                if (stream.storedSize == size)
+                {
+                    buffer.assign(storedData, (storedData + size));
+                }
+
+                break;
+
+            case StreamCodec::LZ4:
+                buffer.resize(size);
+                if (!Compression::Decompress(storedData, stream.storedSize, buffer.data(), size))
+                {
+                    buffer.clear();
+                }
+
+                break;
+
+            case StreamCodec::ShuffledLZ4:
+                if (std::vector<uint8_t> shuffledBuffer(size); Compression::Decompress(storedData, stream.storedSize, shuffledBuffer.data(), size))
+                {
+                    buffer.resize(size);
+                    Compression::Unshuffle(shuffledBuffer.data(), size, elementSize, buffer.data());
+                }
+
+                break;
+            };
+
+            return buffer;
+        }
+    }; // namespace ModelFormat
+}; // namespace Gek
@@ -0,0 +1,92 @@
+﻿/// @file
+/// @author Todd Zupan <toddzupan@gmail.com>
+/// @version $Revision$
+/// @section LICENSE
+/// https://en.wikipedia.org/wiki/MIT_License
+/// @section DESCRIPTION
+/// Last Changed: $Date$
+#pragma once
+
+#include "API/System/RenderDevice.hpp"
+#include "GEK/Math/Matrix4x4.hpp"
+#include "GEK/Math/SIMD.hpp"
+#include "GEK/Utility/Allocator.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace Gek
+{
+    namespace Meshlets
+    {
+        // Bounding spheres and normal cones of the meshlets in the layout of the SIMD culling, centers, radii, cone axes
+        // and cone cutoffs, padded with zeroed meshlets
+        struct List
+        {
+            std::vector<float, AlignedAllocator<float, 16>> elementList[8];
+            std::vector<uint32_t> firstIndexList;
+            std::vector<uint32_t> indexCountList;
+        };
+
+        struct IndexRange
+        {
+            uint32_t firstIndex = 0;
+            uint32_t indexCount = 0;
+        };
+
+        enum class Culling : uint8_t
+        {
+            Frustum = 0,
+            Backface,
+        };
+
+        // The normal cones only hold for back faces that are actually culled, seen from a single point of view with
+        // the winding the mesh was built with.  Anything else, two sided or front culled materials, orthographic
+        // views and mirrored instances, keeps every meshlet that is inside the frustum.
+        inline Culling GetCulling(Render::RenderState::CullMode cullMode, Math::Float4x4 const &modelViewMatrix, Math::Float4x4 const &projectionMatrix)
+        {
+            const bool perspective = (projectionMatrix._44 == 0.0f);
+            const bool mirrored = (modelViewMatrix.getDeterminant() <= 0.0f);
+            return ((cullMode == Render::RenderState::CullMode::Back && perspective && !mirrored) ? Culling::Backface : Culling::Frustum);
+        }
+
+        // Culls every meshlet against the model space frustum, and the view position when back faces are culled, the
+        // meshlets that are left are merged in to as few index ranges as their order allows.  Returns the number of
+        // meshlets culled.
+        inline uint32_t Cull(List const &meshletList, Culling culling, Math::SIMD::Frustum const &frustum, Math::Float3 const &viewPosition, std::vector<uint8_t> &visibilityList, std::vector<IndexRange> &rangeList)
+        {
+            const size_t meshletCount = meshletList.firstIndexList.size();
+            visibilityList.resize(meshletList.elementList[0].size());
+            if (culling == Culling::Backface)
+            {
+                Math::SIMD::cullClusters(frustum, viewPosition, visibilityList.size(), meshletList.elementList, visibilityList);
+            }
+            else
+            {
+                Math::SIMD::cullSpheres(frustum, visibilityList.size(), meshletList.elementList[0], meshletList.elementList[1], meshletList.elementList[2], meshletList.elementList[3], visibilityList);
+            }
+
+            uint32_t culledCount = 0;
+            for (size_t meshletIndex = 0; meshletIndex < meshletCount; ++meshletIndex)
+            {
+                if (!visibilityList[meshletIndex])
+                {
+                    ++culledCount;
+                    continue;
+                }
+
+                auto firstIndex = meshletList.firstIndexList[meshletIndex];
+                auto indexCount = meshletList.indexCountList[meshletIndex];
+                if (!rangeList.empty() && ((rangeList.back().firstIndex + rangeList.back().indexCount) == firstIndex))
+                {
+                    rangeList.back().indexCount += indexCount;
+                }
+                else
+                {
+                    rangeList.push_back({ firstIndex, indexCount });
+                }
+            }
+
+            return culledCount;
+        }
+    }; // namespace Meshlets
+}; // namespace Gek
@@ -12,21 +12,34 @@
 #include "GEK/Math/Matrix4x4.hpp"
 #include "GEK/Math/SIMD.hpp"
 #include "GEK/Model/Base.hpp"
+#include "GEK/Model/Format.hpp"
+#include "GEK/Model/Meshlets.hpp"
 #include "GEK/Shapes/AlignedBox.hpp"
+#include "GEK/Shapes/BoundingVolumeHierarchy.hpp"
+#include "GEK/Shapes/Frustum.hpp"
+#include "GEK/Shapes/OcclusionBuffer.hpp"
 #include "GEK/Utility/Allocator.hpp"
+#include "GEK/Utility/Compression.hpp"
 #include "GEK/Utility/ContextUser.hpp"
+#include "GEK/Utility/FileReader.hpp"
 #include "GEK/Utility/FileSystem.hpp"
 #include "GEK/Utility/JSON.hpp"
+#include "GEK/Utility/Profiler.hpp"
 #include "GEK/Utility/String.hpp"
 #include "GEK/Utility/ThreadPool.hpp"
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstring>
 #include <execution>
 #include <future>
 #include <memory>
 #include <mutex>
+#include <limits>
+#include <tbb/concurrent_queue.h>
 #include <tbb/concurrent_unordered_map.h>
 #include <tbb/concurrent_vector.h>
+#include <tbb/parallel_for.h>
 #include <unordered_set>
 #include <xmmintrin.h>
 
@@ -44,22 +57,30 @@ namespace Gek
         }
     }
 
+    // Blocks point straight into the file view, nothing is copied until the buffers are created
     class Unpacker
     {
       private:
-        uint8_t *buffer;
+        FileSystem::FileView view;
+        size_t offset = 0;
 
       public:
-        Unpacker(uint8_t *buffer)
-            : buffer(buffer)
+        Unpacker(FileSystem::FileView const &view)
+            : view(view)
         {
         }
 
         template <typename TYPE>
         TYPE const *readBlock(size_t count)
         {
-            TYPE *data = reinterpret_cast<TYPE *>(buffer);
-            buffer += (sizeof(TYPE) * count);
+            const size_t blockSize = (sizeof(TYPE) * count);
+            if ((offset + blockSize) > view.getSize())
+            {
+                return nullptr;
+            }
+
+            auto data = reinterpret_cast<TYPE const *>(view.getData() + offset);
+            offset += blockSize;
             return data;
         }
     };
@@ -88,6 +109,17 @@ namespace Gek
             data->name = evaluate(importData, String::Empty);
         }
 
+        void cook(Components::Model const *const data, std::vector<uint8_t> &buffer) const
+        {
+            cookValue(buffer, data->name);
+        }
+
+        uint8_t const *uncook(Components::Model *const data, uint8_t const *buffer, uint8_t const *bufferEnd)
+        {
+            buffer = uncookValue(buffer, bufferEnd, data->name);
+            return buffer;
+        }
+
         // Edit::Component
         bool onUserInterface(ImGuiContext *const guiContext, Plugin::Entity *const entity, Plugin::Component::Data *data)
         {
@@ -256,66 +288,43 @@ namespace Gek
         }
     };
 
-    GEK_CONTEXT_USER(ModelProcessor, Plugin::Core *)
-    , public Plugin::EntityProcessor<ModelProcessor, Components::Model, Components::Transform>, public Gek::Processor::Model
+    GEK_CONTEXT_USER(Occluder, Plugin::Population *)
+    , public Plugin::ComponentMixin<Components::Occluder>
     {
       public:
-        enum class NormalEncoding : uint8_t
-        {
-            RG = 0,
-            RGB = 1,
-        };
-
-        static constexpr uint16_t LegacyModelVersion = 8;
-        static constexpr uint16_t CurrentModelVersion = 9;
-
-        struct FileHeader
+        Occluder(Context * context, Plugin::Population * population)
+            : ContextRegistration(context), ComponentMixin(population)
         {
-            uint32_t identifier = 0;
-            uint16_t type = 0;
-            uint16_t version = 0;
-
-            Shapes::AlignedBox boundingBox;
+        }
+    };
 
-            uint32_t meshCount = 0;
-        };
+    GEK_CONTEXT_USER(ModelProcessor, Plugin::Core *)
+    , public Plugin::EntityProcessor<ModelProcessor, Components::Model, Components::Transform>, public Gek::Processor::Model
+    {
+      public:
+        using NormalEncoding = ModelFormat::NormalEncoding;
+        using StreamCodec = ModelFormat::StreamCodec;
+        using VertexEncoding = ModelFormat::VertexEncoding;
 
-        struct LegacyMeshHeader
-        {
-            char material[64] = "";
-            uint32_t vertexCount = 0;
-            uint32_t faceCount = 0;
-        };
+        static constexpr size_t VertexEncodingCount = ModelFormat::VertexEncodingCount;
+        static constexpr uint32_t StreamCount = ModelFormat::StreamCount;
+        static constexpr uint32_t MaxLevelCount = ModelFormat::MaxLevelCount;
 
-        struct Header
-        {
-            struct Mesh
-            {
-                char material[64];
-                uint32_t vertexCount = 0;
-                uint32_t faceCount = 0;
-                uint8_t normalEncoding = static_cast<uint8_t>(NormalEncoding::RGB);
-                uint8_t reserved[3] = { 0, 0, 0 };
-            };
+        // Each encoding is drawn through the visual with the matching input layout
+        static constexpr std::array<std::string_view, VertexEncodingCount> VisualNameList = { "Model", "ModelQuantized" };
 
-            uint32_t identifier = 0;
-            uint16_t type = 0;
-            uint16_t version = 0;
+        static constexpr std::array<std::string_view, StreamCount> StreamNameList = { "positions", "texcoords", "tangents", "normals" };
 
-            Shapes::AlignedBox boundingBox;
+        // Simplified levels stored after the full detail mesh, an instance switches to the next level once that level's
+        // error projects under the screen error and back as soon as its own error projects over it
+        static constexpr float LevelScreenError = (2.0f / 1080.0f);
+        static constexpr float LevelHysteresis = 0.75f;
 
-            uint32_t meshCount = 0;
-            Mesh meshList[1];
-        };
+        // Each camera steps from the level it drew last, cameras beyond this many share slots and lose their hysteresis
+        static constexpr uint32_t LevelViewCount = 4;
 
-        struct Face
-        {
-            uint16_t data[3];
-            uint16_t &operator[](size_t index)
-            {
-                return data[index];
-            }
-        };
+        using MeshletList = Meshlets::List;
+        using IndexRange = Meshlets::IndexRange;
 
         struct Group
         {
@@ -326,12 +335,39 @@ namespace Gek
                     MaterialHandle material;
                     std::vector<ResourceHandle> vertexBufferList = std::vector<ResourceHandle>(4);
                     ResourceHandle indexBuffer;
+                    uint32_t firstIndex = 0;
                     uint32_t indexCount = 0;
                     uint32_t vertexCount = 0;
+                    VertexEncoding vertexEncoding = VertexEncoding::Float;
+
+                    // Expands quantized positions back in to model space, applied ahead of each instance transform
+                    Math::Float4x4 positionMatrix = Math::Float4x4::Identity;
+
+                    // Bounds are in model space, only the full detail meshes have meshlets
+                    std::shared_ptr<MeshletList const> meshletList;
+                };
+
+                // Shares the buffers of the full detail meshes and only draws a different range of their indices
+                struct Level
+                {
+                    float error = 0.0f;
+                    std::vector<Mesh> meshList;
                 };
 
                 Shapes::AlignedBox boundingBox;
                 std::vector<Mesh> meshList;
+                std::vector<Level> levelList;
+
+                // Model space error of the level, the full detail meshes are level zero
+                float getLevelError(size_t level) const
+                {
+                    return (level == 0 ? 0.0f : levelList[level - 1].error);
+                }
+
+                std::vector<Mesh> const &getLevelMeshList(size_t level) const
+                {
+                    return (level == 0 ? meshList : levelList[level - 1].meshList);
+                }
             };
 
             std::vector<Model> modelList;
@@ -339,9 +375,175 @@ namespace Gek
             std::atomic_bool ready = false;
         };
 
+        static constexpr uint32_t InvalidCullSlot = std::numeric_limits<uint32_t>::max();
+
         struct Data
         {
             std::shared_ptr<Group> group;
+            uint32_t cullSlot = InvalidCullSlot;
+            bool occluder = false;
+        };
+
+        // Persistent structure of arrays fed to the SIMD culling, objects keep their slot until they are removed and
+        // unused slots are left zeroed so that the culling always rejects them
+        struct CullList
+        {
+            std::vector<float, AlignedAllocator<float, 16>> halfSizeXList;
+            std::vector<float, AlignedAllocator<float, 16>> halfSizeYList;
+            std::vector<float, AlignedAllocator<float, 16>> halfSizeZList;
+            std::vector<float, AlignedAllocator<float, 16>> transformList[16];
+            std::vector<uint8_t> visibilityList;
+            std::unordered_map<uint32_t, std::vector<uint32_t>> freeSlotMap;
+            uint32_t slotCount = 0;
+
+            size_t getPaddedCount(void) const
+            {
+                return halfSizeXList.size();
+            }
+
+            // Returns the first of count consecutive slots, freed ranges are only reused by ranges of the same size
+            uint32_t allocate(uint32_t count)
+            {
+                auto &freeSlotList = freeSlotMap[count];
+                if (!freeSlotList.empty())
+                {
+                    auto slot = freeSlotList.back();
+                    freeSlotList.pop_back();
+                    return slot;
+                }
+
+                return append(count);
+            }
+
+            uint32_t append(uint32_t count)
+            {
+                auto slot = slotCount;
+                slotCount += count;
+                if (slotCount > getPaddedCount())
+                {
+                    auto paddedCount = std::max(Math::SIMD::GetPaddedCount(slotCount), (getPaddedCount() * 2));
+                    halfSizeXList.resize(paddedCount);
+                    halfSizeYList.resize(paddedCount);
+                    halfSizeZList.resize(paddedCount);
+                    for (auto &elementList : transformList)
+                    {
+                        elementList.resize(paddedCount);
+                    }
+
+                    visibilityList.resize(paddedCount);
+                }
+
+                return slot;
+            }
+
+            void release(uint32_t slot, uint32_t count)
+            {
+                for (uint32_t index = slot; index < (slot + count); ++index)
+                {
+                    reset(index);
+                }
+
+                freeSlotMap[count].push_back(slot);
+            }
+
+            void reset(uint32_t slot)
+            {
+                halfSizeXList[slot] = 0.0f;
+                halfSizeYList[slot] = 0.0f;
+                halfSizeZList[slot] = 0.0f;
+                for (auto &elementList : transformList)
+                {
+                    elementList[slot] = 0.0f;
+                }
+
+                visibilityList[slot] = 0;
+            }
+
+            void copy(uint32_t slot, CullList const &source, uint32_t sourceSlot)
+            {
+                halfSizeXList[slot] = source.halfSizeXList[sourceSlot];
+                halfSizeYList[slot] = source.halfSizeYList[sourceSlot];
+                halfSizeZList[slot] = source.halfSizeZList[sourceSlot];
+                for (size_t element = 0; element < 16; ++element)
+                {
+                    transformList[element][slot] = source.transformList[element][sourceSlot];
+                }
+            }
+
+            void set(uint32_t slot, Math::Float3 const &halfSize, Math::Float4x4 const &matrix)
+            {
+                halfSizeXList[slot] = halfSize.x;
+                halfSizeYList[slot] = halfSize.y;
+                halfSizeZList[slot] = halfSize.z;
+                for (size_t element = 0; element < 16; ++element)
+                {
+                    transformList[element][slot] = matrix.data[element];
+                }
+            }
+
+            void clear(void)
+            {
+                halfSizeXList.clear();
+                halfSizeYList.clear();
+                halfSizeZList.clear();
+                for (auto &elementList : transformList)
+                {
+                    elementList.clear();
+                }
+
+                visibilityList.clear();
+                freeSlotMap.clear();
+                slotCount = 0;
+            }
+
+            void cull(Math::Float4x4 const &viewMatrix, Math::Float4x4 const &projectionMatrix)
+            {
+                Math::SIMD::cullOrientedBoundingBoxes(viewMatrix, projectionMatrix, getPaddedCount(), halfSizeXList, halfSizeYList, halfSizeZList, transformList, visibilityList);
+            }
+        };
+
+        // Render state of an entity cull slot, models only get slots of their own when the group has more than one
+        struct EntitySlot
+        {
+            Group const *group = nullptr;
+            uint32_t transformVersion = 0;
+            uint32_t modelSlot = 0;
+            uint32_t modelSlotCount = 0;
+            uint32_t proxy = Shapes::BoundingVolumeHierarchy::InvalidProxy;
+            bool occluder = false;
+            Shapes::AlignedBox bounds;
+            Math::Float4x4 matrix = Math::Float4x4::Identity;
+            std::vector<uint8_t> levelList;
+
+            uint8_t &getLevel(uint32_t modelIndex, uint32_t levelView)
+            {
+                return levelList[(modelIndex * LevelViewCount) + levelView];
+            }
+        };
+
+        // Entity slot that passed the spatial index, modelCandidate is where its models were copied for the oriented
+        // box test or InvalidCullSlot when the entity is entirely inside the frustum
+        struct CandidateSlot
+        {
+            uint32_t slot = 0;
+            uint32_t modelCandidate = InvalidCullSlot;
+        };
+
+        // Entities whose cull slots have to be (re)assigned, gathered in parallel and applied serially afterwards
+        struct PendingSlot
+        {
+            uint32_t slot = 0;
+            Group const *group = nullptr;
+            uint32_t transformVersion = 0;
+            Math::Float4x4 matrix;
+            Math::Float3 scale;
+        };
+
+        // Instance whose meshlets were culled, only the ranges of the meshlets that are left get drawn
+        struct MeshletInstance
+        {
+            Math::Float4x4 matrix;
+            std::vector<IndexRange> rangeList;
         };
 
         struct DrawData
@@ -349,9 +551,10 @@ namespace Gek
             uint32_t instanceStart = 0;
             uint32_t instanceCount = 0;
             const Group::Model::Mesh *data = nullptr;
+            std::vector<IndexRange> rangeList;
 
-            DrawData(uint32_t instanceStart = 0, uint32_t instanceCount = 0, Group::Model::Mesh const *data = nullptr)
-                : instanceStart(instanceStart), instanceCount(instanceCount), data(data)
+            DrawData(uint32_t instanceStart = 0, uint32_t instanceCount = 0, Group::Model::Mesh const *data = nullptr, std::vector<IndexRange> &&rangeList = {})
+                : instanceStart(instanceStart), instanceCount(instanceCount), data(data), rangeList(std::move(rangeList))
             {
             }
         };
@@ -364,29 +567,78 @@ namespace Gek
         Plugin::Visualizer *renderer = nullptr;
         Edit::Events *events = nullptr;
 
-        VisualHandle visual;
+        std::array<VisualHandle, VertexEncodingCount> visualList;
         std::vector<Render::BufferPtr> instanceBufferPool;
         // Keep instance buffers alive for 3 frames to avoid freeing them while the GPU
         // is still executing commands that reference them.
         static constexpr size_t kInstanceBufferFrameSlots = 3;
         std::array<std::vector<Render::BufferPtr>, kInstanceBufferFrameSlots> instanceBufferRetireSlots;
         size_t instanceBufferRetireIndex = 0;
-        ThreadPool loadPool;
+        ThreadPool *threadPool = nullptr;
+        FileReader *fileReader = nullptr;
+        TaskGroup loadTaskGroup;
 
         tbb::concurrent_unordered_map<std::size_t, std::shared_ptr<Group>> groupMap;
 
-        std::vector<float, AlignedAllocator<float, 16>> halfSizeXList;
-        std::vector<float, AlignedAllocator<float, 16>> halfSizeYList;
-        std::vector<float, AlignedAllocator<float, 16>> halfSizeZList;
-        std::vector<float, AlignedAllocator<float, 16>> transformList[16];
-        std::vector<bool> visibilityList;
+        // Slots are assigned with the entry list locked, everything else is only touched while rendering
+        std::mutex cullMutex;
+        Shapes::BoundingVolumeHierarchy *spatialIndex = nullptr;
+        CullList entityCullList;
+        CullList modelCullList;
+        std::vector<EntitySlot> entitySlotList;
+        tbb::concurrent_vector<PendingSlot> pendingSlotList;
+
+        // Cameras that own a column of every entity's level list, the least recently drawn one is handed on
+        struct LevelView
+        {
+            Hash camera = 0;
+            uint64_t drawCounter = 0;
+        };
+
+        std::array<LevelView, LevelViewCount> levelViewList;
+        tbb::concurrent_vector<uint32_t> movedSlotList;
+
+        // Scratch lists for the entities the spatial index could not fully accept
+        CullList candidateCullList;
+        CullList candidateModelCullList;
+        std::vector<CandidateSlot> candidateSlotList;
+        std::vector<CandidateSlot> visibleSlotList;
 
-        using EntityDataList = tbb::concurrent_vector<std::tuple<Plugin::Entity *const, Data const *, uint32_t>>;
-        using EntityModelList = tbb::concurrent_vector<std::tuple<Plugin::Entity *const, Group::Model const *, uint32_t>>;
-        EntityDataList entityDataList;
-        EntityModelList entityModelList;
+        // Frustum visible occluders are rasterized on the CPU, everything visible is then tested against them
+        Shapes::OcclusionBuffer occlusionBuffer;
+        std::vector<uint8_t> occludedList;
+        tbb::concurrent_queue<uint32_t> releasedSlotQueue;
+        uint64_t cullFrameIndex = std::numeric_limits<uint64_t>::max();
+        uint32_t cullEntityCount = 0;
+        uint32_t cullModelCount = 0;
+
+        struct MetricHandles
+        {
+            Metrics::Handle frame;
+            Metrics::Handle entities;
+            Metrics::Handle testedEntities;
+            Metrics::Handle visibleEntities;
+            Metrics::Handle occluders;
+            Metrics::Handle occlusionTested;
+            Metrics::Handle occlusionCulled;
+            Metrics::Handle models;
+            Metrics::Handle visibleModels;
+            Metrics::Handle simplifiedModels;
+            Metrics::Handle culledMeshlets;
+            Metrics::Handle queuedBatches;
+        } metricHandles;
+
+        struct InstanceList
+        {
+            tbb::concurrent_vector<Math::Float4x4> matrixList;
+            tbb::concurrent_vector<MeshletInstance> meshletInstanceList;
+
+            size_t size(void) const
+            {
+                return (matrixList.size() + meshletInstanceList.size());
+            }
+        };
 
-        using InstanceList = tbb::concurrent_vector<Math::Float4x4>;
         using MeshInstanceMap = tbb::concurrent_unordered_map<const Group::Model::Mesh *, InstanceList>;
         using MaterialMeshMap = tbb::concurrent_unordered_map<MaterialHandle, MeshInstanceMap>;
         MaterialMeshMap renderList;
@@ -398,7 +650,7 @@ namespace Gek
 
       public:
         ModelProcessor(Context * context, Plugin::Core * core)
-            : ContextRegistration(context), core(core), videoDevice(core->getVisualizer()->getRenderDevice()), population(core->getPopulation()), resources(core->getResources()), renderer(core->getVisualizer()), loadPool(5)
+            : ContextRegistration(context), EntityProcessor(core->getPopulation()), core(core), videoDevice(core->getVisualizer()->getRenderDevice()), population(core->getPopulation()), resources(core->getResources()), renderer(core->getVisualizer()), threadPool(core->getThreadPool()), fileReader(core->getFileReader()), spatialIndex(&core->getPopulation()->getSpatialIndex(Plugin::Population::SpatialLayer::Models))
         {
             assert(core);
             assert(videoDevice);
@@ -408,10 +660,25 @@ namespace Gek
 
             getContext()->log(Context::Info, "Initializing model system");
 
+            auto &metrics = getContext()->getRuntimeMetrics();
+            metricHandles.frame = metrics.getHandle("model.frame");
+            metricHandles.entities = metrics.getHandle("model.entities");
+            metricHandles.testedEntities = metrics.getHandle("model.testedEntities");
+            metricHandles.visibleEntities = metrics.getHandle("model.visibleEntities");
+            metricHandles.occluders = metrics.getHandle("model.occluders");
+            metricHandles.occlusionTested = metrics.getHandle("model.occlusionTested");
+            metricHandles.occlusionCulled = metrics.getHandle("model.occlusionCulled");
+            metricHandles.models = metrics.getHandle("model.models");
+            metricHandles.visibleModels = metrics.getHandle("model.visibleModels");
+            metricHandles.simplifiedModels = metrics.getHandle("model.simplifiedModels");
+            metricHandles.culledMeshlets = metrics.getHandle("model.culledMeshlets");
+            metricHandles.queuedBatches = metrics.getHandle("model.queuedBatches");
+
             core->onInitialized.connect(this, &ModelProcessor::onInitialized);
             core->onShutdown.connect(this, &ModelProcessor::onShutdown);
             population->onReset.connect(this, &ModelProcessor::onReset);
             population->onEntityCreated.connect(this, &ModelProcessor::onEntityCreated);
+            population->onEntityListCreated.connect(this, &ModelProcessor::onEntityListCreated);
             population->onEntityDestroyed.connect(this, &ModelProcessor::onEntityDestroyed);
             population->onComponentAdded.connect(this, &ModelProcessor::onComponentAdded);
             population->onComponentRemoved.connect(this, &ModelProcessor::onComponentRemoved);
@@ -421,17 +688,20 @@ namespace Gek
             population->listEntities([this](Plugin::Entity *const entity) -> void
                                      { addEntity(entity); });
 
-            visual = resources->loadVisual("model");
+            for (size_t encodingIndex = 0; encodingIndex < VertexEncodingCount; ++encodingIndex)
+            {
+                visualList[encodingIndex] = resources->loadVisual(VisualNameList[encodingIndex]);
+            }
         }
 
-        void scheduleLoadMesh(Header::Mesh & meshHeader, Group::Model::Mesh & mesh, uint32_t meshIndex, std::string fileName, std::string name, uint8_t *meshBuffer, std::shared_ptr<std::vector<uint8_t>> buffer)
+        void scheduleLoadMesh(ModelFormat::MeshHeader const &meshHeader, Group::Model::Mesh & mesh, uint32_t meshIndex, std::string fileName, std::string name, FileSystem::FileView meshView)
         {
             if (shuttingDown)
             {
                 return;
             }
 
-            Unpacker unpacker(meshBuffer);
+            Unpacker unpacker(meshView);
             mesh.material = resources->loadMaterial(meshHeader.material);
             auto normalEncoding = static_cast<NormalEncoding>(meshHeader.normalEncoding);
             if ((normalEncoding != NormalEncoding::RG) && (normalEncoding != NormalEncoding::RGB))
@@ -469,7 +739,19 @@ namespace Gek
                 mesh.material = resources->loadMaterial("debug");
             }
             mesh.vertexCount = meshHeader.vertexCount;
-            mesh.indexCount = (meshHeader.faceCount * 3);
+            mesh.indexCount = 0;
+            if (meshHeader.vertexEncoding >= VertexEncodingCount)
+            {
+                getContext()->log(Context::Error, "Unknown vertex encoding {} of mesh {} from '{}' in group '{}'", meshHeader.vertexEncoding, meshIndex, fileName, name);
+                mesh.vertexCount = 0;
+                return;
+            }
+
+            mesh.vertexEncoding = static_cast<VertexEncoding>(meshHeader.vertexEncoding);
+            if (mesh.vertexEncoding == VertexEncoding::Quantized)
+            {
+                mesh.positionMatrix = Math::Float4x4::MakeScaling(Math::Float3(meshHeader.positionScale), meshHeader.positionMinimum);
+            }
 
             if (mesh.vertexCount == 0)
             {
@@ -482,33 +764,123 @@ namespace Gek
                 return;
             }
 
-            // Render::Buffer::Description indexBufferDescription;
-            // indexBufferDescription.format = Render::Format::R16_UINT;
-            // indexBufferDescription.count = (meshHeader.faceCount * 3);
-            // indexBufferDescription.type = Render::Buffer::Type::Index;
-            // mesh.indexBuffer = resources->createBuffer(std::format("model:{}.{}.{}:indices", meshIndex, fileName, name), indexBufferDescription, unpacker.readBlock<Face>(meshHeader.faceCount));
-
             Render::Buffer::Description vertexBufferDescription;
-            vertexBufferDescription.name = std::format("model:{}.{}.{}:positions", meshIndex, fileName, name);
-            vertexBufferDescription.stride = sizeof(Math::Float3);
             vertexBufferDescription.count = meshHeader.vertexCount;
             vertexBufferDescription.type = Render::Buffer::Type::Vertex;
-            mesh.vertexBufferList[0] = resources->createBuffer(vertexBufferDescription, unpacker.readBlock<Math::Float3>(meshHeader.vertexCount), Plugin::Resources::Flags::Immediate);
+            for (uint32_t streamIndex = 0; streamIndex < StreamCount; ++streamIndex)
+            {
+                auto const &stream = meshHeader.streamList[streamIndex];
+                const uint32_t streamStride = ModelFormat::StreamStrideList[meshHeader.vertexEncoding][streamIndex];
+                const size_t streamSize = (size_t(meshHeader.vertexCount) * streamStride);
+                auto streamData = ModelFormat::DecodeStream(stream, unpacker.readBlock<uint8_t>(stream.storedSize), streamSize, ModelFormat::StreamElementSizeList[meshHeader.vertexEncoding]);
+                if (streamData.empty())
+                {
+                    getContext()->log(Context::Error, "Unable to decode {} of mesh {} from '{}' in group '{}'", StreamNameList[streamIndex], meshIndex, fileName, name);
+                    mesh.vertexCount = 0;
+                    return;
+                }
+
+                vertexBufferDescription.name = std::format("model:{}.{}.{}:{}", meshIndex, fileName, name, StreamNameList[streamIndex]);
+                vertexBufferDescription.stride = streamStride;
+                mesh.vertexBufferList[streamIndex] = resources->createBuffer(vertexBufferDescription, std::move(streamData), Plugin::Resources::Flags::Immediate);
+            }
 
-            vertexBufferDescription.stride = sizeof(Math::Float2);
-            vertexBufferDescription.name = std::format("model:{}.{}.{}:texcoords", meshIndex, fileName, name);
-            mesh.vertexBufferList[1] = resources->createBuffer(vertexBufferDescription, unpacker.readBlock<Math::Float2>(meshHeader.vertexCount), Plugin::Resources::Flags::Immediate);
+            if ((meshHeader.indexSize != 0) && (meshHeader.faceCount > 0))
+            {
+                uint32_t indexCount = (meshHeader.faceCount * 3);
+                for (uint32_t level = 0; level < meshHeader.levelCount; ++level)
+                {
+                    indexCount += meshHeader.levelIndexCountList[level];
+                }
 
-            vertexBufferDescription.stride = sizeof(Math::Float4);
-            vertexBufferDescription.name = std::format("model:{}.{}.{}:tangents", meshIndex, fileName, name);
-            mesh.vertexBufferList[2] = resources->createBuffer(vertexBufferDescription, unpacker.readBlock<Math::Float4>(meshHeader.vertexCount), Plugin::Resources::Flags::Immediate);
+                auto indexData = ModelFormat::DecodeStream(meshHeader.indexStream, unpacker.readBlock<uint8_t>(meshHeader.indexStream.storedSize), (size_t(indexCount) * meshHeader.indexSize), meshHeader.indexSize);
+                if (indexData.empty())
+                {
+                    getContext()->log(Context::Error, "Unable to decode indices of mesh {} from '{}' in group '{}'", meshIndex, fileName, name);
+                    mesh.vertexCount = 0;
+                    return;
+                }
 
-            vertexBufferDescription.stride = sizeof(Math::Float3);
-            vertexBufferDescription.name = std::format("model:{}.{}.{}:normals", meshIndex, fileName, name);
-            mesh.vertexBufferList[3] = resources->createBuffer(vertexBufferDescription, unpacker.readBlock<Math::Float3>(meshHeader.vertexCount), Plugin::Resources::Flags::Immediate);
+                Render::Buffer::Description indexBufferDescription;
+                indexBufferDescription.name = std::format("model:{}.{}.{}:indices", meshIndex, fileName, name);
+                indexBufferDescription.format = ((meshHeader.indexSize == sizeof(uint16_t)) ? Render::Format::R16_UINT : Render::Format::R32_UINT);
+                indexBufferDescription.count = indexCount;
+                indexBufferDescription.type = Render::Buffer::Type::Index;
+                mesh.indexBuffer = resources->createBuffer(indexBufferDescription, std::move(indexData), Plugin::Resources::Flags::Immediate);
+                mesh.indexCount = (meshHeader.faceCount * 3);
+                if (meshHeader.meshletCount > 0)
+                {
+                    mesh.meshletList = LoadMeshlets(meshHeader, unpacker.readBlock<uint8_t>(meshHeader.meshletStream.storedSize));
+                    if (!mesh.meshletList)
+                    {
+                        getContext()->log(Context::Warning, "Unable to decode meshlets of mesh {} from '{}' in group '{}', drawing it whole", meshIndex, fileName, name);
+                    }
+                }
+            }
+        }
+
+        static std::shared_ptr<MeshletList const> LoadMeshlets(ModelFormat::MeshHeader const &meshHeader, uint8_t const *storedData)
+        {
+            auto meshletData = ModelFormat::DecodeStream(meshHeader.meshletStream, storedData, (sizeof(ModelFormat::Meshlet) * meshHeader.meshletCount), sizeof(float));
+            if (meshletData.empty())
+            {
+                return nullptr;
+            }
+
+            auto meshletList = std::make_shared<MeshletList>();
+            const size_t paddedCount = Math::SIMD::GetPaddedCount(meshHeader.meshletCount);
+            for (auto &elementList : meshletList->elementList)
+            {
+                elementList.resize(paddedCount, 0.0f);
+            }
+
+            for (uint32_t meshletIndex = 0; meshletIndex < meshHeader.meshletCount; ++meshletIndex)
+            {
+                ModelFormat::Meshlet meshlet;
+                std::memcpy(&meshlet, (meshletData.data() + (sizeof(ModelFormat::Meshlet) * meshletIndex)), sizeof(ModelFormat::Meshlet));
+                if ((meshlet.firstIndex > (meshHeader.faceCount * 3)) || (meshlet.indexCount > ((meshHeader.faceCount * 3) - meshlet.firstIndex)))
+                {
+                    return nullptr;
+                }
+
+                meshletList->firstIndexList.push_back(meshlet.firstIndex);
+                meshletList->indexCountList.push_back(meshlet.indexCount);
+                meshletList->elementList[0][meshletIndex] = meshlet.center.x;
+                meshletList->elementList[1][meshletIndex] = meshlet.center.y;
+                meshletList->elementList[2][meshletIndex] = meshlet.center.z;
+                meshletList->elementList[3][meshletIndex] = meshlet.radius;
+                meshletList->elementList[4][meshletIndex] = meshlet.coneAxis.x;
+                meshletList->elementList[5][meshletIndex] = meshlet.coneAxis.y;
+                meshletList->elementList[6][meshletIndex] = meshlet.coneAxis.z;
+                meshletList->elementList[7][meshletIndex] = meshlet.coneCutoff;
+            }
+
+            return meshletList;
+        }
+
+        // Meshes with fewer levels than the rest of their model keep drawing their coarsest level
+        static void FinishLevels(Group::Model &model)
+        {
+            for (size_t level = 0; level < model.levelList.size(); ++level)
+            {
+                auto &levelMeshList = model.levelList[level].meshList;
+                levelMeshList.resize(model.meshList.size());
+                for (size_t meshIndex = 0; meshIndex < model.meshList.size(); ++meshIndex)
+                {
+                    auto &levelMesh = levelMeshList[meshIndex];
+                    auto const &previousMesh = model.getLevelMeshList(level)[meshIndex];
+                    auto firstIndex = (levelMesh.indexCount > 0 ? levelMesh.firstIndex : previousMesh.firstIndex);
+                    auto indexCount = (levelMesh.indexCount > 0 ? levelMesh.indexCount : previousMesh.indexCount);
+                    levelMesh = model.meshList[meshIndex];
+                    levelMesh.firstIndex = firstIndex;
+                    levelMesh.indexCount = indexCount;
+                    levelMesh.meshletList.reset();
+                }
+            }
         }
 
-        void scheduleLoadData(std::string name, FileSystem::Path filePath, ModelProcessor::Group & group, ModelProcessor::Group::Model & model)
+        // Each mesh is decoded by its own task on the load pool, the tasks are added to the list for the caller to await
+        void scheduleLoadData(std::string name, FileSystem::Path filePath, FileSystem::FileView const &fileView, ModelProcessor::Group & group, ModelProcessor::Group::Model & model, std::vector<Task<>> & meshTaskList)
         {
             if (shuttingDown)
             {
@@ -516,31 +888,28 @@ namespace Gek
             }
 
             auto fileName(filePath.getFileName());
-
-            std::shared_ptr<std::vector<uint8_t>> buffer = std::make_shared<std::vector<uint8_t>>(FileSystem::Load(filePath));
-
-            if (buffer->size() < sizeof(FileHeader))
+            if (fileView.getSize() < sizeof(ModelFormat::FileHeader))
             {
                 getContext()->log(Context::Error, "Model file too small to contain header: {}", filePath.getString());
                 return;
             }
 
-            FileHeader *header = reinterpret_cast<FileHeader *>(buffer->data());
-            if ((header->version != LegacyModelVersion) && (header->version != CurrentModelVersion))
+            auto header = reinterpret_cast<ModelFormat::FileHeader const *>(fileView.getData());
+            if (!ModelFormat::IsSupportedVersion(header->version))
             {
                 getContext()->log(
                     Context::Error,
-                    "Unsupported model version encountered (requires: {} or {}, has {}): {}",
-                    LegacyModelVersion,
-                    CurrentModelVersion,
+                    "Unsupported model version encountered (requires: {} to {}, has {}): {}",
+                    ModelFormat::LegacyVersion,
+                    ModelFormat::CurrentVersion,
                     header->version,
                     filePath.getString());
                 return;
             }
 
-            const size_t meshHeaderSize = (header->version >= CurrentModelVersion) ? sizeof(Header::Mesh) : sizeof(LegacyMeshHeader);
-            const size_t requiredHeaderSize = sizeof(FileHeader) + (meshHeaderSize * header->meshCount);
-            if (buffer->size() < requiredHeaderSize)
+            const size_t meshHeaderSize = ModelFormat::GetMeshHeaderSize(header->version);
+            const size_t requiredHeaderSize = sizeof(ModelFormat::FileHeader) + (meshHeaderSize * header->meshCount);
+            if (fileView.getSize() < requiredHeaderSize)
             {
                 getContext()->log(Context::Error, "Model file too small to contain mesh headers: {}", filePath.getString());
                 return;
@@ -552,43 +921,72 @@ namespace Gek
             group.boundingBox.extend(model.boundingBox.minimum);
             group.boundingBox.extend(model.boundingBox.maximum);
             model.meshList.resize(header->meshCount);
-            uint8_t *meshHeaderBuffer = buffer->data() + sizeof(FileHeader);
-            uint8_t *meshBuffer = meshHeaderBuffer + (meshHeaderSize * header->meshCount);
+            uint8_t const *meshHeaderBuffer = fileView.getData() + sizeof(ModelFormat::FileHeader);
+            size_t meshOffset = requiredHeaderSize;
             for (uint32_t meshIndex = 0; meshIndex < header->meshCount; ++meshIndex)
             {
                 Group::Model::Mesh &mesh = model.meshList[meshIndex];
 
-                Header::Mesh meshHeader;
-                if (header->version >= CurrentModelVersion)
+                auto meshHeader = ModelFormat::ReadMeshHeader(header->version, (meshHeaderBuffer + (meshHeaderSize * meshIndex)));
+                if ((meshHeader.levelCount > MaxLevelCount) || ((meshHeader.levelCount > 0) && (meshHeader.indexSize == 0)))
                 {
-                    meshHeader = *reinterpret_cast<Header::Mesh *>(meshHeaderBuffer + (meshHeaderSize * meshIndex));
+                    getContext()->log(Context::Error, "Invalid level count {} of mesh {}: {}", meshHeader.levelCount, meshIndex, filePath.getString());
+                    model.meshList.resize(meshIndex);
+                    break;
                 }
-                else
+
+                // Level meshes only get their index ranges here, the rest is copied once the full detail mesh is loaded
+                uint32_t firstIndex = (meshHeader.faceCount * 3);
+                for (uint32_t level = 0; level < meshHeader.levelCount; ++level)
+                {
+                    if (model.levelList.size() <= level)
+                    {
+                        model.levelList.emplace_back().meshList.resize(header->meshCount);
+                    }
+
+                    auto &levelMesh = model.levelList[level].meshList[meshIndex];
+                    levelMesh.firstIndex = firstIndex;
+                    levelMesh.indexCount = meshHeader.levelIndexCountList[level];
+                    model.levelList[level].error = std::max(model.levelList[level].error, meshHeader.levelErrorList[level]);
+                    firstIndex += meshHeader.levelIndexCountList[level];
+                }
+
+                size_t meshSize = (meshHeader.indexStream.storedSize + meshHeader.meshletStream.storedSize);
+                for (auto const &stream : meshHeader.streamList)
+                {
+                    meshSize += stream.storedSize;
+                }
+
+                if ((meshOffset + meshSize) > fileView.getSize())
                 {
-                    auto const &legacyMeshHeader = *reinterpret_cast<LegacyMeshHeader *>(meshHeaderBuffer + (meshHeaderSize * meshIndex));
-                    std::memcpy(meshHeader.material, legacyMeshHeader.material, sizeof(meshHeader.material));
-                    meshHeader.vertexCount = legacyMeshHeader.vertexCount;
-                    meshHeader.faceCount = legacyMeshHeader.faceCount;
-                    meshHeader.normalEncoding = static_cast<uint8_t>(NormalEncoding::RGB);
+                    getContext()->log(Context::Error, "Model file too small to contain mesh {}: {}", meshIndex, filePath.getString());
+                    model.meshList.resize(meshIndex);
+                    break;
                 }
 
-                scheduleLoadMesh(meshHeader, mesh, meshIndex, fileName, name, meshBuffer, buffer);
-                meshBuffer += (meshHeader.vertexCount * (sizeof(Math::Float3) + sizeof(Math::Float2) + sizeof(Math::Float4) + sizeof(Math::Float3)));
+                meshTaskList.push_back(threadPool->run(loadTaskGroup, [this, meshHeader, &mesh, meshIndex, fileName, name, meshView = fileView.getView(meshOffset, meshSize)](void) -> void
+                {
+                    scheduleLoadMesh(meshHeader, mesh, meshIndex, fileName, name, meshView);
+                }, ThreadPool::Queue::Streaming));
+
+                meshOffset += meshSize;
             }
 
             getContext()->log(Context::Info, "Group {}, mesh {} successfully loaded", name, fileName);
         }
 
-        Task scheduleLoadGroup(std::string name, std::shared_ptr<ModelProcessor::Group> group)
+        Task<> scheduleLoadGroup(std::string name, std::shared_ptr<ModelProcessor::Group> group)
         {
             getContext()->log(Context::Info, "Queueing group for load: {}", name);
 
-            co_await loadPool.schedule();
+            co_await threadPool->schedule(loadTaskGroup, ThreadPool::Queue::Streaming);
             if (shuttingDown || !group)
             {
                 co_return;
             }
 
+            GEK_PROFILE_ZONE("ModelProcessor::loadGroup");
+
             Group loadedGroup;
 
             if (name == "#cube")
@@ -674,14 +1072,14 @@ namespace Gek
                     std::string fileName(filePath.getString());
                     if (filePath.isFile() && String::GetLower(filePath.getExtension()) == ".gek")
                     {
-                        std::vector<uint8_t> buffer(FileSystem::Load(filePath, sizeof(FileHeader)));
-                        if (buffer.size() < sizeof(FileHeader))
+                        std::vector<uint8_t> buffer(FileSystem::Load(filePath, sizeof(ModelFormat::FileHeader)));
+                        if (buffer.size() < sizeof(ModelFormat::FileHeader))
                         {
                             getContext()->log(Context::Error, "Model file too small to contain header: {}", fileName);
                             return true;
                         }
 
-                        FileHeader* header = reinterpret_cast<FileHeader*>(buffer.data());
+                        ModelFormat::FileHeader* header = reinterpret_cast<ModelFormat::FileHeader*>(buffer.data());
                         if (header->identifier != *(uint32_t*)"GEKX")
                         {
                             getContext()->log(Context::Error, "Unknown model file identifier encountered (requires: GEKX, has: {}): {}", header->identifier, fileName);
@@ -694,13 +1092,13 @@ namespace Gek
                             return true;
                         }
 
-                        if ((header->version != LegacyModelVersion) && (header->version != CurrentModelVersion))
+                        if (!ModelFormat::IsSupportedVersion(header->version))
                         {
                             getContext()->log(
                                 Context::Error,
-                                "Unsupported model version encountered (requires: {} or {}, has {}): {}",
-                                LegacyModelVersion,
-                                CurrentModelVersion,
+                                "Unsupported model version encountered (requires: {} to {}, has {}): {}",
+                                ModelFormat::LegacyVersion,
+                                ModelFormat::CurrentVersion,
                                 header->version,
                                 fileName);
                             return true;
@@ -716,12 +1114,44 @@ namespace Gek
                     getContext()->log(Context::Error, "No models found for group: {}", name);
                 }
 
+                // Geometry is read ahead of textures, which at least have a fallback to draw with
+                auto fileViewList = co_await fileReader->read(loadTaskGroup, modelPathList, FileReader::Priority::High);
+                if (shuttingDown)
+                {
+                    co_return;
+                }
+
+                std::vector<Task<>> meshTaskList;
                 loadedGroup.modelList.resize(modelPathList.size());
                 for (size_t modelIndex = 0; modelIndex < modelPathList.size(); ++modelIndex)
                 {
                     auto &model = loadedGroup.modelList[modelIndex];
                     auto &filePath = modelPathList[modelIndex];
-                    scheduleLoadData(name, filePath, loadedGroup, model);
+                    scheduleLoadData(name, filePath, fileViewList[modelIndex], loadedGroup, model, meshTaskList);
+                }
+
+                // Every mesh task writes into loadedGroup, so all of them finish before a cancelled one ends the load
+                bool meshTaskCancelled = false;
+                for (auto &meshTask : meshTaskList)
+                {
+                    try
+                    {
+                        co_await meshTask;
+                    }
+                    catch (TaskCancelled const &)
+                    {
+                        meshTaskCancelled = true;
+                    }
+                }
+
+                for (auto &model : loadedGroup.modelList)
+                {
+                    FinishLevels(model);
+                }
+
+                if (shuttingDown || meshTaskCancelled)
+                {
+                    co_return;
                 }
             }
 
@@ -750,9 +1180,141 @@ namespace Gek
                     }
 
                     data.group = pair.first->second;
+                }
+
+                data.occluder = entity->hasComponent<Components::Occluder>();
+                if (data.cullSlot == InvalidCullSlot)
+                {
+                    std::lock_guard<std::mutex> lock(cullMutex);
+                    data.cullSlot = entityCullList.allocate(1);
+                    entitySlotList.resize(entityCullList.slotCount);
+                    entitySlotList[data.cullSlot] = EntitySlot();
                 } });
         }
 
+        // Plugin::EntityProcessor
+        void onEntryRemoved(Plugin::Entity *const entity, Data &data)
+        {
+            if (data.cullSlot != InvalidCullSlot)
+            {
+                releasedSlotQueue.push(data.cullSlot);
+            }
+        }
+
+        void writeCullSlots(uint32_t slot, EntitySlot &entitySlot, Math::Float4x4 const &matrix, Math::Float3 const &scale)
+        {
+            auto group = entitySlot.group;
+            auto center(group->boundingBox.getCenter() * scale);
+            auto centerMatrix(matrix);
+            centerMatrix.translation() = matrix.transform(center);
+            auto halfSize(group->boundingBox.getHalfSize() * scale);
+            entityCullList.set(slot, halfSize, centerMatrix);
+            entitySlot.matrix = (Math::Float4x4::MakeScaling(scale) * matrix);
+
+            auto extent((centerMatrix.r.x.xyz().getAbsolute() * halfSize.x) + (centerMatrix.r.y.xyz().getAbsolute() * halfSize.y) + (centerMatrix.r.z.xyz().getAbsolute() * halfSize.z));
+            entitySlot.bounds = Shapes::AlignedBox((centerMatrix.translation() - extent), (centerMatrix.translation() + extent));
+            for (uint32_t modelIndex = 0; modelIndex < entitySlot.modelSlotCount; ++modelIndex)
+            {
+                auto const &model = group->modelList[modelIndex];
+                center = (model.boundingBox.getCenter() * scale);
+                centerMatrix.translation() = matrix.transform(center);
+                modelCullList.set((entitySlot.modelSlot + modelIndex), model.boundingBox.getHalfSize() * scale, centerMatrix);
+            }
+        }
+
+        void releaseCullSlot(uint32_t slot)
+        {
+            auto &entitySlot = entitySlotList[slot];
+            if (entitySlot.group)
+            {
+                --cullEntityCount;
+                cullModelCount -= static_cast<uint32_t>(entitySlot.group->modelList.size());
+            }
+
+            if (entitySlot.modelSlotCount > 0)
+            {
+                modelCullList.release(entitySlot.modelSlot, entitySlot.modelSlotCount);
+            }
+
+            if (entitySlot.proxy != Shapes::BoundingVolumeHierarchy::InvalidProxy)
+            {
+                spatialIndex->destroyProxy(entitySlot.proxy);
+            }
+
+            entitySlot = EntitySlot();
+            entityCullList.reset(slot);
+        }
+
+        // Only entities that finished loading, changed group or moved since the last frame are written
+        void updateCullLists(void)
+        {
+            GEK_PROFILE_ZONE("ModelProcessor::updateCullLists");
+            pendingSlotList.clear();
+            movedSlotList.clear();
+            parallelListEntities([&](Plugin::Entity *const entity, auto &data, auto &modelComponent, auto &transformComponent) -> void
+                                 {
+                auto group = ((data.group && data.group->ready.load(std::memory_order_acquire)) ? data.group.get() : nullptr);
+                auto &entitySlot = entitySlotList[data.cullSlot];
+                entitySlot.occluder = data.occluder;
+                if (group != entitySlot.group)
+                {
+                    pendingSlotList.push_back({ data.cullSlot, group, transformComponent.version, transformComponent.getMatrix(), transformComponent.scale });
+                }
+                else if (group && (transformComponent.version != entitySlot.transformVersion))
+                {
+                    entitySlot.transformVersion = transformComponent.version;
+                    writeCullSlots(data.cullSlot, entitySlot, transformComponent.getMatrix(), transformComponent.scale);
+                    movedSlotList.push_back(data.cullSlot);
+                } });
+
+            std::lock_guard<std::mutex> lock(cullMutex);
+            for (auto slot : movedSlotList)
+            {
+                auto const &entitySlot = entitySlotList[slot];
+                spatialIndex->moveProxy(entitySlot.proxy, entitySlot.bounds);
+            }
+
+            uint32_t createdProxyCount = 0;
+            for (auto const &pendingSlot : pendingSlotList)
+            {
+                auto &entitySlot = entitySlotList[pendingSlot.slot];
+                const bool occluder = entitySlot.occluder;
+                releaseCullSlot(pendingSlot.slot);
+
+                entitySlot.occluder = occluder;
+                entitySlot.group = pendingSlot.group;
+                entitySlot.transformVersion = pendingSlot.transformVersion;
+                if (auto group = pendingSlot.group)
+                {
+                    ++cullEntityCount;
+                    cullModelCount += static_cast<uint32_t>(group->modelList.size());
+                    entitySlot.levelList.assign((group->modelList.size() * LevelViewCount), 0);
+                    if (group->modelList.size() > 1)
+                    {
+                        entitySlot.modelSlotCount = static_cast<uint32_t>(group->modelList.size());
+                        entitySlot.modelSlot = modelCullList.allocate(entitySlot.modelSlotCount);
+                    }
+
+                    writeCullSlots(pendingSlot.slot, entitySlot, pendingSlot.matrix, pendingSlot.scale);
+                    entitySlot.proxy = spatialIndex->createProxy(entitySlot.bounds, pendingSlot.slot);
+                    ++createdProxyCount;
+                }
+            }
+
+            // Scenes finishing their load insert most of the tree at once, a full rebuild gives a better tree than that
+            if (createdProxyCount > 64 && createdProxyCount > (spatialIndex->getProxyCount() / 2))
+            {
+                spatialIndex->rebuild();
+            }
+
+            uint32_t releasedSlot;
+            while (releasedSlotQueue.try_pop(releasedSlot))
+            {
+                releaseCullSlot(releasedSlot);
+                entityCullList.release(releasedSlot, 1);
+            }
+        }
+
         // Plugin::Processor
         void onInitialized(void)
         {
@@ -769,7 +1331,8 @@ namespace Gek
         {
             shuttingDown = true;
 
-            loadPool.drain();
+            fileReader->cancel(loadTaskGroup);
+            loadTaskGroup.join();
             if (events)
             {
                 events->onModified.disconnect(this, &ModelProcessor::onModified);
@@ -777,6 +1340,7 @@ namespace Gek
 
             population->onReset.disconnect(this, &ModelProcessor::onReset);
             population->onEntityCreated.disconnect(this, &ModelProcessor::onEntityCreated);
+            population->onEntityListCreated.disconnect(this, &ModelProcessor::onEntityListCreated);
             population->onEntityDestroyed.disconnect(this, &ModelProcessor::onEntityDestroyed);
             population->onComponentAdded.disconnect(this, &ModelProcessor::onComponentAdded);
             population->onComponentRemoved.disconnect(this, &ModelProcessor::onComponentRemoved);
@@ -808,6 +1372,15 @@ namespace Gek
         void onReset(void)
         {
             clear();
+
+            std::lock_guard<std::mutex> lock(cullMutex);
+            spatialIndex->clear();
+            entityCullList.clear();
+            modelCullList.clear();
+            entitySlotList.clear();
+            releasedSlotQueue.clear();
+            cullEntityCount = 0;
+            cullModelCount = 0;
         }
 
         void onEntityCreated(Plugin::Entity *const entity)
@@ -815,6 +1388,14 @@ namespace Gek
             addEntity(entity);
         }
 
+        void onEntityListCreated(std::vector<Plugin::Entity *> const &entityList)
+        {
+            for (auto entity : entityList)
+            {
+                addEntity(entity);
+            }
+        }
+
         void onEntityDestroyed(Plugin::Entity *const entity)
         {
             removeEntity(entity);
@@ -827,20 +1408,73 @@ namespace Gek
 
         void onComponentRemoved(Plugin::Entity *const entity)
         {
-            if (!entity->hasComponents<Components::Model, Components::Transform>())
+            if (entity->hasComponents<Components::Model, Components::Transform>())
+            {
+                // Still a model, refresh the flags that depend on the optional components
+                addEntity(entity);
+            }
+            else
             {
                 removeEntity(entity);
             }
         }
 
+        // Steps through the levels one at a time from the last one drawn, the error is projected from the nearest point
+        // of the model's bounding sphere and coarsening needs a margin below the screen error so instances don't flicker
+        static uint8_t SelectLevel(Group::Model const &model, uint8_t level, Math::Float4x4 const &modelViewMatrix, float worldScale, float projectionScale)
+        {
+            auto center(modelViewMatrix.transform(model.boundingBox.getCenter()));
+            auto radius = (model.boundingBox.getHalfSize().getLength() * worldScale);
+            auto depth = (center.z - radius);
+            if (depth <= 0.0f)
+            {
+                return 0;
+            }
+
+            const float errorScale = ((worldScale * projectionScale) / depth);
+            level = std::min<uint8_t>(level, static_cast<uint8_t>(model.levelList.size()));
+            while ((level > 0) && ((model.getLevelError(level) * errorScale) > LevelScreenError))
+            {
+                --level;
+            }
+
+            while ((level < model.levelList.size()) && ((model.getLevelError(level + 1) * errorScale) <= (LevelScreenError * LevelHysteresis)))
+            {
+                ++level;
+            }
+
+            return level;
+        }
+
         // Plugin::Visualizer Slots
-        void onQueueDrawCalls(Shapes::Frustum const &viewFrustum, Math::Float4x4 const &viewMatrix, Math::Float4x4 const &projectionMatrix)
+        // A recycled view keeps the levels of its last camera, SelectLevel steps either way so they only cost a few steps
+        uint32_t getLevelView(std::string const &cameraName, uint64_t drawCounter)
+        {
+            const Hash camera = GetHash(cameraName);
+            uint32_t levelView = 0;
+            for (uint32_t viewIndex = 0; viewIndex < LevelViewCount; ++viewIndex)
+            {
+                if (levelViewList[viewIndex].camera == camera)
+                {
+                    levelView = viewIndex;
+                    break;
+                }
+                else if (levelViewList[viewIndex].drawCounter < levelViewList[levelView].drawCounter)
+                {
+                    levelView = viewIndex;
+                }
+            }
+
+            levelViewList[levelView] = { camera, drawCounter };
+            return levelView;
+        }
+
+        void onQueueDrawCalls(Shapes::Frustum const &viewFrustum, Math::Float4x4 const &viewMatrix, Math::Float4x4 const &projectionMatrix, std::string const &cameraName)
         {
+            GEK_PROFILE_ZONE("ModelProcessor::onQueueDrawCalls");
             assert(renderer);
             static uint64_t modelQueueFrameCounter = 0;
             ++modelQueueFrameCounter;
-            uint32_t entityCullingFallbackCount = 0;
-            uint32_t modelCullingFallbackCount = 0;
 
             // Advance the retire ring: clear the slot from 3 frames ago (GPU is done by then).
             instanceBufferRetireIndex = (instanceBufferRetireIndex + 1) % kInstanceBufferFrameSlots;
@@ -853,147 +1487,194 @@ namespace Gek
             }
             instanceBufferRetireSlots[instanceBufferRetireIndex].clear();
 
-            // Cull by entity/group
-            const auto entityCount = getEntityCount();
-            auto buffer = (entityCount % 4);
-            buffer = (buffer ? (4 - buffer) : buffer);
-            const auto bufferedEntityCount = (entityCount + buffer);
-            halfSizeXList.resize(bufferedEntityCount);
-            halfSizeYList.resize(bufferedEntityCount);
-            halfSizeZList.resize(bufferedEntityCount);
-            for (auto &elementList : transformList)
+            if (population->getFrameIndex() != cullFrameIndex)
             {
-                elementList.resize(bufferedEntityCount);
+                cullFrameIndex = population->getFrameIndex();
+                updateCullLists();
             }
 
-            entityDataList.clear();
-            entityDataList.reserve(static_cast<EntityDataList::size_type>(entityCount));
-            parallelListEntities([&](Plugin::Entity *const entity, auto &data, auto &modelComponent, auto &transformComponent) -> void
-                                 {
-                if (data.group && data.group->ready.load(std::memory_order_acquire))
+            std::atomic_uint32_t visibleModelCount = 0;
+            std::atomic_uint32_t simplifiedModelCount = 0;
+            std::atomic_uint32_t culledMeshletCount = 0;
+            uint32_t testedEntityCount = 0;
+            uint32_t occluderCount = 0;
+            uint32_t occlusionTestedCount = 0;
+            uint32_t occlusionCulledCount = 0;
+            {
+                std::lock_guard<std::mutex> lock(cullMutex);
+
+                // Entities fully inside the frustum are accepted by the tree, the rest get the oriented box test
+                visibleSlotList.clear();
+                candidateSlotList.clear();
+                candidateCullList.clear();
+                spatialIndex->query(viewFrustum, [&](uint64_t userData, bool isInside) -> void
                 {
-                    auto group = data.group;
-                    auto matrix(transformComponent.getMatrix());
-                    matrix.translation() += group->boundingBox.getCenter();
-                    auto halfSize(group->boundingBox.getHalfSize() * transformComponent.scale);
-
-                    auto entityInsert = entityDataList.push_back(std::make_tuple(entity, &data, 0));
-					auto entityIndex = std::get<2>(*entityInsert) = static_cast<uint32_t>(std::distance(std::begin(entityDataList), entityInsert));
-
-                    halfSizeXList[entityIndex] = halfSize.x;
-                    halfSizeYList[entityIndex] = halfSize.y;
-                    halfSizeZList[entityIndex] = halfSize.z;
-                    for (size_t element = 0; element < 16; ++element)
+                    auto slot = static_cast<uint32_t>(userData);
+                    if (isInside)
                     {
-                        transformList[element][entityIndex] = matrix.data[element];
+                        visibleSlotList.push_back({ slot });
                     }
-                } });
+                    else
+                    {
+                        candidateCullList.copy(candidateCullList.append(1), entityCullList, slot);
+                        candidateSlotList.push_back({ slot });
+                    }
+                });
 
-            visibilityList.resize(bufferedEntityCount);
-            Math::SIMD::cullOrientedBoundingBoxes(viewMatrix, projectionMatrix, static_cast<uint32_t>(bufferedEntityCount), halfSizeXList, halfSizeYList, halfSizeZList, transformList, visibilityList);
+                testedEntityCount = static_cast<uint32_t>(candidateSlotList.size());
+                candidateCullList.cull(viewMatrix, projectionMatrix);
+                candidateModelCullList.clear();
+                for (uint32_t candidate = 0; candidate < candidateSlotList.size(); ++candidate)
+                {
+                    if (!candidateCullList.visibilityList[candidate])
+                    {
+                        continue;
+                    }
 
-            const auto visibleEntityCount = std::accumulate(std::begin(entityDataList), std::end(entityDataList), size_t(0), [&](size_t count, auto const &entitySearch) -> size_t
-                                                            { return (count + (visibilityList[std::get<2>(entitySearch)] ? 1 : 0)); });
+                    auto candidateSlot = candidateSlotList[candidate];
+                    auto const &entitySlot = entitySlotList[candidateSlot.slot];
+                    if (entitySlot.modelSlotCount > 0)
+                    {
+                        candidateSlot.modelCandidate = candidateModelCullList.append(entitySlot.modelSlotCount);
+                        for (uint32_t modelIndex = 0; modelIndex < entitySlot.modelSlotCount; ++modelIndex)
+                        {
+                            candidateModelCullList.copy((candidateSlot.modelCandidate + modelIndex), modelCullList, (entitySlot.modelSlot + modelIndex));
+                        }
+                    }
 
-            if (!entityDataList.empty() && visibleEntityCount == 0)
-            {
-                for (auto const &entitySearch : entityDataList)
-                {
-                    visibilityList[std::get<2>(entitySearch)] = true;
+                    visibleSlotList.push_back(candidateSlot);
                 }
 
-                entityCullingFallbackCount = 1;
-            }
-
-            // Cull by model inside group
-            const auto modelCount = std::accumulate(std::begin(entityDataList), std::end(entityDataList), size_t(0), [this](size_t count, auto const &entitySearch) -> size_t
-                                                    {
-				if (visibilityList[std::get<2>(entitySearch)])
-				{
-					auto data = std::get<1>(entitySearch);
-					count += data->group->modelList.size();
-				}
+                candidateModelCullList.cull(viewMatrix, projectionMatrix);
+                if (core->getOption("render", "occlusionCulling", true))
+                {
+                    // Only occluders that survived the frustum test are drawn, a hidden occluder can't hide anything else
+                    occlusionBuffer.clear(viewMatrix, projectionMatrix);
+                    for (auto const &visibleSlot : visibleSlotList)
+                    {
+                        auto const &entitySlot = entitySlotList[visibleSlot.slot];
+                        if (entitySlot.occluder)
+                        {
+                            occlusionBuffer.addOccluder(entitySlot.group->boundingBox, entitySlot.matrix);
+                        }
+                    }
 
-				return count; });
+                    occluderCount = occlusionBuffer.getOccluderCount();
+                    if (occluderCount > 0)
+                    {
+                        occlusionBuffer.finalize();
+                        occlusionTestedCount = static_cast<uint32_t>(visibleSlotList.size());
+                        occludedList.assign(visibleSlotList.size(), 0);
+                        tbb::parallel_for(tbb::blocked_range<size_t>(0, visibleSlotList.size()), [&](tbb::blocked_range<size_t> const &range) -> void
+                                          {
+                            for (size_t visibleIndex = range.begin(); visibleIndex != range.end(); ++visibleIndex)
+                            {
+                                auto const &entitySlot = entitySlotList[visibleSlotList[visibleIndex].slot];
+                                occludedList[visibleIndex] = (entitySlot.occluder ? 0 : !occlusionBuffer.isVisible(entitySlot.group->boundingBox, entitySlot.matrix));
+                            } });
+
+                        size_t keptCount = 0;
+                        for (size_t visibleIndex = 0; visibleIndex < visibleSlotList.size(); ++visibleIndex)
+                        {
+                            if (!occludedList[visibleIndex])
+                            {
+                                visibleSlotList[keptCount++] = visibleSlotList[visibleIndex];
+                            }
+                        }
 
-            buffer = (modelCount % 4);
-            buffer = (buffer ? (4 - buffer) : buffer);
-            const auto bufferedModelCount = (modelCount + buffer);
-            halfSizeXList.resize(bufferedModelCount);
-            halfSizeYList.resize(bufferedModelCount);
-            halfSizeZList.resize(bufferedModelCount);
-            for (auto &elementList : transformList)
-            {
-                elementList.resize(bufferedModelCount);
-            }
+                        visibleSlotList.resize(keptCount);
 
-            entityModelList.clear();
-            entityModelList.reserve(static_cast<EntityModelList::size_type>(bufferedModelCount));
-            std::for_each(std::execution::par, std::begin(entityDataList), std::end(entityDataList), [&](auto &entitySearch) -> void
-                          {
-				auto entityDataIndex = std::get<2>(entitySearch);
-				if (visibilityList[entityDataIndex])
-				{
-					Plugin::Entity * const entity = std::get<0>(entitySearch);
-					auto data = std::get<1>(entitySearch);
-					auto group = data->group;
-
-					auto &transformComponent = entity->getComponent<Components::Transform>();
-					auto matrix(transformComponent.getMatrix());
-
-					std::for_each(std::execution::par, std::begin(group->modelList), std::end(group->modelList), [&](Group::Model const &model) -> void
-					{
-                        auto halfSize(model.boundingBox.getHalfSize() * transformComponent.scale);
-                        auto center(model.boundingBox.getCenter() * transformComponent.scale);
-                        auto centerTransform(matrix);
-                        centerTransform.translation() = matrix.transform(center);
-
-						auto entityInsert = entityModelList.push_back(std::make_tuple(entity, &model, 0));
-                        auto entityModelIndex = std::get<2>(*entityInsert) = static_cast<uint32_t>(std::distance(std::begin(entityModelList), entityInsert));
-
-						halfSizeXList[entityModelIndex] = halfSize.x;
-						halfSizeYList[entityModelIndex] = halfSize.y;
-						halfSizeZList[entityModelIndex] = halfSize.z;
-						for (size_t element = 0; element < 16; ++element)
-						{
-                            transformList[element][entityModelIndex] = centerTransform.data[element];
-						}
-					});
-				} });
-
-            visibilityList.resize(bufferedModelCount);
-            Math::SIMD::cullOrientedBoundingBoxes(viewMatrix, projectionMatrix, static_cast<uint32_t>(bufferedModelCount), halfSizeXList, halfSizeYList, halfSizeZList, transformList, visibilityList);
-
-            const auto visibleModelCount = std::accumulate(std::begin(entityModelList), std::end(entityModelList), size_t(0), [&](size_t count, auto const &entitySearch) -> size_t
-                                                           { return (count + (visibilityList[std::get<2>(entitySearch)] ? 1 : 0)); });
-
-            if (!entityModelList.empty() && visibleModelCount == 0)
-            {
-                for (auto const &entitySearch : entityModelList)
-                {
-                    visibilityList[std::get<2>(entitySearch)] = true;
+                        occlusionCulledCount = (occlusionTestedCount - static_cast<uint32_t>(visibleSlotList.size()));
+                    }
                 }
 
-                modelCullingFallbackCount = 1;
-            }
+                const bool levelOfDetail = core->getOption("render", "levelOfDetail", true);
+                const uint32_t levelView = getLevelView(cameraName, modelQueueFrameCounter);
+                const bool meshletCulling = core->getOption("render", "meshletCulling", true);
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, visibleSlotList.size()), [&](tbb::blocked_range<size_t> const &range) -> void
+                                  {
+                    uint32_t localModelCount = 0;
+                    uint32_t localSimplifiedCount = 0;
+                    uint32_t localCulledMeshletCount = 0;
+                    std::vector<uint8_t> meshletVisibilityList;
+                    for (size_t visibleIndex = range.begin(); visibleIndex != range.end(); ++visibleIndex)
+                    {
+                        auto const &visibleSlot = visibleSlotList[visibleIndex];
+                        auto &entitySlot = entitySlotList[visibleSlot.slot];
+                        auto modelViewMatrix(entitySlot.matrix * viewMatrix);
+                        auto worldScale = std::max({ modelViewMatrix.r.x.xyz().getLength(), modelViewMatrix.r.y.xyz().getLength(), modelViewMatrix.r.z.xyz().getLength() });
+
+                        // Meshlets are culled in model space, the material and view decide if the normal cones apply
+                        bool hasModelFrustum = false;
+                        Math::SIMD::Frustum modelFrustum;
+                        Math::Float3 modelViewPosition;
+                        auto const &modelList = entitySlot.group->modelList;
+                        for (uint32_t modelIndex = 0; modelIndex < modelList.size(); ++modelIndex)
+                        {
+                            if (visibleSlot.modelCandidate != InvalidCullSlot && !candidateModelCullList.visibilityList[visibleSlot.modelCandidate + modelIndex])
+                            {
+                                continue;
+                            }
+
+                            ++localModelCount;
+                            auto const &model = modelList[modelIndex];
+                            auto &level = entitySlot.getLevel(modelIndex, levelView);
+                            if (levelOfDetail && !model.levelList.empty())
+                            {
+                                level = SelectLevel(model, level, modelViewMatrix, worldScale, projectionMatrix._22);
+                                localSimplifiedCount += (level > 0);
+                            }
+                            else
+                            {
+                                level = 0;
+                            }
+
+                            for (auto const &mesh : model.getLevelMeshList(level))
+                            {
+                                auto &meshMap = renderList[mesh.material];
+                                auto &instanceList = meshMap[&mesh];
+                                auto instanceMatrix((mesh.vertexEncoding == VertexEncoding::Quantized) ? (mesh.positionMatrix * modelViewMatrix) : modelViewMatrix);
+                                if (!meshletCulling || !mesh.meshletList)
+                                {
+                                    instanceList.matrixList.push_back(instanceMatrix);
+                                    continue;
+                                }
 
-            std::for_each(std::execution::par, std::begin(entityModelList), std::end(entityModelList), [&](auto &entitySearch) -> void
-                          {
-				if (visibilityList[std::get<2>(entitySearch)])
-				{
-					Plugin::Entity * const entity = std::get<0>(entitySearch);
-					auto model = std::get<1>(entitySearch);
+                                if (!hasModelFrustum)
+                                {
+                                    Shapes::Frustum frustum(modelViewMatrix * projectionMatrix);
+                                    modelFrustum = Math::SIMD::loadFrustum(&frustum.planeList[0].vector);
+                                    modelViewPosition = modelViewMatrix.getInverse().translation();
+                                    hasModelFrustum = true;
+                                }
 
-					auto &transformComponent = entity->getComponent<Components::Transform>();
-					auto modelViewMatrix(transformComponent.getScaledMatrix() * viewMatrix);
+                                MeshletInstance meshletInstance;
+                                const auto culling = Meshlets::GetCulling(resources->getMaterialCullMode(mesh.material), modelViewMatrix, projectionMatrix);
+                                localCulledMeshletCount += Meshlets::Cull(*mesh.meshletList, culling, modelFrustum, modelViewPosition, meshletVisibilityList, meshletInstance.rangeList);
+                                if (meshletInstance.rangeList.empty())
+                                {
+                                    continue;
+                                }
 
-					std::for_each(std::execution::par, std::begin(model->meshList), std::end(model->meshList), [&](Group::Model::Mesh const &mesh) -> void
-					{
-						auto &meshMap = renderList[mesh.material];
-						auto &instanceList = meshMap[&mesh];
-						instanceList.push_back(modelViewMatrix);
-					});
-				} });
+                                // Instances that kept every meshlet still batch with the rest
+                                auto const &firstRange = meshletInstance.rangeList.front();
+                                if ((meshletInstance.rangeList.size() == 1) && (firstRange.firstIndex == mesh.firstIndex) && (firstRange.indexCount == mesh.indexCount))
+                                {
+                                    instanceList.matrixList.push_back(instanceMatrix);
+                                }
+                                else
+                                {
+                                    meshletInstance.matrix = instanceMatrix;
+                                    instanceList.meshletInstanceList.push_back(std::move(meshletInstance));
+                                }
+                            }
+                        }
+                    }
+
+                    visibleModelCount.fetch_add(localModelCount, std::memory_order_relaxed);
+                    simplifiedModelCount.fetch_add(localSimplifiedCount, std::memory_order_relaxed);
+                    culledMeshletCount.fetch_add(localCulledMeshletCount, std::memory_order_relaxed); });
+            }
 
             std::atomic_size_t queuedBatchCount = 0;
             std::for_each(std::begin(renderList), std::end(renderList), [&](auto &materialPair) -> void
@@ -1009,128 +1690,157 @@ namespace Gek
 					materialInstanceCount += materialInstanceList.size();
 				}
 
-                std::vector<DrawData> drawDataList;
-                drawDataList.reserve(materialMap.size());
-                std::vector<Math::Float4x4> instanceList;
-                instanceList.reserve(materialInstanceCount);
-				for (auto &levelPair : materialMap)
-				{
-					auto level = levelPair.first;
-					if (level)
-					{
-						auto &levelInstanceList = levelPair.second;
-                        drawDataList.push_back(DrawData(static_cast<uint32_t>(instanceList.size()), static_cast<uint32_t>(levelInstanceList.size()), level));
-						instanceList.insert(std::end(instanceList), std::begin(levelInstanceList), std::end(levelInstanceList));
-						levelInstanceList.clear();
-					}
-				}
-
-                if (instanceList.empty())
+                // Quantized meshes need their own input layout, so each encoding is drawn as a separate batch
+                for (size_t encodingIndex = 0; encodingIndex < VertexEncodingCount; ++encodingIndex)
                 {
-                    return;
-                }
+                    std::vector<DrawData> drawDataList;
+                    drawDataList.reserve(materialMap.size());
+                    std::vector<Math::Float4x4> instanceList;
+                    instanceList.reserve(materialInstanceCount);
+                    for (auto &levelPair : materialMap)
+                    {
+                        auto level = levelPair.first;
+                        if (level && (level->vertexEncoding == static_cast<VertexEncoding>(encodingIndex)))
+                        {
+                            auto &levelInstanceList = levelPair.second;
+                            if (!levelInstanceList.matrixList.empty())
+                            {
+                                drawDataList.push_back(DrawData(static_cast<uint32_t>(instanceList.size()), static_cast<uint32_t>(levelInstanceList.matrixList.size()), level));
+                                instanceList.insert(std::end(instanceList), std::begin(levelInstanceList.matrixList), std::end(levelInstanceList.matrixList));
+                            }
+
+                            for (auto &meshletInstance : levelInstanceList.meshletInstanceList)
+                            {
+                                drawDataList.push_back(DrawData(static_cast<uint32_t>(instanceList.size()), 1, level, std::move(meshletInstance.rangeList)));
+                                instanceList.push_back(meshletInstance.matrix);
+                            }
+
+                            levelInstanceList.matrixList.clear();
+                            levelInstanceList.meshletInstanceList.clear();
+                        }
+                    }
 
-                uint32_t const requiredInstanceCount = static_cast<uint32_t>(instanceList.size());
-                Render::BufferPtr batchBuffer;
-                auto poolIt = std::find_if(
-                    std::begin(instanceBufferPool), std::end(instanceBufferPool),
-                    [requiredInstanceCount](Render::BufferPtr const &candidate) -> bool
+                    if (instanceList.empty())
                     {
-                        return candidate && (candidate->getDescription().count >= requiredInstanceCount);
-                    });
-                if (poolIt != std::end(instanceBufferPool))
-                {
-                    batchBuffer = std::move(*poolIt);
-                    instanceBufferPool.erase(poolIt);
-                }
-                else
-                {
-                    Render::Buffer::Description instanceDescription;
-                    instanceDescription.name = "model:instances";
-                    instanceDescription.stride = sizeof(Math::Float4x4);
-                    instanceDescription.count = std::max<uint32_t>(requiredInstanceCount, 100);
-                    instanceDescription.type = Render::Buffer::Type::Vertex;
-                    instanceDescription.flags = Render::Buffer::Flags::Mappable;
-
-                    batchBuffer = videoDevice->createBuffer(instanceDescription);
-                    if (!batchBuffer)
+                        continue;
+                    }
+
+                    uint32_t const requiredInstanceCount = static_cast<uint32_t>(instanceList.size());
+                    Render::BufferPtr batchBuffer;
+                    auto poolIt = std::find_if(
+                        std::begin(instanceBufferPool), std::end(instanceBufferPool),
+                        [requiredInstanceCount](Render::BufferPtr const &candidate) -> bool
+                        {
+                            return candidate && (candidate->getDescription().count >= requiredInstanceCount);
+                        });
+                    if (poolIt != std::end(instanceBufferPool))
                     {
-                        getContext()->log(Context::Warning,
-                            "ModelProcessor skipped draw batch due to instance buffer creation failure (instances={})",
-                            instanceList.size());
-                        return;
+                        batchBuffer = std::move(*poolIt);
+                        instanceBufferPool.erase(poolIt);
+                    }
+                    else
+                    {
+                        Render::Buffer::Description instanceDescription;
+                        instanceDescription.name = "model:instances";
+                        instanceDescription.stride = sizeof(Math::Float4x4);
+                        instanceDescription.count = std::max<uint32_t>(requiredInstanceCount, 100);
+                        instanceDescription.type = Render::Buffer::Type::Vertex;
+                        instanceDescription.flags = Render::Buffer::Flags::Mappable;
+
+                        batchBuffer = videoDevice->createBuffer(instanceDescription);
+                        if (!batchBuffer)
+                        {
+                            getContext()->log(Context::Warning,
+                                "ModelProcessor skipped draw batch due to instance buffer creation failure (instances={})",
+                                instanceList.size());
+                            continue;
+                        }
                     }
-                }
 
-                instanceBufferRetireSlots[instanceBufferRetireIndex].push_back(std::move(batchBuffer));
-                Render::Buffer *batchBufferHandle = instanceBufferRetireSlots[instanceBufferRetireIndex].back().get();
+                    instanceBufferRetireSlots[instanceBufferRetireIndex].push_back(std::move(batchBuffer));
+                    Render::Buffer *batchBufferHandle = instanceBufferRetireSlots[instanceBufferRetireIndex].back().get();
 
-                queuedBatchCount.fetch_add(1);
-                renderer->queueDrawCall(visual, material, [this, batchBufferHandle, drawDataList = std::move(drawDataList), instanceList = std::move(instanceList)](Render::Device::Context *videoContext) -> void
-				{
-                    if (batchBufferHandle)
-					{
-						Math::Float4x4 *instanceData = nullptr;
-                        if (!videoDevice->mapBuffer(batchBufferHandle, instanceData))
-						{
-							getContext()->log(Context::Warning,
-								"ModelProcessor skipped draw batch due to instance buffer mapping failure (instances={})",
-								instanceList.size());
-							return;
-						}
-
-						std::copy(std::begin(instanceList), std::end(instanceList), instanceData);
-                        videoDevice->unmapBuffer(batchBufferHandle);
-                        videoContext->setVertexBufferList({ batchBufferHandle }, 4);
-						for (auto const &drawData : drawDataList)
-						{
-							if (drawData.data)
-							{
-								auto &level = *drawData.data;
-                                if ((level.vertexCount == 0) && (!level.indexBuffer || (level.indexCount == 0)))
-                                {
-                                    continue;
-                                }
-                                if (!std::all_of(std::begin(level.vertexBufferList), std::end(level.vertexBufferList), [](ResourceHandle const &handle) { return (handle.identifier != 0); }))
-                                {
-                                    continue;
-                                }
-								resources->setVertexBufferList(videoContext, level.vertexBufferList, 0);
-                                if (level.indexBuffer)
+                    queuedBatchCount.fetch_add(1);
+                    renderer->queueDrawCall(visualList[encodingIndex], material, [this, batchBufferHandle, drawDataList = std::move(drawDataList), instanceList = std::move(instanceList)](Render::Device::Context *videoContext) -> void
+                    {
+                        if (batchBufferHandle)
+                        {
+                            Math::Float4x4 *instanceData = nullptr;
+                            if (!videoDevice->mapBuffer(batchBufferHandle, instanceData))
+                            {
+                                getContext()->log(Context::Warning,
+                                    "ModelProcessor skipped draw batch due to instance buffer mapping failure (instances={})",
+                                    instanceList.size());
+                                return;
+                            }
+
+                            std::copy(std::begin(instanceList), std::end(instanceList), instanceData);
+                            videoDevice->unmapBuffer(batchBufferHandle);
+                            videoContext->setVertexBufferList({ batchBufferHandle }, 4);
+                            for (auto const &drawData : drawDataList)
+                            {
+                                if (drawData.data)
                                 {
-                                    if (level.indexCount == 0)
+                                    auto &level = *drawData.data;
+                                    if ((level.vertexCount == 0) && (!level.indexBuffer || (level.indexCount == 0)))
                                     {
                                         continue;
                                     }
-
-                                    resources->setIndexBuffer(videoContext, level.indexBuffer, 0);
-                                    resources->drawInstancedIndexedPrimitive(videoContext, drawData.instanceCount, drawData.instanceStart, level.indexCount, 0, 0);
-                                }
-                                else
-                                {
-                                    if (level.vertexCount == 0)
+                                    if (!std::all_of(std::begin(level.vertexBufferList), std::end(level.vertexBufferList), [](ResourceHandle const &handle) { return (handle.identifier != 0); }))
                                     {
                                         continue;
                                     }
+                                    resources->setVertexBufferList(videoContext, level.vertexBufferList, 0);
+                                    if (level.indexBuffer)
+                                    {
+                                        if (level.indexCount == 0)
+                                        {
+                                            continue;
+                                        }
+
+                                        resources->setIndexBuffer(videoContext, level.indexBuffer, 0);
+                                        if (drawData.rangeList.empty())
+                                        {
+                                            resources->drawInstancedIndexedPrimitive(videoContext, drawData.instanceCount, drawData.instanceStart, level.indexCount, level.firstIndex, 0);
+                                        }
+
+                                        for (auto const &range : drawData.rangeList)
+                                        {
+                                            resources->drawInstancedIndexedPrimitive(videoContext, drawData.instanceCount, drawData.instanceStart, range.indexCount, range.firstIndex, 0);
+                                        }
+                                    }
+                                    else
+                                    {
+                                        if (level.vertexCount == 0)
+                                        {
+                                            continue;
+                                        }
 
-                                    resources->drawInstancedPrimitive(videoContext, drawData.instanceCount, drawData.instanceStart, level.vertexCount, 0);
+                                        resources->drawInstancedPrimitive(videoContext, drawData.instanceCount, drawData.instanceStart, level.vertexCount, 0);
+                                    }
                                 }
-							}
-						}
-					}
-				}); });
-
-            getContext()->setRuntimeMetric("model.frame", static_cast<double>(modelQueueFrameCounter));
-            getContext()->setRuntimeMetric("model.entities", static_cast<double>(entityDataList.size()));
-            getContext()->setRuntimeMetric("model.visibleEntities", static_cast<double>(visibleEntityCount));
-            getContext()->setRuntimeMetric("model.models", static_cast<double>(entityModelList.size()));
-            getContext()->setRuntimeMetric("model.visibleModels", static_cast<double>(visibleModelCount));
-            getContext()->setRuntimeMetric("model.queuedBatches", static_cast<double>(queuedBatchCount.load()));
-            getContext()->setRuntimeMetric("model.entityCullingFallback", static_cast<double>(entityCullingFallbackCount));
-            getContext()->setRuntimeMetric("model.modelCullingFallback", static_cast<double>(modelCullingFallbackCount));
+                            }
+                        }
+                    });
+                } });
+
+            auto &metrics = getContext()->getRuntimeMetrics();
+            metrics.set(metricHandles.frame, static_cast<double>(modelQueueFrameCounter));
+            metrics.set(metricHandles.entities, static_cast<double>(cullEntityCount));
+            metrics.set(metricHandles.testedEntities, static_cast<double>(testedEntityCount));
+            metrics.set(metricHandles.visibleEntities, static_cast<double>(visibleSlotList.size()));
+            metrics.set(metricHandles.occluders, static_cast<double>(occluderCount));
+            metrics.set(metricHandles.occlusionTested, static_cast<double>(occlusionTestedCount));
+            metrics.set(metricHandles.occlusionCulled, static_cast<double>(occlusionCulledCount));
+            metrics.set(metricHandles.models, static_cast<double>(cullModelCount));
+            metrics.set(metricHandles.visibleModels, static_cast<double>(visibleModelCount.load()));
+            metrics.set(metricHandles.simplifiedModels, static_cast<double>(simplifiedModelCount.load()));
+            metrics.set(metricHandles.culledMeshlets, static_cast<double>(culledMeshletCount.load()));
+            metrics.set(metricHandles.queuedBatches, static_cast<double>(queuedBatchCount.load()));
         }
     };
 
     GEK_REGISTER_CONTEXT_USER(Model)
+    GEK_REGISTER_CONTEXT_USER(Occluder)
     GEK_REGISTER_CONTEXT_USER(ModelProcessor)
 }; // namespace Gek
@@ -0,0 +1,243 @@
+#include "GEK/Model/Format.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace Gek;
+
+namespace
+{
+    std::vector<uint8_t> GetRandomData(size_t size)
+    {
+        std::mt19937 generator(42);
+        std::uniform_int_distribution<uint32_t> distribution(0, 255);
+        std::vector<uint8_t> data(size);
+        for (auto &value : data)
+        {
+            value = static_cast<uint8_t>(distribution(generator));
+        }
+
+        return data;
+    }
+
+    // Smoothly varying floats, the high bytes repeat but the low bytes do not
+    std::vector<uint8_t> GetPositionData(size_t count)
+    {
+        std::vector<float> positionList(count * 3);
+        for (size_t index = 0; index < positionList.size(); ++index)
+        {
+            positionList[index] = (std::sin(float(index) * 0.01f) * 10.0f);
+        }
+
+        auto rawData = reinterpret_cast<uint8_t const *>(positionList.data());
+        return std::vector<uint8_t>(rawData, (rawData + (positionList.size() * sizeof(float))));
+    }
+
+    std::vector<uint8_t> RoundTrip(std::vector<uint8_t> const &data, size_t elementSize, bool compress, ModelFormat::StreamCodec &codec)
+    {
+        ModelFormat::MeshHeader::Stream stream;
+        auto storedData = ModelFormat::EncodeStream(data.data(), data.size(), elementSize, compress, stream);
+        EXPECT_EQ(stream.storedSize, storedData.size());
+        codec = static_cast<ModelFormat::StreamCodec>(stream.codec);
+        return ModelFormat::DecodeStream(stream, storedData.data(), data.size(), elementSize);
+    }
+
+    ModelFormat::MeshHeader GetFullMeshHeader(void)
+    {
+        ModelFormat::MeshHeader meshHeader;
+        std::strncpy(meshHeader.material, "stone", sizeof(meshHeader.material) - 1);
+        meshHeader.vertexCount = 24;
+        meshHeader.faceCount = 12;
+        meshHeader.normalEncoding = static_cast<uint8_t>(ModelFormat::NormalEncoding::RG);
+        meshHeader.indexSize = sizeof(uint16_t);
+        meshHeader.vertexEncoding = static_cast<uint8_t>(ModelFormat::VertexEncoding::Quantized);
+        for (uint32_t streamIndex = 0; streamIndex < ModelFormat::StreamCount; ++streamIndex)
+        {
+            meshHeader.streamList[streamIndex] = { (100 + streamIndex), static_cast<uint8_t>(ModelFormat::StreamCodec::ShuffledLZ4) };
+        }
+
+        meshHeader.indexStream = { 72, static_cast<uint8_t>(ModelFormat::StreamCodec::LZ4) };
+        meshHeader.positionMinimum = Math::Float3(-1.0f, -2.0f, -3.0f);
+        meshHeader.positionScale = 6.0f;
+        meshHeader.levelCount = 2;
+        meshHeader.levelIndexCountList[0] = 18;
+        meshHeader.levelIndexCountList[1] = 6;
+        meshHeader.levelErrorList[0] = 0.01f;
+        meshHeader.levelErrorList[1] = 0.1f;
+        meshHeader.meshletCount = 1;
+        meshHeader.meshletStream = { 40, static_cast<uint8_t>(ModelFormat::StreamCodec::None) };
+        return meshHeader;
+    }
+
+    // Stores the header the way the given version wrote it, each version only ever appended fields
+    ModelFormat::MeshHeader StoreAndRead(ModelFormat::MeshHeader const &meshHeader, uint16_t version)
+    {
+        std::vector<uint8_t> storedData(ModelFormat::GetMeshHeaderSize(version));
+        std::memcpy(storedData.data(), &meshHeader, storedData.size());
+        return ModelFormat::ReadMeshHeader(version, storedData.data());
+    }
+}; // namespace
+
+TEST(ModelFormat, SupportedVersions)
+{
+    EXPECT_FALSE(ModelFormat::IsSupportedVersion(ModelFormat::LegacyVersion - 1));
+    for (uint16_t version = ModelFormat::LegacyVersion; version <= ModelFormat::CurrentVersion; ++version)
+    {
+        EXPECT_TRUE(ModelFormat::IsSupportedVersion(version));
+    }
+
+    EXPECT_FALSE(ModelFormat::IsSupportedVersion(ModelFormat::CurrentVersion + 1));
+    for (uint16_t version = ModelFormat::UncompressedVersion; version <= ModelFormat::CurrentVersion; ++version)
+    {
+        EXPECT_GT(ModelFormat::GetMeshHeaderSize(version), ModelFormat::GetMeshHeaderSize(version - 1));
+    }
+}
+
+TEST(ModelFormat, StreamsRoundTripThroughEveryCodec)
+{
+    ModelFormat::StreamCodec codec;
+    auto randomData = GetRandomData(4096);
+    EXPECT_EQ(RoundTrip(randomData, sizeof(float), false, codec), randomData);
+    EXPECT_EQ(codec, ModelFormat::StreamCodec::None);
+    EXPECT_EQ(RoundTrip(randomData, sizeof(float), true, codec), randomData);
+    EXPECT_EQ(codec, ModelFormat::StreamCodec::None);
+
+    std::vector<uint8_t> repeatedData(4096);
+    for (size_t index = 0; index < repeatedData.size(); ++index)
+    {
+        repeatedData[index] = static_cast<uint8_t>(index % 7);
+    }
+
+    EXPECT_EQ(RoundTrip(repeatedData, 1, true, codec), repeatedData);
+    EXPECT_EQ(codec, ModelFormat::StreamCodec::LZ4);
+
+    auto positionData = GetPositionData(1024);
+    EXPECT_EQ(RoundTrip(positionData, sizeof(float), true, codec), positionData);
+    EXPECT_EQ(codec, ModelFormat::StreamCodec::ShuffledLZ4);
+
+    // Trailing bytes that do not fill an element still come back
+    positionData.resize(positionData.size() - 3);
+    EXPECT_EQ(RoundTrip(positionData, sizeof(float), true, codec), positionData);
+}
+
+TEST(ModelFormat, EmptyStreamsEncodeToNothing)
+{
+    ModelFormat::MeshHeader::Stream stream;
+    EXPECT_TRUE(ModelFormat::EncodeStream(nullptr, 0, sizeof(float), true, stream).empty());
+    EXPECT_EQ(stream.storedSize, 0U);
+    EXPECT_EQ(stream.codec, static_cast<uint8_t>(ModelFormat::StreamCodec::None));
+}
+
+TEST(ModelFormat, MalformedStreamsDecodeEmpty)
+{
+    auto positionData = GetPositionData(256);
+    ModelFormat::MeshHeader::Stream stream;
+    auto storedData = ModelFormat::EncodeStream(positionData.data(), positionData.size(), sizeof(float), true, stream);
+    ASSERT_NE(stream.codec, static_cast<uint8_t>(ModelFormat::StreamCodec::None));
+
+    EXPECT_TRUE(ModelFormat::DecodeStream(stream, nullptr, positionData.size(), sizeof(float)).empty());
+    EXPECT_TRUE(ModelFormat::DecodeStream(stream, storedData.data(), (positionData.size() + 1), sizeof(float)).empty());
+
+    auto truncatedStream = stream;
+    --truncatedStream.storedSize;
+    EXPECT_TRUE(ModelFormat::DecodeStream(truncatedStream, storedData.data(), positionData.size(), sizeof(float)).empty());
+
+    auto unknownStream = stream;
+    unknownStream.codec = 7;
+    EXPECT_TRUE(ModelFormat::DecodeStream(unknownStream, storedData.data(), positionData.size(), sizeof(float)).empty());
+
+    ModelFormat::MeshHeader::Stream rawStream = { static_cast<uint32_t>(positionData.size() - 1), static_cast<uint8_t>(ModelFormat::StreamCodec::None) };
+    EXPECT_TRUE(ModelFormat::DecodeStream(rawStream, positionData.data(), positionData.size(), sizeof(float)).empty());
+}
+
+TEST(ModelFormat, CurrentMeshHeaderRoundTrips)
+{
+    auto meshHeader = GetFullMeshHeader();
+    auto readHeader = StoreAndRead(meshHeader, ModelFormat::CurrentVersion);
+    EXPECT_EQ(std::memcmp(&readHeader, &meshHeader, sizeof(ModelFormat::MeshHeader)), 0);
+}
+
+TEST(ModelFormat, CompressedMeshHeadersKeepDefaultsForLaterFields)
+{
+    auto meshHeader = GetFullMeshHeader();
+    ModelFormat::MeshHeader defaultHeader;
+
+    auto levelHeader = StoreAndRead(meshHeader, ModelFormat::LevelVersion);
+    EXPECT_EQ(levelHeader.levelCount, 2U);
+    EXPECT_EQ(levelHeader.levelIndexCountList[1], 6U);
+    EXPECT_EQ(levelHeader.meshletCount, 0U);
+    EXPECT_EQ(levelHeader.meshletStream.storedSize, 0U);
+
+    auto quantizedHeader = StoreAndRead(meshHeader, ModelFormat::QuantizedVersion);
+    EXPECT_EQ(quantizedHeader.positionScale, 6.0f);
+    EXPECT_EQ(quantizedHeader.positionMinimum.y, -2.0f);
+    EXPECT_EQ(quantizedHeader.levelCount, 0U);
+
+    auto indexedHeader = StoreAndRead(meshHeader, ModelFormat::IndexedVersion);
+    EXPECT_EQ(indexedHeader.indexStream.storedSize, 72U);
+    EXPECT_EQ(indexedHeader.positionScale, defaultHeader.positionScale);
+
+    auto compressedHeader = StoreAndRead(meshHeader, ModelFormat::CompressedVersion);
+    EXPECT_STREQ(compressedHeader.material, "stone");
+    EXPECT_EQ(compressedHeader.vertexCount, 24U);
+    EXPECT_EQ(compressedHeader.indexSize, sizeof(uint16_t));
+    EXPECT_EQ(compressedHeader.streamList[3].storedSize, 103U);
+    EXPECT_EQ(compressedHeader.streamList[3].codec, static_cast<uint8_t>(ModelFormat::StreamCodec::ShuffledLZ4));
+    EXPECT_EQ(compressedHeader.indexStream.storedSize, 0U);
+}
+
+TEST(ModelFormat, LegacyMeshHeadersStoreRawFloatStreams)
+{
+    ModelFormat::LegacyMeshHeader legacyMeshHeader;
+    std::strncpy(legacyMeshHeader.material, "legacy", sizeof(legacyMeshHeader.material) - 1);
+    legacyMeshHeader.vertexCount = 10;
+    legacyMeshHeader.faceCount = 4;
+
+    std::vector<uint8_t> storedData(ModelFormat::GetMeshHeaderSize(ModelFormat::LegacyVersion));
+    ASSERT_EQ(storedData.size(), sizeof(ModelFormat::LegacyMeshHeader));
+    std::memcpy(storedData.data(), &legacyMeshHeader, storedData.size());
+
+    auto meshHeader = ModelFormat::ReadMeshHeader(ModelFormat::LegacyVersion, storedData.data());
+    EXPECT_STREQ(meshHeader.material, "legacy");
+    EXPECT_EQ(meshHeader.vertexCount, 10U);
+    EXPECT_EQ(meshHeader.faceCount, 4U);
+    EXPECT_EQ(meshHeader.normalEncoding, static_cast<uint8_t>(ModelFormat::NormalEncoding::RGB));
+    EXPECT_EQ(meshHeader.vertexEncoding, static_cast<uint8_t>(ModelFormat::VertexEncoding::Float));
+    EXPECT_EQ(meshHeader.indexSize, 0U);
+    EXPECT_EQ(meshHeader.levelCount, 0U);
+    EXPECT_EQ(meshHeader.meshletCount, 0U);
+    for (uint32_t streamIndex = 0; streamIndex < ModelFormat::StreamCount; ++streamIndex)
+    {
+        auto const &stream = meshHeader.streamList[streamIndex];
+        EXPECT_EQ(stream.codec, static_cast<uint8_t>(ModelFormat::StreamCodec::None));
+        EXPECT_EQ(stream.storedSize, (10U * ModelFormat::StreamStrideList[0][streamIndex]));
+    }
+
+    // Raw streams decode as they are stored
+    auto positionData = GetRandomData(meshHeader.streamList[0].storedSize);
+    EXPECT_EQ(ModelFormat::DecodeStream(meshHeader.streamList[0], positionData.data(), positionData.size(), sizeof(float)), positionData);
+}
+
+TEST(ModelFormat, UncompressedMeshHeadersKeepTheirNormalEncoding)
+{
+    ModelFormat::UncompressedMeshHeader uncompressedMeshHeader;
+    std::strncpy(uncompressedMeshHeader.material, "uncompressed", sizeof(uncompressedMeshHeader.material) - 1);
+    uncompressedMeshHeader.vertexCount = 6;
+    uncompressedMeshHeader.faceCount = 2;
+    uncompressedMeshHeader.normalEncoding = static_cast<uint8_t>(ModelFormat::NormalEncoding::RG);
+
+    std::vector<uint8_t> storedData(ModelFormat::GetMeshHeaderSize(ModelFormat::UncompressedVersion));
+    ASSERT_EQ(storedData.size(), sizeof(ModelFormat::UncompressedMeshHeader));
+    std::memcpy(storedData.data(), &uncompressedMeshHeader, storedData.size());
+
+    auto meshHeader = ModelFormat::ReadMeshHeader(ModelFormat::UncompressedVersion, storedData.data());
+    EXPECT_STREQ(meshHeader.material, "uncompressed");
+    EXPECT_EQ(meshHeader.vertexCount, 6U);
+    EXPECT_EQ(meshHeader.faceCount, 2U);
+    EXPECT_EQ(meshHeader.normalEncoding, static_cast<uint8_t>(ModelFormat::NormalEncoding::RG));
+    EXPECT_EQ(meshHeader.indexSize, 0U);
+    EXPECT_EQ(meshHeader.streamList[2].storedSize, (6U * sizeof(Math::Float4)));
+    EXPECT_EQ(meshHeader.streamList[2].codec, static_cast<uint8_t>(ModelFormat::StreamCodec::None));
+}
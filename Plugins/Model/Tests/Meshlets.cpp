@@ -0,0 +1,108 @@
+#include "GEK/Model/Meshlets.hpp"
+#include "GEK/Shapes/Frustum.hpp"
+#include <gtest/gtest.h>
+
+using namespace Gek;
+
+namespace
+{
+    struct Meshlet
+    {
+        Math::Float3 center;
+        float radius;
+        Math::Float3 coneAxis;
+        float coneCutoff;
+    };
+
+    // One triangle per meshlet, in front of the view and facing it, in front of the view and facing away, and off to
+    // the side outside of the frustum
+    Meshlets::List CreateMeshletList(void)
+    {
+        static const Meshlet meshletList[] = {
+            { Math::Float3(0.0f, 0.0f, 5.0f), 1.0f, Math::Float3(0.0f, 0.0f, -1.0f), 0.0f },
+            { Math::Float3(0.0f, 0.0f, 5.0f), 1.0f, Math::Float3(0.0f, 0.0f, 1.0f), 0.0f },
+            { Math::Float3(50.0f, 0.0f, 5.0f), 1.0f, Math::Float3(0.0f, 0.0f, -1.0f), 0.0f },
+        };
+
+        Meshlets::List list;
+        for (uint32_t meshletIndex = 0; meshletIndex < std::size(meshletList); ++meshletIndex)
+        {
+            auto const &meshlet = meshletList[meshletIndex];
+            const float elementList[8] = { meshlet.center.x, meshlet.center.y, meshlet.center.z, meshlet.radius, meshlet.coneAxis.x, meshlet.coneAxis.y, meshlet.coneAxis.z, meshlet.coneCutoff };
+            for (size_t element = 0; element < 8; ++element)
+            {
+                list.elementList[element].push_back(elementList[element]);
+            }
+
+            list.firstIndexList.push_back(meshletIndex * 3);
+            list.indexCountList.push_back(3);
+        }
+
+        for (auto &elementList : list.elementList)
+        {
+            elementList.resize(8, 0.0f);
+        }
+
+        return list;
+    }
+
+    uint32_t Cull(Meshlets::Culling culling, Math::Float4x4 const &modelViewMatrix, Math::Float4x4 const &projectionMatrix, std::vector<Meshlets::IndexRange> &rangeList)
+    {
+        Shapes::Frustum frustum(modelViewMatrix * projectionMatrix);
+        std::vector<uint8_t> visibilityList;
+        return Meshlets::Cull(CreateMeshletList(), culling, Math::SIMD::loadFrustum(&frustum.planeList[0].vector), modelViewMatrix.getInverse().translation(), visibilityList, rangeList);
+    }
+
+    const Math::Float4x4 PerspectiveMatrix(Math::Float4x4::MakePerspective(Math::DegreesToRadians(90.0f), 1.0f, 0.1f, 100.0f));
+    const Math::Float4x4 OrthographicMatrix(Math::Float4x4::MakeOrthographic(-10.0f, 10.0f, 10.0f, -10.0f, 0.1f, 100.0f));
+}; // namespace
+
+TEST(Meshlets, BackCulledMaterialDropsBackFacingMeshlets)
+{
+    auto culling = Meshlets::GetCulling(Render::RenderState::CullMode::Back, Math::Float4x4::Identity, PerspectiveMatrix);
+    EXPECT_EQ(culling, Meshlets::Culling::Backface);
+
+    std::vector<Meshlets::IndexRange> rangeList;
+    EXPECT_EQ(Cull(culling, Math::Float4x4::Identity, PerspectiveMatrix, rangeList), 2U);
+    ASSERT_EQ(rangeList.size(), 1U);
+    EXPECT_EQ(rangeList[0].firstIndex, 0U);
+    EXPECT_EQ(rangeList[0].indexCount, 3U);
+}
+
+TEST(Meshlets, TwoSidedMaterialKeepsBackFacingMeshlets)
+{
+    for (auto cullMode : { Render::RenderState::CullMode::None, Render::RenderState::CullMode::Front })
+    {
+        auto culling = Meshlets::GetCulling(cullMode, Math::Float4x4::Identity, PerspectiveMatrix);
+        EXPECT_EQ(culling, Meshlets::Culling::Frustum);
+
+        std::vector<Meshlets::IndexRange> rangeList;
+        EXPECT_EQ(Cull(culling, Math::Float4x4::Identity, PerspectiveMatrix, rangeList), 1U);
+        ASSERT_EQ(rangeList.size(), 1U);
+        EXPECT_EQ(rangeList[0].firstIndex, 0U);
+        EXPECT_EQ(rangeList[0].indexCount, 6U);
+    }
+}
+
+TEST(Meshlets, OrthographicViewKeepsBackFacingMeshlets)
+{
+    auto culling = Meshlets::GetCulling(Render::RenderState::CullMode::Back, Math::Float4x4::Identity, OrthographicMatrix);
+    EXPECT_EQ(culling, Meshlets::Culling::Frustum);
+
+    std::vector<Meshlets::IndexRange> rangeList;
+    EXPECT_EQ(Cull(culling, Math::Float4x4::Identity, OrthographicMatrix, rangeList), 1U);
+    ASSERT_EQ(rangeList.size(), 1U);
+    EXPECT_EQ(rangeList[0].indexCount, 6U);
+}
+
+TEST(Meshlets, MirroredInstanceKeepsBackFacingMeshlets)
+{
+    auto mirrorMatrix(Math::Float4x4::MakeScaling(Math::Float3(-1.0f, 1.0f, 1.0f)));
+    auto culling = Meshlets::GetCulling(Render::RenderState::CullMode::Back, mirrorMatrix, PerspectiveMatrix);
+    EXPECT_EQ(culling, Meshlets::Culling::Frustum);
+
+    std::vector<Meshlets::IndexRange> rangeList;
+    EXPECT_EQ(Cull(culling, mirrorMatrix, PerspectiveMatrix, rangeList), 1U);
+    ASSERT_EQ(rangeList.size(), 1U);
+    EXPECT_EQ(rangeList[0].indexCount, 6U);
+}
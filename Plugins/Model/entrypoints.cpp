@@ -3,11 +3,14 @@
 namespace Gek
 {
     GEK_DECLARE_CONTEXT_USER(Model);
+    GEK_DECLARE_CONTEXT_USER(Occluder);
     GEK_DECLARE_CONTEXT_USER(ModelProcessor);
 
     GEK_CONTEXT_BEGIN(Engine);
     GEK_CONTEXT_ADD_CLASS(Components::Model, Model);
     GEK_CONTEXT_ADD_TYPE(ComponentType)
+    GEK_CONTEXT_ADD_CLASS(Components::Occluder, Occluder);
+    GEK_CONTEXT_ADD_TYPE(ComponentType)
     GEK_CONTEXT_ADD_CLASS(Processors::ModelProcessor, ModelProcessor);
     GEK_CONTEXT_ADD_TYPE(ProcessorType);
     GEK_CONTEXT_END()
@@ -0,0 +1,151 @@
+/// @file
+/// @author Todd Zupan <toddzupan@gmail.com>
+/// @version $Revision$
+/// @section LICENSE
+/// https://en.wikipedia.org/wiki/MIT_License
+/// @section DESCRIPTION
+/// Last Changed: $Date$
+#pragma once
+
+#include "GEK/Utility/Compression.hpp"
+#include "GEK/Utility/FileSystem.hpp"
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace Gek
+{
+    // Layout of the .gek physics files written by createhull and createtree, shared with the loader
+    namespace PhysicsFormat
+    {
+        static constexpr uint32_t Identifier = (uint32_t('G') | (uint32_t('E') << 8) | (uint32_t('K') << 16) | (uint32_t('X') << 24));
+
+        static constexpr uint16_t UncompressedVersion = 3;
+        static constexpr uint16_t CurrentVersion = 4;
+
+        inline bool IsSupportedVersion(uint16_t version)
+        {
+            return ((version == UncompressedVersion) || (version == CurrentVersion));
+        }
+
+        struct Header
+        {
+            uint32_t identifier = Identifier;
+            uint16_t type = 0;
+            uint16_t version = CurrentVersion;
+        };
+
+        // Version 4 stores everything after the header as one chunk, compressed when that made it smaller
+        struct Payload
+        {
+            Compression::Type compression = Compression::Type::None;
+            uint8_t reserved[3] = { 0, 0, 0 };
+            uint32_t size = 0;
+            uint32_t storedSize = 0;
+        };
+
+        // Takes a whole version 3 layout, header first, and returns the version 4 file for it
+        inline std::vector<uint8_t> EncodePayload(std::vector<uint8_t> const &buffer, bool compress)
+        {
+            if (buffer.size() < sizeof(Header))
+            {
+                return {};
+            }
+
+            auto payloadData = (buffer.data() + sizeof(Header));
+            auto payloadSize = (buffer.size() - sizeof(Header));
+
+            std::vector<uint8_t> storedData;
+            if (compress)
+            {
+                storedData = Compression::Compress(payloadData, payloadSize);
+            }
+
+            Payload payload;
+            payload.size = static_cast<uint32_t>(payloadSize);
+            if (storedData.empty())
+            {
+                storedData.assign(payloadData, (payloadData + payloadSize));
+            }
+            else
+            {
+                payload.compression = Compression::Type::LZ4;
+            }
+
+            payload.storedSize = static_cast<uint32_t>(storedData.size());
+
+            Header header;
+            std::memcpy(&header, buffer.data(), sizeof(Header));
+            header.version = CurrentVersion;
+
+            std::vector<uint8_t> fileData(sizeof(Header) + sizeof(Payload) + storedData.size());
+            std::memcpy(fileData.data(), &header, sizeof(Header));
+            std::memcpy((fileData.data() + sizeof(Header)), &payload, sizeof(Payload));
+            std::memcpy((fileData.data() + sizeof(Header) + sizeof(Payload)), storedData.data(), storedData.size());
+            return fileData;
+        }
+
+        // The payload is expanded behind a copy of the header, so the result reads just like a version 3 file, which
+        // is returned as it is.  Empty when the file is not a supported physics file or its payload does not decode.
+        inline FileSystem::FileView DecodePayload(FileSystem::FileView const &fileView)
+        {
+            if (fileView.getSize() < sizeof(Header))
+            {
+                return FileSystem::FileView();
+            }
+
+            Header header;
+            std::memcpy(&header, fileView.getData(), sizeof(Header));
+            if (header.identifier != Identifier || !IsSupportedVersion(header.version))
+            {
+                return FileSystem::FileView();
+            }
+            else if (header.version == UncompressedVersion)
+            {
+                return fileView;
+            }
+
+            Payload payload;
+            if (fileView.getSize() < (sizeof(Header) + sizeof(Payload)))
+            {
+                return FileSystem::FileView();
+            }
+
+            std::memcpy(&payload, (fileView.getData() + sizeof(Header)), sizeof(Payload));
+            if (payload.storedSize > (fileView.getSize() - sizeof(Header) - sizeof(Payload)))
+            {
+                return FileSystem::FileView();
+            }
+
+            auto storedData = (fileView.getData() + sizeof(Header) + sizeof(Payload));
+            const size_t size = (sizeof(Header) + payload.size);
+            auto buffer = std::make_shared_for_overwrite<uint8_t[]>(size);
+            std::memcpy(buffer.get(), &header, sizeof(Header));
+            switch (payload.compression)
+            {
+            case Compression::Type::None:
+                if (payload.storedSize != payload.size)
+                {
+                    return FileSystem::FileView();
+                }
+
+                std::memcpy((buffer.get() + sizeof(Header)), storedData, payload.size);
+                break;
+
+            case Compression::Type::LZ4:
+                if (!Compression::Decompress(storedData, payload.storedSize, (buffer.get() + sizeof(Header)), payload.size))
+                {
+                    return FileSystem::FileView();
+                }
+
+                break;
+
+            default:
+                return FileSystem::FileView();
+            };
+
+            return FileSystem::FileView(buffer, buffer.get(), size);
+        }
+    }; // namespace PhysicsFormat
+}; // namespace Gek
@@ -33,6 +33,17 @@ namespace Gek
                 data->mass = evaluate(importData, "mass", 0.0f);
             }
 
+            void cook(Components::Physical const *const data, std::vector<uint8_t> &buffer) const
+            {
+                cookValue(buffer, data->mass);
+            }
+
+            uint8_t const *uncook(Components::Physical *const data, uint8_t const *buffer, uint8_t const *bufferEnd)
+            {
+                buffer = uncookValue(buffer, bufferEnd, data->mass);
+                return buffer;
+            }
+
             // Edit::Component
             bool onUserInterface(ImGuiContext *const guiContext, Plugin::Entity *const entity, Plugin::Component::Data *data)
             {
@@ -9,6 +9,7 @@
 #include "GEK/Math/Matrix4x4.hpp"
 #include "GEK/Model/Base.hpp"
 #include "GEK/Physics/Base.hpp"
+#include "GEK/Physics/Format.hpp"
 #include "GEK/Physics/StaticBody.hpp"
 #include "GEK/Shapes/AlignedBox.hpp"
 #include "GEK/Utility/ContextUser.hpp"
@@ -19,6 +20,7 @@
 #include "GEK/Utility/ThreadPool.hpp"
 #include <dCollision/ndContactNotify.h>
 #include <dCollision/ndShapeCompound.h>
+#include <cstring>
 #include <future>
 #include <tbb/concurrent_unordered_map.h>
 #include <tbb/concurrent_vector.h>
@@ -33,13 +35,12 @@ namespace Gek
         class BufferReader
         {
           private:
-            uint8_t *buffer = nullptr;
-            size_t size = 0;
+            FileSystem::FileView view;
             size_t index = 0;
 
           public:
-            BufferReader(uint8_t *buffer, size_t size)
-                : buffer(buffer), size(size)
+            BufferReader(FileSystem::FileView const &view)
+                : view(view)
             {
             }
 
@@ -47,18 +48,18 @@ namespace Gek
             bool canRead(uint32_t count = 1) const
             {
                 size_t readSize = sizeof(TYPE) * static_cast<size_t>(count);
-                return (index + readSize) <= size;
+                return (index + readSize) <= view.getSize();
             }
 
             template <typename TYPE>
-            TYPE *read(uint32_t count = 1)
+            TYPE const *read(uint32_t count = 1)
             {
                 if (!canRead<TYPE>(count))
                 {
                     return nullptr;
                 }
 
-                TYPE *data = (TYPE *)(buffer + index);
+                auto data = reinterpret_cast<TYPE const *>(view.getData() + index);
                 index += (sizeof(TYPE) * count);
                 return data;
             }
@@ -68,12 +69,7 @@ namespace Gek
         , public Plugin::Processor, public World
         {
           public:
-            struct Header
-            {
-                uint32_t identifier = 0;
-                uint16_t type = 0;
-                uint16_t version = 0;
-            };
+            using Header = PhysicsFormat::Header;
 
             struct HullHeader : public Header
             {
@@ -131,19 +127,12 @@ namespace Gek
                     for (NodeType *node = points.GetFirst(); node; node = node->GetNext())
                     {
                         const ndContactMaterial &cp = node->GetInfo();
-                        Plugin::Entity *entity0 = nullptr;
-                        Plugin::Entity *entity1 = nullptr;
-                        ndBodyKinematic *body0 = (ndBodyKinematic *)contact->GetBody0();
-                        ndBodyKinematic *body1 = (ndBodyKinematic *)contact->GetBody1();
-                        for (auto &pair : processor->entityBodyMap)
-                        {
-                            if (pair.second && pair.second->getAsNewtonBody() == body0)
-                                entity0 = pair.first;
-                            if (pair.second && pair.second->getAsNewtonBody() == body1)
-                                entity1 = pair.first;
-                        }
-                        if (!entity0 || !entity1)
+                        auto entity0Search = processor->bodyEntityMap.find(contact->GetBody0());
+                        auto entity1Search = processor->bodyEntityMap.find(contact->GetBody1());
+                        if (entity0Search == std::end(processor->bodyEntityMap) || entity1Search == std::end(processor->bodyEntityMap))
                             continue;
+                        Plugin::Entity *entity0 = entity0Search->second;
+                        Plugin::Entity *entity1 = entity1Search->second;
                         Math::Float3 position(cp.m_point.m_x, cp.m_point.m_y, cp.m_point.m_z);
                         Math::Float3 normal(cp.m_normal.m_x, cp.m_normal.m_y, cp.m_normal.m_z);
                         processor->onCollision(entity0, position, normal, entity1);
@@ -169,14 +158,17 @@ namespace Gek
             tbb::concurrent_vector<Surface> surfaceList;
             tbb::concurrent_unordered_map<std::size_t, uint32_t> surfaceIndexMap;
             NewtonWorld *newtonWorld = nullptr;
-            ThreadPool loadPool;
+            ThreadPool *threadPool = nullptr;
+            TaskGroup loadTaskGroup;
+            uint32_t updateStageIdentifier = 0;
 
             tbb::concurrent_unordered_map<Plugin::Entity *, Physics::Body *> entityBodyMap;
+            tbb::concurrent_unordered_map<ndBody *, Plugin::Entity *> bodyEntityMap;
             tbb::concurrent_unordered_map<Hash, std::shared_future<ndShape *>> shapeFutureMap;
 
           public:
             Processor(Context * context, Plugin::Core * core)
-                : ContextRegistration(context), core(core), population(core->getPopulation()), renderer(core->getVisualizer()), loadPool(5)
+                : ContextRegistration(context), core(core), population(core->getPopulation()), renderer(core->getVisualizer()), threadPool(core->getThreadPool())
             {
                 assert(core);
                 assert(population);
@@ -186,10 +178,20 @@ namespace Gek
                 core->onShutdown.connect(this, &Processor::onShutdown);
                 population->onReset.connect(this, &Processor::onReset);
                 population->onEntityCreated.connect(this, &Processor::onEntityCreated);
+                population->onEntityListCreated.connect(this, &Processor::onEntityListCreated);
                 population->onEntityDestroyed.connect(this, &Processor::onEntityDestroyed);
                 population->onComponentAdded.connect(this, &Processor::onComponentAdded);
                 population->onComponentRemoved.connect(this, &Processor::onComponentRemoved);
-                population->onUpdate[50].connect(this, &Processor::onUpdate);
+                updateStageIdentifier = population->addUpdateStage({
+                    .name = "physics",
+                    .order = 50,
+                    .readList = { Components::Physical::GetIdentifier(), Components::Player::GetIdentifier(), Components::Model::GetIdentifier() },
+                    .writeList = { Components::Transform::GetIdentifier() },
+                    .onUpdate = [this](float frameTime) -> void
+                    {
+                        onUpdate(frameTime);
+                    },
+                });
                 renderer->onShowUserInterface.connect(this, &Processor::onShowUserInterface);
 
                 onReset();
@@ -207,6 +209,7 @@ namespace Gek
                     newtonWorld->CleanUp();
 
                     entityBodyMap.clear();
+                    bodyEntityMap.clear();
                     shapeFutureMap.clear();
 
                     delete newtonWorld;
@@ -214,9 +217,17 @@ namespace Gek
                 }
             }
 
-            Task scheduleLoadShape(std::shared_ptr<std::promise<ndShape *>> promise, Components::Model const &modelComponent)
+            Task<> scheduleLoadShape(std::shared_ptr<std::promise<ndShape *>> promise, Components::Model const &modelComponent)
             {
-                co_await loadPool.schedule();
+                try
+                {
+                    co_await threadPool->schedule(loadTaskGroup, ThreadPool::Queue::Streaming);
+                }
+                catch (TaskCancelled const &)
+                {
+                    promise->set_value(nullptr);
+                    co_return;
+                }
 
                 ndShape *shape = nullptr;
                 if (modelComponent.name == "#cube")
@@ -233,16 +244,16 @@ namespace Gek
                 {
                     auto filePath = getContext()->findDataPath(FileSystem::CreatePath("physics", modelComponent.name).withExtension(".gek"));
                     getContext()->log(Context::Info, "Loading physics model from file: {}", filePath.getFileName());
-                    std::vector<uint8_t> buffer(FileSystem::Load(filePath));
-                    if (buffer.size() < sizeof(Header))
+                    auto fileView = FileSystem::Map(filePath);
+                    if (fileView.getSize() < sizeof(Header))
                     {
                         getContext()->log(Context::Error, "File too small to be physics model: {}", modelComponent.name);
                         promise->set_value(nullptr);
                         co_return;
                     }
 
-                    BufferReader reader(buffer.data(), buffer.size());
-                    Header *header = reader.read<Header>(0);
+                    BufferReader reader(fileView);
+                    Header const *header = reader.read<Header>(0);
                     if (!header)
                     {
                         getContext()->log(Context::Error, "Unable to read physics header: {}", modelComponent.name);
@@ -250,24 +261,38 @@ namespace Gek
                         co_return;
                     }
 
-                    if (header->identifier != *(uint32_t *)"GEKX")
+                    if (header->identifier != PhysicsFormat::Identifier)
                     {
                         getContext()->log(Context::Error, "Unknown model file identifier encountered: {}", modelComponent.name);
                         promise->set_value(nullptr);
                         co_return;
                     }
 
-                    if (header->version != 3)
+                    if (!PhysicsFormat::IsSupportedVersion(header->version))
                     {
-                        getContext()->log(Context::Error, "Unsupported model version encountered (requires: 3, has: {}): {}", header->version, modelComponent.name);
+                        getContext()->log(Context::Error, "Unsupported model version encountered (requires: 3 or 4, has: {}): {}", header->version, modelComponent.name);
                         promise->set_value(nullptr);
                         co_return;
                     }
 
+                    if (header->version >= PhysicsFormat::CurrentVersion)
+                    {
+                        fileView = PhysicsFormat::DecodePayload(fileView);
+                        if (!fileView.isValid())
+                        {
+                            getContext()->log(Context::Error, "Unable to decode physics model data: {}", modelComponent.name);
+                            promise->set_value(nullptr);
+                            co_return;
+                        }
+
+                        reader = BufferReader(fileView);
+                        header = reader.read<Header>(0);
+                    }
+
                     if (header->type == 1)
                     {
                         getContext()->log(Context::Info, "Loading convex hull for static scene: {}", modelComponent.name);
-                        HullHeader *hullHeader = reader.read<HullHeader>();
+                        HullHeader const *hullHeader = reader.read<HullHeader>();
                         if (!hullHeader)
                         {
                             getContext()->log(Context::Error, "Unable to read convex hull header: {}", modelComponent.name);
@@ -275,7 +300,7 @@ namespace Gek
                             co_return;
                         }
 
-                        Math::Float3 *points = reader.read<Math::Float3>(hullHeader->pointCount);
+                        Math::Float3 const *points = reader.read<Math::Float3>(hullHeader->pointCount);
                         if (!points)
                         {
                             getContext()->log(Context::Error, "Invalid convex hull point data in physics model: {}", modelComponent.name);
@@ -288,7 +313,7 @@ namespace Gek
                     else if (header->type == 2)
                     {
                         getContext()->log(Context::Info, "Loading tree mesh for static scene: {}", modelComponent.name);
-                        TreeHeader *treeHeader = reader.read<TreeHeader>();
+                        TreeHeader const *treeHeader = reader.read<TreeHeader>();
                         if (!treeHeader)
                         {
                             getContext()->log(Context::Error, "Unable to read tree mesh header: {}", modelComponent.name);
@@ -300,7 +325,7 @@ namespace Gek
                         std::vector<std::string> materialNames;
                         for (uint32_t i = 0; i < treeHeader->materialCount; ++i)
                         {
-                            TreeHeader::Material *mat = reader.read<TreeHeader::Material>();
+                            TreeHeader::Material const *mat = reader.read<TreeHeader::Material>();
                             if (!mat)
                             {
                                 getContext()->log(Context::Error, "Invalid material data in tree physics model: {}", modelComponent.name);
@@ -315,7 +340,7 @@ namespace Gek
                         std::vector<TreeHeader::Mesh> meshes;
                         for (uint32_t i = 0; i < treeHeader->meshCount; ++i)
                         {
-                            TreeHeader::Mesh *mesh = reader.read<TreeHeader::Mesh>();
+                            TreeHeader::Mesh const *mesh = reader.read<TreeHeader::Mesh>();
                             if (!mesh)
                             {
                                 getContext()->log(Context::Error, "Invalid mesh header in tree physics model: {}", modelComponent.name);
@@ -340,8 +365,8 @@ namespace Gek
 
                         for (auto &mesh : meshes)
                         {
-                            TreeHeader::Face *faces = reader.read<TreeHeader::Face>(mesh.faceCount);
-                            Math::Float3 *meshPoints = reader.read<Math::Float3>(mesh.pointCount);
+                            TreeHeader::Face const *faces = reader.read<TreeHeader::Face>(mesh.faceCount);
+                            Math::Float3 const *meshPoints = reader.read<Math::Float3>(mesh.pointCount);
                             if (!faces || !meshPoints)
                             {
                                 getContext()->log(Context::Error, "Invalid face/point data in tree physics model: {}", modelComponent.name);
@@ -491,6 +516,7 @@ namespace Gek
                                 newtonWorld->AddBody(staticBody->getAsNewtonBody());
                                 fprintf(stderr, "[addEntity] static-branch: AddBody done\n"); fflush(stderr);
                             }
+                            bodyEntityMap[staticBody->getAsNewtonBody()] = entity;
                             entityBodyMap[entity] = staticBody.release();
                             fprintf(stderr, "[addEntity] static-branch: done\n"); fflush(stderr);
                         }
@@ -543,6 +569,7 @@ namespace Gek
                         newtonWorld->AddBody(sharedBody);
                         fprintf(stderr, "[addEntity] dynamic AddBody done\n"); fflush(stderr);
                     }
+                    bodyEntityMap[body->getAsNewtonBody()] = entity;
                     entityBodyMap[entity] = body.release();
                 }
                 fprintf(stderr, "[addEntity] EXIT\n"); fflush(stderr);
@@ -553,6 +580,7 @@ namespace Gek
                 auto entitySearch = entityBodyMap.find(entity);
                 if (entitySearch != std::end(entityBodyMap))
                 {
+                    bodyEntityMap.unsafe_erase(entitySearch->second->getAsNewtonBody());
                     newtonWorld->RemoveBody(entitySearch->second->getAsNewtonBody());
                     entityBodyMap.unsafe_erase(entitySearch);
                 }
@@ -580,11 +608,13 @@ namespace Gek
                 renderer->onShowUserInterface.disconnect(this, &Processor::onShowUserInterface);
                 population->onReset.disconnect(this, &Processor::onReset);
                 population->onEntityCreated.disconnect(this, &Processor::onEntityCreated);
+                population->onEntityListCreated.disconnect(this, &Processor::onEntityListCreated);
                 population->onEntityDestroyed.disconnect(this, &Processor::onEntityDestroyed);
                 population->onComponentAdded.disconnect(this, &Processor::onComponentAdded);
                 population->onComponentRemoved.disconnect(this, &Processor::onComponentRemoved);
-                population->onUpdate[50].disconnect(this, &Processor::onUpdate);
+                population->removeUpdateStage(updateStageIdentifier);
 
+                loadTaskGroup.join();
                 clear();
             }
 
@@ -653,6 +683,14 @@ namespace Gek
                 addEntity(entity);
             }
 
+            void onEntityListCreated(std::vector<Plugin::Entity *> const &entityList)
+            {
+                for (auto entity : entityList)
+                {
+                    addEntity(entity);
+                }
+            }
+
             void onEntityDestroyed(Plugin::Entity *const entity)
             {
                 removeEntity(entity);
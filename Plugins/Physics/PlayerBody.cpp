@@ -97,6 +97,7 @@ namespace Gek
                     auto &transformComponent = playerBody->entity->getComponent<Components::Transform>();
                     transformComponent.rotation = mat->getRotation();
                     transformComponent.position = mat->translation();
+                    ++transformComponent.version;
                 }
 
                 void OnApplyExternalForce(ndInt32 threadIndex, ndFloat32 timeStep) override
@@ -36,6 +36,23 @@ namespace Gek
         data->stairStep = evaluate(importData, "stairStep", 0.0f);
     }
 
+    void cook(Components::Player const *const data, std::vector<uint8_t> &buffer) const
+    {
+        cookValue(buffer, data->height);
+        cookValue(buffer, data->outerRadius);
+        cookValue(buffer, data->innerRadius);
+        cookValue(buffer, data->stairStep);
+    }
+
+    uint8_t const *uncook(Components::Player *const data, uint8_t const *buffer, uint8_t const *bufferEnd)
+    {
+        buffer = uncookValue(buffer, bufferEnd, data->height);
+        buffer = uncookValue(buffer, bufferEnd, data->outerRadius);
+        buffer = uncookValue(buffer, bufferEnd, data->innerRadius);
+        buffer = uncookValue(buffer, bufferEnd, data->stairStep);
+        return buffer;
+    }
+
     // Edit::Component
     bool onUserInterface(ImGuiContext *const guiContext, Plugin::Entity *const entity, Plugin::Component::Data *data)
     {
@@ -92,6 +92,7 @@ namespace Gek
                 auto &transformComponent = entity->getComponent<Components::Transform>();
                 transformComponent.rotation = matrix->getRotation();
                 transformComponent.position = matrix->translation();
+                ++transformComponent.version;
             }
 
             void OnApplyExternalForce(ndBodyNotify *bodyNotify, ndInt32 threadIndex, ndFloat32 timeStep)
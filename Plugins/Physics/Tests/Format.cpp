@@ -0,0 +1,135 @@
+#include "GEK/Physics/Format.hpp"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace Gek;
+
+namespace
+{
+    // A version 3 hull, the header followed by the point count and the points
+    std::vector<uint8_t> GetHullData(uint16_t version, uint32_t pointCount)
+    {
+        PhysicsFormat::Header header;
+        header.type = 1;
+        header.version = version;
+
+        std::vector<float> pointList(pointCount * 3);
+        for (size_t index = 0; index < pointList.size(); ++index)
+        {
+            pointList[index] = float(index % 12);
+        }
+
+        std::vector<uint8_t> buffer(sizeof(PhysicsFormat::Header) + sizeof(uint32_t) + (pointList.size() * sizeof(float)));
+        std::memcpy(buffer.data(), &header, sizeof(PhysicsFormat::Header));
+        std::memcpy((buffer.data() + sizeof(PhysicsFormat::Header)), &pointCount, sizeof(uint32_t));
+        std::memcpy((buffer.data() + sizeof(PhysicsFormat::Header) + sizeof(uint32_t)), pointList.data(), (pointList.size() * sizeof(float)));
+        return buffer;
+    }
+
+    FileSystem::FileView GetView(std::vector<uint8_t> const &data)
+    {
+        auto owner = std::make_shared<std::vector<uint8_t>>(data);
+        return FileSystem::FileView(owner, owner->data(), owner->size());
+    }
+
+    std::vector<uint8_t> GetData(FileSystem::FileView const &view)
+    {
+        return std::vector<uint8_t>(view.getData(), (view.getData() + view.getSize()));
+    }
+
+    PhysicsFormat::Payload GetPayload(std::vector<uint8_t> const &fileData)
+    {
+        PhysicsFormat::Payload payload;
+        std::memcpy(&payload, (fileData.data() + sizeof(PhysicsFormat::Header)), sizeof(PhysicsFormat::Payload));
+        return payload;
+    }
+
+    void SetPayload(std::vector<uint8_t> &fileData, PhysicsFormat::Payload const &payload)
+    {
+        std::memcpy((fileData.data() + sizeof(PhysicsFormat::Header)), &payload, sizeof(PhysicsFormat::Payload));
+    }
+}; // namespace
+
+TEST(PhysicsFormat, PayloadsRoundTrip)
+{
+    auto hullData = GetHullData(PhysicsFormat::CurrentVersion, 256);
+    for (bool compress : { false, true })
+    {
+        auto fileData = PhysicsFormat::EncodePayload(hullData, compress);
+        auto payload = GetPayload(fileData);
+        EXPECT_EQ(payload.compression, (compress ? Compression::Type::LZ4 : Compression::Type::None));
+        EXPECT_EQ(payload.size, (hullData.size() - sizeof(PhysicsFormat::Header)));
+        EXPECT_EQ(fileData.size(), (sizeof(PhysicsFormat::Header) + sizeof(PhysicsFormat::Payload) + payload.storedSize));
+        if (compress)
+        {
+            EXPECT_LT(payload.storedSize, payload.size);
+        }
+
+        EXPECT_EQ(GetData(PhysicsFormat::DecodePayload(GetView(fileData))), hullData);
+    }
+}
+
+TEST(PhysicsFormat, IncompressiblePayloadsAreStored)
+{
+    auto hullData = GetHullData(PhysicsFormat::CurrentVersion, 0);
+    auto fileData = PhysicsFormat::EncodePayload(hullData, true);
+    EXPECT_EQ(GetPayload(fileData).compression, Compression::Type::None);
+    EXPECT_EQ(GetData(PhysicsFormat::DecodePayload(GetView(fileData))), hullData);
+}
+
+TEST(PhysicsFormat, UncompressedFilesReadAsTheyAre)
+{
+    auto hullData = GetHullData(PhysicsFormat::UncompressedVersion, 16);
+    auto fileView = GetView(hullData);
+    auto decodedView = PhysicsFormat::DecodePayload(fileView);
+    EXPECT_EQ(decodedView.getData(), fileView.getData());
+    EXPECT_EQ(decodedView.getSize(), fileView.getSize());
+}
+
+TEST(PhysicsFormat, RejectsUnsupportedHeaders)
+{
+    EXPECT_FALSE(PhysicsFormat::DecodePayload(GetView({})).isValid());
+    EXPECT_FALSE(PhysicsFormat::DecodePayload(GetView(std::vector<uint8_t>(sizeof(PhysicsFormat::Header) - 1, 0))).isValid());
+
+    for (uint16_t version : { uint16_t(2), uint16_t(5) })
+    {
+        EXPECT_FALSE(PhysicsFormat::IsSupportedVersion(version));
+        EXPECT_FALSE(PhysicsFormat::DecodePayload(GetView(GetHullData(version, 16))).isValid());
+    }
+
+    auto hullData = GetHullData(PhysicsFormat::UncompressedVersion, 16);
+    hullData[0] = 'X';
+    EXPECT_FALSE(PhysicsFormat::DecodePayload(GetView(hullData)).isValid());
+
+    // Version 4 without room for the payload description
+    auto fileData = PhysicsFormat::EncodePayload(GetHullData(PhysicsFormat::CurrentVersion, 16), true);
+    fileData.resize(sizeof(PhysicsFormat::Header) + sizeof(PhysicsFormat::Payload) - 1);
+    EXPECT_FALSE(PhysicsFormat::DecodePayload(GetView(fileData)).isValid());
+}
+
+TEST(PhysicsFormat, RejectsCorruptPayloads)
+{
+    auto hullData = GetHullData(PhysicsFormat::CurrentVersion, 256);
+    auto compressedData = PhysicsFormat::EncodePayload(hullData, true);
+    auto storedData = PhysicsFormat::EncodePayload(hullData, false);
+
+    auto truncatedData = compressedData;
+    truncatedData.pop_back();
+    EXPECT_FALSE(PhysicsFormat::DecodePayload(GetView(truncatedData)).isValid());
+
+    auto modify = [](std::vector<uint8_t> fileData, auto &&modifyPayload) -> FileSystem::FileView
+    {
+        auto payload = GetPayload(fileData);
+        modifyPayload(payload);
+        SetPayload(fileData, payload);
+        return PhysicsFormat::DecodePayload(GetView(fileData));
+    };
+
+    EXPECT_FALSE(modify(compressedData, [](PhysicsFormat::Payload &payload) { ++payload.size; }).isValid());
+    EXPECT_FALSE(modify(compressedData, [](PhysicsFormat::Payload &payload) { --payload.size; }).isValid());
+    EXPECT_FALSE(modify(compressedData, [](PhysicsFormat::Payload &payload) { --payload.storedSize; }).isValid());
+    EXPECT_FALSE(modify(compressedData, [](PhysicsFormat::Payload &payload) { payload.compression = static_cast<Compression::Type>(9); }).isValid());
+    EXPECT_FALSE(modify(storedData, [](PhysicsFormat::Payload &payload) { --payload.size; }).isValid());
+}
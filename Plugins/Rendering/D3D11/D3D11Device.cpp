@@ -3447,10 +3447,10 @@ namespace Gek
                 }
             }
 
-            Render::TexturePtr loadTextureFromKtx2(std::vector<uint8_t> const &fileData, FileSystem::Path const &filePath)
+            Render::TexturePtr loadTextureFromKtx2(FileSystem::FileView const &fileView, FileSystem::Path const &filePath)
             {
                 ktxTexture2 *kTexture = nullptr;
-                KTX_error_code ktxResult = ktxTexture2_CreateFromMemory(fileData.data(), fileData.size(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &kTexture);
+                KTX_error_code ktxResult = ktxTexture2_CreateFromMemory(fileView.getData(), fileView.getSize(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &kTexture);
                 if (ktxResult != KTX_SUCCESS || !kTexture)
                 {
                     getContext()->log(Gek::Context::Error, "D3D11 loadTexture failed: KTX2 decode error for '{}'", filePath.getString());
@@ -3532,11 +3532,15 @@ namespace Gek
             }
 
             Render::TexturePtr loadTexture(FileSystem::Path const &filePath, uint32_t flags)
+            {
+                return loadTexture(filePath, FileSystem::Map(filePath), flags);
+            }
+
+            Render::TexturePtr loadTexture(FileSystem::Path const &filePath, FileSystem::FileView const &fileView, uint32_t flags)
             {
                 assert(d3dDevice);
 
-                std::vector<uint8_t> fileData(FileSystem::Load(filePath));
-                if (fileData.empty())
+                if (!fileView.isValid())
                 {
                     getContext()->log(Gek::Context::Error, "Unable to load data from texture file: {}", filePath.getString());
                     return nullptr;
@@ -3545,11 +3549,11 @@ namespace Gek
                 std::string extension(String::GetLower(filePath.getExtension()));
                 if (extension == ".ktx2")
                 {
-                    return loadTextureFromKtx2(fileData, filePath);
+                    return loadTextureFromKtx2(fileView, filePath);
                 }
 
                 int width = 0, height = 0, channels = 0;
-                stbi_uc *pixels = stbi_load_from_memory(fileData.data(), static_cast<int>(fileData.size()), &width, &height, &channels, 4);
+                stbi_uc *pixels = stbi_load_from_memory(fileView.getData(), static_cast<int>(fileView.getSize()), &width, &height, &channels, 4);
                 if (!pixels)
                 {
                     getContext()->log(Gek::Context::Error, "stb_image failed to decode texture: {}", filePath.getString());
@@ -3671,15 +3675,15 @@ namespace Gek
                 std::string extension(String::GetLower(filePath.getExtension()));
                 if (extension == ".ktx2")
                 {
-                    std::vector<uint8_t> buffer(FileSystem::Load(filePath));
-                    if (buffer.empty())
+                    auto fileView = FileSystem::Map(filePath);
+                    if (!fileView.isValid())
                     {
                         getContext()->log(Gek::Context::Error, "Unable to load KTX2 file for description: {}", filePath.getString());
                         return EmptyDescription;
                     }
 
                     ktxTexture2 *kTexture = nullptr;
-                    KTX_error_code ktxResult = ktxTexture2_CreateFromMemory(buffer.data(), buffer.size(), KTX_TEXTURE_CREATE_SKIP_KVDATA_BIT, &kTexture);
+                    KTX_error_code ktxResult = ktxTexture2_CreateFromMemory(fileView.getData(), fileView.getSize(), KTX_TEXTURE_CREATE_SKIP_KVDATA_BIT, &kTexture);
                     if (ktxResult != KTX_SUCCESS || !kTexture)
                     {
                         getContext()->log(Gek::Context::Error, "KTX2 header parse failed for: {}", filePath.getString());
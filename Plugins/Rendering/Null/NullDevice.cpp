@@ -0,0 +1,1327 @@
+#include "API/System/RenderDevice.hpp"
+#include "API/System/WindowDevice.hpp"
+#include "GEK/Utility/ContextUser.hpp"
+#include "GEK/Utility/FileSystem.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+
+namespace Gek
+{
+    namespace Render::Implementation
+    {
+        static constexpr std::string_view SemanticNameList[] = {
+            "POSITION",
+            "TEXCOORD",
+            "TANGENT",
+            "BINORMAL",
+            "NORMAL",
+            "COLOR",
+        };
+
+        uint32_t GetFormatStride(Render::Format format)
+        {
+            switch (format)
+            {
+            case Render::Format::R32G32B32A32_FLOAT:
+            case Render::Format::R32G32B32A32_UINT:
+            case Render::Format::R32G32B32A32_INT:
+                return 16;
+
+            case Render::Format::R32G32B32_FLOAT:
+            case Render::Format::R32G32B32_UINT:
+            case Render::Format::R32G32B32_INT:
+                return 12;
+
+            case Render::Format::R16G16B16A16_FLOAT:
+            case Render::Format::R16G16B16A16_UINT:
+            case Render::Format::R16G16B16A16_INT:
+            case Render::Format::R16G16B16A16_UNORM:
+            case Render::Format::R16G16B16A16_NORM:
+            case Render::Format::R32G32_FLOAT:
+            case Render::Format::R32G32_UINT:
+            case Render::Format::R32G32_INT:
+            case Render::Format::D32_FLOAT_S8X24_UINT:
+                return 8;
+
+            case Render::Format::R16_FLOAT:
+            case Render::Format::R8G8_UINT:
+            case Render::Format::R16_UINT:
+            case Render::Format::R8G8_INT:
+            case Render::Format::R16_INT:
+            case Render::Format::R8G8_UNORM:
+            case Render::Format::R16_UNORM:
+            case Render::Format::R8G8_NORM:
+            case Render::Format::R16_NORM:
+            case Render::Format::D16_UNORM:
+                return 2;
+
+            case Render::Format::R8_UINT:
+            case Render::Format::R8_INT:
+            case Render::Format::R8_UNORM:
+            case Render::Format::R8_NORM:
+                return 1;
+
+            case Render::Format::Unknown:
+                return 0;
+
+            default:
+                return 4;
+            };
+        }
+
+        template <typename BASE>
+        class DescribedObject
+            : public BASE
+        {
+          public:
+            typename BASE::Description description;
+
+          public:
+            DescribedObject(typename BASE::Description const &description)
+                : description(description)
+            {
+            }
+
+            typename BASE::Description const &getDescription(void) const
+            {
+                return description;
+            }
+
+            // Render::Object
+            std::string_view getName(void) const
+            {
+                return description.name;
+            }
+        };
+
+        class NamedObject
+            : public Render::Object
+        {
+          public:
+            std::string name;
+
+          public:
+            NamedObject(std::string_view name)
+                : name(name)
+            {
+            }
+
+            // Render::Object
+            std::string_view getName(void) const
+            {
+                return name;
+            }
+        };
+
+        using RenderState = DescribedObject<Render::RenderState>;
+        using DepthState = DescribedObject<Render::DepthState>;
+        using BlendState = DescribedObject<Render::BlendState>;
+        using SamplerState = DescribedObject<Render::SamplerState>;
+        using Texture = DescribedObject<Render::Texture>;
+
+        // Buffers keep their contents in memory so that mapping, updating and copying behave like a real device
+        class Buffer
+            : public DescribedObject<Render::Buffer>
+        {
+          public:
+            std::vector<uint8_t> data;
+
+          public:
+            Buffer(Render::Buffer::Description const &description, void const *staticData)
+                : DescribedObject(description)
+                , data(size_t(description.stride ? description.stride : GetFormatStride(description.format)) * description.count)
+            {
+                if (staticData && !data.empty())
+                {
+                    std::memcpy(data.data(), staticData, data.size());
+                }
+            }
+        };
+
+        class Target
+            : public DescribedObject<Render::Target>
+        {
+          public:
+            Render::ViewPort viewPort;
+
+          public:
+            Target(Render::Texture::Description const &description)
+                : DescribedObject(description)
+                , viewPort(Math::Float2::Zero, Math::Float2(float(description.width), float(description.height)), 0.0f, 1.0f)
+            {
+            }
+
+            // Render::Target
+            Render::ViewPort const &getViewPort(void) const
+            {
+                return viewPort;
+            }
+        };
+
+        class Query
+            : public Render::Query
+        {
+          public:
+            Render::Query::Type type;
+            std::chrono::steady_clock::time_point timeStamp;
+
+          public:
+            Query(Render::Query::Type type)
+                : type(type)
+            {
+            }
+
+            // Render::Object
+            std::string_view getName(void) const
+            {
+                return "query";
+            }
+        };
+
+        class Program
+            : public Render::Program
+        {
+          public:
+            Render::Program::Information information;
+
+          public:
+            Program(Render::Program::Information const &information)
+                : information(information)
+            {
+            }
+
+            // Render::Program
+            Render::Program::Information const &getInformation(void) const
+            {
+                return information;
+            }
+
+            // Render::Object
+            std::string_view getName(void) const
+            {
+                return information.name;
+            }
+        };
+
+        // Everything a context was asked to do in submission order, so that a frame can be counted, written out and
+        // replayed into another context.  Lists and values live in shared pools to keep each command small.
+        class FrameLog
+        {
+          public:
+            enum class CommandType : uint8_t
+            {
+                SetProgram = 0,
+                SetSamplerStateList,
+                SetConstantBufferList,
+                SetResourceList,
+                SetUnorderedAccessList,
+                ClearSamplerStateList,
+                ClearConstantBufferList,
+                ClearResourceList,
+                ClearUnorderedAccessList,
+                Begin,
+                End,
+                GenerateMipMaps,
+                ResolveSamples,
+                CopyResource,
+                ClearState,
+                ClearUnorderedAccessFloat,
+                ClearUnorderedAccessInteger,
+                ClearRenderTarget,
+                ClearDepthStencilTarget,
+                ClearRenderTargetList,
+                ClearIndexBuffer,
+                ClearVertexBufferList,
+                SetViewportList,
+                SetScissorList,
+                SetRenderTargetList,
+                SetRenderState,
+                SetDepthState,
+                SetBlendState,
+                SetInputLayout,
+                SetIndexBuffer,
+                SetVertexBufferList,
+                SetPrimitiveType,
+                DrawPrimitive,
+                DrawInstancedPrimitive,
+                DrawIndexedPrimitive,
+                DrawInstancedIndexedPrimitive,
+                Dispatch,
+            };
+
+            static constexpr std::string_view CommandNameList[] = {
+                "setProgram",
+                "setSamplerStateList",
+                "setConstantBufferList",
+                "setResourceList",
+                "setUnorderedAccessList",
+                "clearSamplerStateList",
+                "clearConstantBufferList",
+                "clearResourceList",
+                "clearUnorderedAccessList",
+                "begin",
+                "end",
+                "generateMipMaps",
+                "resolveSamples",
+                "copyResource",
+                "clearState",
+                "clearUnorderedAccessFloat",
+                "clearUnorderedAccessInteger",
+                "clearRenderTarget",
+                "clearDepthStencilTarget",
+                "clearRenderTargetList",
+                "clearIndexBuffer",
+                "clearVertexBufferList",
+                "setViewportList",
+                "setScissorList",
+                "setRenderTargetList",
+                "setRenderState",
+                "setDepthState",
+                "setBlendState",
+                "setInputLayout",
+                "setIndexBuffer",
+                "setVertexBufferList",
+                "setPrimitiveType",
+                "drawPrimitive",
+                "drawInstancedPrimitive",
+                "drawIndexedPrimitive",
+                "drawInstancedIndexedPrimitive",
+                "dispatch",
+            };
+
+            static constexpr std::string_view PipelineNameList[] = {
+                "compute",
+                "vertex",
+                "geometry",
+                "pixel",
+            };
+
+            struct Command
+            {
+                CommandType type = CommandType::ClearState;
+                Render::Program::Type pipeline = Render::Program::Type::Compute;
+                void *object = nullptr;
+                std::array<uint32_t, 5> argumentList = {};
+                uint32_t pointerStart = 0;
+                uint32_t pointerCount = 0;
+                uint32_t valueStart = 0;
+                uint32_t valueCount = 0;
+            };
+
+            struct Statistics
+            {
+                uint32_t commandCount = 0;
+                uint32_t drawCallCount = 0;
+                uint32_t dispatchCount = 0;
+                uint32_t stateChangeCount = 0;
+                uint32_t clearCount = 0;
+                uint32_t copyCount = 0;
+                uint64_t vertexCount = 0;
+            };
+
+          private:
+            std::vector<Command> commandList;
+            std::vector<void *> pointerList;
+            std::vector<uint32_t> valueList;
+
+          public:
+            bool isEmpty(void) const
+            {
+                return commandList.empty();
+            }
+
+            // Keeps the allocations so that the next frame records without growing the pools again
+            void clear(void)
+            {
+                commandList.clear();
+                pointerList.clear();
+                valueList.clear();
+            }
+
+            Command &record(CommandType type, void *object = nullptr, std::initializer_list<uint32_t> argumentList = {})
+            {
+                auto &command = commandList.emplace_back();
+                command.type = type;
+                command.object = object;
+                std::copy(std::begin(argumentList), std::end(argumentList), std::begin(command.argumentList));
+                return command;
+            }
+
+            Command &record(Render::Program::Type pipeline, CommandType type, void *object = nullptr, std::initializer_list<uint32_t> argumentList = {})
+            {
+                auto &command = record(type, object, argumentList);
+                command.pipeline = pipeline;
+                return command;
+            }
+
+            // Pointers are stored exactly as they were passed so they cast back to the same interface on replay
+            template <typename TYPE>
+            void addPointerList(Command &command, std::vector<TYPE *> const &list)
+            {
+                command.pointerStart = static_cast<uint32_t>(pointerList.size());
+                command.pointerCount = static_cast<uint32_t>(list.size());
+                pointerList.insert(std::end(pointerList), std::begin(list), std::end(list));
+            }
+
+            void addValueList(Command &command, void const *data, size_t size)
+            {
+                command.valueStart = static_cast<uint32_t>(valueList.size());
+                command.valueCount = static_cast<uint32_t>(size / sizeof(uint32_t));
+                valueList.resize(valueList.size() + command.valueCount);
+                std::memcpy(valueList.data() + command.valueStart, data, (command.valueCount * sizeof(uint32_t)));
+            }
+
+            template <typename TYPE>
+            std::vector<TYPE *> getPointerList(Command const &command) const
+            {
+                std::vector<TYPE *> list(command.pointerCount);
+                for (uint32_t index = 0; index < command.pointerCount; ++index)
+                {
+                    list[index] = static_cast<TYPE *>(pointerList[command.pointerStart + index]);
+                }
+
+                return list;
+            }
+
+            template <typename TYPE>
+            std::vector<TYPE> getValueList(Command const &command) const
+            {
+                static_assert((sizeof(TYPE) % sizeof(uint32_t)) == 0);
+                std::vector<TYPE> list((command.valueCount * sizeof(uint32_t)) / sizeof(TYPE));
+                std::memcpy(static_cast<void *>(list.data()), valueList.data() + command.valueStart, (list.size() * sizeof(TYPE)));
+                return list;
+            }
+
+            template <typename TYPE>
+            TYPE getValue(Command const &command) const
+            {
+                return getValueList<TYPE>(command).front();
+            }
+
+            Statistics getStatistics(void) const
+            {
+                Statistics statistics;
+                statistics.commandCount = static_cast<uint32_t>(commandList.size());
+                for (auto const &command : commandList)
+                {
+                    auto const &argumentList = command.argumentList;
+                    switch (command.type)
+                    {
+                    case CommandType::DrawPrimitive:
+                    case CommandType::DrawIndexedPrimitive:
+                        ++statistics.drawCallCount;
+                        statistics.vertexCount += argumentList[0];
+                        break;
+
+                    case CommandType::DrawInstancedPrimitive:
+                    case CommandType::DrawInstancedIndexedPrimitive:
+                        ++statistics.drawCallCount;
+                        statistics.vertexCount += (uint64_t(argumentList[0]) * argumentList[2]);
+                        break;
+
+                    case CommandType::Dispatch:
+                        ++statistics.dispatchCount;
+                        break;
+
+                    case CommandType::ClearUnorderedAccessFloat:
+                    case CommandType::ClearUnorderedAccessInteger:
+                    case CommandType::ClearRenderTarget:
+                    case CommandType::ClearDepthStencilTarget:
+                        ++statistics.clearCount;
+                        break;
+
+                    case CommandType::CopyResource:
+                    case CommandType::GenerateMipMaps:
+                    case CommandType::ResolveSamples:
+                        ++statistics.copyCount;
+                        break;
+
+                    case CommandType::Begin:
+                    case CommandType::End:
+                        break;
+
+                    default:
+                        ++statistics.stateChangeCount;
+                        break;
+                    };
+                }
+
+                return statistics;
+            }
+
+            void replay(Render::Device::Context *context) const
+            {
+                for (auto const &command : commandList)
+                {
+                    auto const &argumentList = command.argumentList;
+                    Render::Device::Context::Pipeline *pipeline = nullptr;
+                    switch (command.pipeline)
+                    {
+                    case Render::Program::Type::Compute:
+                        pipeline = context->computePipeline();
+                        break;
+
+                    case Render::Program::Type::Vertex:
+                        pipeline = context->vertexPipeline();
+                        break;
+
+                    case Render::Program::Type::Geometry:
+                        pipeline = context->geometryPipeline();
+                        break;
+
+                    case Render::Program::Type::Pixel:
+                        pipeline = context->pixelPipeline();
+                        break;
+                    };
+
+                    switch (command.type)
+                    {
+                    case CommandType::SetProgram:
+                        pipeline->setProgram(static_cast<Render::Program *>(command.object));
+                        break;
+
+                    case CommandType::SetSamplerStateList:
+                        pipeline->setSamplerStateList(getPointerList<Render::Object>(command), argumentList[0]);
+                        break;
+
+                    case CommandType::SetConstantBufferList:
+                        pipeline->setConstantBufferList(getPointerList<Render::Buffer>(command), argumentList[0]);
+                        break;
+
+                    case CommandType::SetResourceList:
+                        pipeline->setResourceList(getPointerList<Render::Object>(command), argumentList[0]);
+                        break;
+
+                    case CommandType::SetUnorderedAccessList:
+                        if (argumentList[1])
+                        {
+                            auto countList = getValueList<uint32_t>(command);
+                            pipeline->setUnorderedAccessList(getPointerList<Render::Object>(command), argumentList[0], countList.data());
+                        }
+                        else
+                        {
+                            pipeline->setUnorderedAccessList(getPointerList<Render::Object>(command), argumentList[0]);
+                        }
+
+                        break;
+
+                    case CommandType::ClearSamplerStateList:
+                        pipeline->clearSamplerStateList(argumentList[0], argumentList[1]);
+                        break;
+
+                    case CommandType::ClearConstantBufferList:
+                        pipeline->clearConstantBufferList(argumentList[0], argumentList[1]);
+                        break;
+
+                    case CommandType::ClearResourceList:
+                        pipeline->clearResourceList(argumentList[0], argumentList[1]);
+                        break;
+
+                    case CommandType::ClearUnorderedAccessList:
+                        pipeline->clearUnorderedAccessList(argumentList[0], argumentList[1]);
+                        break;
+
+                    case CommandType::Begin:
+                        context->begin(static_cast<Render::Query *>(command.object));
+                        break;
+
+                    case CommandType::End:
+                        context->end(static_cast<Render::Query *>(command.object));
+                        break;
+
+                    case CommandType::GenerateMipMaps:
+                        context->generateMipMaps(static_cast<Render::Texture *>(command.object));
+                        break;
+
+                    case CommandType::ResolveSamples:
+                        context->resolveSamples(static_cast<Render::Texture *>(command.object), getPointerList<Render::Texture>(command).front());
+                        break;
+
+                    case CommandType::CopyResource:
+                        context->copyResource(static_cast<Render::Object *>(command.object), getPointerList<Render::Object>(command).front());
+                        break;
+
+                    case CommandType::ClearState:
+                        context->clearState();
+                        break;
+
+                    case CommandType::ClearUnorderedAccessFloat:
+                        context->clearUnorderedAccess(static_cast<Render::Object *>(command.object), getValue<Math::Float4>(command));
+                        break;
+
+                    case CommandType::ClearUnorderedAccessInteger:
+                        context->clearUnorderedAccess(static_cast<Render::Object *>(command.object), getValue<Math::UInt4>(command));
+                        break;
+
+                    case CommandType::ClearRenderTarget:
+                        context->clearRenderTarget(static_cast<Render::Target *>(command.object), getValue<Math::Float4>(command));
+                        break;
+
+                    case CommandType::ClearDepthStencilTarget:
+                        context->clearDepthStencilTarget(static_cast<Render::Object *>(command.object), argumentList[0], std::bit_cast<float>(argumentList[1]), argumentList[2]);
+                        break;
+
+                    case CommandType::ClearRenderTargetList:
+                        context->clearRenderTargetList(argumentList[0], argumentList[1]);
+                        break;
+
+                    case CommandType::ClearIndexBuffer:
+                        context->clearIndexBuffer();
+                        break;
+
+                    case CommandType::ClearVertexBufferList:
+                        context->clearVertexBufferList(argumentList[0], argumentList[1]);
+                        break;
+
+                    case CommandType::SetViewportList:
+                        context->setViewportList(getValueList<Render::ViewPort>(command));
+                        break;
+
+                    case CommandType::SetScissorList:
+                        context->setScissorList(getValueList<Math::UInt4>(command));
+                        break;
+
+                    case CommandType::SetRenderTargetList:
+                        context->setRenderTargetList(getPointerList<Render::Target>(command), static_cast<Render::Object *>(command.object));
+                        break;
+
+                    case CommandType::SetRenderState:
+                        context->setRenderState(static_cast<Render::Object *>(command.object));
+                        break;
+
+                    case CommandType::SetDepthState:
+                        context->setDepthState(static_cast<Render::Object *>(command.object), argumentList[0]);
+                        break;
+
+                    case CommandType::SetBlendState:
+                        context->setBlendState(static_cast<Render::Object *>(command.object), getValue<Math::Float4>(command), argumentList[0]);
+                        break;
+
+                    case CommandType::SetInputLayout:
+                        context->setInputLayout(static_cast<Render::Object *>(command.object));
+                        break;
+
+                    case CommandType::SetIndexBuffer:
+                        context->setIndexBuffer(static_cast<Render::Buffer *>(command.object), argumentList[0]);
+                        break;
+
+                    case CommandType::SetVertexBufferList:
+                        if (argumentList[1])
+                        {
+                            auto offsetList = getValueList<uint32_t>(command);
+                            context->setVertexBufferList(getPointerList<Render::Buffer>(command), argumentList[0], offsetList.data());
+                        }
+                        else
+                        {
+                            context->setVertexBufferList(getPointerList<Render::Buffer>(command), argumentList[0]);
+                        }
+
+                        break;
+
+                    case CommandType::SetPrimitiveType:
+                        context->setPrimitiveType(static_cast<Render::PrimitiveType>(argumentList[0]));
+                        break;
+
+                    case CommandType::DrawPrimitive:
+                        context->drawPrimitive(argumentList[0], argumentList[1]);
+                        break;
+
+                    case CommandType::DrawInstancedPrimitive:
+                        context->drawInstancedPrimitive(argumentList[0], argumentList[1], argumentList[2], argumentList[3]);
+                        break;
+
+                    case CommandType::DrawIndexedPrimitive:
+                        context->drawIndexedPrimitive(argumentList[0], argumentList[1], argumentList[2]);
+                        break;
+
+                    case CommandType::DrawInstancedIndexedPrimitive:
+                        context->drawInstancedIndexedPrimitive(argumentList[0], argumentList[1], argumentList[2], argumentList[3], argumentList[4]);
+                        break;
+
+                    case CommandType::Dispatch:
+                        context->dispatch(argumentList[0], argumentList[1], argumentList[2]);
+                        break;
+                    };
+                }
+            }
+
+            // One line per command with its arguments, for diffing frames between builds
+            std::string getString(void) const
+            {
+                std::string output;
+                for (size_t commandIndex = 0; commandIndex < commandList.size(); ++commandIndex)
+                {
+                    auto const &command = commandList[commandIndex];
+                    output += std::format("{:>6} {}", commandIndex, CommandNameList[static_cast<uint8_t>(command.type)]);
+                    if (command.type <= CommandType::ClearUnorderedAccessList)
+                    {
+                        output += std::format(" pipeline={}", PipelineNameList[static_cast<uint8_t>(command.pipeline)]);
+                    }
+
+                    output += std::format(" arguments={},{},{},{},{}", command.argumentList[0], command.argumentList[1], command.argumentList[2], command.argumentList[3], command.argumentList[4]);
+                    if (command.pointerCount > 0)
+                    {
+                        output += std::format(" objects={}", command.pointerCount);
+                    }
+
+                    output += "\n";
+                }
+
+                return output;
+            }
+        };
+
+        class CommandList
+            : public Render::Object
+        {
+          public:
+            FrameLog frameLog;
+
+          public:
+            // Render::Object
+            std::string_view getName(void) const
+            {
+                return "commandList";
+            }
+        };
+
+        GEK_CONTEXT_USER(Device, Window::Device *, Render::Device::Description)
+        , public Render::Device
+        {
+            class Context
+                : public Render::Device::Context
+            {
+              public:
+                class Pipeline
+                    : public Render::Device::Context::Pipeline
+                {
+                  private:
+                    FrameLog &frameLog;
+                    Type type;
+
+                  public:
+                    Pipeline(FrameLog &frameLog, Type type)
+                        : frameLog(frameLog)
+                        , type(type)
+                    {
+                    }
+
+                    // Render::Device::Context::Pipeline
+                    Type getType(void) const
+                    {
+                        return type;
+                    }
+
+                    void setProgram(Render::Program *program)
+                    {
+                        frameLog.record(type, FrameLog::CommandType::SetProgram, program);
+                    }
+
+                    void setSamplerStateList(const std::vector<Render::Object *> &samplerStateList, uint32_t firstStage)
+                    {
+                        auto &command = frameLog.record(type, FrameLog::CommandType::SetSamplerStateList, nullptr, { firstStage });
+                        frameLog.addPointerList(command, samplerStateList);
+                    }
+
+                    void setConstantBufferList(const std::vector<Render::Buffer *> &constantBufferList, uint32_t firstStage)
+                    {
+                        auto &command = frameLog.record(type, FrameLog::CommandType::SetConstantBufferList, nullptr, { firstStage });
+                        frameLog.addPointerList(command, constantBufferList);
+                    }
+
+                    void setResourceList(const std::vector<Render::Object *> &resourceList, uint32_t firstStage)
+                    {
+                        auto &command = frameLog.record(type, FrameLog::CommandType::SetResourceList, nullptr, { firstStage });
+                        frameLog.addPointerList(command, resourceList);
+                    }
+
+                    void setUnorderedAccessList(const std::vector<Render::Object *> &unorderedAccessList, uint32_t firstStage, uint32_t *countList)
+                    {
+                        auto &command = frameLog.record(type, FrameLog::CommandType::SetUnorderedAccessList, nullptr, { firstStage, (countList ? 1U : 0U) });
+                        frameLog.addPointerList(command, unorderedAccessList);
+                        if (countList)
+                        {
+                            frameLog.addValueList(command, countList, (unorderedAccessList.size() * sizeof(uint32_t)));
+                        }
+                    }
+
+                    void clearSamplerStateList(uint32_t count, uint32_t firstStage)
+                    {
+                        frameLog.record(type, FrameLog::CommandType::ClearSamplerStateList, nullptr, { count, firstStage });
+                    }
+
+                    void clearConstantBufferList(uint32_t count, uint32_t firstStage)
+                    {
+                        frameLog.record(type, FrameLog::CommandType::ClearConstantBufferList, nullptr, { count, firstStage });
+                    }
+
+                    void clearResourceList(uint32_t count, uint32_t firstStage)
+                    {
+                        frameLog.record(type, FrameLog::CommandType::ClearResourceList, nullptr, { count, firstStage });
+                    }
+
+                    void clearUnorderedAccessList(uint32_t count, uint32_t firstStage)
+                    {
+                        frameLog.record(type, FrameLog::CommandType::ClearUnorderedAccessList, nullptr, { count, firstStage });
+                    }
+                };
+
+              public:
+                FrameLog frameLog;
+
+              private:
+                Pipeline computeSystemHandler = Pipeline(frameLog, Render::Program::Type::Compute);
+                Pipeline vertexSystemHandler = Pipeline(frameLog, Render::Program::Type::Vertex);
+                Pipeline geomtrySystemHandler = Pipeline(frameLog, Render::Program::Type::Geometry);
+                Pipeline pixelSystemHandler = Pipeline(frameLog, Render::Program::Type::Pixel);
+
+              public:
+                // Render::Device::Context
+                Render::Device::Context::Pipeline *const computePipeline(void)
+                {
+                    return &computeSystemHandler;
+                }
+
+                Render::Device::Context::Pipeline *const vertexPipeline(void)
+                {
+                    return &vertexSystemHandler;
+                }
+
+                Render::Device::Context::Pipeline *const geometryPipeline(void)
+                {
+                    return &geomtrySystemHandler;
+                }
+
+                Render::Device::Context::Pipeline *const pixelPipeline(void)
+                {
+                    return &pixelSystemHandler;
+                }
+
+                void begin(Render::Query *query)
+                {
+                    frameLog.record(FrameLog::CommandType::Begin, query);
+                }
+
+                void end(Render::Query *query)
+                {
+                    frameLog.record(FrameLog::CommandType::End, query);
+                    auto nullQuery = dynamic_cast<Query *>(query);
+                    if (nullQuery)
+                    {
+                        nullQuery->timeStamp = std::chrono::steady_clock::now();
+                    }
+                }
+
+                // Time stamps are taken on the CPU when the query ends, with a nanosecond frequency
+                Render::Query::Status getData(Render::Query *query, void *data, size_t dataSize, bool waitUntilReady)
+                {
+                    auto nullQuery = dynamic_cast<Query *>(query);
+                    if (!nullQuery)
+                    {
+                        return Render::Query::Status::Error;
+                    }
+
+                    if (nullQuery->type == Render::Query::Type::TimeStamp && dataSize >= sizeof(Render::Query::TimeStamp))
+                    {
+                        *static_cast<Render::Query::TimeStamp *>(data) = std::chrono::duration_cast<std::chrono::nanoseconds>(nullQuery->timeStamp.time_since_epoch()).count();
+                    }
+                    else if (nullQuery->type == Render::Query::Type::DisjointTimeStamp && dataSize >= sizeof(Render::Query::DisjointTimeStamp))
+                    {
+                        auto disjointTimeStamp = static_cast<Render::Query::DisjointTimeStamp *>(data);
+                        disjointTimeStamp->frequency = 1000000000;
+                        disjointTimeStamp->isDisjoint = false;
+                    }
+
+                    return Render::Query::Status::Ready;
+                }
+
+                void generateMipMaps(Render::Texture *texture)
+                {
+                    frameLog.record(FrameLog::CommandType::GenerateMipMaps, texture);
+                }
+
+                void resolveSamples(Render::Texture *destination, Render::Texture *source)
+                {
+                    auto &command = frameLog.record(FrameLog::CommandType::ResolveSamples, destination);
+                    frameLog.addPointerList(command, std::vector<Render::Texture *>({ source }));
+                }
+
+                void copyResource(Render::Object *destination, Render::Object *source)
+                {
+                    auto &command = frameLog.record(FrameLog::CommandType::CopyResource, destination);
+                    frameLog.addPointerList(command, std::vector<Render::Object *>({ source }));
+                    CopyResource(destination, source);
+                }
+
+                void clearState(void)
+                {
+                    frameLog.record(FrameLog::CommandType::ClearState);
+                }
+
+                void clearUnorderedAccess(Render::Object *object, Math::Float4 const &value)
+                {
+                    auto &command = frameLog.record(FrameLog::CommandType::ClearUnorderedAccessFloat, object);
+                    frameLog.addValueList(command, &value, sizeof(value));
+                }
+
+                void clearUnorderedAccess(Render::Object *object, Math::UInt4 const &value)
+                {
+                    auto &command = frameLog.record(FrameLog::CommandType::ClearUnorderedAccessInteger, object);
+                    frameLog.addValueList(command, &value, sizeof(value));
+                }
+
+                void clearRenderTarget(Render::Target *renderTarget, Math::Float4 const &clearColor)
+                {
+                    auto &command = frameLog.record(FrameLog::CommandType::ClearRenderTarget, renderTarget);
+                    frameLog.addValueList(command, &clearColor, sizeof(clearColor));
+                }
+
+                void clearDepthStencilTarget(Render::Object *depthBuffer, uint32_t flags, float clearDepth, uint32_t clearStencil)
+                {
+                    frameLog.record(FrameLog::CommandType::ClearDepthStencilTarget, depthBuffer, { flags, std::bit_cast<uint32_t>(clearDepth), clearStencil });
+                }
+
+                void clearRenderTargetList(uint32_t count, bool depthBuffer)
+                {
+                    frameLog.record(FrameLog::CommandType::ClearRenderTargetList, nullptr, { count, (depthBuffer ? 1U : 0U) });
+                }
+
+                void clearIndexBuffer(void)
+                {
+                    frameLog.record(FrameLog::CommandType::ClearIndexBuffer);
+                }
+
+                void clearVertexBufferList(uint32_t count, uint32_t firstSlot)
+                {
+                    frameLog.record(FrameLog::CommandType::ClearVertexBufferList, nullptr, { count, firstSlot });
+                }
+
+                void setViewportList(const std::vector<Render::ViewPort> &viewPortList)
+                {
+                    auto &command = frameLog.record(FrameLog::CommandType::SetViewportList);
+                    frameLog.addValueList(command, viewPortList.data(), (viewPortList.size() * sizeof(Render::ViewPort)));
+                }
+
+                void setScissorList(const std::vector<Math::UInt4> &rectangleList)
+                {
+                    auto &command = frameLog.record(FrameLog::CommandType::SetScissorList);
+                    frameLog.addValueList(command, rectangleList.data(), (rectangleList.size() * sizeof(Math::UInt4)));
+                }
+
+                void setRenderTargetList(const std::vector<Render::Target *> &renderTargetList, Render::Object *depthBuffer)
+                {
+                    auto &command = frameLog.record(FrameLog::CommandType::SetRenderTargetList, depthBuffer);
+                    frameLog.addPointerList(command, renderTargetList);
+                }
+
+                void setRenderState(Render::Object *renderState)
+                {
+                    frameLog.record(FrameLog::CommandType::SetRenderState, renderState);
+                }
+
+                void setDepthState(Render::Object *depthState, uint32_t stencilReference)
+                {
+                    frameLog.record(FrameLog::CommandType::SetDepthState, depthState, { stencilReference });
+                }
+
+                void setBlendState(Render::Object *blendState, Math::Float4 const &blendFactor, uint32_t sampleMask)
+                {
+                    auto &command = frameLog.record(FrameLog::CommandType::SetBlendState, blendState, { sampleMask });
+                    frameLog.addValueList(command, &blendFactor, sizeof(blendFactor));
+                }
+
+                void setInputLayout(Render::Object *inputLayout)
+                {
+                    frameLog.record(FrameLog::CommandType::SetInputLayout, inputLayout);
+                }
+
+                void setIndexBuffer(Render::Buffer *indexBuffer, uint32_t offset)
+                {
+                    frameLog.record(FrameLog::CommandType::SetIndexBuffer, indexBuffer, { offset });
+                }
+
+                void setVertexBufferList(const std::vector<Render::Buffer *> &vertexBufferList, uint32_t firstSlot, uint32_t *offsetList)
+                {
+                    auto &command = frameLog.record(FrameLog::CommandType::SetVertexBufferList, nullptr, { firstSlot, (offsetList ? 1U : 0U) });
+                    frameLog.addPointerList(command, vertexBufferList);
+                    if (offsetList)
+                    {
+                        frameLog.addValueList(command, offsetList, (vertexBufferList.size() * sizeof(uint32_t)));
+                    }
+                }
+
+                void setPrimitiveType(Render::PrimitiveType primitiveType)
+                {
+                    frameLog.record(FrameLog::CommandType::SetPrimitiveType, nullptr, { static_cast<uint32_t>(primitiveType) });
+                }
+
+                void drawPrimitive(uint32_t vertexCount, uint32_t firstVertex)
+                {
+                    frameLog.record(FrameLog::CommandType::DrawPrimitive, nullptr, { vertexCount, firstVertex });
+                }
+
+                void drawInstancedPrimitive(uint32_t instanceCount, uint32_t firstInstance, uint32_t vertexCount, uint32_t firstVertex)
+                {
+                    frameLog.record(FrameLog::CommandType::DrawInstancedPrimitive, nullptr, { instanceCount, firstInstance, vertexCount, firstVertex });
+                }
+
+                void drawIndexedPrimitive(uint32_t indexCount, uint32_t firstIndex, uint32_t firstVertex)
+                {
+                    frameLog.record(FrameLog::CommandType::DrawIndexedPrimitive, nullptr, { indexCount, firstIndex, firstVertex });
+                }
+
+                void drawInstancedIndexedPrimitive(uint32_t instanceCount, uint32_t firstInstance, uint32_t indexCount, uint32_t firstIndex, uint32_t firstVertex)
+                {
+                    frameLog.record(FrameLog::CommandType::DrawInstancedIndexedPrimitive, nullptr, { instanceCount, firstInstance, indexCount, firstIndex, firstVertex });
+                }
+
+                void dispatch(uint32_t threadGroupCountX, uint32_t threadGroupCountY, uint32_t threadGroupCountZ)
+                {
+                    frameLog.record(FrameLog::CommandType::Dispatch, nullptr, { threadGroupCountX, threadGroupCountY, threadGroupCountZ });
+                }
+
+                // The recorded commands move into the list and are replayed into the default context when it is executed
+                Render::ObjectPtr finishCommandList(void)
+                {
+                    auto commandList = std::make_unique<CommandList>();
+                    std::swap(commandList->frameLog, frameLog);
+                    return commandList;
+                }
+            };
+
+            static void CopyResource(Render::Object *destination, Render::Object *source)
+            {
+                auto destinationBuffer = dynamic_cast<Buffer *>(destination);
+                auto sourceBuffer = dynamic_cast<Buffer *>(source);
+                if (destinationBuffer && sourceBuffer)
+                {
+                    std::memcpy(destinationBuffer->data.data(), sourceBuffer->data.data(), std::min(destinationBuffer->data.size(), sourceBuffer->data.size()));
+                }
+            }
+
+          private:
+            Window::Device *window = nullptr;
+            Render::Device::Description description;
+            std::unique_ptr<Target> backBuffer;
+            Context defaultContext;
+
+            // Resources are created and mapped from loader threads as well as the render thread
+            std::atomic<uint32_t> bufferMapCount = 0;
+            std::atomic<uint64_t> bytesUploaded = 0;
+            uint32_t commandListCount = 0;
+            uint32_t presentFrameIndex = 0;
+
+            struct MetricHandles
+            {
+                Metrics::Handle frame;
+                Metrics::Handle totalCommands;
+                Metrics::Handle drawCalls;
+                Metrics::Handle vertices;
+                Metrics::Handle dispatches;
+                Metrics::Handle stateChanges;
+                Metrics::Handle clears;
+                Metrics::Handle copies;
+                Metrics::Handle commandLists;
+                Metrics::Handle bufferMaps;
+                Metrics::Handle bytesUploaded;
+            } metricHandles;
+
+            std::string frameLogPath;
+            FrameLog lastFrameLog;
+
+          public:
+            Device(Gek::Context *context, Window::Device *window, Render::Device::Description description)
+                : ContextRegistration(context)
+                , window(window)
+                , description(description)
+            {
+                getContext()->log(Gek::Context::Info, "Null render device created, nothing will be drawn");
+                getContext()->setRuntimeMetric("render.backend", 2.0);
+
+                auto &metrics = getContext()->getRuntimeMetrics();
+                metricHandles.frame = metrics.getHandle("render.frame");
+                metricHandles.totalCommands = metrics.getHandle("render.totalCommands");
+                metricHandles.drawCalls = metrics.getHandle("null.drawCalls");
+                metricHandles.vertices = metrics.getHandle("null.vertices");
+                metricHandles.dispatches = metrics.getHandle("null.dispatches");
+                metricHandles.stateChanges = metrics.getHandle("null.stateChanges");
+                metricHandles.clears = metrics.getHandle("null.clears");
+                metricHandles.copies = metrics.getHandle("null.copies");
+                metricHandles.commandLists = metrics.getHandle("null.commandLists");
+                metricHandles.bufferMaps = metrics.getHandle("null.bufferMaps");
+                metricHandles.bytesUploaded = metrics.getHandle("null.bytesUploaded");
+                createBackBuffer(1280, 720);
+
+                if (auto environmentFrameLog = std::getenv("gek_null_frame_log"); environmentFrameLog && environmentFrameLog[0])
+                {
+                    frameLogPath = environmentFrameLog;
+                }
+            }
+
+            // The last presented frame is written out for comparing command streams between builds
+            ~Device(void)
+            {
+                if (!frameLogPath.empty() && !lastFrameLog.isEmpty())
+                {
+                    FileSystem::Save(frameLogPath, lastFrameLog.getString());
+                    getContext()->log(Gek::Context::Info, "Null render device frame log written to {}", frameLogPath);
+                }
+            }
+
+            void createBackBuffer(uint32_t width, uint32_t height)
+            {
+                Render::Texture::Description backBufferDescription;
+                backBufferDescription.name = "backBuffer";
+                backBufferDescription.format = description.displayFormat;
+                backBufferDescription.width = width;
+                backBufferDescription.height = height;
+                backBufferDescription.flags = Render::Texture::Flags::RenderTarget;
+                backBuffer = std::make_unique<Target>(backBufferDescription);
+            }
+
+            // Render::Device
+            Render::DisplayModeList getDisplayModeList(Render::Format format) const
+            {
+                Render::DisplayModeList displayModeList;
+                for (auto [width, height] : { std::pair(1280U, 720U), std::pair(1600U, 900U), std::pair(1920U, 1080U) })
+                {
+                    Render::DisplayMode displayMode(width, height, format);
+                    displayMode.refreshRate.numerator = 60;
+                    displayMode.refreshRate.denominator = 1;
+                    displayModeList.push_back(displayMode);
+                }
+
+                return displayModeList;
+            }
+
+            void setFullScreenState(bool fullScreen)
+            {
+            }
+
+            void setDisplayMode(const Render::DisplayMode &displayMode)
+            {
+                createBackBuffer(displayMode.width, displayMode.height);
+                if (window)
+                {
+                    window->resize(Math::Int2(displayMode.width, displayMode.height));
+                }
+            }
+
+            void handleResize(void)
+            {
+                if (window)
+                {
+                    auto clientRectangle = window->getClientRectangle();
+                    createBackBuffer(std::max(1, clientRectangle.maximum.x - clientRectangle.minimum.x), std::max(1, clientRectangle.maximum.y - clientRectangle.minimum.y));
+                }
+            }
+
+            Render::Target *const getBackBuffer(void)
+            {
+                return backBuffer.get();
+            }
+
+            Render::Device::Context *const getDefaultContext(void)
+            {
+                return &defaultContext;
+            }
+
+            Render::Device::ContextPtr createDeferredContext(void)
+            {
+                return std::make_unique<Context>();
+            }
+
+            Render::QueryPtr createQuery(Render::Query::Type type)
+            {
+                return std::make_unique<Query>(type);
+            }
+
+            Render::RenderStatePtr createRenderState(Render::RenderState::Description const &description)
+            {
+                return std::make_unique<RenderState>(description);
+            }
+
+            Render::DepthStatePtr createDepthState(Render::DepthState::Description const &description)
+            {
+                return std::make_unique<DepthState>(description);
+            }
+
+            Render::BlendStatePtr createBlendState(Render::BlendState::Description const &description)
+            {
+                return std::make_unique<BlendState>(description);
+            }
+
+            Render::SamplerStatePtr createSamplerState(Render::SamplerState::Description const &description)
+            {
+                return std::make_unique<SamplerState>(description);
+            }
+
+            Render::TexturePtr createTexture(Render::Texture::Description const &description, const void *data)
+            {
+                if (data)
+                {
+                    bytesUploaded += (uint64_t(GetFormatStride(description.format)) * description.width * description.height * description.depth);
+                }
+
+                if (description.flags & Render::Texture::Flags::RenderTarget)
+                {
+                    return std::make_unique<Target>(description);
+                }
+
+                return std::make_unique<Texture>(description);
+            }
+
+            Render::TexturePtr loadTexture(void const *buffer, size_t size, uint32_t flags)
+            {
+                Render::Texture::Description description;
+                description.name = "texture";
+                description.format = ((flags & Render::TextureLoadFlags::sRGB) ? Render::Format::R8G8B8A8_UNORM_SRGB : Render::Format::R8G8B8A8_UNORM);
+                description.flags = Render::Texture::Flags::Resource;
+                return std::make_unique<Texture>(description);
+            }
+
+            // The file is still read so that load times include the disk access
+            Render::TexturePtr loadTexture(FileSystem::Path const &filePath, uint32_t flags)
+            {
+                auto buffer = FileSystem::Load(filePath);
+                if (buffer.empty())
+                {
+                    return nullptr;
+                }
+
+                auto texture = loadTexture(buffer.data(), buffer.size(), flags);
+                dynamic_cast<Texture *>(texture.get())->description.name = filePath.getString();
+                return texture;
+            }
+
+            Render::TexturePtr loadTexture(FileSystem::Path const &filePath, FileSystem::FileView const &fileView, uint32_t flags)
+            {
+                if (!fileView.isValid())
+                {
+                    return nullptr;
+                }
+
+                auto texture = loadTexture(fileView.getData(), fileView.getSize(), flags);
+                dynamic_cast<Texture *>(texture.get())->description.name = filePath.getString();
+                return texture;
+            }
+
+            Render::Texture::Description loadTextureDescription(FileSystem::Path const &filePath)
+            {
+                Render::Texture::Description description;
+                description.name = filePath.getString();
+                description.format = Render::Format::R8G8B8A8_UNORM;
+                description.flags = Render::Texture::Flags::Resource;
+                return description;
+            }
+
+            Render::BufferPtr createBuffer(Render::Buffer::Description const &description, const void *staticData)
+            {
+                auto buffer = std::make_unique<Buffer>(description, staticData);
+                if (staticData)
+                {
+                    bytesUploaded += buffer->data.size();
+                }
+
+                return buffer;
+            }
+
+            bool mapBuffer(Render::Buffer *buffer, void *&data, Render::Map mapping)
+            {
+                auto nullBuffer = dynamic_cast<Buffer *>(buffer);
+                if (!nullBuffer || nullBuffer->data.empty())
+                {
+                    return false;
+                }
+
+                ++bufferMapCount;
+                if (mapping != Render::Map::Read)
+                {
+                    bytesUploaded += nullBuffer->data.size();
+                }
+
+                data = nullBuffer->data.data();
+                return true;
+            }
+
+            void unmapBuffer(Render::Buffer *buffer)
+            {
+            }
+
+            void updateResource(Render::Object *object, const void *data)
+            {
+                auto nullBuffer = dynamic_cast<Buffer *>(object);
+                if (nullBuffer && data)
+                {
+                    std::memcpy(nullBuffer->data.data(), data, nullBuffer->data.size());
+                    bytesUploaded += nullBuffer->data.size();
+                }
+            }
+
+            void copyResource(Render::Object *destination, Render::Object *source)
+            {
+                CopyResource(destination, source);
+            }
+
+            std::string_view const getSemanticMoniker(Render::InputElement::Semantic semantic)
+            {
+                return SemanticNameList[static_cast<uint8_t>(semantic)];
+            }
+
+            Render::ObjectPtr createInputLayout(const std::vector<Render::InputElement> &elementList, Render::Program::Information const &information)
+            {
+                return std::make_unique<NamedObject>(information.name);
+            }
+
+            // Nothing is compiled, leaving the compiled data empty also keeps it out of the shader cache
+            bool compileProgram(Render::Program::Information &information, std::function<bool(IncludeType, std::string_view, void const **data, uint32_t *size)> &&onInclude)
+            {
+                return information.isValid();
+            }
+
+            Render::ProgramPtr createProgram(Render::Program::Information const &information)
+            {
+                return std::make_unique<Program>(information);
+            }
+
+            void executeCommandList(Render::Object *commandList)
+            {
+                auto nullCommandList = dynamic_cast<CommandList *>(commandList);
+                if (nullCommandList)
+                {
+                    nullCommandList->frameLog.replay(&defaultContext);
+                    ++commandListCount;
+                }
+            }
+
+            // Publishes the counts for the frame and keeps its log, the previous log's storage is reused for the next frame
+            void present(bool waitForVerticalSync)
+            {
+                auto statistics = defaultContext.frameLog.getStatistics();
+                auto &metrics = getContext()->getRuntimeMetrics();
+                metrics.set(metricHandles.frame, static_cast<double>(++presentFrameIndex));
+                metrics.set(metricHandles.totalCommands, static_cast<double>(statistics.commandCount));
+                metrics.set(metricHandles.drawCalls, static_cast<double>(statistics.drawCallCount));
+                metrics.set(metricHandles.vertices, static_cast<double>(statistics.vertexCount));
+                metrics.set(metricHandles.dispatches, static_cast<double>(statistics.dispatchCount));
+                metrics.set(metricHandles.stateChanges, static_cast<double>(statistics.stateChangeCount));
+                metrics.set(metricHandles.clears, static_cast<double>(statistics.clearCount));
+                metrics.set(metricHandles.copies, static_cast<double>(statistics.copyCount));
+                metrics.set(metricHandles.commandLists, static_cast<double>(std::exchange(commandListCount, 0)));
+                metrics.set(metricHandles.bufferMaps, static_cast<double>(bufferMapCount.exchange(0)));
+                metrics.set(metricHandles.bytesUploaded, static_cast<double>(bytesUploaded.exchange(0)));
+
+                std::swap(lastFrameLog, defaultContext.frameLog);
+                defaultContext.frameLog.clear();
+            }
+        };
+
+        GEK_REGISTER_CONTEXT_USER(Device);
+    }; // namespace Render::Implementation
+}; // namespace Gek
@@ -0,0 +1,139 @@
+#include "API/System/RenderDevice.hpp"
+#include "API/System/WindowDevice.hpp"
+#include "GEK/Utility/ContextUser.hpp"
+#include "GEK/Utility/FileSystem.hpp"
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <string>
+
+using namespace Gek;
+
+namespace
+{
+    struct NullDevice
+    {
+        ContextPtr context;
+        Render::DevicePtr device;
+
+        NullDevice(void)
+        {
+            std::vector<FileSystem::Path> pluginList = { FileSystem::Path(GEK_RENDERNULL_PLUGIN) };
+            context = Context::Create(nullptr, &pluginList);
+            context->setLogSinkMask(Context::LogSink_None);
+            device = context->createClass<Render::Device>("Default::Device::Video", static_cast<Window::Device *>(nullptr), Render::Device::Description());
+        }
+
+        double getMetric(std::string_view name) const
+        {
+            double value = -1.0;
+            context->getRuntimeMetric(name, value);
+            return value;
+        }
+    };
+
+    // A small deferred frame: two geometry passes, a lighting dispatch and a composite, with the shadow pass
+    // recorded on a deferred context and executed into the frame
+    void RenderScene(Render::Device *device, Render::Buffer *vertexBuffer, Render::Buffer *indexBuffer)
+    {
+        auto shadowContext = device->createDeferredContext();
+        shadowContext->setIndexBuffer(indexBuffer, 0);
+        shadowContext->setVertexBufferList({ vertexBuffer }, 0);
+        shadowContext->drawInstancedIndexedPrimitive(4, 0, 36, 0, 0);
+        auto shadowCommandList = shadowContext->finishCommandList();
+
+        auto context = device->getDefaultContext();
+        context->clearRenderTarget(device->getBackBuffer(), Math::Float4::Zero);
+        device->executeCommandList(shadowCommandList.get());
+
+        context->setPrimitiveType(Render::PrimitiveType::TriangleList);
+        context->setIndexBuffer(indexBuffer, 0);
+        context->setVertexBufferList({ vertexBuffer }, 0);
+        context->drawIndexedPrimitive(36, 0, 0);
+        context->drawInstancedIndexedPrimitive(10, 0, 36, 0, 0);
+
+        context->dispatch(80, 45, 1);
+        context->drawPrimitive(3, 0);
+    }
+
+    size_t CountLines(std::string const &text, std::string_view command)
+    {
+        size_t count = 0;
+        for (size_t position = text.find(command); position != std::string::npos; position = text.find(command, position + command.size()))
+        {
+            ++count;
+        }
+
+        return count;
+    }
+}; // namespace
+
+TEST(FrameLog, CountsDrawsAndDispatches)
+{
+    NullDevice nullDevice;
+    ASSERT_TRUE(nullDevice.device);
+
+    Render::Buffer::Description vertexBufferDescription;
+    vertexBufferDescription.name = "vertices";
+    vertexBufferDescription.stride = sizeof(Math::Float3);
+    vertexBufferDescription.count = 24;
+    vertexBufferDescription.type = Render::Buffer::Type::Vertex;
+    auto vertexBuffer = nullDevice.device->createBuffer(vertexBufferDescription);
+
+    Render::Buffer::Description indexBufferDescription;
+    indexBufferDescription.name = "indices";
+    indexBufferDescription.format = Render::Format::R16_UINT;
+    indexBufferDescription.count = 36;
+    indexBufferDescription.type = Render::Buffer::Type::Index;
+    auto indexBuffer = nullDevice.device->createBuffer(indexBufferDescription);
+
+    RenderScene(nullDevice.device.get(), vertexBuffer.get(), indexBuffer.get());
+    nullDevice.device->present(false);
+
+    EXPECT_EQ(nullDevice.getMetric("render.frame"), 1.0);
+    EXPECT_EQ(nullDevice.getMetric("null.drawCalls"), 4.0);
+    EXPECT_EQ(nullDevice.getMetric("null.dispatches"), 1.0);
+    EXPECT_EQ(nullDevice.getMetric("null.commandLists"), 1.0);
+    EXPECT_EQ(nullDevice.getMetric("null.clears"), 1.0);
+    EXPECT_EQ(nullDevice.getMetric("null.vertices"), double((4 * 36) + 36 + (10 * 36) + 3));
+
+    // Every frame is counted on its own
+    nullDevice.device->getDefaultContext()->dispatch(1, 1, 1);
+    nullDevice.device->present(false);
+    EXPECT_EQ(nullDevice.getMetric("render.frame"), 2.0);
+    EXPECT_EQ(nullDevice.getMetric("null.drawCalls"), 0.0);
+    EXPECT_EQ(nullDevice.getMetric("null.dispatches"), 1.0);
+    EXPECT_EQ(nullDevice.getMetric("null.commandLists"), 0.0);
+}
+
+TEST(FrameLog, WritesLastFrame)
+{
+    FileSystem::Path frameLogPath(std::filesystem::temp_directory_path() / "gek_null_frame_log.txt");
+#ifdef _WIN32
+    _putenv_s("gek_null_frame_log", frameLogPath.getString().data());
+#else
+    setenv("gek_null_frame_log", frameLogPath.getString().data(), 1);
+#endif
+
+    {
+        NullDevice nullDevice;
+        ASSERT_TRUE(nullDevice.device);
+        nullDevice.device->getDefaultContext()->dispatch(1, 1, 1);
+        nullDevice.device->present(false);
+
+        RenderScene(nullDevice.device.get(), nullptr, nullptr);
+        nullDevice.device->present(false);
+    }
+
+#ifdef _WIN32
+    _putenv_s("gek_null_frame_log", "");
+#else
+    unsetenv("gek_null_frame_log");
+#endif
+
+    auto frameLog = FileSystem::Read(frameLogPath);
+    EXPECT_EQ(CountLines(frameLog, " drawPrimitive "), 1U);
+    EXPECT_EQ(CountLines(frameLog, " drawIndexedPrimitive "), 1U);
+    EXPECT_EQ(CountLines(frameLog, " drawInstancedIndexedPrimitive "), 2U);
+    EXPECT_EQ(CountLines(frameLog, " dispatch "), 1U);
+    EXPECT_EQ(CountLines(frameLog, " clearRenderTarget "), 1U);
+}
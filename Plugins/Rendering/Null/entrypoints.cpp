@@ -0,0 +1,13 @@
+#include "GEK/Utility/ContextUser.hpp"
+
+namespace Gek
+{
+    namespace Render::Implementation
+    {
+        GEK_DECLARE_CONTEXT_USER(Device);
+    };
+
+    GEK_CONTEXT_BEGIN(System);
+    GEK_CONTEXT_ADD_CLASS(Default::Device::Video, Render::Implementation::Device);
+    GEK_CONTEXT_END();
+}; // namespace Gek
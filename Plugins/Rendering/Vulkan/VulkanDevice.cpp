@@ -6710,6 +6710,11 @@ namespace Gek
             }
 
             Render::TexturePtr loadTexture(FileSystem::Path const &filePath, uint32_t flags)
+            {
+                return loadTexture(filePath, FileSystem::Map(filePath), flags);
+            }
+
+            Render::TexturePtr loadTexture(FileSystem::Path const &filePath, FileSystem::FileView const &sourceView, uint32_t flags)
             {
                 std::lock_guard<std::mutex> decodeLock(getTextureDecodeMutex());
 
@@ -6763,8 +6768,7 @@ namespace Gek
                     return nullptr;
                 };
 
-                std::vector<uint8_t> sourceData = FileSystem::Load(filePath);
-                if (sourceData.empty())
+                if (!sourceView.isValid())
                 {
                     getContext()->log(Gek::Context::Error, "Vulkan loadTexture failed: unable to read file '{}'", filePath.getString());
                     return nullptr;
@@ -6776,7 +6780,7 @@ namespace Gek
                 if (extension == ".ktx2")
                 {
                     ktxTexture2 *kTexture = nullptr;
-                    KTX_error_code ktxResult = ktxTexture2_CreateFromMemory(sourceData.data(), sourceData.size(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &kTexture);
+                    KTX_error_code ktxResult = ktxTexture2_CreateFromMemory(sourceView.getData(), sourceView.getSize(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &kTexture);
                     if (ktxResult != KTX_SUCCESS || !kTexture)
                     {
                         getContext()->log(Gek::Context::Error, "Vulkan loadTexture failed: KTX2 decode error for '{}'", filePath.getString());
@@ -6850,7 +6854,7 @@ namespace Gek
 
                 // Raster image fallback via stb_image
                 int imgWidth = 0, imgHeight = 0, imgChannels = 0;
-                stbi_uc *pixels = stbi_load_from_memory(sourceData.data(), static_cast<int>(sourceData.size()), &imgWidth, &imgHeight, &imgChannels, 4);
+                stbi_uc *pixels = stbi_load_from_memory(sourceView.getData(), static_cast<int>(sourceView.getSize()), &imgWidth, &imgHeight, &imgChannels, 4);
                 if (!pixels)
                 {
                     getContext()->log(Gek::Context::Error, "Vulkan loadTexture failed: stb_image could not decode '{}'", filePath.getString());
@@ -6975,14 +6979,14 @@ namespace Gek
 
                 if (extension == ".ktx2")
                 {
-                    std::vector<uint8_t> sourceData = FileSystem::Load(filePath);
-                    if (sourceData.empty())
+                    auto sourceView = FileSystem::Map(filePath);
+                    if (!sourceView.isValid())
                     {
                         return description;
                     }
 
                     ktxTexture2 *kTexture = nullptr;
-                    KTX_error_code ktxResult = ktxTexture2_CreateFromMemory(sourceData.data(), sourceData.size(), KTX_TEXTURE_CREATE_SKIP_KVDATA_BIT, &kTexture);
+                    KTX_error_code ktxResult = ktxTexture2_CreateFromMemory(sourceView.getData(), sourceView.getSize(), KTX_TEXTURE_CREATE_SKIP_KVDATA_BIT, &kTexture);
                     if (ktxResult != KTX_SUCCESS || !kTexture)
                     {
                         return description;
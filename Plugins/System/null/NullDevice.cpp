@@ -0,0 +1,94 @@
+#include "API/System/WindowDevice.hpp"
+#include "GEK/Utility/ContextUser.hpp"
+#include <algorithm>
+#include <atomic>
+
+namespace Gek
+{
+    namespace Window::Implementation
+    {
+        // Window without a surface for headless runs, create() drives the idle loop until close() is called
+        GEK_CONTEXT_USER_BASE(Device)
+        , public Window::Device
+        {
+          private:
+            std::atomic_bool stop = false;
+            uint32_t clientWidth = 1;
+            uint32_t clientHeight = 1;
+            Math::Int2 cursorPosition = Math::Int2::Zero;
+
+          public:
+            Device(Context * context)
+                : ContextRegistration(context)
+            {
+            }
+
+            // Window::Device
+            void create(Window::Description const &description)
+            {
+                clientWidth = std::max(1U, description.initialWidth);
+                clientHeight = std::max(1U, description.initialHeight);
+                getContext()->log(Context::Info, "Null window created: {}x{}", clientWidth, clientHeight);
+
+                stop.store(false);
+                onCreated();
+                onActivate(true);
+                while (!stop.load())
+                {
+                    onIdle();
+                }
+            }
+
+            void close(void)
+            {
+                stop.store(true);
+            }
+
+            void *getWindowData(uint32_t data) const
+            {
+                return nullptr;
+            }
+
+            Math::Int4 getClientRectangle(bool moveToScreen = false) const
+            {
+                return Math::Int4(0, 0, static_cast<int32_t>(clientWidth), static_cast<int32_t>(clientHeight));
+            }
+
+            Math::Int4 getScreenRectangle(void) const
+            {
+                return getClientRectangle();
+            }
+
+            Math::Int2 getCursorPosition(void) const
+            {
+                return cursorPosition;
+            }
+
+            void setCursorPosition(Math::Int2 const &position)
+            {
+                cursorPosition = position;
+            }
+
+            void setCursorVisibility(bool isVisible)
+            {
+            }
+
+            void setVisibility(bool isVisible)
+            {
+            }
+
+            void move(Math::Int2 const &position)
+            {
+            }
+
+            void resize(Math::Int2 const &size)
+            {
+                clientWidth = static_cast<uint32_t>(std::max<int32_t>(1, size.x));
+                clientHeight = static_cast<uint32_t>(std::max<int32_t>(1, size.y));
+                onSizeChanged(false);
+            }
+        };
+
+        GEK_REGISTER_CONTEXT_USER(Device);
+    }; // namespace Window::Implementation
+}; // namespace Gek